@@ -0,0 +1,13 @@
+FIND_PATH(LZ4_INCLUDE_DIR NAMES lz4frame.h)
+MARK_AS_ADVANCED(LZ4_INCLUDE_DIR)
+FIND_LIBRARY(LZ4_LIBRARY NAMES lz4)
+MARK_AS_ADVANCED(LZ4_LIBRARY)
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LZ4 DEFAULT_MSG LZ4_LIBRARY LZ4_INCLUDE_DIR)
+IF (LZ4_FOUND)
+	SET(LZ4_LIBRARIES ${LZ4_LIBRARY})
+	SET(LZ4_INCLUDE_DIRS ${LZ4_INCLUDE_DIR})
+ELSE()
+	SET(LZ4_LIBRARIES)
+	SET(LZ4_INCLUDE_DIRS)
+ENDIF()
@@ -0,0 +1,13 @@
+FIND_PATH(ZSTD_INCLUDE_DIR NAMES zstd.h)
+MARK_AS_ADVANCED(ZSTD_INCLUDE_DIR)
+FIND_LIBRARY(ZSTD_LIBRARY NAMES zstd)
+MARK_AS_ADVANCED(ZSTD_LIBRARY)
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(ZSTD DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+IF (ZSTD_FOUND)
+	SET(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+	SET(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+ELSE()
+	SET(ZSTD_LIBRARIES)
+	SET(ZSTD_INCLUDE_DIRS)
+ENDIF()
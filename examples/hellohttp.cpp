@@ -1,11 +1,10 @@
 #include <silicium/http/http.hpp>
-#include <silicium/asio/accepting_source.hpp>
+#include <silicium/http/request_view_parser_sink.hpp>
+#include <silicium/asio/server_pool.hpp>
 #include <silicium/asio/socket_sink.hpp>
 #include <silicium/asio/socket_source.hpp>
-#include <silicium/source/virtualized_source.hpp>
-#include <silicium/source/buffering_source.hpp>
-#include <silicium/make_unique.hpp>
 #include <silicium/sink/ptr_sink.hpp>
+#include <silicium/sink/function_sink.hpp>
 #include <silicium/sink/append.hpp>
 #include <silicium/sink/buffering_sink.hpp>
 #include <silicium/terminate_on_exception.hpp>
@@ -13,54 +12,124 @@
 #include <iostream>
 
 #define SILICIUM_EXAMPLE_AVAILABLE                                             \
-    (SILICIUM_HAS_ASIO_ACCEPTING_SOURCE && SILICIUM_HAS_BUFFERING_SINK)
+    (SILICIUM_HAS_ASIO_SERVER_POOL && SILICIUM_HAS_BUFFERING_SINK &&           \
+     SILICIUM_HAS_HTTP_REQUEST_VIEW)
 
 #if SILICIUM_EXAMPLE_AVAILABLE
 namespace
 {
+    template <class CharSink>
+    void respond(CharSink &&sender,
+                 boost::asio::ip::tcp::socket const &client, bool bad_request,
+                 bool keep_alive)
+    {
+        if (bad_request)
+        {
+            Si::http::response response;
+            response.status = 400;
+            response.status_text = "Bad Request";
+            response.http_version = "HTTP/1.1";
+            response.arguments.set("Content-Length", "0");
+            response.arguments.set("Connection", "close");
+            Si::http::generate_response(sender, response);
+            return;
+        }
+
+        auto const client_endpoint = client.remote_endpoint();
+        auto const client_name =
+            boost::str(boost::format("%1%:%2%") % client_endpoint.address() %
+                       client_endpoint.port());
+        std::string const content = "Hello, " + client_name + "!";
+
+        Si::http::response response;
+        response.status = 200;
+        response.status_text = "OK";
+        response.http_version = "HTTP/1.1";
+        response.arguments.set(
+            "Content-Length", boost::lexical_cast<std::string>(content.size()));
+        if (!keep_alive)
+        {
+            response.arguments.set("Connection", "close");
+        }
+        response.arguments.set("Content-Type", "text/html");
+        Si::http::generate_response(sender, response);
+        Si::append(sender, content);
+    }
+
     void serve_client(std::shared_ptr<boost::asio::ip::tcp::socket> client,
                       boost::asio::yield_context yield)
     {
         try
         {
-            auto receiver =
-                Si::virtualize_source(Si::asio::socket_source(*client, yield));
+            Si::asio::socket_source receiver(*client, yield);
             Si::asio::socket_sink sender(*client, yield);
             auto buffered_sender =
                 Si::make_buffering_sink(Si::ref_sink(sender));
-            auto buffered_receiver = Si::make_buffer(receiver, 4096);
-            Si::optional<Si::http::request> const header =
-                Si::http::parse_request(buffered_receiver);
-            if (!header)
+            bool bad_request = false;
+            bool keep_alive = false;
+            bool done = false;
+            auto parser = Si::http::make_request_view_parser_sink(
+                Si::make_function_sink<Si::http::request_view>(
+                    [&](Si::iterator_range<Si::http::request_view const *>
+                            requests)
+                    {
+                        for (Si::http::request_view const &request : requests)
+                        {
+                            bad_request = request.path.empty() ||
+                                          request.http_version.empty();
+                            keep_alive =
+                                !bad_request &&
+                                Si::http::is_keep_alive(
+                                    request.http_version, request.arguments);
+                        }
+                        return Si::success();
+                    }),
+                Si::make_function_sink<Si::http::body_element>(
+                    [&](Si::iterator_range<Si::http::body_element const *>
+                            body)
+                    {
+                        for (Si::http::body_element const &element : body)
+                        {
+                            // the body is not needed, we only answer when the
+                            // request is complete
+                            if (done ||
+                                !Si::try_get_ptr<Si::http::end_of_body>(
+                                    element))
+                            {
+                                continue;
+                            }
+                            respond(buffered_sender, *client, bad_request,
+                                    keep_alive);
+                            done = !keep_alive;
+                        }
+                        return Si::success();
+                    }));
+
+            // the request is parsed directly from the receive buffer of the
+            // source, so nothing has to be allocated unless a request header
+            // does not fit in there. Pipelined requests that arrive together
+            // are answered with a single write.
+            while (!done && !parser.has_failed())
             {
-                Si::http::response response;
-                response.status = 400;
-                response.status_text = "Bad Request";
-                response.http_version = "HTTP/1.0";
-                Si::http::generate_response(buffered_sender, response);
+                Si::iterator_range<char const *> const received =
+                    receiver.map_next(4096);
+                if (received.empty())
+                {
+                    // the client closed the connection
+                    break;
+                }
+                Si::append(parser, received);
+                receiver.skip(static_cast<std::size_t>(received.size()));
                 buffered_sender.flush();
-                return;
             }
 
-            auto const client_endpoint = client->remote_endpoint();
-            auto const client_name =
-                boost::str(boost::format("%1%:%2%") %
-                           client_endpoint.address() % client_endpoint.port());
-            std::string const content = "Hello, " + client_name + "!";
-
-            Si::http::response response;
-            response.arguments = Si::make_unique<
-                std::map<Si::noexcept_string, Si::noexcept_string>>();
-            response.status = 200;
-            response.status_text = "OK";
-            response.http_version = "HTTP/1.0";
-            (*response.arguments)["Content-Length"] =
-                boost::lexical_cast<Si::noexcept_string>(content.size());
-            (*response.arguments)["Connection"] = "close";
-            (*response.arguments)["Content-Type"] = "text/html";
-            Si::http::generate_response(buffered_sender, response);
-            Si::append(buffered_sender, content);
-            buffered_sender.flush();
+            // a header that is too large or a body that cannot be framed
+            // still gets an answer before the connection is closed
+            if (!done && parser.has_failed())
+            {
+                respond(buffered_sender, *client, true, false);
+                buffered_sender.flush();
+            }
         }
         catch (boost::system::system_error const &)
         {
@@ -73,24 +142,14 @@ namespace
 int main()
 {
 #if SILICIUM_EXAMPLE_AVAILABLE
-    boost::asio::io_service io;
-    boost::asio::ip::tcp::acceptor acceptor(
-        io,
-        boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4(), 8080));
-    boost::asio::spawn(
-        io, [&acceptor](boost::asio::yield_context yield)
-        {
-            auto clients = Si::virtualize_source(
-                Si::asio::accepting_source(acceptor, yield));
-            auto range = Si::make_buffer(clients, 1);
-            for (auto client : range)
-            {
-                boost::asio::spawn(
-                    acceptor.get_io_service(),
-                    std::bind(serve_client, client, std::placeholders::_1));
-            }
-        });
-    io.run();
+    // one event loop per core so that a single busy loop does not limit the
+    // throughput
+    std::size_t const loop_count =
+        (std::max)(1u, std::thread::hardware_concurrency());
+    Si::asio::server_pool server(
+        boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4(), 8080),
+        loop_count, serve_client);
+    server.run();
 #else
     std::cerr << "This example requires boost::asio::spawn\n";
 #endif
@@ -17,10 +17,7 @@ int main()
                         {
                             Si::html::unpaired_element(destination, "br");
                         })));
-    std::vector<char> generated;
-    auto sink =
-        Si::Sink<char, Si::success>::erase(Si::make_container_sink(generated));
-    document.generate(sink);
+    std::vector<char> const generated = generate<std::vector<char>>(document);
     std::cout.write(
         generated.data(), static_cast<std::streamsize>(generated.size()));
     std::cout << '\n';
@@ -3,7 +3,10 @@
 
 #include <algorithm>
 #include <silicium/source/source.hpp>
+#include <silicium/asio/get_io_service.hpp>
+#include <silicium/asio/socket_pool.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <functional>
 #include <memory>
 
 #define SILICIUM_HAS_ASIO_ACCEPTING_SOURCE                                     \
@@ -21,14 +24,26 @@ namespace Si
         {
             typedef std::shared_ptr<boost::asio::ip::tcp::socket> element_type;
 
+            typedef std::function<boost::asio::io_service &()>
+                service_selector;
+
             explicit accepting_source(boost::asio::ip::tcp::acceptor &acceptor,
                                       boost::asio::yield_context &yield);
+
+            /// The accepted sockets belong to the io_service returned by
+            /// select_service instead of the io_service of the acceptor. This
+            /// allows one acceptor to distribute clients over several event
+            /// loops.
+            accepting_source(boost::asio::ip::tcp::acceptor &acceptor,
+                             boost::asio::yield_context &yield,
+                             service_selector select_service);
             iterator_range<element_type const *> map_next(std::size_t);
             element_type *copy_next(iterator_range<element_type *> destination);
 
         private:
             boost::asio::ip::tcp::acceptor *m_acceptor;
             boost::asio::yield_context *m_yield;
+            service_selector m_select_service;
         };
 
         inline accepting_source::accepting_source(
@@ -39,6 +54,15 @@ namespace Si
         {
         }
 
+        inline accepting_source::accepting_source(
+            boost::asio::ip::tcp::acceptor &acceptor,
+            boost::asio::yield_context &yield, service_selector select_service)
+            : m_acceptor(&acceptor)
+            , m_yield(&yield)
+            , m_select_service(std::move(select_service))
+        {
+        }
+
         inline iterator_range<accepting_source::element_type const *>
             accepting_source::map_next(std::size_t)
         {
@@ -54,12 +78,55 @@ namespace Si
             {
                 assert(m_acceptor);
                 client = std::make_shared<boost::asio::ip::tcp::socket>(
-                    m_acceptor->get_io_service());
+                    m_select_service ? m_select_service()
+                                     : get_io_service(*m_acceptor));
                 assert(m_yield);
                 m_acceptor->async_accept(*client, *m_yield);
             }
             return destination.end();
         }
+
+        /// Like accepting_source, but the sockets come from a socket_pool and
+        /// are returned to it when the last pooled_socket handle is gone.
+        /// This avoids an allocation and atomic reference counting per
+        /// client. The handles must not leave the thread of the io_service
+        /// of the pool.
+        struct pooled_accepting_source
+        {
+            typedef pooled_socket element_type;
+
+            pooled_accepting_source(boost::asio::ip::tcp::acceptor &acceptor,
+                                    boost::asio::yield_context &yield,
+                                    socket_pool &sockets)
+                : m_acceptor(&acceptor)
+                , m_yield(&yield)
+                , m_sockets(&sockets)
+            {
+            }
+
+            iterator_range<element_type const *> map_next(std::size_t)
+            {
+                return iterator_range<element_type const *>();
+            }
+
+            element_type *copy_next(iterator_range<element_type *> destination)
+            {
+                assert(m_acceptor);
+                assert(m_yield);
+                assert(m_sockets);
+                for (auto &client : destination)
+                {
+                    client = m_sockets->acquire();
+                    m_acceptor->async_accept(*client, *m_yield);
+                }
+                return destination.end();
+            }
+
+        private:
+            boost::asio::ip::tcp::acceptor *m_acceptor;
+            boost::asio::yield_context *m_yield;
+            socket_pool *m_sockets;
+        };
     }
 }
 #endif
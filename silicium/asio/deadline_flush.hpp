@@ -0,0 +1,179 @@
+#ifndef SILICIUM_ASIO_DEADLINE_FLUSH_HPP
+#define SILICIUM_ASIO_DEADLINE_FLUSH_HPP
+
+#include <silicium/config.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <memory>
+
+namespace Si
+{
+    namespace asio
+    {
+        namespace detail
+        {
+            inline boost::system::error_code
+            to_flush_error(boost::system::error_code const &error)
+            {
+                return error;
+            }
+
+            template <class Error>
+            boost::system::error_code to_flush_error(Error const &error)
+            {
+                if (!error)
+                {
+                    return boost::system::error_code();
+                }
+                return boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+            }
+        }
+
+        /// A flush policy for buffering_sink that passes data on when it has
+        /// been waiting in the buffer for longer than a delay. The sink is
+        /// flushed from a completion handler of the io_service, so the
+        /// destination has to be usable from there. A coroutine-based sink
+        /// like socket_sink cannot be used with this policy. Moving the sink
+        /// cancels a pending timed flush and the next append starts the timer
+        /// again. A timer that expires while the sink is corked does nothing.
+        /// An error of a timed flush leaves the data in the buffer and
+        /// is kept in error(). The next append of the owner flushes again and
+        /// returns the result of that.
+        struct deadline_flush
+        {
+            deadline_flush(boost::asio::io_service &io,
+                           std::chrono::microseconds delay)
+                : m_state(std::make_shared<state>(io))
+                , m_delay(delay)
+            {
+            }
+
+            /// The handler of a pending timer refers to the sink that is being
+            /// moved from, so it must not run.
+            deadline_flush(deadline_flush &&other) BOOST_NOEXCEPT
+                : m_state(std::move(other.m_state)),
+                  m_delay(other.m_delay)
+            {
+                disarm();
+            }
+
+            deadline_flush &operator=(deadline_flush &&other) BOOST_NOEXCEPT
+            {
+                disarm();
+                m_state = std::move(other.m_state);
+                m_delay = other.m_delay;
+                disarm();
+                return *this;
+            }
+
+            /// Starts the timer when data enters the empty buffer. Asks the
+            /// owner to flush right away when the last timed flush failed.
+            template <class Sink>
+            bool should_flush(Sink &sink, std::size_t buffered, std::size_t)
+            {
+                if (!m_state || (buffered == 0))
+                {
+                    return false;
+                }
+                if (m_state->error)
+                {
+                    return true;
+                }
+                if (m_state->armed)
+                {
+                    return false;
+                }
+                m_state->armed = true;
+                m_state->timer.expires_from_now(m_delay);
+                std::weak_ptr<state> const weak_state = m_state;
+                std::size_t const generation = m_state->generation;
+                Sink *const flushed_sink = &sink;
+                m_state->timer.async_wait(
+                    [weak_state, generation,
+                     flushed_sink](boost::system::error_code const &)
+                    {
+                        std::shared_ptr<state> const alive = weak_state.lock();
+                        // the buffer may have been flushed and refilled in
+                        // the meantime
+                        if (!alive || (alive->generation != generation))
+                        {
+                            return;
+                        }
+                        // uncork() passes the data on, and the next append
+                        // starts the timer again
+                        if (flushed_sink->is_corked())
+                        {
+                            alive->armed = false;
+                            return;
+                        }
+                        boost::system::error_code const error =
+                            detail::to_flush_error(flushed_sink->flush());
+                        if (alive->generation == generation)
+                        {
+                            // the flush failed, the next append tries again
+                            alive->armed = false;
+                            alive->error = error;
+                        }
+                    });
+                return false;
+            }
+
+            void flushed()
+            {
+                if (!m_state)
+                {
+                    return;
+                }
+                m_state->error = boost::system::error_code();
+                disarm();
+            }
+
+            /// The error of the last timed flush if the buffer has not been
+            /// emptied since.
+            boost::system::error_code error() const BOOST_NOEXCEPT
+            {
+                return m_state ? m_state->error : boost::system::error_code();
+            }
+
+        private:
+            struct state
+            {
+                boost::asio::steady_timer timer;
+                std::size_t generation;
+                bool armed;
+                boost::system::error_code error;
+
+                explicit state(boost::asio::io_service &io)
+                    : timer(io)
+                    , generation(0)
+                    , armed(false)
+                {
+                }
+            };
+
+            std::shared_ptr<state> m_state;
+            std::chrono::microseconds m_delay;
+
+            void disarm() BOOST_NOEXCEPT
+            {
+                if (!m_state || !m_state->armed)
+                {
+                    return;
+                }
+                m_state->armed = false;
+                ++m_state->generation;
+                boost::system::error_code ignored;
+                m_state->timer.cancel(ignored);
+            }
+
+            SILICIUM_DELETED_FUNCTION(deadline_flush(deadline_flush const &))
+            SILICIUM_DELETED_FUNCTION(
+                deadline_flush &operator=(deadline_flush const &))
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef SILICIUM_ASIO_GET_IO_SERVICE_HPP
+#define SILICIUM_ASIO_GET_IO_SERVICE_HPP
+
+#include <silicium/config.hpp>
+#include <boost/asio/io_service.hpp>
+
+namespace Si
+{
+    namespace asio
+    {
+        /// Returns the io_service that an I/O object like a socket belongs
+        /// to. Newer versions of Boost removed get_io_service() in favour of
+        /// executors.
+        template <class IoObject>
+        boost::asio::io_service &get_io_service(IoObject &object)
+        {
+#if BOOST_VERSION >= 106600
+            return static_cast<boost::asio::io_service &>(
+                object.get_executor().context());
+#else
+            return object.get_io_service();
+#endif
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,396 @@
+#ifndef SILICIUM_ASIO_SERVER_POOL_HPP
+#define SILICIUM_ASIO_SERVER_POOL_HPP
+
+#include <silicium/asio/accepting_source.hpp>
+#include <silicium/make_destructor.hpp>
+
+#define SILICIUM_HAS_ASIO_SERVER_POOL SILICIUM_HAS_ASIO_ACCEPTING_SOURCE
+
+#if SILICIUM_HAS_ASIO_SERVER_POOL
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef SO_REUSEPORT
+#define SILICIUM_HAS_ASIO_REUSE_PORT 1
+#else
+#define SILICIUM_HAS_ASIO_REUSE_PORT 0
+#endif
+
+namespace Si
+{
+    namespace asio
+    {
+#if SILICIUM_HAS_ASIO_REUSE_PORT
+        /// Lets several sockets listen on the same port. The kernel
+        /// distributes incoming connections over them.
+        typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET,
+                                                            SO_REUSEPORT>
+            reuse_port;
+#endif
+
+        enum class accept_sharding
+        {
+            /// Every loop has its own acceptor bound with SO_REUSEPORT, so
+            /// accepting does not need any synchronization between the loops.
+            reuse_port,
+
+            /// The first loop accepts all clients and hands every client to
+            /// the loop with the fewest connections.
+            shared_acceptor
+        };
+
+        /// A snapshot of the counters of one event loop of a server_pool.
+        struct loop_statistics
+        {
+            /// Clients that were ever assigned to the loop.
+            std::size_t accepted;
+
+            /// Clients whose handler is currently running on the loop.
+            std::size_t active_connections;
+
+            /// Clients that were assigned to the loop, but whose handler has
+            /// not been started yet because the loop is busy.
+            std::size_t queued_connections;
+        };
+
+        enum class accept_error_kind
+        {
+            /// Only the connection that was about to be accepted is affected.
+            client,
+
+            /// The process or the system ran out of file descriptors or
+            /// memory. Accepting again right away would fail the same way.
+            resources,
+
+            /// The acceptor cannot be used anymore.
+            fatal
+        };
+
+        inline accept_error_kind
+        classify_accept_error(boost::system::error_code error) BOOST_NOEXCEPT
+        {
+            namespace asio_error = boost::asio::error;
+            if ((error == asio_error::no_descriptors) ||
+                (error == asio_error::no_buffer_space) ||
+                (error == asio_error::no_memory) ||
+                (error == boost::system::errc::too_many_files_open_in_system))
+            {
+                return accept_error_kind::resources;
+            }
+            if ((error == asio_error::connection_aborted) ||
+                (error == asio_error::connection_reset) ||
+                (error == asio_error::interrupted) ||
+                (error == asio_error::would_block) ||
+                (error == asio_error::try_again) ||
+                (error == asio_error::no_permission) ||
+                (error == asio_error::network_down) ||
+                (error == asio_error::network_unreachable) ||
+                (error == asio_error::host_unreachable) ||
+                (error == asio_error::no_protocol_option) ||
+                (error == asio_error::operation_not_supported) ||
+                (error == boost::system::errc::protocol_error))
+            {
+                return accept_error_kind::client;
+            }
+            return accept_error_kind::fatal;
+        }
+
+        namespace detail
+        {
+            struct server_loop
+            {
+                // the counters are declared first because handlers that are
+                // destroyed together with io still decrement them
+                std::atomic<std::size_t> accepted;
+                std::atomic<std::size_t> active_connections;
+                std::atomic<std::size_t> queued_connections;
+                boost::asio::io_service io;
+                std::unique_ptr<boost::asio::io_service::work> keep_running;
+                std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+
+                server_loop()
+                    : accepted(0)
+                    , active_connections(0)
+                    , queued_connections(0)
+                    , keep_running(new boost::asio::io_service::work(io))
+                {
+                }
+
+                std::size_t load() const BOOST_NOEXCEPT
+                {
+                    return active_connections.load() +
+                           queued_connections.load();
+                }
+            };
+        }
+
+        /// Runs one event loop per thread and serves clients of one TCP
+        /// endpoint on all of them. Every client is handled by a coroutine
+        /// on the loop that it was assigned to, so a handler does not need
+        /// any synchronization as long as it only uses its own socket.
+        struct server_pool
+        {
+            typedef std::function<void(
+                std::shared_ptr<boost::asio::ip::tcp::socket>,
+                boost::asio::yield_context)> client_handler;
+
+            /// Binds the acceptors immediately, so an endpoint with port 0
+            /// can be used to find a free port. No client is accepted
+            /// before run() is called.
+            server_pool(boost::asio::ip::tcp::endpoint const &endpoint,
+                        std::size_t loop_count, client_handler handle_client,
+                        accept_sharding sharding = default_sharding())
+                : m_handle_client(std::move(handle_client))
+                , m_sharding(sharding)
+                , m_next_loop(0)
+            {
+                assert(loop_count >= 1);
+                assert(m_handle_client);
+#if !SILICIUM_HAS_ASIO_REUSE_PORT
+                m_sharding = accept_sharding::shared_acceptor;
+#endif
+                m_loops.reserve(loop_count);
+                for (std::size_t i = 0; i < loop_count; ++i)
+                {
+                    m_loops.emplace_back(new detail::server_loop);
+                }
+                std::size_t const acceptor_count =
+                    (m_sharding == accept_sharding::reuse_port) ? loop_count
+                                                                : 1;
+                boost::asio::ip::tcp::endpoint bound = endpoint;
+                for (std::size_t i = 0; i < acceptor_count; ++i)
+                {
+                    detail::server_loop &loop = *m_loops[i];
+                    loop.acceptor.reset(
+                        new boost::asio::ip::tcp::acceptor(loop.io));
+                    open_acceptor(*loop.acceptor, bound);
+                    // the other acceptors have to use the same port even if
+                    // the first one got a random one
+                    bound = loop.acceptor->local_endpoint();
+                    boost::asio::spawn(loop.io, [this, i](
+                                                    boost::asio::yield_context
+                                                        yield)
+                                       {
+                                           accept_clients(i, yield);
+                                       });
+                }
+            }
+
+            ~server_pool()
+            {
+                stop();
+                join();
+            }
+
+            SILICIUM_DELETED_FUNCTION(server_pool(server_pool const &))
+            SILICIUM_DELETED_FUNCTION(
+                server_pool &operator=(server_pool const &))
+
+            static accept_sharding default_sharding() BOOST_NOEXCEPT
+            {
+#if SILICIUM_HAS_ASIO_REUSE_PORT
+                return accept_sharding::reuse_port;
+#else
+                return accept_sharding::shared_acceptor;
+#endif
+            }
+
+            accept_sharding sharding() const BOOST_NOEXCEPT
+            {
+                return m_sharding;
+            }
+
+            boost::asio::ip::tcp::endpoint local_endpoint() const
+            {
+                return m_loops.front()->acceptor->local_endpoint();
+            }
+
+            std::size_t loop_count() const BOOST_NOEXCEPT
+            {
+                return m_loops.size();
+            }
+
+            boost::asio::io_service &get_io_service(std::size_t loop)
+            {
+                return m_loops[loop]->io;
+            }
+
+            /// Can be called from any thread while the pool is running.
+            loop_statistics get_statistics(std::size_t loop) const
+            {
+                detail::server_loop const &selected = *m_loops[loop];
+                loop_statistics result;
+                result.accepted = selected.accepted.load();
+                result.active_connections = selected.active_connections.load();
+                result.queued_connections = selected.queued_connections.load();
+                return result;
+            }
+
+            /// Runs every loop on its own thread and returns when all of them
+            /// have been stopped. The first loop runs on the calling thread.
+            void run()
+            {
+                for (std::size_t i = 1; i < m_loops.size(); ++i)
+                {
+                    boost::asio::io_service &io = m_loops[i]->io;
+                    m_threads.emplace_back([&io]
+                                           {
+                                               io.run();
+                                           });
+                }
+                m_loops.front()->io.run();
+                join();
+            }
+
+            /// Stops all loops. Running handlers are abandoned. Can be
+            /// called from any thread.
+            void stop()
+            {
+                for (std::unique_ptr<detail::server_loop> const &loop :
+                     m_loops)
+                {
+                    loop->io.stop();
+                }
+            }
+
+        private:
+            client_handler m_handle_client;
+            accept_sharding m_sharding;
+            std::vector<std::unique_ptr<detail::server_loop>> m_loops;
+            std::vector<std::thread> m_threads;
+            std::size_t m_next_loop;
+
+            void open_acceptor(boost::asio::ip::tcp::acceptor &acceptor,
+                               boost::asio::ip::tcp::endpoint const &endpoint)
+            {
+                acceptor.open(endpoint.protocol());
+                acceptor.set_option(
+                    boost::asio::ip::tcp::acceptor::reuse_address(true));
+#if SILICIUM_HAS_ASIO_REUSE_PORT
+                if (m_sharding == accept_sharding::reuse_port)
+                {
+                    acceptor.set_option(reuse_port(true));
+                }
+#endif
+                acceptor.bind(endpoint);
+                acceptor.listen();
+            }
+
+            /// Prefers the loop with the fewest clients. Ties are broken
+            /// round-robin so that an idle server still uses all loops.
+            std::size_t select_loop()
+            {
+                std::size_t const count = m_loops.size();
+                std::size_t best = m_next_loop % count;
+                std::size_t best_load = m_loops[best]->load();
+                for (std::size_t i = 1; (i < count) && (best_load != 0); ++i)
+                {
+                    std::size_t const candidate = (m_next_loop + i) % count;
+                    std::size_t const load = m_loops[candidate]->load();
+                    if (load < best_load)
+                    {
+                        best = candidate;
+                        best_load = load;
+                    }
+                }
+                m_next_loop = best + 1;
+                return best;
+            }
+
+            void accept_clients(std::size_t accepting_loop,
+                                boost::asio::yield_context yield)
+            {
+                std::size_t target = accepting_loop;
+                accepting_source::service_selector select_service;
+                if (m_sharding == accept_sharding::shared_acceptor)
+                {
+                    select_service = [this, &target]()
+                        -> boost::asio::io_service &
+                    {
+                        target = select_loop();
+                        return m_loops[target]->io;
+                    };
+                }
+                accepting_source clients(*m_loops[accepting_loop]->acceptor,
+                                         yield, std::move(select_service));
+                for (;;)
+                {
+                    std::shared_ptr<boost::asio::ip::tcp::socket> client;
+                    try
+                    {
+                        clients.copy_next(
+                            Si::make_iterator_range(&client, &client + 1));
+                    }
+                    catch (boost::system::system_error const &ex)
+                    {
+                        switch (classify_accept_error(ex.code()))
+                        {
+                        case accept_error_kind::client:
+                            // a client can disconnect before it is accepted
+                            continue;
+
+                        case accept_error_kind::resources:
+                        {
+                            // give the handlers time to close connections
+                            // instead of spinning on the same error
+                            boost::asio::steady_timer backoff(
+                                m_loops[accepting_loop]->io,
+                                accept_backoff());
+                            boost::system::error_code ignored;
+                            backoff.async_wait(yield[ignored]);
+                            continue;
+                        }
+
+                        case accept_error_kind::fatal:
+                            // includes operation_aborted from stopping
+                            return;
+                        }
+                    }
+                    dispatch(*m_loops[target], std::move(client));
+                }
+            }
+
+            static std::chrono::milliseconds accept_backoff() BOOST_NOEXCEPT
+            {
+                return std::chrono::milliseconds(100);
+            }
+
+            void dispatch(detail::server_loop &owner,
+                          std::shared_ptr<boost::asio::ip::tcp::socket> client)
+            {
+                ++owner.accepted;
+                ++owner.queued_connections;
+                client_handler const &handle_client = m_handle_client;
+                boost::asio::spawn(
+                    owner.io, [&owner, &handle_client, client](
+                                  boost::asio::yield_context yield)
+                    {
+                        --owner.queued_connections;
+                        ++owner.active_connections;
+                        auto const finished = make_destructor([&owner]
+                                                              {
+                            --owner.active_connections;
+                        });
+                        handle_client(client, yield);
+                    });
+            }
+
+            void join()
+            {
+                for (std::thread &thread : m_threads)
+                {
+                    thread.join();
+                }
+                m_threads.clear();
+            }
+        };
+    }
+}
+#endif
+
+#endif
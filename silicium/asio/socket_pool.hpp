@@ -0,0 +1,272 @@
+#ifndef SILICIUM_ASIO_SOCKET_POOL_HPP
+#define SILICIUM_ASIO_SOCKET_POOL_HPP
+
+#include <silicium/config.hpp>
+#include <silicium/explicit_operator_bool.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cassert>
+
+namespace Si
+{
+    namespace asio
+    {
+        namespace detail
+        {
+            struct socket_pool_state;
+
+            struct pooled_socket_node
+            {
+                boost::asio::ip::tcp::socket socket;
+                std::size_t references;
+                socket_pool_state *owner;
+                pooled_socket_node *next_free;
+
+                pooled_socket_node(boost::asio::io_service &io,
+                                   socket_pool_state &owner)
+                    : socket(io)
+                    , references(0)
+                    , owner(&owner)
+                    , next_free(nullptr)
+                {
+                }
+            };
+
+            /// Outlives the socket_pool while sockets are still in use, so
+            /// that they can be released after the pool has been destroyed.
+            struct socket_pool_state
+            {
+                boost::asio::io_service *io;
+                pooled_socket_node *free;
+                std::size_t free_count;
+                std::size_t in_use;
+                bool orphaned;
+
+                explicit socket_pool_state(boost::asio::io_service &io)
+                    : io(&io)
+                    , free(nullptr)
+                    , free_count(0)
+                    , in_use(0)
+                    , orphaned(false)
+                {
+                }
+
+                ~socket_pool_state()
+                {
+                    assert(in_use == 0);
+                    while (free)
+                    {
+                        pooled_socket_node *const next = free->next_free;
+                        delete free;
+                        free = next;
+                    }
+                }
+
+                pooled_socket_node &acquire()
+                {
+                    pooled_socket_node *node = free;
+                    if (node)
+                    {
+                        free = node->next_free;
+                        node->next_free = nullptr;
+                        --free_count;
+                    }
+                    else
+                    {
+                        node = new pooled_socket_node(*io, *this);
+                    }
+                    assert(node->references == 0);
+                    ++in_use;
+                    return *node;
+                }
+
+                void reserve(std::size_t free_sockets)
+                {
+                    while (free_count < free_sockets)
+                    {
+                        pooled_socket_node *const node =
+                            new pooled_socket_node(*io, *this);
+                        node->next_free = free;
+                        free = node;
+                        ++free_count;
+                    }
+                }
+
+                static void release(pooled_socket_node &node) BOOST_NOEXCEPT
+                {
+                    assert(node.references == 0);
+                    socket_pool_state &state = *node.owner;
+                    // the socket is going to be reused for another accept,
+                    // so it has to be closed
+                    boost::system::error_code ignored;
+                    node.socket.close(ignored);
+                    --state.in_use;
+                    if (state.orphaned)
+                    {
+                        delete &node;
+                        if (state.in_use == 0)
+                        {
+                            delete &state;
+                        }
+                        return;
+                    }
+                    node.next_free = state.free;
+                    state.free = &node;
+                    ++state.free_count;
+                }
+            };
+        }
+
+        /// A shared handle to a socket that returns the socket to its
+        /// socket_pool when the last handle disappears. The reference count
+        /// is not atomic, so all copies of a handle have to be used on the
+        /// thread that runs the io_service of the pool.
+        struct pooled_socket
+        {
+            pooled_socket() BOOST_NOEXCEPT : m_node(nullptr)
+            {
+            }
+
+            explicit pooled_socket(detail::pooled_socket_node &node)
+                BOOST_NOEXCEPT : m_node(&node)
+            {
+                ++m_node->references;
+            }
+
+            pooled_socket(pooled_socket const &other) BOOST_NOEXCEPT
+                : m_node(other.m_node)
+            {
+                if (m_node)
+                {
+                    ++m_node->references;
+                }
+            }
+
+            pooled_socket(pooled_socket &&other) BOOST_NOEXCEPT
+                : m_node(other.m_node)
+            {
+                other.m_node = nullptr;
+            }
+
+            ~pooled_socket() BOOST_NOEXCEPT
+            {
+                reset();
+            }
+
+            pooled_socket &operator=(pooled_socket other) BOOST_NOEXCEPT
+            {
+                swap(other);
+                return *this;
+            }
+
+            void swap(pooled_socket &other) BOOST_NOEXCEPT
+            {
+                std::swap(m_node, other.m_node);
+            }
+
+            void reset() BOOST_NOEXCEPT
+            {
+                if (!m_node)
+                {
+                    return;
+                }
+                detail::pooled_socket_node &node = *m_node;
+                m_node = nullptr;
+                if (--node.references == 0)
+                {
+                    detail::socket_pool_state::release(node);
+                }
+            }
+
+            boost::asio::ip::tcp::socket *get() const BOOST_NOEXCEPT
+            {
+                return m_node ? &m_node->socket : nullptr;
+            }
+
+            boost::asio::ip::tcp::socket &operator*() const BOOST_NOEXCEPT
+            {
+                assert(m_node);
+                return m_node->socket;
+            }
+
+            boost::asio::ip::tcp::socket *operator->() const BOOST_NOEXCEPT
+            {
+                assert(m_node);
+                return &m_node->socket;
+            }
+
+            bool operator!() const BOOST_NOEXCEPT
+            {
+                return !m_node;
+            }
+
+            SILICIUM_EXPLICIT_OPERATOR_BOOL()
+
+            std::size_t use_count() const BOOST_NOEXCEPT
+            {
+                return m_node ? m_node->references : 0;
+            }
+
+        private:
+            detail::pooled_socket_node *m_node;
+        };
+
+        /// Recycles socket objects of one io_service so that accepting a
+        /// client does not allocate once the pool has warmed up. A pool must
+        /// only be used by the thread that runs its io_service.
+        struct socket_pool
+        {
+            explicit socket_pool(boost::asio::io_service &io)
+                : m_state(new detail::socket_pool_state(io))
+            {
+            }
+
+            ~socket_pool()
+            {
+                if (m_state->in_use == 0)
+                {
+                    delete m_state;
+                    return;
+                }
+                // the last released socket deletes the state
+                m_state->orphaned = true;
+            }
+
+            SILICIUM_DELETED_FUNCTION(socket_pool(socket_pool const &))
+            SILICIUM_DELETED_FUNCTION(
+                socket_pool &operator=(socket_pool const &))
+
+            boost::asio::io_service &get_io_service() const BOOST_NOEXCEPT
+            {
+                return *m_state->io;
+            }
+
+            /// Returns a closed socket, either a recycled one or a new one.
+            pooled_socket acquire()
+            {
+                return pooled_socket(m_state->acquire());
+            }
+
+            /// Allocates sockets in advance so that the first clients do not
+            /// have to wait for the allocator either.
+            void reserve(std::size_t free_sockets)
+            {
+                m_state->reserve(free_sockets);
+            }
+
+            std::size_t free_count() const BOOST_NOEXCEPT
+            {
+                return m_state->free_count;
+            }
+
+            std::size_t in_use() const BOOST_NOEXCEPT
+            {
+                return m_state->in_use;
+            }
+
+        private:
+            detail::socket_pool_state *m_state;
+        };
+    }
+}
+
+#endif
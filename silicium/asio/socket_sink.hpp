@@ -2,7 +2,10 @@
 #define SILICIUM_ASIO_SOCKET_SINK_HPP
 
 #include <silicium/sink/sink.hpp>
+#include <silicium/sink/append_file.hpp>
+#include <silicium/transfer_file.hpp>
 #include <algorithm>
+#include <array>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 
@@ -12,6 +15,9 @@
 
 #if SILICIUM_HAS_ASIO_SOCKET_SINK
 #include <boost/asio/spawn.hpp>
+#if SILICIUM_HAS_ZERO_COPY_TRANSFER
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif
 
 namespace Si
 {
@@ -26,9 +32,31 @@ namespace Si
                                  boost::asio::yield_context &yield);
             boost::system::error_code append(iterator_range<char const *> data);
 
+            /// Writes all ranges with a single gathering write as long as
+            /// there are not more than 16 of them.
+            boost::system::error_code append_ranges(
+                iterator_range<iterator_range<char const *> const *> ranges);
+
+            /// Sends up to size bytes from the current position of file. On
+            /// Linux the data is sent with sendfile(2) or splice(2) without
+            /// being copied into user memory. The coroutine waits whenever
+            /// the socket is not writable or a pipe has nothing to read.
+            boost::system::error_code append_file(native_file_descriptor file,
+                                                  std::size_t size);
+
         private:
             boost::asio::ip::tcp::socket *m_socket;
             boost::asio::yield_context *m_yield;
+
+            boost::system::error_code wait_until_writable();
+            boost::system::error_code
+            wait_until_readable(native_file_descriptor file);
+            boost::system::error_code copy_file(native_file_descriptor file,
+                                                std::size_t size)
+            {
+                return Si::detail::append_file(
+                    *this, file, size, std::false_type());
+            }
         };
 
         inline socket_sink::socket_sink(boost::asio::ip::tcp::socket &socket,
@@ -51,6 +79,159 @@ namespace Si
                 (*m_yield)[ec]);
             return ec;
         }
+
+        inline boost::system::error_code socket_sink::append_ranges(
+            iterator_range<iterator_range<char const *> const *> ranges)
+        {
+            assert(m_socket);
+            assert(m_yield);
+            std::array<boost::asio::const_buffer, 16> buffers;
+            while (!ranges.empty())
+            {
+                std::size_t const count = (std::min)(
+                    buffers.size(), static_cast<std::size_t>(ranges.size()));
+                // unused elements stay empty, which costs nothing
+                buffers.fill(boost::asio::const_buffer());
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    iterator_range<char const *> const &range =
+                        ranges.begin()[i];
+                    buffers[i] = boost::asio::buffer(
+                        range.begin(), static_cast<std::size_t>(range.size()));
+                }
+                boost::system::error_code ec;
+                boost::asio::async_write(*m_socket, buffers, (*m_yield)[ec]);
+                if (ec)
+                {
+                    return ec;
+                }
+                ranges.pop_front(static_cast<std::ptrdiff_t>(count));
+            }
+            return boost::system::error_code();
+        }
+
+        inline boost::system::error_code
+        socket_sink::append_file(native_file_descriptor file, std::size_t size)
+        {
+            assert(m_socket);
+            assert(m_yield);
+            Si::detail::transfer_method const method =
+                Si::detail::choose_transfer_method(
+                    file, m_socket->native_handle());
+            if (method == Si::detail::transfer_method::copy)
+            {
+                return copy_file(file, size);
+            }
+            // the system call must not block the thread of the io_service,
+            // neither on the socket nor on a pipe
+            bool const was_non_blocking = m_socket->non_blocking();
+            boost::system::error_code ec;
+            m_socket->non_blocking(true, ec);
+            if (ec)
+            {
+                return ec;
+            }
+            std::size_t transferred = 0;
+            while (transferred < size)
+            {
+                error_or<std::size_t> const step = Si::detail::transfer_once(
+                    file, m_socket->native_handle(), size - transferred,
+                    method, true);
+                if (!step.is_error())
+                {
+                    if (step.get() == 0)
+                    {
+                        break;
+                    }
+                    transferred += step.get();
+                    continue;
+                }
+                if ((step.error() ==
+                     boost::system::errc::resource_unavailable_try_again) ||
+                    (step.error() ==
+                     boost::system::errc::operation_would_block))
+                {
+                    // splice does not tell which end would have blocked
+                    ec = ((method == Si::detail::transfer_method::splice) &&
+                          !Si::detail::is_readable(file))
+                             ? wait_until_readable(file)
+                             : wait_until_writable();
+                }
+                else if ((transferred == 0) &&
+                         Si::detail::is_transfer_unsupported(step.error()))
+                {
+                    m_socket->non_blocking(was_non_blocking, ec);
+                    return copy_file(file, size);
+                }
+                else
+                {
+                    ec = step.error();
+                }
+                if (ec)
+                {
+                    break;
+                }
+            }
+            boost::system::error_code ignored;
+            m_socket->non_blocking(was_non_blocking, ignored);
+            return ec;
+        }
+
+        inline boost::system::error_code socket_sink::wait_until_writable()
+        {
+            boost::system::error_code ec;
+#if BOOST_VERSION >= 106600
+            m_socket->async_wait(boost::asio::ip::tcp::socket::wait_write,
+                                 (*m_yield)[ec]);
+#else
+            m_socket->async_write_some(boost::asio::null_buffers(),
+                                       (*m_yield)[ec]);
+#endif
+            return ec;
+        }
+
+        inline boost::system::error_code
+        socket_sink::wait_until_readable(native_file_descriptor file)
+        {
+#if SILICIUM_HAS_ZERO_COPY_TRANSFER
+            // the descriptor only borrows file for the wait
+#if BOOST_VERSION >= 107000
+            boost::asio::posix::stream_descriptor descriptor(
+                m_socket->get_executor());
+#else
+            boost::asio::posix::stream_descriptor descriptor(
+                m_socket->get_io_service());
+#endif
+            boost::system::error_code ec;
+            descriptor.assign(file, ec);
+            if (ec)
+            {
+                return ec;
+            }
+            try
+            {
+#if BOOST_VERSION >= 106600
+                descriptor.async_wait(
+                    boost::asio::posix::stream_descriptor::wait_read,
+                    (*m_yield)[ec]);
+#else
+                descriptor.async_read_some(boost::asio::null_buffers(),
+                                           (*m_yield)[ec]);
+#endif
+            }
+            catch (...)
+            {
+                descriptor.release();
+                throw;
+            }
+            descriptor.release();
+            return ec;
+#else
+            // only splice can wait for the file
+            ignore_unused_variable_warning(file);
+            return wait_until_writable();
+#endif
+        }
     }
 }
 #endif
@@ -3,6 +3,7 @@
 
 #include <silicium/source/source.hpp>
 #include <algorithm>
+#include <vector>
 #include <boost/asio/ip/tcp.hpp>
 
 #define SILICIUM_HAS_ASIO_SOCKET_SOURCE                                        \
@@ -16,48 +17,111 @@ namespace Si
 {
     namespace asio
     {
+        /// Reads from a TCP socket in a coroutine. map_next receives into an
+        /// internal buffer of buffer_size bytes and maps it, so that a parser
+        /// can work on the received bytes where they are. copy_next reads
+        /// directly into the destination unless there are buffered bytes.
         template <class YieldContext>
         struct basic_socket_source
         {
             typedef char element_type;
 
             explicit basic_socket_source(boost::asio::ip::tcp::socket &socket,
-                                         YieldContext &yield);
+                                         YieldContext &yield,
+                                         std::size_t buffer_size = 4096);
             iterator_range<char const *> map_next(std::size_t size);
             char *copy_next(iterator_range<char *> destination);
+            std::size_t skip(std::size_t count);
 
         private:
             boost::asio::ip::tcp::socket *m_socket;
             YieldContext *m_yield;
+            std::vector<char> m_buffer;
+            std::size_t m_buffer_size;
+            std::size_t m_begin;
+            std::size_t m_end;
+
+            std::size_t receive(char *destination, std::size_t size);
         };
 
         template <class YieldContext>
         basic_socket_source<YieldContext>::basic_socket_source(
-            boost::asio::ip::tcp::socket &socket, YieldContext &yield)
+            boost::asio::ip::tcp::socket &socket, YieldContext &yield,
+            std::size_t buffer_size)
             : m_socket(&socket)
             , m_yield(&yield)
+            , m_buffer_size((std::max)(buffer_size, std::size_t(1)))
+            , m_begin(0)
+            , m_end(0)
         {
         }
 
         template <class YieldContext>
         iterator_range<char const *>
-            basic_socket_source<YieldContext>::map_next(std::size_t)
+        basic_socket_source<YieldContext>::map_next(std::size_t size)
         {
-            return iterator_range<char const *>();
+            if (size == 0)
+            {
+                return iterator_range<char const *>();
+            }
+            if (m_begin == m_end)
+            {
+                m_buffer.resize(m_buffer_size);
+                m_begin = 0;
+                m_end = receive(m_buffer.data(), m_buffer.size());
+            }
+            char const *const begin = m_buffer.data() + m_begin;
+            return make_iterator_range(
+                begin, begin + (std::min)(size, m_end - m_begin));
         }
 
         template <class YieldContext>
         char *basic_socket_source<YieldContext>::copy_next(
             iterator_range<char *> destination)
+        {
+            if (m_begin != m_end)
+            {
+                std::size_t const count = (std::min)(
+                    m_end - m_begin,
+                    static_cast<std::size_t>(destination.size()));
+                char *const copied =
+                    std::copy_n(m_buffer.data() + m_begin, count,
+                                destination.begin());
+                m_begin += count;
+                return copied;
+            }
+            return destination.begin() +
+                   receive(destination.begin(),
+                           static_cast<std::size_t>(destination.size()));
+        }
+
+        template <class YieldContext>
+        std::size_t basic_socket_source<YieldContext>::skip(std::size_t count)
+        {
+            std::size_t skipped = 0;
+            while (skipped < count)
+            {
+                std::size_t const available =
+                    static_cast<std::size_t>(map_next(count - skipped).size());
+                if (available == 0)
+                {
+                    break;
+                }
+                m_begin += available;
+                skipped += available;
+            }
+            return skipped;
+        }
+
+        template <class YieldContext>
+        std::size_t
+        basic_socket_source<YieldContext>::receive(char *destination,
+                                                   std::size_t size)
         {
             assert(m_socket);
             assert(m_yield);
-            size_t const read = m_socket->async_read_some(
-                boost::asio::buffer(
-                    destination.begin(),
-                    static_cast<std::size_t>(destination.size())),
-                *m_yield);
-            return destination.begin() + read;
+            return m_socket->async_read_some(
+                boost::asio::buffer(destination, size), *m_yield);
         }
 
         typedef basic_socket_source<boost::asio::yield_context> socket_source;
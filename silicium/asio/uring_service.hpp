@@ -0,0 +1,803 @@
+#ifndef SILICIUM_ASIO_URING_SERVICE_HPP
+#define SILICIUM_ASIO_URING_SERVICE_HPP
+
+#include <silicium/linux/io_uring.hpp>
+#include <silicium/source/source.hpp>
+#include <silicium/sink/sink.hpp>
+#include <silicium/sink/append_ranges.hpp>
+#include <boost/asio/io_service.hpp>
+
+#define SILICIUM_HAS_ASIO_URING_SERVICE                                        \
+    (SILICIUM_HAS_IO_URING && (BOOST_VERSION >= 107000) &&                     \
+     SILICIUM_HAS_EXCEPTIONS)
+
+#if SILICIUM_HAS_ASIO_URING_SERVICE
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <sys/eventfd.h>
+#include <climits>
+#include <memory>
+
+#if !SILICIUM_AVOID_BOOST_COROUTINE
+#include <boost/asio/spawn.hpp>
+#endif
+
+namespace Si
+{
+    namespace asio
+    {
+        /// Refers to a file in an operation of a uring_service, either by
+        /// its descriptor or by its index in the files registered with
+        /// uring_service::register_files.
+        struct uring_file
+        {
+            native_file_descriptor descriptor;
+            bool is_registered;
+        };
+
+        inline uring_file plain_file(native_file_descriptor descriptor)
+        {
+            uring_file const result = {descriptor, false};
+            return result;
+        }
+
+        inline uring_file registered_file(unsigned index)
+        {
+            uring_file const result = {
+                static_cast<native_file_descriptor>(index), true};
+            return result;
+        }
+
+        namespace detail
+        {
+            struct uring_operation
+            {
+                uring_operation *previous;
+                uring_operation *next;
+                std::vector<iovec> vectors;
+
+                uring_operation()
+                    : previous(nullptr)
+                    , next(nullptr)
+                {
+                }
+
+                virtual ~uring_operation()
+                {
+                }
+
+                virtual void complete(boost::system::error_code ec,
+                                      std::size_t transferred) = 0;
+            };
+
+            template <class Handler>
+            struct uring_completion
+            {
+                Handler handler;
+                boost::system::error_code ec;
+                std::size_t transferred;
+
+                void operator()()
+                {
+                    handler(ec, transferred);
+                }
+            };
+
+            /// Calls the handler on its associated executor, so that strands
+            /// and the executors of coroutines are respected. The executor
+            /// counts as busy while the operation is pending.
+            template <class Handler>
+            struct uring_handler_operation : uring_operation
+            {
+                typedef typename boost::asio::associated_executor<
+                    Handler, boost::asio::io_service::executor_type>::type
+                    executor_type;
+
+                uring_handler_operation(Handler handler,
+                                        boost::asio::io_service &io)
+                    : m_handler(std::move(handler))
+                    , m_work(boost::asio::get_associated_executor(
+                          m_handler, io.get_executor()))
+                {
+                }
+
+                virtual void complete(boost::system::error_code ec,
+                                      std::size_t transferred) SILICIUM_OVERRIDE
+                {
+                    // the operation is destroyed after this call, so the
+                    // handler is moved out first
+                    boost::asio::executor_work_guard<executor_type> const work(
+                        std::move(m_work));
+                    uring_completion<Handler> completion = {
+                        std::move(m_handler), ec, transferred};
+                    boost::asio::dispatch(work.get_executor(),
+                                          std::move(completion));
+                }
+
+            private:
+                Handler m_handler;
+                boost::asio::executor_work_guard<executor_type> m_work;
+            };
+
+            struct uring_request
+            {
+                boost::uint8_t opcode;
+                uring_file file;
+                boost::uint64_t offset;
+                std::vector<iovec> vectors;
+                boost::uint16_t buffer_index;
+            };
+
+            inline iovec make_iovec(void const *data, std::size_t size)
+            {
+                iovec result;
+                result.iov_base = const_cast<void *>(data);
+                result.iov_len = size;
+                return result;
+            }
+
+            /// Everything that completion handlers have to access. It is
+            /// shared with the handlers posted to the io_service, so that the
+            /// uring_service can be destroyed while some are still queued.
+            struct uring_state : std::enable_shared_from_this<uring_state>
+            {
+                boost::asio::io_service &io;
+                uring::ring ring;
+                boost::asio::posix::stream_descriptor event;
+                boost::uint64_t event_counter;
+                uring_operation *operations;
+                std::size_t in_flight;
+                bool is_flush_posted;
+                bool is_armed;
+                bool is_closed;
+
+                uring_state(boost::asio::io_service &io, uring::ring ring)
+                    : io(io)
+                    , ring(std::move(ring))
+                    , event(io)
+                    , event_counter(0)
+                    , operations(nullptr)
+                    , in_flight(0)
+                    , is_flush_posted(false)
+                    , is_armed(false)
+                    , is_closed(false)
+                {
+                }
+
+                ~uring_state()
+                {
+                    delete_operations();
+                }
+
+                void link(uring_operation &operation) BOOST_NOEXCEPT
+                {
+                    operation.next = operations;
+                    if (operations)
+                    {
+                        operations->previous = &operation;
+                    }
+                    operations = &operation;
+                    ++in_flight;
+                }
+
+                void unlink(uring_operation &operation) BOOST_NOEXCEPT
+                {
+                    if (operation.previous)
+                    {
+                        operation.previous->next = operation.next;
+                    }
+                    else
+                    {
+                        operations = operation.next;
+                    }
+                    if (operation.next)
+                    {
+                        operation.next->previous = operation.previous;
+                    }
+                    --in_flight;
+                }
+
+                void delete_operations() BOOST_NOEXCEPT
+                {
+                    while (operations)
+                    {
+                        uring_operation *const next = operations->next;
+                        delete operations;
+                        operations = next;
+                    }
+                    in_flight = 0;
+                }
+
+                /// Returns nullptr only if even submitting everything that
+                /// is queued did not free an entry.
+                io_uring_sqe *acquire_entry()
+                {
+                    io_uring_sqe *entry = ring.get_sqe();
+                    if (!entry)
+                    {
+                        submit();
+                        entry = ring.get_sqe();
+                    }
+                    return entry;
+                }
+
+                /// Passes the prepared entries to the kernel. If that fails,
+                /// the operations of the entries fail with the error instead.
+                /// Their handlers and those of operations that complete in
+                /// the meantime are called later, because this can happen
+                /// within an initiating function.
+                void submit()
+                {
+                    error_or<unsigned> const submitted = ring.submit(
+                        [this](io_uring_cqe const &completion)
+                        {
+                            complete_later(take(completion.user_data),
+                                           to_error(completion.res),
+                                           to_transferred(completion.res));
+                        });
+                    if (!submitted.is_error())
+                    {
+                        return;
+                    }
+                    boost::system::error_code const error = submitted.error();
+                    ring.discard_unsubmitted(
+                        [this, error](io_uring_sqe const &entry)
+                        {
+                            complete_later(take(entry.user_data), error, 0);
+                        });
+                }
+
+                /// Removes an operation that has been submitted from the
+                /// list of pending operations.
+                std::unique_ptr<uring_operation>
+                take(boost::uint64_t user_data) BOOST_NOEXCEPT
+                {
+                    uring_operation *const operation =
+                        reinterpret_cast<uring_operation *>(user_data);
+                    unlink(*operation);
+                    return std::unique_ptr<uring_operation>(operation);
+                }
+
+                /// Calls the handler from the io_service unless the service
+                /// is destroyed before.
+                void complete_later(std::unique_ptr<uring_operation> operation,
+                                    boost::system::error_code ec,
+                                    std::size_t transferred)
+                {
+                    std::shared_ptr<uring_operation> const deferred(
+                        std::move(operation));
+                    std::shared_ptr<uring_state> const state =
+                        shared_from_this();
+                    boost::asio::post(io, [state, deferred, ec, transferred]()
+                                      {
+                                          if (state->is_closed)
+                                          {
+                                              return;
+                                          }
+                                          deferred->complete(ec, transferred);
+                                      });
+                }
+
+                static boost::system::error_code to_error(int result)
+                {
+                    if (result < 0)
+                    {
+                        return boost::system::error_code(
+                            -result, boost::system::system_category());
+                    }
+                    return boost::system::error_code();
+                }
+
+                static std::size_t to_transferred(int result) BOOST_NOEXCEPT
+                {
+                    return (result < 0) ? 0 : static_cast<std::size_t>(result);
+                }
+
+                static void prepare(io_uring_sqe &entry,
+                                    uring_request const &request,
+                                    uring_operation &operation)
+                {
+                    entry.opcode = request.opcode;
+                    entry.fd = request.file.descriptor;
+                    if (request.file.is_registered)
+                    {
+                        entry.flags |= IOSQE_FIXED_FILE;
+                    }
+                    entry.off = request.offset;
+                    if ((request.opcode == IORING_OP_READ_FIXED) ||
+                        (request.opcode == IORING_OP_WRITE_FIXED))
+                    {
+                        entry.addr = reinterpret_cast<boost::uint64_t>(
+                            operation.vectors.front().iov_base);
+                        entry.len = static_cast<boost::uint32_t>(
+                            operation.vectors.front().iov_len);
+                        entry.buf_index = request.buffer_index;
+                    }
+                    else
+                    {
+                        entry.addr = reinterpret_cast<boost::uint64_t>(
+                            operation.vectors.data());
+                        entry.len = static_cast<boost::uint32_t>(
+                            operation.vectors.size());
+                    }
+                    entry.user_data =
+                        reinterpret_cast<boost::uint64_t>(&operation);
+                }
+
+                static void flush(std::shared_ptr<uring_state> const &state)
+                {
+                    state->is_flush_posted = false;
+                    if (state->is_closed)
+                    {
+                        return;
+                    }
+                    state->submit();
+                    arm(state);
+                }
+
+                static void arm(std::shared_ptr<uring_state> const &state)
+                {
+                    if (state->is_armed || (state->in_flight == 0))
+                    {
+                        return;
+                    }
+                    state->is_armed = true;
+                    state->event.async_read_some(
+                        boost::asio::buffer(&state->event_counter,
+                                            sizeof(state->event_counter)),
+                        [state](boost::system::error_code ec, std::size_t)
+                        {
+                            state->is_armed = false;
+                            if (state->is_closed ||
+                                (ec == boost::asio::error::operation_aborted))
+                            {
+                                return;
+                            }
+                            state->reap();
+                            arm(state);
+                        });
+                }
+
+                void reap()
+                {
+                    ring.reap([this](io_uring_cqe const &completion)
+                              {
+                                  // a handler may have destroyed the service
+                                  if (is_closed)
+                                  {
+                                      return;
+                                  }
+                                  take(completion.user_data)
+                                      ->complete(
+                                          to_error(completion.res),
+                                          to_transferred(completion.res));
+                              });
+                }
+            };
+        }
+
+        /// Performs file and socket I/O through an io_uring(7) instance
+        /// whose completions are delivered by an io_service. Operations
+        /// started during one turn of the event loop are submitted together
+        /// with a single system call, and registered files and buffers save
+        /// the kernel from looking them up for every operation.
+        ///
+        /// The async_* functions accept any asio completion token like a
+        /// yield_context or use_future with the signature
+        /// void(error_code, std::size_t). Buffers must stay valid until the
+        /// operation has completed. Destroying the service abandons the
+        /// pending operations without calling their handlers.
+        ///
+        /// A uring_service must only be used by the thread that runs its
+        /// io_service.
+        struct uring_service
+        {
+            /// Reads and writes at the current position of the file and
+            /// advances it, like read(2) and write(2). This is the only
+            /// offset that makes sense for pipes and sockets.
+            static boost::uint64_t const current_position =
+                ~static_cast<boost::uint64_t>(0);
+
+            /// Creating the ring fails on kernels older than 5.1 or where
+            /// io_uring has been disabled.
+            static error_or<std::unique_ptr<uring_service>>
+            create(boost::asio::io_service &io, unsigned entries = 256)
+            {
+                error_or<uring::ring> ring = uring::ring::create(entries);
+                if (ring.is_error())
+                {
+                    return ring.error();
+                }
+                file_handle event(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+                if (event.handle == no_file_handle)
+                {
+                    return get_last_error();
+                }
+                boost::system::error_code const registered =
+                    ring.get().register_eventfd(event.handle);
+                if (registered)
+                {
+                    return registered;
+                }
+                std::unique_ptr<uring_service> result(
+                    new uring_service(io, ring.move_value()));
+                result->m_state->event.assign(event.release());
+                return result;
+            }
+
+            ~uring_service()
+            {
+                m_state->is_closed = true;
+                boost::system::error_code ignored;
+                m_state->event.close(ignored);
+                m_state->delete_operations();
+            }
+
+            boost::asio::io_service &get_io_service() const BOOST_NOEXCEPT
+            {
+                return m_state->io;
+            }
+
+            /// The number of operations whose handlers have not been called
+            /// yet.
+            std::size_t pending() const BOOST_NOEXCEPT
+            {
+                return m_state->in_flight;
+            }
+
+            /// The buffers can be used with async_read_fixed and
+            /// async_write_fixed afterwards. Buffers can only be registered
+            /// once per service.
+            boost::system::error_code register_buffers(
+                iterator_range<mutable_memory_range const *> buffers)
+            {
+                return m_state->ring.register_buffers(buffers);
+            }
+
+            /// The files can be referred to with registered_file(index)
+            /// afterwards, where index is the position in files.
+            boost::system::error_code
+            register_files(iterator_range<native_file_descriptor const *> files)
+            {
+                return m_state->ring.register_files(files);
+            }
+
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            async_read(uring_file file, mutable_memory_range destination,
+                       boost::uint64_t offset, CompletionToken &&token)
+            {
+                detail::uring_request request = {
+                    IORING_OP_READV, file, offset,
+                    std::vector<iovec>(
+                        1, detail::make_iovec(destination.begin(),
+                                              static_cast<std::size_t>(
+                                                  destination.size()))),
+                    0};
+                return start(std::move(request),
+                             std::forward<CompletionToken>(token));
+            }
+
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            async_write(uring_file file, memory_range data,
+                        boost::uint64_t offset, CompletionToken &&token)
+            {
+                detail::uring_request request = {
+                    IORING_OP_WRITEV, file, offset,
+                    std::vector<iovec>(
+                        1, detail::make_iovec(
+                               data.begin(),
+                               static_cast<std::size_t>(data.size()))),
+                    0};
+                return start(std::move(request),
+                             std::forward<CompletionToken>(token));
+            }
+
+            /// Writes all ranges with a single gathering write.
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            async_writev(uring_file file,
+                         iterator_range<memory_range const *> ranges,
+                         boost::uint64_t offset, CompletionToken &&token)
+            {
+                detail::uring_request request = {
+                    IORING_OP_WRITEV, file, offset, std::vector<iovec>(), 0};
+                request.vectors.reserve(
+                    static_cast<std::size_t>(ranges.size()));
+                for (memory_range const &range : ranges)
+                {
+                    request.vectors.emplace_back(detail::make_iovec(
+                        range.begin(), static_cast<std::size_t>(range.size())));
+                }
+                return start(std::move(request),
+                             std::forward<CompletionToken>(token));
+            }
+
+            /// destination has to lie within the registered buffer with the
+            /// index buffer_index.
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            async_read_fixed(uring_file file, mutable_memory_range destination,
+                             unsigned buffer_index, boost::uint64_t offset,
+                             CompletionToken &&token)
+            {
+                detail::uring_request request = {
+                    IORING_OP_READ_FIXED, file, offset,
+                    std::vector<iovec>(
+                        1, detail::make_iovec(destination.begin(),
+                                              static_cast<std::size_t>(
+                                                  destination.size()))),
+                    static_cast<boost::uint16_t>(buffer_index)};
+                return start(std::move(request),
+                             std::forward<CompletionToken>(token));
+            }
+
+            /// data has to lie within the registered buffer with the index
+            /// buffer_index.
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            async_write_fixed(uring_file file, memory_range data,
+                              unsigned buffer_index, boost::uint64_t offset,
+                              CompletionToken &&token)
+            {
+                detail::uring_request request = {
+                    IORING_OP_WRITE_FIXED, file, offset,
+                    std::vector<iovec>(
+                        1, detail::make_iovec(
+                               data.begin(),
+                               static_cast<std::size_t>(data.size()))),
+                    static_cast<boost::uint16_t>(buffer_index)};
+                return start(std::move(request),
+                             std::forward<CompletionToken>(token));
+            }
+
+        private:
+            std::shared_ptr<detail::uring_state> m_state;
+
+            uring_service(boost::asio::io_service &io, uring::ring ring)
+                : m_state(std::make_shared<detail::uring_state>(
+                      io, std::move(ring)))
+            {
+            }
+
+            struct initiation
+            {
+                std::shared_ptr<detail::uring_state> state;
+                detail::uring_request request;
+
+                template <class Handler>
+                void operator()(Handler &&handler)
+                {
+                    typedef typename std::decay<Handler>::type handler_type;
+                    std::unique_ptr<detail::uring_operation> operation(
+                        new detail::uring_handler_operation<handler_type>(
+                            std::forward<Handler>(handler), state->io));
+                    operation->vectors = std::move(request.vectors);
+                    io_uring_sqe *const entry = state->acquire_entry();
+                    if (!entry)
+                    {
+                        // the handler must not be called from within the
+                        // initiating function
+                        state->complete_later(
+                            std::move(operation),
+                            boost::asio::error::no_buffer_space, 0);
+                        return;
+                    }
+                    detail::uring_state::prepare(*entry, request, *operation);
+                    state->link(*operation.release());
+                    if (!state->is_flush_posted)
+                    {
+                        state->is_flush_posted = true;
+                        std::shared_ptr<detail::uring_state> const
+                            captured_state = state;
+                        boost::asio::post(
+                            state->io, [captured_state]()
+                            {
+                                detail::uring_state::flush(captured_state);
+                            });
+                    }
+                }
+            };
+
+            template <class CompletionToken>
+            BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken,
+                                          void(boost::system::error_code,
+                                               std::size_t))
+            start(detail::uring_request request, CompletionToken &&token)
+            {
+                initiation initiate = {m_state, std::move(request)};
+                return boost::asio::async_initiate<
+                    CompletionToken,
+                    void(boost::system::error_code, std::size_t)>(
+                    std::move(initiate), token);
+            }
+
+            SILICIUM_DELETED_FUNCTION(uring_service(uring_service const &))
+            SILICIUM_DELETED_FUNCTION(
+                uring_service &operator=(uring_service const &))
+        };
+
+#if !SILICIUM_AVOID_BOOST_COROUTINE
+        /// Reads from a file of a uring_service in a coroutine. Throws
+        /// boost::system::system_error when reading fails, like
+        /// socket_source.
+        struct uring_source
+        {
+            typedef char element_type;
+
+            uring_source(uring_service &service, uring_file file,
+                         boost::asio::yield_context &yield,
+                         boost::uint64_t offset =
+                             uring_service::current_position)
+                : m_service(&service)
+                , m_file(file)
+                , m_yield(&yield)
+                , m_offset(offset)
+            {
+            }
+
+            iterator_range<char const *> map_next(std::size_t)
+            {
+                return iterator_range<char const *>();
+            }
+
+            char *copy_next(iterator_range<char *> destination)
+            {
+                std::size_t const read = m_service->async_read(
+                    m_file, destination, m_offset, *m_yield);
+                if (m_offset != uring_service::current_position)
+                {
+                    m_offset += read;
+                }
+                return destination.begin() + read;
+            }
+
+        private:
+            uring_service *m_service;
+            uring_file m_file;
+            boost::asio::yield_context *m_yield;
+            boost::uint64_t m_offset;
+        };
+
+        /// Writes to a file of a uring_service in a coroutine.
+        struct uring_sink
+        {
+            typedef char element_type;
+            typedef boost::system::error_code error_type;
+
+            uring_sink(uring_service &service, uring_file file,
+                       boost::asio::yield_context &yield,
+                       boost::uint64_t offset = uring_service::current_position)
+                : m_service(&service)
+                , m_file(file)
+                , m_yield(&yield)
+                , m_offset(offset)
+            {
+            }
+
+            error_type append(iterator_range<char const *> data)
+            {
+                while (!data.empty())
+                {
+                    boost::system::error_code ec;
+                    std::size_t const written = m_service->async_write(
+                        m_file, data, m_offset, (*m_yield)[ec]);
+                    if (ec)
+                    {
+                        return ec;
+                    }
+                    if (written == 0)
+                    {
+                        return write_zero();
+                    }
+                    advance(written);
+                    data.pop_front(static_cast<std::ptrdiff_t>(written));
+                }
+                return error_type();
+            }
+
+            /// Writes up to max_vectors ranges with one gathering write unless
+            /// the kernel accepts only a part of them.
+            error_type append_ranges(
+                iterator_range<iterator_range<char const *> const *> ranges)
+            {
+                while (!ranges.empty())
+                {
+                    // writing nothing could not be told apart from a file
+                    // that does not accept anything
+                    if (ranges.front().empty())
+                    {
+                        ranges.pop_front();
+                        continue;
+                    }
+                    iterator_range<iterator_range<char const *> const *> const
+                        batch(ranges.begin(),
+                              ranges.begin() +
+                                  (std::min)(ranges.size(),
+                                             static_cast<std::ptrdiff_t>(
+                                                 max_vectors)));
+                    boost::system::error_code ec;
+                    std::size_t written = m_service->async_writev(
+                        m_file, batch, m_offset, (*m_yield)[ec]);
+                    if (ec)
+                    {
+                        return ec;
+                    }
+                    if (written == 0)
+                    {
+                        return write_zero();
+                    }
+                    advance(written);
+                    while (!ranges.empty() &&
+                           (written >=
+                            static_cast<std::size_t>(ranges.front().size())))
+                    {
+                        written -=
+                            static_cast<std::size_t>(ranges.front().size());
+                        ranges.pop_front();
+                    }
+                    if (!ranges.empty() && (written > 0))
+                    {
+                        iterator_range<char const *> rest = ranges.front();
+                        rest.pop_front(static_cast<std::ptrdiff_t>(written));
+                        ranges.pop_front();
+                        error_type const error = append(rest);
+                        if (error)
+                        {
+                            return error;
+                        }
+                    }
+                }
+                return error_type();
+            }
+
+            /// The kernel rejects a writev with more vectors than this.
+            static std::size_t const max_vectors =
+#ifdef IOV_MAX
+                IOV_MAX;
+#else
+                1024;
+#endif
+
+        private:
+            uring_service *m_service;
+            uring_file m_file;
+            boost::asio::yield_context *m_yield;
+            boost::uint64_t m_offset;
+
+            /// A write that accepts nothing would be repeated forever.
+            static error_type write_zero()
+            {
+                return boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+            }
+
+            void advance(std::size_t written)
+            {
+                if (m_offset != uring_service::current_position)
+                {
+                    m_offset += written;
+                }
+            }
+        };
+#endif
+    }
+}
+#endif
+
+#endif
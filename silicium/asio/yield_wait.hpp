@@ -0,0 +1,104 @@
+#ifndef SILICIUM_ASIO_YIELD_WAIT_HPP
+#define SILICIUM_ASIO_YIELD_WAIT_HPP
+
+#include <silicium/channel.hpp>
+#include <boost/asio/io_service.hpp>
+
+#define SILICIUM_HAS_ASIO_YIELD_WAIT                                           \
+    (!SILICIUM_AVOID_BOOST_COROUTINE && (BOOST_VERSION >= 107000) &&           \
+     SILICIUM_HAS_EXCEPTIONS)
+
+#if SILICIUM_HAS_ASIO_YIELD_WAIT
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <memory>
+
+namespace Si
+{
+    namespace asio
+    {
+        /// A wait strategy for channel ends that suspends a coroutine instead
+        /// of blocking its thread. The other end of the channel may be used
+        /// by any thread.
+        struct yield_wait
+        {
+            explicit yield_wait(boost::asio::yield_context &yield)
+                : m_yield(&yield)
+            {
+            }
+
+            template <class Predicate>
+            void operator()(channel_signal &signal, Predicate &&ready) const
+            {
+                initiation<typename std::decay<Predicate>::type> initiate = {
+                    &signal, &ready};
+                // the token is an lvalue so that the yield_context is not
+                // moved from
+                boost::asio::async_initiate<boost::asio::yield_context &,
+                                            void()>(initiate, *m_yield);
+            }
+
+        private:
+            boost::asio::yield_context *m_yield;
+
+            /// Keeps the io_service running while the coroutine waits for
+            /// another thread.
+            template <class Handler>
+            struct waiting_coroutine
+            {
+                typedef typename boost::asio::associated_executor<
+                    Handler>::type work_executor;
+
+                Handler handler;
+                boost::asio::executor_work_guard<work_executor> work;
+
+                explicit waiting_coroutine(Handler handler)
+                    : handler(std::move(handler))
+                    , work(boost::asio::get_associated_executor(this->handler))
+                {
+                }
+
+                void operator()()
+                {
+                    handler();
+                }
+            };
+
+            template <class Predicate>
+            struct initiation
+            {
+                channel_signal *signal;
+                Predicate *ready;
+
+                template <class Handler>
+                void operator()(Handler &&handler) const
+                {
+                    typedef typename std::decay<Handler>::type handler_type;
+                    typedef waiting_coroutine<handler_type> waiting;
+                    typedef typename waiting::work_executor work_executor;
+                    std::shared_ptr<waiting> const shared =
+                        std::make_shared<waiting>(
+                            std::forward<Handler>(handler));
+                    // The coroutine is resumed on its own executor. The
+                    // handler owns the coroutine, so it is moved away from
+                    // the notifying thread to be destroyed there, too.
+                    std::function<void()> const resume = [shared]()
+                    {
+                        work_executor const executor =
+                            shared->work.get_executor();
+                        boost::asio::post(executor, std::move(*shared));
+                    };
+                    if (!signal->register_wake_up(*ready, resume))
+                    {
+                        resume();
+                    }
+                }
+            };
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef SILICIUM_BUFFER_POOL_HPP
+#define SILICIUM_BUFFER_POOL_HPP
+
+#include <silicium/config.hpp>
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Si
+{
+    struct buffer_pool;
+
+    /// A block of memory that goes back to its pool when destroyed.
+    struct pooled_block
+    {
+        pooled_block() BOOST_NOEXCEPT : m_pool(nullptr),
+                                        m_data(nullptr),
+                                        m_size(0)
+        {
+        }
+
+        pooled_block(buffer_pool &pool, char *data,
+                     std::size_t size) BOOST_NOEXCEPT : m_pool(&pool),
+                                                        m_data(data),
+                                                        m_size(size)
+        {
+        }
+
+        pooled_block(pooled_block &&other) BOOST_NOEXCEPT
+            : m_pool(other.m_pool),
+              m_data(other.m_data),
+              m_size(other.m_size)
+        {
+            other.m_pool = nullptr;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+
+        pooled_block &operator=(pooled_block &&other) BOOST_NOEXCEPT
+        {
+            pooled_block moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        ~pooled_block();
+
+        void swap(pooled_block &other) BOOST_NOEXCEPT
+        {
+            std::swap(m_pool, other.m_pool);
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+        }
+
+        char *data() const BOOST_NOEXCEPT
+        {
+            return m_data;
+        }
+
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return m_size;
+        }
+
+    private:
+        buffer_pool *m_pool;
+        char *m_data;
+        std::size_t m_size;
+
+        SILICIUM_DELETED_FUNCTION(pooled_block(pooled_block const &))
+        SILICIUM_DELETED_FUNCTION(pooled_block &operator=(pooled_block const &))
+    };
+
+    /// Keeps released blocks of memory in size classes (the powers of two
+    /// between a minimum and a maximum size) so that they can be handed out
+    /// again without calling the allocator. Can be shared between threads.
+    struct buffer_pool
+    {
+        /// A minimum_size of zero is treated as one.
+        explicit buffer_pool(std::size_t minimum_size = 4096,
+                             std::size_t maximum_size = 1024 * 1024,
+                             std::size_t cached_per_class = 64)
+            : m_minimum_size((std::max)(minimum_size, std::size_t(1)))
+            , m_cached_per_class(cached_per_class)
+        {
+            for (std::size_t size = m_minimum_size;; size *= 2)
+            {
+                // release must not allocate
+                m_classes.emplace_back();
+                m_classes.back().reserve(cached_per_class);
+                // comparing with half of the maximum cannot overflow
+                if (size > (maximum_size / 2))
+                {
+                    break;
+                }
+            }
+        }
+
+        std::size_t minimum_size() const BOOST_NOEXCEPT
+        {
+            return m_minimum_size;
+        }
+
+        std::size_t maximum_size() const BOOST_NOEXCEPT
+        {
+            return m_minimum_size << (m_classes.size() - 1);
+        }
+
+        /// Returns a block of at least size bytes, rounded up to the next
+        /// size class. size is limited to maximum_size().
+        pooled_block acquire(std::size_t size)
+        {
+            std::size_t const index = class_of(size);
+            std::size_t const class_size = m_minimum_size << index;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                std::vector<std::unique_ptr<char[]>> &free = m_classes[index];
+                if (!free.empty())
+                {
+                    char *const data = free.back().release();
+                    free.pop_back();
+                    return pooled_block(*this, data, class_size);
+                }
+            }
+            return pooled_block(*this, new char[class_size], class_size);
+        }
+
+        /// The number of blocks waiting to be handed out again.
+        std::size_t cached_blocks() const
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            std::size_t count = 0;
+            for (std::vector<std::unique_ptr<char[]>> const &free : m_classes)
+            {
+                count += free.size();
+            }
+            return count;
+        }
+
+    private:
+        friend struct pooled_block;
+
+        std::size_t const m_minimum_size;
+        std::size_t const m_cached_per_class;
+        mutable std::mutex m_mutex;
+        std::vector<std::vector<std::unique_ptr<char[]>>> m_classes;
+
+        std::size_t class_of(std::size_t size) const BOOST_NOEXCEPT
+        {
+            std::size_t index = 0;
+            while (((m_minimum_size << index) < size) &&
+                   ((index + 1) < m_classes.size()))
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        void release(char *data, std::size_t size) BOOST_NOEXCEPT
+        {
+            std::unique_ptr<char[]> owned(data);
+            std::size_t const index = class_of(size);
+            assert((m_minimum_size << index) == size);
+            std::unique_lock<std::mutex> lock(m_mutex);
+            std::vector<std::unique_ptr<char[]>> &free = m_classes[index];
+            if (free.size() < m_cached_per_class)
+            {
+                free.emplace_back(std::move(owned));
+            }
+        }
+
+        SILICIUM_DELETED_FUNCTION(buffer_pool(buffer_pool const &))
+        SILICIUM_DELETED_FUNCTION(buffer_pool &operator=(buffer_pool const &))
+    };
+
+    inline pooled_block::~pooled_block()
+    {
+        if (m_pool)
+        {
+            m_pool->release(m_data, m_size);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,397 @@
+#ifndef SILICIUM_CHANNEL_HPP
+#define SILICIUM_CHANNEL_HPP
+
+#include <silicium/spsc_ring.hpp>
+#include <silicium/mpmc_queue.hpp>
+#include <silicium/source/source.hpp>
+#include <silicium/sink/sink.hpp>
+#include <boost/system/error_code.hpp>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace Si
+{
+    /// Wakes up the threads and coroutines that wait for one side of a
+    /// channel. Notifying is a single atomic load as long as nobody waits.
+    struct channel_signal
+    {
+        channel_signal()
+            : m_waiters(0)
+        {
+        }
+
+        /// Blocks the calling thread until ready() returns true. ready is
+        /// evaluated with the internal mutex locked.
+        template <class Predicate>
+        void wait(Predicate &&ready)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_condition.wait(lock, ready);
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /// Calls wake_up once after the next notification unless ready()
+        /// already returns true, in which case false is returned and
+        /// wake_up is dropped. wake_up is called by the notifying thread.
+        template <class Predicate>
+        bool register_wake_up(Predicate &&ready, std::function<void()> wake_up)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready())
+            {
+                m_waiters.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_wake_ups.emplace_back(std::move(wake_up));
+            return true;
+        }
+
+        /// Has to be called after every change that could make a waiting
+        /// predicate true.
+        void notify()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waiters.load(std::memory_order_relaxed) == 0)
+            {
+                return;
+            }
+            std::vector<std::function<void()>> wake_ups;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                wake_ups.swap(m_wake_ups);
+                m_waiters.fetch_sub(wake_ups.size(), std::memory_order_relaxed);
+            }
+            m_condition.notify_all();
+            for (std::function<void()> const &wake_up : wake_ups)
+            {
+                wake_up();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::atomic<std::size_t> m_waiters;
+        std::vector<std::function<void()>> m_wake_ups;
+
+        SILICIUM_DELETED_FUNCTION(channel_signal(channel_signal const &))
+        SILICIUM_DELETED_FUNCTION(
+            channel_signal &operator=(channel_signal const &))
+    };
+
+    /// A wait strategy that blocks the calling thread.
+    struct blocking_wait
+    {
+        template <class Predicate>
+        void operator()(channel_signal &signal, Predicate &&ready) const
+        {
+            signal.wait(std::forward<Predicate>(ready));
+        }
+    };
+
+    namespace detail
+    {
+        template <class Queue>
+        struct channel_state
+        {
+            Queue queue;
+            channel_signal readable;
+            channel_signal writable;
+            std::atomic<std::size_t> writers;
+            std::atomic<std::size_t> readers;
+
+            explicit channel_state(std::size_t capacity)
+                : queue(capacity)
+                , writers(1)
+                , readers(1)
+            {
+            }
+
+            bool is_readable() const BOOST_NOEXCEPT
+            {
+                return queue.can_pop() ||
+                       (writers.load(std::memory_order_acquire) == 0);
+            }
+
+            bool is_writable() const BOOST_NOEXCEPT
+            {
+                return queue.can_push() ||
+                       (readers.load(std::memory_order_acquire) == 0);
+            }
+        };
+    }
+
+    /// The writing end of a channel. append waits until all elements have
+    /// been queued, so a full channel slows the producer down to the speed
+    /// of the consumers. The channel is closed for the readers when the last
+    /// sink is destroyed.
+    template <class Queue, class Wait = blocking_wait>
+    struct channel_sink
+    {
+        typedef typename Queue::element_type element_type;
+        typedef boost::system::error_code error_type;
+
+        channel_sink() BOOST_NOEXCEPT
+        {
+        }
+
+        channel_sink(std::shared_ptr<detail::channel_state<Queue>> state,
+                     Wait wait)
+            : m_state(std::move(state))
+            , m_wait(std::move(wait))
+        {
+        }
+
+        channel_sink(channel_sink &&other) BOOST_NOEXCEPT
+            : m_state(std::move(other.m_state)),
+              m_wait(std::move(other.m_wait))
+        {
+        }
+
+        channel_sink &operator=(channel_sink &&other) BOOST_NOEXCEPT
+        {
+            close();
+            m_state = std::move(other.m_state);
+            m_wait = std::move(other.m_wait);
+            return *this;
+        }
+
+        ~channel_sink()
+        {
+            close();
+        }
+
+        /// Returns another writer of the same channel. Only available for
+        /// queues that support multiple producers.
+        template <class OtherWait>
+        channel_sink<Queue, OtherWait> clone(OtherWait wait) const
+        {
+            BOOST_STATIC_ASSERT(Queue::is_multi_producer);
+            assert(m_state);
+            m_state->writers.fetch_add(1, std::memory_order_relaxed);
+            return channel_sink<Queue, OtherWait>(m_state, std::move(wait));
+        }
+
+        /// Fails with broken_pipe when there are no readers anymore.
+        error_type append(iterator_range<element_type const *> elements)
+        {
+            assert(m_state);
+            detail::channel_state<Queue> &state = *m_state;
+            for (;;)
+            {
+                if (state.readers.load(std::memory_order_acquire) == 0)
+                {
+                    return boost::system::errc::make_error_code(
+                        boost::system::errc::broken_pipe);
+                }
+                std::size_t const pushed = state.queue.push(elements);
+                if (pushed > 0)
+                {
+                    state.readable.notify();
+                    elements.pop_front(static_cast<std::ptrdiff_t>(pushed));
+                }
+                if (elements.empty())
+                {
+                    return error_type();
+                }
+                m_wait(state.writable, [&state]()
+                       {
+                           return state.is_writable();
+                       });
+            }
+        }
+
+        /// Turns this end into one that waits with another strategy.
+        template <class OtherWait>
+        channel_sink<Queue, OtherWait> with_wait(OtherWait wait)
+        {
+            return channel_sink<Queue, OtherWait>(std::move(m_state),
+                                                  std::move(wait));
+        }
+
+        /// Closes this end early.
+        void close()
+        {
+            if (!m_state)
+            {
+                return;
+            }
+            if (m_state->writers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_state->readable.notify();
+            }
+            m_state.reset();
+        }
+
+    private:
+        std::shared_ptr<detail::channel_state<Queue>> m_state;
+        Wait m_wait;
+
+        SILICIUM_DELETED_FUNCTION(channel_sink(channel_sink const &))
+        SILICIUM_DELETED_FUNCTION(channel_sink &operator=(channel_sink const &))
+    };
+
+    /// The reading end of a channel. copy_next waits until at least one
+    /// element is available, and returns destination.begin() only after all
+    /// writers are gone and everything has been read.
+    template <class Queue, class Wait = blocking_wait>
+    struct channel_source
+    {
+        typedef typename Queue::element_type element_type;
+
+        channel_source() BOOST_NOEXCEPT
+        {
+        }
+
+        channel_source(std::shared_ptr<detail::channel_state<Queue>> state,
+                       Wait wait)
+            : m_state(std::move(state))
+            , m_wait(std::move(wait))
+        {
+        }
+
+        channel_source(channel_source &&other) BOOST_NOEXCEPT
+            : m_state(std::move(other.m_state)),
+              m_wait(std::move(other.m_wait))
+        {
+        }
+
+        channel_source &operator=(channel_source &&other) BOOST_NOEXCEPT
+        {
+            close();
+            m_state = std::move(other.m_state);
+            m_wait = std::move(other.m_wait);
+            return *this;
+        }
+
+        ~channel_source()
+        {
+            close();
+        }
+
+        /// Returns another reader of the same channel. Only available for
+        /// queues that support multiple consumers.
+        template <class OtherWait>
+        channel_source<Queue, OtherWait> clone(OtherWait wait) const
+        {
+            BOOST_STATIC_ASSERT(Queue::is_multi_consumer);
+            assert(m_state);
+            m_state->readers.fetch_add(1, std::memory_order_relaxed);
+            return channel_source<Queue, OtherWait>(m_state, std::move(wait));
+        }
+
+        iterator_range<element_type const *> map_next(std::size_t)
+        {
+            return iterator_range<element_type const *>();
+        }
+
+        element_type *copy_next(iterator_range<element_type *> destination)
+        {
+            assert(m_state);
+            if (destination.empty())
+            {
+                return destination.begin();
+            }
+            detail::channel_state<Queue> &state = *m_state;
+            for (;;)
+            {
+                element_type *const end = state.queue.pop(destination);
+                if (end != destination.begin())
+                {
+                    state.writable.notify();
+                    return end;
+                }
+                if (state.writers.load(std::memory_order_acquire) == 0)
+                {
+                    // a writer may have pushed right before it went away
+                    element_type *const rest = state.queue.pop(destination);
+                    if (rest != destination.begin())
+                    {
+                        state.writable.notify();
+                    }
+                    return rest;
+                }
+                m_wait(state.readable, [&state]()
+                       {
+                           return state.is_readable();
+                       });
+            }
+        }
+
+        /// Turns this end into one that waits with another strategy.
+        template <class OtherWait>
+        channel_source<Queue, OtherWait> with_wait(OtherWait wait)
+        {
+            return channel_source<Queue, OtherWait>(std::move(m_state),
+                                                    std::move(wait));
+        }
+
+        /// Closes this end early.
+        void close()
+        {
+            if (!m_state)
+            {
+                return;
+            }
+            if (m_state->readers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_state->writable.notify();
+            }
+            m_state.reset();
+        }
+
+    private:
+        std::shared_ptr<detail::channel_state<Queue>> m_state;
+        Wait m_wait;
+
+        SILICIUM_DELETED_FUNCTION(channel_source(channel_source const &))
+        SILICIUM_DELETED_FUNCTION(
+            channel_source &operator=(channel_source const &))
+    };
+
+    template <class Queue, class Wait = blocking_wait>
+    struct channel
+    {
+        channel_sink<Queue, Wait> writer;
+        channel_source<Queue, Wait> reader;
+    };
+
+    /// Creates a channel with room for at least capacity elements. Both ends
+    /// use the same wait strategy at first. with_wait and clone create ends
+    /// with a different one, for example for a coroutine that reads what
+    /// threads write.
+    template <class Queue, class Wait = blocking_wait>
+    channel<Queue, Wait> make_channel(std::size_t capacity, Wait wait = Wait())
+    {
+        std::shared_ptr<detail::channel_state<Queue>> const state =
+            std::make_shared<detail::channel_state<Queue>>(capacity);
+        channel<Queue, Wait> result = {
+            channel_sink<Queue, Wait>(state, wait),
+            channel_source<Queue, Wait>(state, wait)};
+        return result;
+    }
+
+    /// A channel between exactly one writing and one reading thread.
+    template <class Element, class Wait = blocking_wait>
+    channel<spsc_ring<Element>, Wait> make_spsc_channel(std::size_t capacity,
+                                                        Wait wait = Wait())
+    {
+        return make_channel<spsc_ring<Element>>(capacity, std::move(wait));
+    }
+
+    /// A channel for any number of writers and readers. Use clone to create
+    /// more of them.
+    template <class Element, class Wait = blocking_wait>
+    channel<mpmc_queue<Element>, Wait> make_mpmc_channel(std::size_t capacity,
+                                                         Wait wait = Wait())
+    {
+        return make_channel<mpmc_queue<Element>>(capacity, std::move(wait));
+    }
+}
+
+#endif
@@ -0,0 +1,435 @@
+#ifndef SILICIUM_COMPRESSION_CODEC_HPP
+#define SILICIUM_COMPRESSION_CODEC_HPP
+
+#include <silicium/trait.hpp>
+#include <silicium/error_or.hpp>
+#include <silicium/memory_range.hpp>
+#include <silicium/success.hpp>
+#include <silicium/variant.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+#include <vector>
+
+#define SILICIUM_HAS_COMPRESSION_CODEC SILICIUM_HAS_VARIANT
+
+namespace Si
+{
+    namespace detail
+    {
+        /// Converts the error of the next sink into the error_type of the
+        /// compressing sinks.
+        inline boost::system::error_code
+        to_error_code(boost::system::error_code error) BOOST_NOEXCEPT
+        {
+            return error;
+        }
+
+        inline boost::system::error_code to_error_code(success) BOOST_NOEXCEPT
+        {
+            return boost::system::error_code();
+        }
+    }
+}
+
+#if SILICIUM_HAS_COMPRESSION_CODEC
+namespace Si
+{
+    /// Makes everything appended so far available to the reader. The
+    /// compression state is kept.
+    struct flush
+    {
+    };
+
+    /// Like flush, but also resets the compression state, so that a reader
+    /// can start decompressing here. Costs compression ratio.
+    struct full_flush
+    {
+    };
+
+    /// Ends the compressed stream. Nothing can be appended after this.
+    struct finish
+    {
+    };
+
+    typedef variant<flush, memory_range, full_flush, finish>
+        compression_sink_element;
+
+    /// What a compressor does with the data it has buffered.
+    enum class codec_flush
+    {
+        none,
+        sync,
+        full,
+        finish
+    };
+
+    struct codec_progress
+    {
+        std::size_t consumed;
+        std::size_t produced;
+
+        /// Whether the end of a compressed stream has been reached.
+        bool is_end;
+    };
+
+    /// One direction of a streaming compression format. process reads from
+    /// input and writes into output until one of them is used up. If it
+    /// returns with space left in output, it has consumed all of the input
+    /// and done what flush asks for. Decompressors ignore flush and
+    /// continue with the next stream when input goes on after the end of
+    /// one.
+    SILICIUM_TRAIT(
+        Codec,
+        ((process, (3, (memory_range, mutable_memory_range, codec_flush)),
+          error_or<codec_progress>)))
+
+    namespace detail
+    {
+        /// Runs codec over input and writes its output into the append
+        /// space of next, at most max_output bytes at a time.
+        template <class Codec, class Next>
+        boost::system::error_code
+        run_codec(Codec &codec, Next &next, memory_range input,
+                  codec_flush flush, std::size_t max_output,
+                  boost::uint64_t &consumed, boost::uint64_t &produced,
+                  bool &is_end)
+        {
+            char const *next_in = input.begin();
+            for (;;)
+            {
+                iterator_range<char *> space =
+                    next.make_append_space(max_output);
+                if (space.empty())
+                {
+                    boost::system::error_code const error =
+                        to_error_code(next.flush_append_space());
+                    if (error)
+                    {
+                        return error;
+                    }
+                    space = next.make_append_space(max_output);
+                    if (space.empty())
+                    {
+                        return boost::system::errc::make_error_code(
+                            boost::system::errc::no_buffer_space);
+                    }
+                }
+                error_or<codec_progress> const result = codec.process(
+                    make_iterator_range(next_in, input.end()), space, flush);
+                if (result.is_error())
+                {
+                    next.make_append_space(0);
+                    return result.error();
+                }
+                codec_progress const &progress = result.get();
+                next_in += progress.consumed;
+                consumed += progress.consumed;
+                produced += progress.produced;
+                is_end = progress.is_end;
+                next.make_append_space(progress.produced);
+                if (progress.produced > 0)
+                {
+                    boost::system::error_code const error =
+                        to_error_code(next.flush_append_space());
+                    if (error)
+                    {
+                        return error;
+                    }
+                }
+                if ((next_in == input.end()) &&
+                    (progress.is_end ||
+                     (progress.produced <
+                      static_cast<std::size_t>(space.size()))))
+                {
+                    return {};
+                }
+            }
+        }
+    }
+
+    /// Compresses what is appended to it with Codec, which can be a
+    /// concrete compressor or a Codec::box chosen at runtime. Small ranges
+    /// are collected in a staging buffer of staging_size bytes before they
+    /// are passed to the codec.
+    template <class Next, class Codec>
+    struct compressing_sink
+    {
+        typedef compression_sink_element element_type;
+        typedef boost::system::error_code error_type;
+
+        compressing_sink()
+            : m_staging_size(0)
+            , m_max_output(0)
+            , m_uncompressed(0)
+            , m_compressed(0)
+            , m_is_end(false)
+        {
+        }
+
+        compressing_sink(Next next, Codec codec,
+                         std::size_t staging_size = 16 * 1024,
+                         std::size_t max_output = 64 * 1024)
+            : m_next(std::move(next))
+            , m_codec(std::move(codec))
+            , m_staging_size(staging_size)
+            , m_max_output(max_output)
+            , m_uncompressed(0)
+            , m_compressed(0)
+            , m_is_end(false)
+        {
+            assert(m_max_output > 0);
+            m_staging.reserve(m_staging_size);
+        }
+
+#if SILICIUM_COMPILER_GENERATES_MOVES
+        compressing_sink(compressing_sink &&) = default;
+        compressing_sink &operator=(compressing_sink &&) = default;
+#else
+        compressing_sink(compressing_sink &&other)
+            : m_next(std::move(other.m_next))
+            , m_codec(std::move(other.m_codec))
+            , m_staging(std::move(other.m_staging))
+            , m_staging_size(other.m_staging_size)
+            , m_max_output(other.m_max_output)
+            , m_uncompressed(other.m_uncompressed)
+            , m_compressed(other.m_compressed)
+            , m_is_end(other.m_is_end)
+        {
+        }
+
+        compressing_sink &operator=(compressing_sink &&other)
+        {
+            m_next = std::move(other.m_next);
+            m_codec = std::move(other.m_codec);
+            m_staging = std::move(other.m_staging);
+            m_staging_size = other.m_staging_size;
+            m_max_output = other.m_max_output;
+            m_uncompressed = other.m_uncompressed;
+            m_compressed = other.m_compressed;
+            m_is_end = other.m_is_end;
+            return *this;
+        }
+#endif
+
+        error_type append(iterator_range<element_type const *> data)
+        {
+            for (element_type const &piece : data)
+            {
+                error_type const error = visit<error_type>(
+                    piece,
+                    [this](flush)
+                    {
+                        return this->flush_staged(codec_flush::sync);
+                    },
+                    [this](memory_range content)
+                    {
+                        return this->stage(content);
+                    },
+                    [this](full_flush)
+                    {
+                        return this->flush_staged(codec_flush::full);
+                    },
+                    [this](finish)
+                    {
+                        return this->flush_staged(codec_flush::finish);
+                    });
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return {};
+        }
+
+        /// The number of bytes appended so far, including the staged ones.
+        boost::uint64_t uncompressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_uncompressed + m_staging.size();
+        }
+
+        /// The number of bytes written into Next so far.
+        boost::uint64_t compressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_compressed;
+        }
+
+        Codec &codec()
+        {
+            return m_codec;
+        }
+
+    private:
+        Next m_next;
+        Codec m_codec;
+        std::vector<char> m_staging;
+        std::size_t m_staging_size;
+        std::size_t m_max_output;
+        boost::uint64_t m_uncompressed;
+        boost::uint64_t m_compressed;
+        bool m_is_end;
+
+        error_type stage(memory_range content)
+        {
+            assert(!m_is_end);
+            std::size_t const size = static_cast<std::size_t>(content.size());
+            if ((m_staging.size() + size) <= m_staging_size)
+            {
+                m_staging.insert(m_staging.end(), content.begin(),
+                                 content.end());
+                return {};
+            }
+            error_type const error = flush_staged(codec_flush::none);
+            if (error)
+            {
+                return error;
+            }
+            if (size <= m_staging_size)
+            {
+                m_staging.assign(content.begin(), content.end());
+                return {};
+            }
+            return run(content, codec_flush::none);
+        }
+
+        error_type flush_staged(codec_flush flush)
+        {
+            assert(!m_is_end);
+            if (m_staging.empty() && (flush == codec_flush::none))
+            {
+                return {};
+            }
+            error_type const error =
+                run(make_iterator_range(m_staging.data(),
+                                        m_staging.data() + m_staging.size()),
+                    flush);
+            m_staging.clear();
+            return error;
+        }
+
+        error_type run(memory_range input, codec_flush flush)
+        {
+            return detail::run_codec(m_codec, m_next, input, flush,
+                                     m_max_output, m_uncompressed,
+                                     m_compressed, m_is_end);
+        }
+    };
+
+    /// Decompresses what is appended to it with Codec and writes the result
+    /// into the append space of Next, at most max_output bytes at a time.
+    template <class Next, class Codec>
+    struct decompressing_sink
+    {
+        typedef char element_type;
+        typedef boost::system::error_code error_type;
+
+        decompressing_sink()
+            : m_max_output(0)
+            , m_compressed(0)
+            , m_uncompressed(0)
+            , m_is_end(false)
+        {
+        }
+
+        decompressing_sink(Next next, Codec codec,
+                           std::size_t max_output = 64 * 1024)
+            : m_next(std::move(next))
+            , m_codec(std::move(codec))
+            , m_max_output(max_output)
+            , m_compressed(0)
+            , m_uncompressed(0)
+            , m_is_end(false)
+        {
+            assert(m_max_output > 0);
+        }
+
+#if SILICIUM_COMPILER_GENERATES_MOVES
+        decompressing_sink(decompressing_sink &&) = default;
+        decompressing_sink &operator=(decompressing_sink &&) = default;
+#else
+        decompressing_sink(decompressing_sink &&other)
+            : m_next(std::move(other.m_next))
+            , m_codec(std::move(other.m_codec))
+            , m_max_output(other.m_max_output)
+            , m_compressed(other.m_compressed)
+            , m_uncompressed(other.m_uncompressed)
+            , m_is_end(other.m_is_end)
+        {
+        }
+
+        decompressing_sink &operator=(decompressing_sink &&other)
+        {
+            m_next = std::move(other.m_next);
+            m_codec = std::move(other.m_codec);
+            m_max_output = other.m_max_output;
+            m_compressed = other.m_compressed;
+            m_uncompressed = other.m_uncompressed;
+            m_is_end = other.m_is_end;
+            return *this;
+        }
+#endif
+
+        error_type append(iterator_range<char const *> compressed)
+        {
+            return detail::run_codec(m_codec, m_next, compressed,
+                                     codec_flush::none, m_max_output,
+                                     m_compressed, m_uncompressed, m_is_end);
+        }
+
+        /// Whether the input seen so far ends with a complete stream. Data
+        /// that was cut off is detected by checking this at the end.
+        bool is_complete() const BOOST_NOEXCEPT
+        {
+            return m_is_end;
+        }
+
+        boost::uint64_t compressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_compressed;
+        }
+
+        boost::uint64_t uncompressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_uncompressed;
+        }
+
+        Next &next()
+        {
+            return m_next;
+        }
+
+    private:
+        Next m_next;
+        Codec m_codec;
+        std::size_t m_max_output;
+        boost::uint64_t m_compressed;
+        boost::uint64_t m_uncompressed;
+        bool m_is_end;
+    };
+
+    template <class Next, class Codec>
+    auto make_compressing_sink(Next &&next, Codec &&codec)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> compressing_sink<typename std::decay<Next>::type,
+                            typename std::decay<Codec>::type>
+#endif
+    {
+        return compressing_sink<typename std::decay<Next>::type,
+                                typename std::decay<Codec>::type>(
+            std::forward<Next>(next), std::forward<Codec>(codec));
+    }
+
+    template <class Next, class Codec>
+    auto make_decompressing_sink(Next &&next, Codec &&codec)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> decompressing_sink<typename std::decay<Next>::type,
+                              typename std::decay<Codec>::type>
+#endif
+    {
+        return decompressing_sink<typename std::decay<Next>::type,
+                                  typename std::decay<Codec>::type>(
+            std::forward<Next>(next), std::forward<Codec>(codec));
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef SILICIUM_COMPRESSION_SELECT_HPP
+#define SILICIUM_COMPRESSION_SELECT_HPP
+
+#include <silicium/compression/codec.hpp>
+#include <silicium/zlib/codec.hpp>
+#include <silicium/zstd/codec.hpp>
+#include <silicium/lz4/codec.hpp>
+#include <silicium/optional.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+
+#if SILICIUM_HAS_COMPRESSION_CODEC
+namespace Si
+{
+    enum class compression_format
+    {
+        /// deflate with the zlib header (RFC 1950)
+        zlib,
+
+        /// deflate with the gzip header (RFC 1952)
+        gzip,
+
+        /// deflate without any header (RFC 1951)
+        raw_deflate,
+
+        zstd,
+
+        /// the LZ4 frame format
+        lz4
+    };
+
+    /// Whether this build of Silicium can handle format.
+    inline bool is_available(compression_format format) BOOST_NOEXCEPT
+    {
+        switch (format)
+        {
+        case compression_format::zlib:
+        case compression_format::gzip:
+        case compression_format::raw_deflate:
+            return SILICIUM_HAS_ZLIB_CODEC;
+
+        case compression_format::zstd:
+            return SILICIUM_HAS_ZSTD_CODEC;
+
+        case compression_format::lz4:
+            return SILICIUM_HAS_LZ4_CODEC;
+        }
+        return false;
+    }
+
+    inline char const *to_string(compression_format format) BOOST_NOEXCEPT
+    {
+        switch (format)
+        {
+        case compression_format::zlib:
+            return "zlib";
+
+        case compression_format::gzip:
+            return "gzip";
+
+        case compression_format::raw_deflate:
+            return "raw deflate";
+
+        case compression_format::zstd:
+            return "zstd";
+
+        case compression_format::lz4:
+            return "lz4";
+        }
+        return "";
+    }
+
+    struct compression_settings
+    {
+        compression_format format;
+
+        /// The default level of the format if none.
+        optional<int> level;
+
+        /// Compression threads of zstd. The other formats ignore this.
+        unsigned threads;
+
+        /// A dictionary for zstd that the reader has to know as well. The
+        /// other formats ignore this. zstd copies it, so it only has to
+        /// stay valid until make_compressor returns.
+        memory_range dictionary;
+
+        compression_settings()
+            : format(compression_format::gzip)
+            , threads(0)
+        {
+        }
+
+        explicit compression_settings(compression_format format)
+            : format(format)
+            , threads(0)
+        {
+        }
+    };
+
+    namespace detail
+    {
+        SILICIUM_NORETURN inline void
+        throw_unavailable(compression_format format)
+        {
+            boost::throw_exception(std::invalid_argument(
+                std::string("This build does not support compression format ") +
+                to_string(format)));
+        }
+
+#if SILICIUM_HAS_ZLIB_CODEC
+        inline zlib_format to_zlib_format(compression_format format)
+        {
+            switch (format)
+            {
+            case compression_format::zlib:
+                return zlib_format::zlib;
+
+            case compression_format::gzip:
+                return zlib_format::gzip;
+
+            case compression_format::raw_deflate:
+                return zlib_format::raw;
+
+            case compression_format::zstd:
+            case compression_format::lz4:
+                break;
+            }
+            SILICIUM_UNREACHABLE();
+        }
+#endif
+    }
+
+    /// Creates a compressor chosen at runtime, for example per connection
+    /// after content negotiation. Throws std::invalid_argument if the
+    /// format is not available in this build.
+    inline Codec::box make_compressor(compression_settings const &settings)
+    {
+        switch (settings.format)
+        {
+        case compression_format::zlib:
+        case compression_format::gzip:
+        case compression_format::raw_deflate:
+#if SILICIUM_HAS_ZLIB_CODEC
+            return Codec::make_box(zlib_compressor(
+                settings.level ? *settings.level : Z_DEFAULT_COMPRESSION,
+                detail::to_zlib_format(settings.format)));
+#else
+            break;
+#endif
+
+        case compression_format::zstd:
+#if SILICIUM_HAS_ZSTD_CODEC
+            return Codec::make_box(zstd_compressor(
+                settings.level ? *settings.level : ZSTD_CLEVEL_DEFAULT,
+                settings.threads, settings.dictionary));
+#else
+            break;
+#endif
+
+        case compression_format::lz4:
+#if SILICIUM_HAS_LZ4_CODEC
+            return Codec::make_box(
+                lz4_compressor(settings.level ? *settings.level : 0));
+#else
+            break;
+#endif
+        }
+        detail::throw_unavailable(settings.format);
+    }
+
+    /// Creates the decompressor that matches make_compressor. The gzip and
+    /// zlib formats are detected from the header, so either one works for
+    /// both.
+    inline Codec::box
+    make_decompressor(compression_format format,
+                      memory_range dictionary = memory_range())
+    {
+        switch (format)
+        {
+        case compression_format::zlib:
+        case compression_format::gzip:
+#if SILICIUM_HAS_ZLIB_CODEC
+            return Codec::make_box(zlib_decompressor(zlib_format::automatic));
+#else
+            break;
+#endif
+
+        case compression_format::raw_deflate:
+#if SILICIUM_HAS_ZLIB_CODEC
+            return Codec::make_box(zlib_decompressor(zlib_format::raw));
+#else
+            break;
+#endif
+
+        case compression_format::zstd:
+#if SILICIUM_HAS_ZSTD_CODEC
+            return Codec::make_box(zstd_decompressor(dictionary));
+#else
+            break;
+#endif
+
+        case compression_format::lz4:
+#if SILICIUM_HAS_LZ4_CODEC
+            return Codec::make_box(lz4_decompressor::initialize());
+#else
+            break;
+#endif
+        }
+        ignore_unused_variable_warning(dictionary);
+        detail::throw_unavailable(format);
+    }
+}
+#endif
+
+#endif
@@ -74,6 +74,14 @@
 #define SILICIUM_AVOID_ZLIB 0
 #endif
 
+#ifndef SILICIUM_AVOID_ZSTD
+#define SILICIUM_AVOID_ZSTD 0
+#endif
+
+#ifndef SILICIUM_AVOID_LZ4
+#define SILICIUM_AVOID_LZ4 0
+#endif
+
 #ifndef SILICIUM_AVOID_URIPARSER
 #define SILICIUM_AVOID_URIPARSER 0
 #endif
@@ -205,6 +213,7 @@ private:                                                                       \
 #endif
 
 #define SILICIUM_OVERRIDE override
+#define SILICIUM_FINAL final
 
 #ifdef _MSC_VER
 #define SILICIUM_USE_RESULT _Check_return_
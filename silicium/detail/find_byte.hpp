@@ -0,0 +1,108 @@
+#ifndef SILICIUM_DETAIL_FIND_BYTE_HPP
+#define SILICIUM_DETAIL_FIND_BYTE_HPP
+
+#include <silicium/config.hpp>
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SILICIUM_DETAIL_FIND_BYTE_AVX2 1
+#else
+#define SILICIUM_DETAIL_FIND_BYTE_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SILICIUM_DETAIL_FIND_BYTE_SSE2 1
+#else
+#define SILICIUM_DETAIL_FIND_BYTE_SSE2 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Si
+{
+    namespace detail
+    {
+        inline unsigned count_trailing_zeros(boost::uint32_t mask)
+            BOOST_NOEXCEPT
+        {
+            assert(mask != 0);
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        /// Returns a pointer to the first byte in [begin, end) that equals
+        /// first or second, or end if there is none. Scans 32 or 16 bytes at
+        /// once when AVX2 or SSE2 are enabled at compile time.
+        inline char const *find_either_byte(char const *begin,
+                                            char const *end, char first,
+                                            char second) BOOST_NOEXCEPT
+        {
+#if SILICIUM_DETAIL_FIND_BYTE_AVX2
+            {
+                __m256i const first_wide = _mm256_set1_epi8(first);
+                __m256i const second_wide = _mm256_set1_epi8(second);
+                while ((end - begin) >= 32)
+                {
+                    __m256i const chunk = _mm256_loadu_si256(
+                        reinterpret_cast<__m256i const *>(begin));
+                    boost::uint32_t const mask =
+                        static_cast<boost::uint32_t>(_mm256_movemask_epi8(
+                            _mm256_or_si256(
+                                _mm256_cmpeq_epi8(chunk, first_wide),
+                                _mm256_cmpeq_epi8(chunk, second_wide))));
+                    if (mask != 0)
+                    {
+                        return begin + count_trailing_zeros(mask);
+                    }
+                    begin += 32;
+                }
+            }
+#endif
+#if SILICIUM_DETAIL_FIND_BYTE_SSE2
+            {
+                __m128i const first_wide = _mm_set1_epi8(first);
+                __m128i const second_wide = _mm_set1_epi8(second);
+                while ((end - begin) >= 16)
+                {
+                    __m128i const chunk = _mm_loadu_si128(
+                        reinterpret_cast<__m128i const *>(begin));
+                    boost::uint32_t const mask =
+                        static_cast<boost::uint32_t>(_mm_movemask_epi8(
+                            _mm_or_si128(_mm_cmpeq_epi8(chunk, first_wide),
+                                         _mm_cmpeq_epi8(chunk, second_wide))));
+                    if (mask != 0)
+                    {
+                        return begin + count_trailing_zeros(mask);
+                    }
+                    begin += 16;
+                }
+            }
+#endif
+            for (; begin != end; ++begin)
+            {
+                if ((*begin == first) || (*begin == second))
+                {
+                    break;
+                }
+            }
+            return begin;
+        }
+
+        inline char const *find_byte(char const *begin, char const *end,
+                                     char searched) BOOST_NOEXCEPT
+        {
+            return find_either_byte(begin, end, searched, searched);
+        }
+    }
+}
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef SILICIUM_DETAIL_LINE_SOURCE_HPP
 #define SILICIUM_DETAIL_LINE_SOURCE_HPP
 
-#include <silicium/source/source.hpp>
+#include <silicium/source/line_view_source.hpp>
 #include <silicium/noexcept_string.hpp>
 #include <boost/range/algorithm/find.hpp>
 
@@ -9,65 +9,82 @@ namespace Si
 {
     namespace detail
     {
+        /// Splits a source of characters into lines that end with LF or
+        /// CR LF like line_view_source, but copies every line into a vector.
         template <class Next>
         struct line_source : Source<std::vector<char>>::interface
         {
             line_source()
-                : m_next(nullptr)
+                : m_has_peeked(false)
             {
             }
 
             explicit line_source(Next &next)
-                : m_next(&next)
+                : m_lines(next)
+                , m_has_peeked(false)
             {
             }
 
+            /// Reads the next line into an internal buffer and maps it.
             virtual iterator_range<std::vector<char> const *>
-                map_next(std::size_t) SILICIUM_OVERRIDE
+                map_next(std::size_t size) SILICIUM_OVERRIDE
             {
-                return iterator_range<std::vector<char> const *>();
+                if ((size == 0) || (!m_has_peeked && !read_line(m_peeked)))
+                {
+                    return iterator_range<std::vector<char> const *>();
+                }
+                m_has_peeked = true;
+                return make_iterator_range(&m_peeked, &m_peeked + 1);
             }
 
             virtual std::vector<char> *
             copy_next(iterator_range<std::vector<char> *> destination)
                 SILICIUM_OVERRIDE
             {
-                assert(m_next);
                 auto i = begin(destination);
+                if (m_has_peeked && (i != end(destination)))
+                {
+                    i->swap(m_peeked);
+                    m_has_peeked = false;
+                    ++i;
+                }
                 for (; i != end(destination); ++i)
                 {
-                    auto &line = *i;
-                    for (;;)
+                    if (!read_line(*i))
                     {
-                        auto c = get(*m_next);
-                        if (!c)
-                        {
-                            return &line;
-                        }
-                        if (*c == '\r')
-                        {
-                            auto lf = get(*m_next);
-                            if (!lf)
-                            {
-                                return &line;
-                            }
-                            if (*lf == '\n')
-                            {
-                                break;
-                            }
-                        }
-                        if (*c == '\n')
-                        {
-                            break;
-                        }
-                        line.emplace_back(*c);
+                        break;
                     }
                 }
                 return i;
             }
 
+            std::size_t skip(std::size_t count)
+            {
+                std::size_t skipped = 0;
+                if (m_has_peeked && (count > 0))
+                {
+                    m_has_peeked = false;
+                    ++skipped;
+                }
+                return skipped + m_lines.skip(count - skipped);
+            }
+
         private:
-            Next *m_next;
+            line_view_source<Next> m_lines;
+            std::vector<char> m_peeked;
+            bool m_has_peeked;
+
+            bool read_line(std::vector<char> &line)
+            {
+                memory_range view;
+                if (m_lines.copy_next(make_iterator_range(&view, &view + 1)) ==
+                    &view)
+                {
+                    return false;
+                }
+                line.assign(view.begin(), view.end());
+                return true;
+            }
         };
 
         template <class Next>
@@ -0,0 +1,121 @@
+#ifndef SILICIUM_DETAIL_PULL_BUFFER_HPP
+#define SILICIUM_DETAIL_PULL_BUFFER_HPP
+
+#include <silicium/iterator_range.hpp>
+#include <silicium/config.hpp>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <vector>
+
+namespace Si
+{
+    namespace detail
+    {
+        /// The number of elements that adapters like transforming_source
+        /// pull from their input at once when the caller asks for fewer.
+        std::size_t const default_pull_batch_size = 256;
+
+        /// Elements that a source adapter has pulled from its input in one
+        /// block, but not handed out yet. The elements are allocated by the
+        /// first refill, so an adapter can have a pull_buffer of elements
+        /// that are not default-constructible as long as it does not use it.
+        template <class Element>
+        struct pull_buffer
+        {
+            pull_buffer()
+                : m_batch_size(default_pull_batch_size)
+                , m_begin(0)
+                , m_end(0)
+            {
+            }
+
+            explicit pull_buffer(std::size_t batch_size)
+                : m_batch_size((std::max)(batch_size, std::size_t(1)))
+                , m_begin(0)
+                , m_end(0)
+            {
+            }
+
+            std::size_t batch_size() const BOOST_NOEXCEPT
+            {
+                return m_batch_size;
+            }
+
+            iterator_range<Element *> available() BOOST_NOEXCEPT
+            {
+                return make_iterator_range(
+                    m_elements.data() + m_begin, m_elements.data() + m_end);
+            }
+
+            void consume(std::size_t count) BOOST_NOEXCEPT
+            {
+                assert(count <= (m_end - m_begin));
+                m_begin += count;
+            }
+
+            /// Replaces the (exhausted) content with the next batch from
+            /// input. Returns false at the end of the input.
+            template <class Source>
+            bool refill(Source &input)
+            {
+                return refill_with([&input](iterator_range<Element *> batch)
+                                   {
+                                       return input.copy_next(batch);
+                                   });
+            }
+
+            /// Like refill, but the batch is written by fill, which returns
+            /// the end of what it has written.
+            template <class Fill>
+            bool refill_with(Fill &&fill)
+            {
+                assert(m_begin == m_end);
+                if (m_elements.empty())
+                {
+                    m_elements.resize(m_batch_size);
+                }
+                Element *const end = fill(make_iterator_range(
+                    m_elements.data(), m_elements.data() + m_elements.size()));
+                m_begin = 0;
+                m_end = static_cast<std::size_t>(end - m_elements.data());
+                return m_end != 0;
+            }
+
+        private:
+            std::size_t m_batch_size;
+            std::vector<Element> m_elements;
+            std::size_t m_begin;
+            std::size_t m_end;
+        };
+
+        /// Hands the elements of input to consume in contiguous blocks until
+        /// consume is satisfied or the input ends. consume returns how many
+        /// elements of the block it took and whether it wants more.
+        template <class Element, class Source, class Consumer>
+        void pull_blocks(pull_buffer<Element> &buffer, Source &input,
+                         Consumer &&consume)
+        {
+            for (;;)
+            {
+                iterator_range<Element *> available = buffer.available();
+                if (available.empty())
+                {
+                    if (!buffer.refill(input))
+                    {
+                        return;
+                    }
+                    available = buffer.available();
+                }
+                std::pair<std::size_t, bool> const taken = consume(available);
+                buffer.consume(taken.first);
+                if (!taken.second)
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+#endif
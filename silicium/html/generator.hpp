@@ -57,15 +57,63 @@ namespace Si
             }
         }
 
-        template <class CharSink, class StringLike>
-        void write_string(CharSink &&sink, StringLike const &text)
+        namespace detail
         {
-            for (auto c : make_range_from_string_like(text))
+            template <class CharSink, class StringLike>
+            void write_escaped(CharSink &sink, StringLike const &text)
+            {
+                for (auto c : make_range_from_string_like(text))
+                {
+                    write_char(sink, c);
+                }
+            }
+
+            /// Appends the characters between the ones that have to be
+            /// escaped as whole ranges.
+            template <class CharSink>
+            void write_escaped(CharSink &sink, memory_range text)
+            {
+                using Si::append;
+                char const *unescaped = text.begin();
+                for (char const *i = text.begin(); i != text.end(); ++i)
+                {
+                    switch (*i)
+                    {
+                    case '&':
+                    case '<':
+                    case '>':
+                    case '\'':
+                    case '"':
+                        if (unescaped != i)
+                        {
+                            append(sink, make_iterator_range(unescaped, i));
+                        }
+                        write_char(sink, *i);
+                        unescaped = i + 1;
+                        break;
+                    }
+                }
+                if (unescaped != text.end())
+                {
+                    append(sink, make_iterator_range(unescaped, text.end()));
+                }
+            }
+
+            template <class CharSink>
+            void write_escaped(CharSink &sink, std::string const &text)
             {
-                write_char(sink, c);
+                write_escaped(sink, make_memory_range(text.data(),
+                                                      text.data() +
+                                                          text.size()));
             }
         }
 
+        template <class CharSink, class StringLike>
+        void write_string(CharSink &&sink, StringLike const &text)
+        {
+            detail::write_escaped(sink, text);
+        }
+
         template <class CharSink, class StringLike>
         void open_attributed_element(CharSink &&sink, StringLike const &name)
         {
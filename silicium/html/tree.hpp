@@ -3,6 +3,7 @@
 
 #include <silicium/html/generator.hpp>
 #include <silicium/sink/iterator_sink.hpp>
+#include <silicium/sink/ptr_sink.hpp>
 #include <silicium/trait.hpp>
 #include <silicium/identity.hpp>
 
@@ -62,6 +63,7 @@ namespace Si
             struct element
             {
                 typedef Length length_type;
+                typedef ContentGenerator generator_type;
                 ContentGenerator generate;
 
 #if SILICIUM_VC2013
@@ -84,6 +86,147 @@ namespace Si
                                Length>{
                     std::forward<ContentGenerator>(generate)};
             }
+
+            template <class Generator, class CharSink>
+            auto invoke_generator(Generator const &generate,
+                                  CharSink &destination, int)
+                -> decltype(generate(destination), void())
+            {
+                generate(destination);
+            }
+
+            template <class Generator, class CharSink>
+            void invoke_generator(Generator const &generate,
+                                  CharSink &destination, long)
+            {
+                auto erased = Sink<char, success>::erase(ref_sink(destination));
+                generate(erased);
+            }
+
+            /// Calls generate directly if it accepts CharSink. Generators
+            /// that only take a code_sink get an erased reference to
+            /// destination.
+            template <class Generator, class CharSink>
+            void invoke_generator(Generator const &generate,
+                                  CharSink &destination)
+            {
+                invoke_generator(generate, destination, 0);
+            }
+
+            template <std::size_t Length>
+            memory_range literal(char const *content)
+            {
+                return make_memory_range(content, content + Length - 1);
+            }
+
+            struct no_content
+            {
+                template <class CharSink>
+                void operator()(CharSink &) const
+                {
+                }
+            };
+
+            template <std::size_t Length>
+            struct raw_generator
+            {
+                char const *content;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    Si::append(destination, literal<Length>(content));
+                }
+            };
+
+            template <std::size_t NameLength, class AttributesGenerator,
+                      class ContentGenerator>
+            struct tag_generator
+            {
+                char const *name;
+                AttributesGenerator generate_attributes;
+                ContentGenerator generate_content;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    html::open_attributed_element(
+                        destination, literal<NameLength>(name));
+                    invoke_generator(generate_attributes, destination);
+                    html::finish_attributes(destination);
+                    invoke_generator(generate_content, destination);
+                    html::close_element(destination,
+                                        literal<NameLength>(name));
+                }
+            };
+
+            template <std::size_t NameLength, class AttributesGenerator>
+            struct unpaired_tag_generator
+            {
+                char const *name;
+                AttributesGenerator generate_attributes;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    html::open_attributed_element(
+                        destination, literal<NameLength>(name));
+                    invoke_generator(generate_attributes, destination);
+                    html::finish_attributes_of_unpaired_tag(destination);
+                }
+            };
+
+            template <std::size_t KeyLength, class Value>
+            struct attribute_generator
+            {
+                char const *key;
+                Value value;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    html::add_attribute(destination, literal<KeyLength>(key),
+                                        value);
+                }
+            };
+
+            template <std::size_t KeyLength>
+            struct key_attribute_generator
+            {
+                char const *key;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    html::add_attribute(destination, literal<KeyLength>(key));
+                }
+            };
+
+            template <class Content>
+            struct text_generator
+            {
+                Content content;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    html::write_string(destination, content);
+                }
+            };
+
+            template <class HeadGenerator, class TailGenerator>
+            struct sequence_generator
+            {
+                HeadGenerator generate_head;
+                TailGenerator generate_tail;
+
+                template <class CharSink>
+                void operator()(CharSink &destination) const
+                {
+                    invoke_generator(generate_head, destination);
+                    invoke_generator(generate_tail, destination);
+                }
+            };
         }
 
         template <class Length = min_length<0>>
@@ -91,6 +234,8 @@ namespace Si
                                      , ((generate, (1, (code_sink &)), void,
                                          const)))
 
+        /// generate can take a code_sink & or, to avoid the virtual calls,
+        /// any sink type (for example as a generic lambda).
         template <class ContentGenerator>
         auto dynamic(ContentGenerator &&generate)
 #if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
@@ -114,20 +259,11 @@ namespace Si
         }
 
         template <std::size_t Length>
-        auto raw(char const(&content)[Length])
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>,
-                               exact_length<Length - 1>>
-#endif
+        detail::element<detail::raw_generator<Length>, exact_length<Length - 1>>
+        raw(char const(&content)[Length])
         {
-            return fixed_length<Length - 1>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([&content](code_sink &destination)
-                 {
-                     Si::append(destination, content);
-                 }));
+            detail::raw_generator<Length> generate = {content};
+            return fixed_length<Length - 1>(generate);
         }
 
         template <std::size_t NameLength, class Attributes, class Element,
@@ -137,76 +273,54 @@ namespace Si
                           typename std::decay<Attributes>::type::length_type,
                           exact_length<1 + (NameLength - 1) + 1 + 2 +
                                        (NameLength - 1) + 1>>::type>::type>
-        auto tag(char const(&name)[NameLength], Attributes &&attributes,
-                 Element &&content)
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>, ResultLength>
-#endif
+        detail::element<
+            detail::tag_generator<
+                NameLength,
+                typename std::decay<Attributes>::type::generator_type,
+                typename std::decay<Element>::type::generator_type>,
+            ResultLength>
+        tag(char const(&name)[NameLength], Attributes &&attributes,
+            Element &&content)
         {
-            auto &generate_content = content.generate;
-            return detail::make_element<ResultLength>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([
-                   &name,
-                   SILICIUM_CAPTURE_EXPRESSION(
-                       generate_content, std::move(generate_content)),
-                   SILICIUM_CAPTURE_EXPRESSION(
-                       attributes, std::forward<Attributes>(attributes))
-                ](code_sink & destination)
-                 {
-                     html::open_attributed_element(destination, name);
-                     attributes.generate(destination);
-                     html::finish_attributes(destination);
-                     generate_content(destination);
-                     html::close_element(destination, name);
-                 }));
+            detail::tag_generator<
+                NameLength,
+                typename std::decay<Attributes>::type::generator_type,
+                typename std::decay<Element>::type::generator_type>
+                generate = {name,
+                            std::forward<Attributes>(attributes).generate,
+                            std::forward<Element>(content).generate};
+            return detail::make_element<ResultLength>(std::move(generate));
         }
 
         template <std::size_t NameLength, class Attributes,
                   class ResultLength = typename detail::concatenate<
                       min_length<1 + (NameLength - 1) + 2>,
                       typename std::decay<Attributes>::type::length_type>::type>
-        auto tag(char const(&name)[NameLength], Attributes &&attributes,
-                 empty_t)
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>, ResultLength>
-#endif
-        {
-            return detail::make_element<ResultLength>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([
-                   &name,
-                   SILICIUM_CAPTURE_EXPRESSION(
-                       attributes, std::forward<Attributes>(attributes))
-                ](code_sink & destination)
-                 {
-                     html::open_attributed_element(destination, name);
-                     attributes.generate(destination);
-                     finish_attributes_of_unpaired_tag(destination);
-                 }));
-        }
-
-        namespace detail
+        detail::element<
+            detail::unpaired_tag_generator<
+                NameLength,
+                typename std::decay<Attributes>::type::generator_type>,
+            ResultLength>
+        tag(char const(&name)[NameLength], Attributes &&attributes, empty_t)
         {
-            inline void no_attributes(code_sink &)
-            {
-            }
+            detail::unpaired_tag_generator<
+                NameLength,
+                typename std::decay<Attributes>::type::generator_type>
+                generate = {name,
+                            std::forward<Attributes>(attributes).generate};
+            return detail::make_element<ResultLength>(std::move(generate));
         }
 
         template <std::size_t NameLength, class Element>
         auto tag(char const(&name)[NameLength], Element &&content)
 #if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
             -> decltype(tag(name, detail::make_element<exact_length<0>>(
-                                      &detail::no_attributes),
+                                      detail::no_content()),
                             std::forward<Element>(content)))
 #endif
         {
             return tag(name, detail::make_element<exact_length<0>>(
-                                 &detail::no_attributes),
+                                 detail::no_content()),
                        std::forward<Element>(content));
         }
 
@@ -221,116 +335,71 @@ namespace Si
                   std::size_t ResultLength = detail::space + (KeyLength - 1) +
                                              detail::assign + detail::quote +
                                              (ValueLength - 1) + detail::quote>
-        auto attribute(char const(&key)[KeyLength],
-                       char const(&value)[ValueLength])
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>,
-                               min_length<ResultLength>>
-#endif
+        detail::element<detail::attribute_generator<KeyLength, memory_range>,
+                        min_length<ResultLength>>
+        attribute(char const(&key)[KeyLength], char const(&value)[ValueLength])
         {
-            return detail::make_element<min_length<ResultLength>>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([&key, &value](code_sink &destination)
-                 {
-                     add_attribute(destination, key, value);
-                 }));
+            detail::attribute_generator<KeyLength, memory_range> generate = {
+                key, detail::literal<ValueLength>(value)};
+            return detail::make_element<min_length<ResultLength>>(generate);
         }
 
         template <std::size_t KeyLength,
                   std::size_t ResultLength = detail::space + (KeyLength - 1) +
                                              detail::assign + detail::quote +
                                              detail::quote>
-        auto attribute(char const(&key)[KeyLength], std::string value)
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>,
-                               min_length<ResultLength>>
-#endif
+        detail::element<detail::attribute_generator<KeyLength, std::string>,
+                        min_length<ResultLength>>
+        attribute(char const(&key)[KeyLength], std::string value)
         {
+            detail::attribute_generator<KeyLength, std::string> generate = {
+                key, std::move(value)};
             return detail::make_element<min_length<ResultLength>>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([&key, SILICIUM_CAPTURE_EXPRESSION(value, std::move(value)) ](
-                    code_sink & destination)
-                 {
-                     add_attribute(destination, key, value);
-                 }));
+                std::move(generate));
         }
 
         template <std::size_t KeyLength,
                   std::size_t ResultLength = detail::space + (KeyLength - 1)>
-        auto attribute(char const(&key)[KeyLength])
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>,
-                               min_length<ResultLength>>
-#endif
+        detail::element<detail::key_attribute_generator<KeyLength>,
+                        min_length<ResultLength>>
+        attribute(char const(&key)[KeyLength])
         {
-            return detail::make_element<min_length<ResultLength>>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([&key](code_sink &destination)
-                 {
-                     add_attribute(destination, key);
-                 }));
+            detail::key_attribute_generator<KeyLength> generate = {key};
+            return detail::make_element<min_length<ResultLength>>(generate);
         }
 
         template <std::size_t Length>
-        auto text(char const(&content)[Length])
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>,
-                               min_length<Length - 1>>
-#endif
+        detail::element<detail::text_generator<memory_range>,
+                        min_length<Length - 1>>
+        text(char const(&content)[Length])
         {
-            return detail::make_element<min_length<Length - 1>>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([&content](code_sink &destination)
-                 {
-                     html::write_string(destination, content);
-                 }));
+            detail::text_generator<memory_range> generate = {
+                detail::literal<Length>(content)};
+            return detail::make_element<min_length<Length - 1>>(generate);
         }
 
-        inline auto text(std::string content)
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> detail::element<std::function<void(code_sink &)>, min_length<0>>
-#endif
+        inline detail::element<detail::text_generator<std::string>,
+                               min_length<0>>
+        text(std::string content)
         {
-            return detail::make_element<min_length<0>>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([SILICIUM_CAPTURE_EXPRESSION(content, std::move(content))](
-                    code_sink & destination)
-                 {
-                     html::write_string(destination, content);
-                 }));
+            detail::text_generator<std::string> generate = {
+                std::move(content)};
+            return detail::make_element<min_length<0>>(std::move(generate));
         }
 
-        namespace detail
+        inline detail::element<detail::no_content, exact_length<0>> sequence()
         {
-            inline void no_content(code_sink &)
-            {
-            }
-        }
-
-        inline auto sequence()
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-            -> decltype(
-                detail::make_element<exact_length<0>>(&detail::no_content))
-#endif
-        {
-            return detail::make_element<exact_length<0>>(&detail::no_content);
+            return detail::make_element<exact_length<0>>(detail::no_content());
         }
 
         template <class Head, class... Tail>
         auto sequence(Head &&head, Tail &&... tail)
 #if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
             -> detail::element<
-                std::function<void(code_sink &)>,
+                detail::sequence_generator<
+                    typename std::decay<Head>::type::generator_type,
+                    typename identity<decltype(sequence(std::forward<Tail>(
+                        tail)...))>::type::generator_type>,
                 typename detail::concatenate<
                     typename std::decay<Head>::type::length_type,
                     typename identity<decltype(sequence(std::forward<Tail>(
@@ -338,25 +407,15 @@ namespace Si
 #endif
         {
             auto tail_elements = sequence(std::forward<Tail>(tail)...);
-            auto &generate_head = head.generate;
-            auto &generate_tail_elements = tail_elements.generate;
+            detail::sequence_generator<
+                typename std::decay<Head>::type::generator_type,
+                typename decltype(tail_elements)::generator_type>
+                generate = {std::forward<Head>(head).generate,
+                            std::move(tail_elements.generate)};
             return detail::make_element<typename detail::concatenate<
                 typename std::decay<Head>::type::length_type,
                 typename decltype(tail_elements)::length_type>::type>(
-#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
-                std::function<void(code_sink &)>
-#endif
-                ([
-                   SILICIUM_CAPTURE_EXPRESSION(
-                       generate_head, std::move(generate_head)),
-                   SILICIUM_CAPTURE_EXPRESSION(
-                       generate_tail_elements,
-                       std::move(generate_tail_elements))
-                ](code_sink & destination)
-                 {
-                     generate_head(destination);
-                     generate_tail_elements(destination);
-                 }));
+                std::move(generate));
         }
 
         namespace detail
@@ -371,13 +430,17 @@ namespace Si
             }
         }
 
+        /// Renders tree into a new container. The length of the tree is
+        /// known at compile time except for dynamic content, so the
+        /// container is allocated once up front in most cases. The built-in
+        /// elements write into the container without virtual calls.
         template <class ContiguousContainer, class A, class B>
         ContiguousContainer generate(detail::element<A, B> const &tree)
         {
             ContiguousContainer generated;
-            auto sink =
-                Sink<char, success>::erase(make_container_sink(generated));
-            tree.generate(sink);
+            generated.reserve(B::value);
+            auto sink = make_container_sink(generated);
+            detail::invoke_generator(tree.generate, sink);
             return generated;
         }
 #endif
@@ -2,8 +2,7 @@
 #define SILICIUM_HTTP_GENERATE_HEADER_HPP
 
 #include <silicium/noexcept_string.hpp>
-#include <silicium/sink/sink.hpp>
-#include <map>
+#include <silicium/sink/append.hpp>
 
 namespace Si
 {
@@ -26,10 +25,9 @@ namespace Si
 
         namespace detail
         {
-            template <class CharSink>
-            void generate_header_map(
-                CharSink &&out,
-                std::map<noexcept_string, noexcept_string> const &arguments)
+            template <class CharSink, class HeaderRange>
+            void generate_header_map(CharSink &&out,
+                                     HeaderRange const &arguments)
             {
                 for (auto const &argument : arguments)
                 {
@@ -28,7 +28,7 @@ namespace Si
                 out, header.http_version,
                 boost::lexical_cast<std::string>(header.status),
                 header.status_text);
-            detail::generate_header_map(out, *header.arguments);
+            detail::generate_header_map(out, header.arguments);
             append(out, "\r\n");
         }
     }
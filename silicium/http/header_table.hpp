@@ -0,0 +1,435 @@
+#ifndef SILICIUM_HTTP_HEADER_TABLE_HPP
+#define SILICIUM_HTTP_HEADER_TABLE_HPP
+
+#include <silicium/config.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <algorithm>
+#include <functional>
+#include <cassert>
+#include <cstring>
+#include <array>
+#include <vector>
+
+namespace Si
+{
+    namespace http
+    {
+        typedef std::pair<boost::string_ref, boost::string_ref> header_view;
+
+        namespace detail
+        {
+            inline char to_lower_ascii(char c) BOOST_NOEXCEPT
+            {
+                return ((c >= 'A') && (c <= 'Z'))
+                           ? static_cast<char>(c - 'A' + 'a')
+                           : c;
+            }
+
+            /// FNV-1a of the lower case header name, so that names which only
+            /// differ in case get the same hash
+            inline boost::uint32_t
+            hash_header_name(boost::string_ref name) BOOST_NOEXCEPT
+            {
+                boost::uint32_t hash = 2166136261u;
+                for (char c : name)
+                {
+                    hash ^= static_cast<unsigned char>(to_lower_ascii(c));
+                    hash *= 16777619u;
+                }
+                return hash;
+            }
+
+            inline bool equal_header_names(boost::string_ref left,
+                                           boost::string_ref right)
+                BOOST_NOEXCEPT
+            {
+                if (left.size() != right.size())
+                {
+                    return false;
+                }
+                for (std::size_t i = 0; i < left.size(); ++i)
+                {
+                    if (to_lower_ascii(left[i]) != to_lower_ascii(right[i]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            /// Splits "Key: Value" into its parts without copying. A line
+            /// without a colon is treated as a key with an empty value.
+            template <class CharRange>
+            header_view split_header_line(CharRange const &line)
+            {
+                using std::begin;
+                using std::end;
+                std::size_t const line_size = static_cast<std::size_t>(
+                    std::distance(begin(line), end(line)));
+                if (line_size == 0)
+                {
+                    return header_view();
+                }
+                boost::string_ref const whole(&*begin(line), line_size);
+                std::size_t const colon = whole.find(':');
+                if (colon == boost::string_ref::npos)
+                {
+                    return header_view(whole, boost::string_ref());
+                }
+                boost::string_ref value = whole.substr(colon + 1);
+                if (!value.empty() && (value.front() == ' '))
+                {
+                    value.remove_prefix(1);
+                }
+                return header_view(whole.substr(0, colon), value);
+            }
+        }
+
+        /// A table of HTTP header fields that keeps the fields in arrival
+        /// order. The names and values of all fields are stored in a single
+        /// character buffer, and the first inline_capacity fields do not need
+        /// any allocation besides that buffer. clear() keeps the capacity, so
+        /// a table that is reused for many messages stops allocating.
+        ///
+        /// Names are compared case-insensitively. Every field remembers the
+        /// hash of its name, so a lookup is a linear scan over a contiguous
+        /// array of integers which beats a node-based map for the typical
+        /// number of fields.
+        struct header_table
+        {
+            typedef header_view value_type;
+            typedef value_type const *const_iterator;
+            typedef const_iterator iterator;
+
+            static std::size_t const inline_capacity = 16;
+
+            header_table() BOOST_NOEXCEPT : m_inline_hashes(),
+                                            m_inline_size(0),
+                                            m_garbage(0)
+            {
+            }
+
+            header_table(header_table const &other)
+                : m_inline_hashes()
+                , m_inline_size(0)
+                , m_garbage(0)
+            {
+                *this = other;
+            }
+
+            header_table(header_table &&other) BOOST_NOEXCEPT
+                : m_inline(other.m_inline),
+                  m_inline_hashes(other.m_inline_hashes),
+                  m_inline_size(other.m_inline_size),
+                  m_overflow(std::move(other.m_overflow)),
+                  m_overflow_hashes(std::move(other.m_overflow_hashes)),
+                  m_characters(std::move(other.m_characters)),
+                  m_garbage(other.m_garbage)
+            {
+                other.m_inline_size = 0;
+                other.m_garbage = 0;
+            }
+
+            header_table &operator=(header_table const &other)
+            {
+                if (this == &other)
+                {
+                    return *this;
+                }
+                clear();
+                m_characters.reserve(other.m_characters.size());
+                for (std::size_t i = 0, c = other.size(); i < c; ++i)
+                {
+                    header_view const &field = other.begin()[i];
+                    push_back(field.first, field.second,
+                              other.hashes()[i]);
+                }
+                return *this;
+            }
+
+            header_table &operator=(header_table &&other) BOOST_NOEXCEPT
+            {
+                m_inline = other.m_inline;
+                m_inline_hashes = other.m_inline_hashes;
+                m_inline_size = other.m_inline_size;
+                m_overflow = std::move(other.m_overflow);
+                m_overflow_hashes = std::move(other.m_overflow_hashes);
+                m_characters = std::move(other.m_characters);
+                m_garbage = other.m_garbage;
+                other.m_inline_size = 0;
+                other.m_garbage = 0;
+                return *this;
+            }
+
+            const_iterator begin() const BOOST_NOEXCEPT
+            {
+                return is_spilled() ? m_overflow.data() : m_inline.data();
+            }
+
+            const_iterator end() const BOOST_NOEXCEPT
+            {
+                return begin() + size();
+            }
+
+            std::size_t size() const BOOST_NOEXCEPT
+            {
+                return is_spilled() ? m_overflow.size() : m_inline_size;
+            }
+
+            bool empty() const BOOST_NOEXCEPT
+            {
+                return size() == 0;
+            }
+
+            /// Removes all fields, but keeps the allocated memory for reuse.
+            void clear() BOOST_NOEXCEPT
+            {
+                m_inline_size = 0;
+                m_overflow.clear();
+                m_overflow_hashes.clear();
+                m_characters.clear();
+                m_garbage = 0;
+            }
+
+            /// Returns the first field with the given name or end().
+            const_iterator find(boost::string_ref name) const BOOST_NOEXCEPT
+            {
+                boost::uint32_t const hash = detail::hash_header_name(name);
+                boost::uint32_t const *const hashes_begin = hashes();
+                boost::uint32_t const *const hashes_end =
+                    hashes_begin + size();
+                for (boost::uint32_t const *h = hashes_begin; h != hashes_end;
+                     ++h)
+                {
+                    if (*h != hash)
+                    {
+                        continue;
+                    }
+                    const_iterator const candidate =
+                        begin() + (h - hashes_begin);
+                    if (detail::equal_header_names(candidate->first, name))
+                    {
+                        return candidate;
+                    }
+                }
+                return end();
+            }
+
+            std::size_t count(boost::string_ref name) const BOOST_NOEXCEPT
+            {
+                return (find(name) == end()) ? 0 : 1;
+            }
+
+            /// Appends a field even if there already is one with that name.
+            void add(boost::string_ref name, boost::string_ref value)
+            {
+                push_back(name, value, detail::hash_header_name(name));
+            }
+
+            /// Replaces the value of the first field with the given name or
+            /// appends a new field if there is none.
+            void set(boost::string_ref name, boost::string_ref value)
+            {
+                const_iterator const existing = find(name);
+                if (existing == end())
+                {
+                    add(name, value);
+                    return;
+                }
+                std::size_t const index =
+                    static_cast<std::size_t>(existing - begin());
+                boost::string_ref &replaced = mutable_begin()[index].second;
+                if (value.size() <= replaced.size())
+                {
+                    // overwrite in place, value may overlap the old one
+                    char *const destination =
+                        m_characters.data() +
+                        (replaced.data() - m_characters.data());
+                    if (!value.empty())
+                    {
+                        std::memmove(destination, value.data(), value.size());
+                    }
+                    m_garbage += replaced.size() - value.size();
+                    replaced = boost::string_ref(destination, value.size());
+                    return;
+                }
+                m_garbage += replaced.size();
+                header_view const stored =
+                    store(boost::string_ref(), value);
+                mutable_begin()[index].second = stored.second;
+                if (m_garbage > (m_characters.size() / 2))
+                {
+                    compact();
+                }
+            }
+
+            /// The number of characters in the shared buffer, including
+            /// those of replaced values that have not been reclaimed yet.
+            std::size_t buffered_characters() const BOOST_NOEXCEPT
+            {
+                return m_characters.size();
+            }
+
+        private:
+            std::array<header_view, inline_capacity> m_inline;
+            std::array<boost::uint32_t, inline_capacity> m_inline_hashes;
+            std::size_t m_inline_size;
+            std::vector<header_view> m_overflow;
+            std::vector<boost::uint32_t> m_overflow_hashes;
+            std::vector<char> m_characters;
+
+            /// characters of replaced values that are still in m_characters
+            std::size_t m_garbage;
+
+            bool is_spilled() const BOOST_NOEXCEPT
+            {
+                return m_overflow.capacity() != 0;
+            }
+
+            header_view *mutable_begin() BOOST_NOEXCEPT
+            {
+                return is_spilled() ? m_overflow.data() : m_inline.data();
+            }
+
+            boost::uint32_t const *hashes() const BOOST_NOEXCEPT
+            {
+                return is_spilled() ? m_overflow_hashes.data()
+                                    : m_inline_hashes.data();
+            }
+
+            void push_back(boost::string_ref name, boost::string_ref value,
+                           boost::uint32_t hash)
+            {
+                header_view const stored = store(name, value);
+                if (!is_spilled() && (m_inline_size < inline_capacity))
+                {
+                    m_inline[m_inline_size] = stored;
+                    m_inline_hashes[m_inline_size] = hash;
+                    ++m_inline_size;
+                    return;
+                }
+                if (!is_spilled())
+                {
+                    m_overflow.reserve(inline_capacity * 2);
+                    m_overflow_hashes.reserve(inline_capacity * 2);
+                    m_overflow.assign(
+                        m_inline.begin(), m_inline.begin() + m_inline_size);
+                    m_overflow_hashes.assign(m_inline_hashes.begin(),
+                                             m_inline_hashes.begin() +
+                                                 m_inline_size);
+                    m_inline_size = 0;
+                }
+                m_overflow.emplace_back(stored);
+                m_overflow_hashes.emplace_back(hash);
+            }
+
+            /// Copies name and value into the character buffer and returns
+            /// views of the copies. name and value may point into the buffer
+            /// themselves.
+            header_view store(boost::string_ref name, boost::string_ref value)
+            {
+                std::size_t const required =
+                    m_characters.size() + name.size() + value.size();
+                if (required > m_characters.capacity())
+                {
+                    grow_characters(required, name, value);
+                }
+                std::size_t const name_offset = m_characters.size();
+                m_characters.resize(required);
+                char *const stored = m_characters.data() + name_offset;
+                if (!name.empty())
+                {
+                    std::memmove(stored, name.data(), name.size());
+                }
+                if (!value.empty())
+                {
+                    std::memmove(
+                        stored + name.size(), value.data(), value.size());
+                }
+                return header_view(
+                    boost::string_ref(stored, name.size()),
+                    boost::string_ref(stored + name.size(), value.size()));
+            }
+
+            void grow_characters(std::size_t required,
+                                 boost::string_ref &name,
+                                 boost::string_ref &value)
+            {
+                std::vector<char> grown;
+                grown.reserve((std::max)(
+                    required, (std::max)(m_characters.capacity() * 2,
+                                         static_cast<std::size_t>(256))));
+                grown.assign(m_characters.begin(), m_characters.end());
+                char const *const old_begin = m_characters.data();
+                char const *const old_end = old_begin + m_characters.size();
+                char const *const new_begin = grown.data();
+                for (header_view *field = mutable_begin(),
+                                 *fields_end = mutable_begin() + size();
+                     field != fields_end; ++field)
+                {
+                    rebase(field->first, old_begin, old_end, new_begin);
+                    rebase(field->second, old_begin, old_end, new_begin);
+                }
+                rebase(name, old_begin, old_end, new_begin);
+                rebase(value, old_begin, old_end, new_begin);
+                m_characters.swap(grown);
+            }
+
+            /// Copies the characters that are still referenced into a fresh
+            /// buffer of the same capacity.
+            void compact()
+            {
+                std::vector<char> compacted;
+                compacted.reserve(m_characters.capacity());
+                for (header_view *field = mutable_begin(),
+                                 *fields_end = mutable_begin() + size();
+                     field != fields_end; ++field)
+                {
+                    move_into(field->first, compacted);
+                    move_into(field->second, compacted);
+                }
+                m_characters.swap(compacted);
+                m_garbage = 0;
+            }
+
+            static void move_into(boost::string_ref &view,
+                                  std::vector<char> &destination)
+            {
+                assert(destination.size() + view.size() <=
+                       destination.capacity());
+                std::size_t const offset = destination.size();
+                destination.insert(destination.end(), view.begin(), view.end());
+                view = boost::string_ref(destination.data() + offset,
+                                         view.size());
+            }
+
+            static void rebase(boost::string_ref &view, char const *old_begin,
+                               char const *old_end, char const *new_begin)
+            {
+                std::less<char const *> const less;
+                if (!view.data() || less(view.data(), old_begin) ||
+                    less(old_end, view.data()))
+                {
+                    return;
+                }
+                view = boost::string_ref(
+                    new_begin + (view.data() - old_begin), view.size());
+            }
+        };
+
+        inline bool operator==(header_table const &left,
+                               header_table const &right)
+        {
+            return (left.size() == right.size()) &&
+                   std::equal(left.begin(), left.end(), right.begin());
+        }
+
+        inline bool operator!=(header_table const &left,
+                               header_table const &right)
+        {
+            return !(left == right);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,440 @@
+#ifndef SILICIUM_HTTP_MESSAGE_BODY_HPP
+#define SILICIUM_HTTP_MESSAGE_BODY_HPP
+
+#include <silicium/http/header_table.hpp>
+#include <silicium/memory_range.hpp>
+#include <silicium/variant.hpp>
+#include <silicium/sink/sink.hpp>
+#include <silicium/detail/find_byte.hpp>
+#include <boost/cstdint.hpp>
+#include <limits>
+
+#define SILICIUM_HAS_HTTP_MESSAGE_BODY SILICIUM_HAS_VARIANT
+
+#if SILICIUM_HAS_HTTP_MESSAGE_BODY
+namespace Si
+{
+    namespace http
+    {
+        /// Marks the end of the body of a message. It is emitted for every
+        /// message, even for those without a body.
+        struct end_of_body
+        {
+        };
+
+        /// The body of a message is passed to a sink of body_element as
+        /// ranges pointing into the parsed data, followed by an end_of_body.
+        typedef variant<memory_range, end_of_body> body_element;
+
+        /// Finds the first header field with the given (case-insensitive)
+        /// name in a range of header_view-like pairs.
+        template <class HeaderRange>
+        optional<boost::string_ref> find_header(HeaderRange const &headers,
+                                                boost::string_ref name)
+        {
+            for (auto const &header : headers)
+            {
+                boost::string_ref const key(header.first.data(),
+                                            header.first.size());
+                if (detail::equal_header_names(key, name))
+                {
+                    return boost::string_ref(
+                        header.second.data(), header.second.size());
+                }
+            }
+            return none;
+        }
+
+        namespace detail
+        {
+            /// Returns whether token appears in a comma-separated list like
+            /// the value of a Connection field.
+            inline bool contains_token(boost::string_ref list,
+                                       boost::string_ref token)
+            {
+                while (!list.empty())
+                {
+                    std::size_t const comma = list.find(',');
+                    boost::string_ref element = list.substr(0, comma);
+                    while (!element.empty() &&
+                           ((element.front() == ' ') ||
+                            (element.front() == '\t')))
+                    {
+                        element.remove_prefix(1);
+                    }
+                    while (!element.empty() && ((element.back() == ' ') ||
+                                                (element.back() == '\t')))
+                    {
+                        element.remove_suffix(1);
+                    }
+                    if (equal_header_names(element, token))
+                    {
+                        return true;
+                    }
+                    if (comma == boost::string_ref::npos)
+                    {
+                        break;
+                    }
+                    list.remove_prefix(comma + 1);
+                }
+                return false;
+            }
+        }
+
+        /// Decides whether the connection can be used for another message
+        /// after this one (RFC 7230 6.3).
+        template <class HeaderRange>
+        bool is_keep_alive(boost::string_ref http_version,
+                           HeaderRange const &headers)
+        {
+            optional<boost::string_ref> const connection =
+                find_header(headers, "Connection");
+            if (http_version == "HTTP/1.0")
+            {
+                return connection &&
+                       detail::contains_token(*connection, "keep-alive");
+            }
+            return !connection ||
+                   !detail::contains_token(*connection, "close");
+        }
+
+        namespace detail
+        {
+            /// Splits the body of a HTTP/1.1 request from the data that
+            /// follows it. The body is framed either by Content-Length or by
+            /// the chunked Transfer-Encoding. A request with neither does not
+            /// have a body (RFC 7230 3.3.3).
+            struct body_parser
+            {
+                body_parser() BOOST_NOEXCEPT : m_state(state::idle),
+                                               m_remaining(0),
+                                               m_chunk_size_digits(0)
+                {
+                }
+
+                /// Whether the parser has to see more data (or has to emit an
+                /// end_of_body) before the next message begins.
+                bool is_active() const BOOST_NOEXCEPT
+                {
+                    return (m_state != state::idle) &&
+                           (m_state != state::failed);
+                }
+
+                /// A malformed framing was encountered. The rest of the
+                /// stream cannot be interpreted anymore, so the connection
+                /// should be closed.
+                bool has_failed() const BOOST_NOEXCEPT
+                {
+                    return m_state == state::failed;
+                }
+
+                template <class HeaderRange>
+                void begin(HeaderRange const &headers)
+                {
+                    assert(!is_active());
+                    if (has_failed())
+                    {
+                        return;
+                    }
+                    optional<boost::string_ref> const transfer_encoding =
+                        find_header(headers, "Transfer-Encoding");
+                    if (transfer_encoding)
+                    {
+                        // only chunked is supported, and it has to be the
+                        // last encoding
+                        m_state = ends_with_chunked(*transfer_encoding)
+                                      ? state::chunk_size
+                                      : state::failed;
+                        m_remaining = 0;
+                        m_chunk_size_digits = 0;
+                        return;
+                    }
+                    optional<boost::uint64_t> content_length;
+                    for (auto const &header : headers)
+                    {
+                        boost::string_ref const key(header.first.data(),
+                                                    header.first.size());
+                        if (!equal_header_names(key, "Content-Length"))
+                        {
+                            continue;
+                        }
+                        // fields that disagree would let the sender and a
+                        // proxy frame the body differently (RFC 7230 3.3.3)
+                        boost::uint64_t length = 0;
+                        if (!parse_decimal(
+                                boost::string_ref(header.second.data(),
+                                                  header.second.size()),
+                                length) ||
+                            (content_length && (*content_length != length)))
+                        {
+                            m_state = state::failed;
+                            return;
+                        }
+                        content_length = length;
+                    }
+                    if (!content_length)
+                    {
+                        m_state = state::finish;
+                        return;
+                    }
+                    m_remaining = *content_length;
+                    m_state = (m_remaining == 0) ? state::finish
+                                                 : state::content;
+                }
+
+                /// Consumes as much of data as belongs to the current body.
+                /// Parts of the body are appended to out without copying.
+                template <class BodyOutput>
+                typename BodyOutput::error_type consume(memory_range &data,
+                                                        BodyOutput &out)
+                {
+                    typedef typename BodyOutput::error_type error_type;
+                    while (is_active() &&
+                           ((m_state == state::finish) || !data.empty()))
+                    {
+                        switch (m_state)
+                        {
+                        case state::idle:
+                        case state::failed:
+                            SILICIUM_UNREACHABLE();
+
+                        case state::content:
+                        case state::chunk_data:
+                        {
+                            assert(m_remaining != 0);
+                            std::size_t const taken = static_cast<std::size_t>(
+                                (std::min)(m_remaining,
+                                           static_cast<boost::uint64_t>(
+                                               data.size())));
+                            memory_range const piece(
+                                data.begin(), data.begin() + taken);
+                            data.pop_front(
+                                static_cast<std::ptrdiff_t>(taken));
+                            m_remaining -= taken;
+                            if (m_remaining == 0)
+                            {
+                                m_state = (m_state == state::content)
+                                              ? state::finish
+                                              : state::chunk_data_cr;
+                            }
+                            error_type error = emit(out, body_element(piece));
+                            if (error)
+                            {
+                                return error;
+                            }
+                            break;
+                        }
+
+                        case state::chunk_size:
+                        {
+                            char const c = data.front();
+                            int const digit = hex_digit(c);
+                            if (digit >= 0)
+                            {
+                                if ((m_remaining >> 60u) != 0)
+                                {
+                                    m_state = state::failed;
+                                    break;
+                                }
+                                m_remaining = (m_remaining << 4u) |
+                                              static_cast<unsigned>(digit);
+                                ++m_chunk_size_digits;
+                                data.pop_front();
+                                break;
+                            }
+                            // the size is followed by an extension or by
+                            // the end of the line (bare LF is tolerated like
+                            // after the chunk data)
+                            bool const ends_size = (c == ';') || (c == ' ') ||
+                                                   (c == '\t') || (c == '\r') ||
+                                                   (c == '\n');
+                            if ((m_chunk_size_digits == 0) || !ends_size)
+                            {
+                                m_state = state::failed;
+                                break;
+                            }
+                            m_state = state::chunk_extension;
+                            break;
+                        }
+
+                        case state::chunk_extension:
+                        {
+                            char const *const lf = Si::detail::find_byte(
+                                data.begin(), data.end(), '\n');
+                            if (lf == data.end())
+                            {
+                                data.pop_front(data.size());
+                                break;
+                            }
+                            data.pop_front((lf + 1) - data.begin());
+                            m_state = (m_remaining == 0) ? state::trailer_begin
+                                                         : state::chunk_data;
+                            break;
+                        }
+
+                        case state::chunk_data_cr:
+                        {
+                            if (data.front() == '\r')
+                            {
+                                data.pop_front();
+                            }
+                            m_state = state::chunk_data_lf;
+                            break;
+                        }
+
+                        case state::chunk_data_lf:
+                        {
+                            if (data.front() != '\n')
+                            {
+                                m_state = state::failed;
+                                break;
+                            }
+                            data.pop_front();
+                            m_chunk_size_digits = 0;
+                            m_state = state::chunk_size;
+                            break;
+                        }
+
+                        case state::trailer_begin:
+                        {
+                            char const c = data.front();
+                            if (c == '\r')
+                            {
+                                data.pop_front();
+                                break;
+                            }
+                            if (c == '\n')
+                            {
+                                data.pop_front();
+                                m_state = state::finish;
+                                break;
+                            }
+                            m_state = state::trailer;
+                            break;
+                        }
+
+                        case state::trailer:
+                        {
+                            // trailer fields are ignored
+                            char const *const lf = Si::detail::find_byte(
+                                data.begin(), data.end(), '\n');
+                            if (lf == data.end())
+                            {
+                                data.pop_front(data.size());
+                                break;
+                            }
+                            data.pop_front((lf + 1) - data.begin());
+                            m_state = state::trailer_begin;
+                            break;
+                        }
+
+                        case state::finish:
+                        {
+                            m_state = state::idle;
+                            error_type error =
+                                emit(out, body_element(end_of_body()));
+                            if (error)
+                            {
+                                return error;
+                            }
+                            break;
+                        }
+                        }
+                    }
+                    return error_type();
+                }
+
+            private:
+                enum class state
+                {
+                    idle,
+                    content,
+                    chunk_size,
+                    chunk_extension,
+                    chunk_data,
+                    chunk_data_cr,
+                    chunk_data_lf,
+                    trailer_begin,
+                    trailer,
+                    finish,
+                    failed
+                };
+
+                state m_state;
+                boost::uint64_t m_remaining;
+                std::size_t m_chunk_size_digits;
+
+                template <class BodyOutput>
+                static typename BodyOutput::error_type
+                emit(BodyOutput &out, body_element const &element)
+                {
+                    return out.append(
+                        Si::make_iterator_range(&element, &element + 1));
+                }
+
+                static int hex_digit(char c) BOOST_NOEXCEPT
+                {
+                    if ((c >= '0') && (c <= '9'))
+                    {
+                        return c - '0';
+                    }
+                    if ((c >= 'a') && (c <= 'f'))
+                    {
+                        return c - 'a' + 10;
+                    }
+                    if ((c >= 'A') && (c <= 'F'))
+                    {
+                        return c - 'A' + 10;
+                    }
+                    return -1;
+                }
+
+                static bool parse_decimal(boost::string_ref text,
+                                          boost::uint64_t &result)
+                {
+                    while (!text.empty() &&
+                           ((text.back() == ' ') || (text.back() == '\t')))
+                    {
+                        text.remove_suffix(1);
+                    }
+                    if (text.empty())
+                    {
+                        return false;
+                    }
+                    result = 0;
+                    for (char c : text)
+                    {
+                        if ((c < '0') || (c > '9'))
+                        {
+                            return false;
+                        }
+                        boost::uint64_t const digit =
+                            static_cast<boost::uint64_t>(c - '0');
+                        if (result >
+                            (((std::numeric_limits<boost::uint64_t>::max)() -
+                              digit) /
+                             10))
+                        {
+                            return false;
+                        }
+                        result = (result * 10) + digit;
+                    }
+                    return true;
+                }
+
+                static bool ends_with_chunked(boost::string_ref encodings)
+                {
+                    std::size_t const last_comma = encodings.rfind(',');
+                    boost::string_ref const last =
+                        (last_comma == boost::string_ref::npos)
+                            ? encodings
+                            : encodings.substr(last_comma + 1);
+                    return contains_token(last, "chunked");
+                }
+            };
+        }
+    }
+}
+#endif
+
+#endif
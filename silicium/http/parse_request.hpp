@@ -2,12 +2,12 @@
 #define SILICIUM_HTTP_PARSE_REQUEST_HPP
 
 #include <silicium/noexcept_string.hpp>
+#include <silicium/http/header_table.hpp>
 #include <silicium/source/source.hpp>
-#include <silicium/detail/line_source.hpp>
+#include <silicium/source/line_view_source.hpp>
 #include <silicium/to_unique.hpp>
 #include <boost/optional.hpp>
 #include <boost/lexical_cast.hpp>
-#include <map>
 
 namespace Si
 {
@@ -18,13 +18,13 @@ namespace Si
             noexcept_string method;
             noexcept_string path;
             noexcept_string http_version;
-            std::map<noexcept_string, noexcept_string> arguments;
+            header_table arguments;
         };
 
         template <class CharSource>
         SILICIUM_USE_RESULT optional<request> parse_request(CharSource &&in)
         {
-            auto lines = Si::detail::make_line_source(in);
+            auto lines = Si::make_line_view_source(in);
             auto first_line = get(lines);
             if (!first_line)
             {
@@ -63,8 +63,9 @@ namespace Si
                 {
                     break;
                 }
-                auto value = Si::detail::split_value_line(*value_line);
-                header.arguments[value.first] = std::move(value.second);
+                header_view const value =
+                    detail::split_header_line(*value_line);
+                header.arguments.set(value.first, value.second);
             }
             return std::move(header);
         }
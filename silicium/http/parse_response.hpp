@@ -2,12 +2,10 @@
 #define SILICIUM_HTTP_PARSE_RESPONSE_HPP
 
 #include <silicium/noexcept_string.hpp>
-#include <silicium/to_unique.hpp>
-#include <silicium/make_unique.hpp>
-#include <silicium/detail/line_source.hpp>
+#include <silicium/http/header_table.hpp>
+#include <silicium/source/line_view_source.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional.hpp>
-#include <map>
 
 namespace Si
 {
@@ -15,17 +13,21 @@ namespace Si
     {
         struct response
         {
-            typedef std::map<noexcept_string, noexcept_string> arguments_table;
+            typedef header_table arguments_table;
 
             noexcept_string http_version;
             int status;
             noexcept_string status_text;
-            std::unique_ptr<arguments_table> arguments;
+            arguments_table arguments;
 
             response() BOOST_NOEXCEPT : status(0)
             {
             }
 
+#if SILICIUM_COMPILER_GENERATES_MOVES
+            SILICIUM_DEFAULT_MOVE(response)
+            SILICIUM_DEFAULT_COPY(response)
+#else
             response(response &&other) BOOST_NOEXCEPT
                 : http_version(std::move(other.http_version)),
                   status(other.status),
@@ -38,8 +40,7 @@ namespace Si
                 : http_version(other.http_version)
                 , status(other.status)
                 , status_text(other.status_text)
-                , arguments(other.arguments ? to_unique(*other.arguments)
-                                            : nullptr)
+                , arguments(other.arguments)
             {
             }
 
@@ -57,24 +58,22 @@ namespace Si
                 http_version = other.http_version;
                 status = other.status;
                 status_text = other.status_text;
-                arguments =
-                    other.arguments ? to_unique(*other.arguments) : nullptr;
+                arguments = other.arguments;
                 return *this;
             }
+#endif
         };
 
         template <class CharSource>
         SILICIUM_USE_RESULT optional<response> parse_response(CharSource &&in)
         {
-            auto lines = Si::detail::make_line_source(in);
+            auto lines = Si::make_line_view_source(in);
             auto first_line = get(lines);
             if (!first_line)
             {
                 return none;
             }
             response header;
-            header.arguments =
-                Si::make_unique<std::map<noexcept_string, noexcept_string>>();
             {
                 auto const version_end =
                     std::find(first_line->begin(), first_line->end(), ' ');
@@ -114,8 +113,9 @@ namespace Si
                 {
                     break;
                 }
-                auto value = Si::detail::split_value_line(*value_line);
-                (*header.arguments)[value.first] = std::move(value.second);
+                header_view const value =
+                    detail::split_header_line(*value_line);
+                header.arguments.set(value.first, value.second);
             }
             return std::move(header);
         }
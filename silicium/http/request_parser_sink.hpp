@@ -2,35 +2,73 @@
 #define SILICIUM_HTTP_REQUEST_PARSER_SINK_HPP
 
 #include <silicium/http/parse_request.hpp>
+#include <silicium/http/message_body.hpp>
 #include <silicium/sink/sink.hpp>
 #include <silicium/variant.hpp>
 #include <silicium/exchange.hpp>
 
+#if SILICIUM_HAS_HTTP_MESSAGE_BODY
 namespace Si
 {
     namespace http
     {
-        template <class Output>
-        struct request_parser_sink
+        /// Parses a stream of HTTP/1.1 requests as they arrive on a
+        /// persistent connection. The header of every request is appended to
+        /// Output. The body is framed according to Content-Length or the
+        /// chunked Transfer-Encoding and appended to BodyOutput as ranges
+        /// into the parsed data, followed by an end_of_body. Pipelined
+        /// requests are parsed one after another even if they arrive in a
+        /// single call to append.
+        template <class Output,
+                  class BodyOutput =
+                      null_sink<body_element, typename Output::error_type>>
+        struct request_parser_sink SILICIUM_FINAL
             : Sink<char, typename Output::error_type>::interface
         {
             typedef char element_type;
             typedef typename Output::error_type error_type;
 
-            explicit request_parser_sink(Output output)
+            explicit request_parser_sink(Output output,
+                                         BodyOutput body_output = BodyOutput())
                 : m_output(std::move(output))
+                , m_body_output(std::move(body_output))
                 , m_state(state::method)
             {
             }
 
+            /// The framing of a body was invalid, so the rest of the input is
+            /// ignored. The connection should be closed.
+            bool has_failed() const BOOST_NOEXCEPT
+            {
+                return m_body.has_failed();
+            }
+
             virtual error_type
             append(iterator_range<element_type const *> data) SILICIUM_OVERRIDE
             {
-                while (!data.empty())
+                while (!data.empty() && !m_body.has_failed())
                 {
+                    if (m_body.is_active())
+                    {
+                        error_type error = m_body.consume(data, m_body_output);
+                        if (error)
+                        {
+                            return error;
+                        }
+                        continue;
+                    }
                     switch (m_state)
                     {
                     case state::method:
+                        if (m_result.method.empty() &&
+                            ((data.front() == '\r') || (data.front() == '\n')))
+                        {
+                            // empty lines between requests are ignored as
+                            // recommended by RFC 7230 3.5
+                            data.pop_front();
+                            break;
+                        }
+                    // fall through
                     case state::path:
                     {
                         auto space = std::find(data.begin(), data.end(), ' ');
@@ -82,10 +120,6 @@ namespace Si
                             error_type error =
                                 m_output.append(Si::make_iterator_range(
                                     &m_result, &m_result + 1));
-                            m_result.path.clear();
-                            m_result.method.clear();
-                            m_result.http_version.clear();
-                            m_result.arguments.clear();
                             if (error)
                             {
                                 return error;
@@ -121,8 +155,10 @@ namespace Si
                         if (cr != data.end())
                         {
                             data.pop_front(1);
-                            m_result.arguments.insert(std::make_pair(
-                                std::move(m_key), std::move(m_value)));
+                            m_result.arguments.add(
+                                boost::string_ref(m_key.data(), m_key.size()),
+                                boost::string_ref(
+                                    m_value.data(), m_value.size()));
                             m_key.clear();
                             m_value.clear();
                             m_state = state::value_lf;
@@ -147,6 +183,17 @@ namespace Si
                             data.pop_front(1);
                         }
                         m_state = state::method;
+                        m_body.begin(m_result.arguments);
+                        m_result.path.clear();
+                        m_result.method.clear();
+                        m_result.http_version.clear();
+                        m_result.arguments.clear();
+                        // a request without a body is finished right away
+                        error_type error = m_body.consume(data, m_body_output);
+                        if (error)
+                        {
+                            return error;
+                        }
                         break;
                     }
                     }
@@ -169,6 +216,8 @@ namespace Si
             };
 
             Output m_output;
+            BodyOutput m_body_output;
+            detail::body_parser m_body;
             request m_result;
             state m_state;
             noexcept_string m_key;
@@ -185,7 +234,21 @@ namespace Si
                 typename std::remove_reference<Output>::type>(
                 std::forward<Output>(output));
         }
+
+        template <class Output, class BodyOutput>
+        auto make_request_parser_sink(Output &&output, BodyOutput &&body_output)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+            -> request_parser_sink<typename std::decay<Output>::type,
+                                   typename std::decay<BodyOutput>::type>
+#endif
+        {
+            return request_parser_sink<typename std::decay<Output>::type,
+                                       typename std::decay<BodyOutput>::type>(
+                std::forward<Output>(output),
+                std::forward<BodyOutput>(body_output));
+        }
     }
 }
+#endif
 
 #endif
@@ -0,0 +1,363 @@
+#ifndef SILICIUM_HTTP_REQUEST_VIEW_PARSER_SINK_HPP
+#define SILICIUM_HTTP_REQUEST_VIEW_PARSER_SINK_HPP
+
+#include <silicium/http/parse_request.hpp>
+#include <silicium/http/message_body.hpp>
+#include <silicium/sink/sink.hpp>
+#include <silicium/detail/find_byte.hpp>
+#include <algorithm>
+#include <vector>
+
+#define SILICIUM_HAS_HTTP_REQUEST_VIEW                                         \
+    ((BOOST_VERSION >= 105300) && SILICIUM_HAS_HTTP_MESSAGE_BODY)
+
+#if SILICIUM_HAS_HTTP_REQUEST_VIEW
+#include <boost/utility/string_ref.hpp>
+
+namespace Si
+{
+    namespace http
+    {
+        /// A request whose fields point into memory owned by the parser or by
+        /// the caller of append. It is only valid during the call to the
+        /// output sink that receives it. Use to_request to keep a copy.
+        struct request_view
+        {
+            boost::string_ref method;
+            boost::string_ref path;
+            boost::string_ref http_version;
+            iterator_range<header_view const *> arguments;
+        };
+
+        inline request to_request(request_view const &view)
+        {
+            request result;
+            result.method.assign(view.method.begin(), view.method.end());
+            result.path.assign(view.path.begin(), view.path.end());
+            result.http_version.assign(
+                view.http_version.begin(), view.http_version.end());
+            for (header_view const &argument : view.arguments)
+            {
+                result.arguments.add(argument.first, argument.second);
+            }
+            return result;
+        }
+
+        namespace detail
+        {
+            inline boost::string_ref make_string_ref(char const *begin,
+                                                     char const *end)
+            {
+                return boost::string_ref(
+                    begin, static_cast<std::size_t>(end - begin));
+            }
+
+            inline char const *strip_carriage_return(char const *begin,
+                                                     char const *line_end)
+            {
+                if ((line_end != begin) && (line_end[-1] == '\r'))
+                {
+                    return line_end - 1;
+                }
+                return line_end;
+            }
+
+            /// Searches for the empty line that terminates a request header
+            /// starting at scan_from. Returns a pointer behind that line or
+            /// nullptr if the header is not complete yet.
+            inline char const *find_end_of_head(char const *scan_from,
+                                                char const *end)
+            {
+                for (;;)
+                {
+                    char const *const lf =
+                        Si::detail::find_byte(scan_from, end, '\n');
+                    if (lf == end)
+                    {
+                        return nullptr;
+                    }
+                    char const *const next = lf + 1;
+                    if (next == end)
+                    {
+                        return nullptr;
+                    }
+                    if (*next == '\n')
+                    {
+                        return next + 1;
+                    }
+                    if (*next == '\r')
+                    {
+                        if ((next + 1) == end)
+                        {
+                            return nullptr;
+                        }
+                        if (next[1] == '\n')
+                        {
+                            return next + 2;
+                        }
+                    }
+                    scan_from = next;
+                }
+            }
+
+            /// Splits a complete request header [begin, end) into views. end
+            /// has to be the result of find_end_of_head.
+            inline void parse_head(char const *begin, char const *end,
+                                   request_view &result,
+                                   std::vector<header_view> &arguments)
+            {
+                char const *const request_line_end =
+                    Si::detail::find_byte(begin, end, '\n');
+                assert(request_line_end != end);
+                char const *const version_end =
+                    strip_carriage_return(begin, request_line_end);
+
+                char const *const method_end =
+                    Si::detail::find_byte(begin, version_end, ' ');
+                result.method = make_string_ref(begin, method_end);
+                char const *const path_begin =
+                    (method_end == version_end) ? version_end : method_end + 1;
+                char const *const path_end =
+                    Si::detail::find_byte(path_begin, version_end, ' ');
+                result.path = make_string_ref(path_begin, path_end);
+                char const *const version_begin =
+                    (path_end == version_end) ? version_end : path_end + 1;
+                result.http_version =
+                    make_string_ref(version_begin, version_end);
+
+                arguments.clear();
+                char const *line = request_line_end + 1;
+                for (;;)
+                {
+                    char const *const colon =
+                        Si::detail::find_either_byte(line, end, ':', '\n');
+                    assert(colon != end);
+                    if (*colon == '\n')
+                    {
+                        if (strip_carriage_return(line, colon) == line)
+                        {
+                            // the empty line at the end of the header
+                            break;
+                        }
+                        // a line without a colon is not a valid header, so
+                        // we ignore it
+                        line = colon + 1;
+                        continue;
+                    }
+                    char const *const line_end =
+                        Si::detail::find_byte(colon + 1, end, '\n');
+                    assert(line_end != end);
+                    char const *value_begin = colon + 1;
+                    char const *const value_end =
+                        strip_carriage_return(value_begin, line_end);
+                    while ((value_begin != value_end) &&
+                           ((*value_begin == ' ') || (*value_begin == '\t')))
+                    {
+                        ++value_begin;
+                    }
+                    arguments.emplace_back(
+                        make_string_ref(line, colon),
+                        make_string_ref(value_begin, value_end));
+                    line = line_end + 1;
+                }
+                result.arguments = Si::make_iterator_range(
+                    arguments.data(), arguments.data() + arguments.size());
+            }
+        }
+
+        /// A zero-copy alternative to request_parser_sink. The fields of the
+        /// request_views passed to Output point directly into the appended
+        /// data when a request header arrives in one piece. A header that is
+        /// split across several calls to append is collected in an internal
+        /// buffer that keeps its capacity, so parsing does not allocate in
+        /// the steady state.
+        ///
+        /// Bodies are framed like in request_parser_sink and appended to
+        /// BodyOutput without copying.
+        ///
+        /// A request header longer than max_head_size makes the parser fail
+        /// so that a peer cannot make the internal buffer grow without
+        /// limit.
+        template <class Output,
+                  class BodyOutput =
+                      null_sink<body_element, typename Output::error_type>>
+        struct request_view_parser_sink
+        {
+            typedef char element_type;
+            typedef typename Output::error_type error_type;
+
+            static std::size_t const default_max_head_size = 64 * 1024;
+
+            request_view_parser_sink()
+                : m_max_head_size(default_max_head_size)
+                , m_head_too_large(false)
+            {
+            }
+
+            explicit request_view_parser_sink(
+                Output output, BodyOutput body_output = BodyOutput(),
+                std::size_t max_head_size = default_max_head_size)
+                : m_output(std::move(output))
+                , m_body_output(std::move(body_output))
+                , m_max_head_size(max_head_size)
+                , m_head_too_large(false)
+            {
+            }
+
+            /// A request header was too long or the framing of a body was
+            /// invalid, so the rest of the input is ignored. The connection
+            /// should be closed.
+            bool has_failed() const BOOST_NOEXCEPT
+            {
+                return m_head_too_large || m_body.has_failed();
+            }
+
+            error_type append(iterator_range<element_type const *> data)
+            {
+                while (!data.empty() && !has_failed())
+                {
+                    if (m_body.is_active())
+                    {
+                        error_type error = m_body.consume(data, m_body_output);
+                        if (error)
+                        {
+                            return error;
+                        }
+                    }
+                    else if (m_pending.empty())
+                    {
+                        // empty lines between requests are ignored as
+                        // recommended by RFC 7230 3.5
+                        while (!data.empty() &&
+                               ((data.front() == '\r') ||
+                                (data.front() == '\n')))
+                        {
+                            data.pop_front();
+                        }
+                        if (data.empty())
+                        {
+                            break;
+                        }
+                        char const *const head_end = detail::find_end_of_head(
+                            data.begin(), data.end());
+                        char const *const head_begin = data.begin();
+                        if (static_cast<std::size_t>(
+                                (head_end ? head_end : data.end()) -
+                                head_begin) > m_max_head_size)
+                        {
+                            m_head_too_large = true;
+                            break;
+                        }
+                        if (!head_end)
+                        {
+                            m_pending.assign(data.begin(), data.end());
+                            break;
+                        }
+                        data.pop_front(head_end - head_begin);
+                        error_type error = emit(head_begin, head_end, data);
+                        if (error)
+                        {
+                            return error;
+                        }
+                    }
+                    else
+                    {
+                        // the end of the header can begin at most three bytes
+                        // before the new data ("\r\n\r\n")
+                        std::size_t const previously_pending =
+                            m_pending.size();
+                        std::size_t const scan_from =
+                            (previously_pending < 3) ? 0
+                                                     : (previously_pending - 3);
+                        // a header that fits into m_max_head_size ends
+                        // within the first copied bytes
+                        std::size_t const copied = (std::min)(
+                            static_cast<std::size_t>(data.size()),
+                            m_max_head_size - previously_pending);
+                        m_pending.insert(m_pending.end(), data.begin(),
+                                         data.begin() + copied);
+                        char const *const pending_begin = m_pending.data();
+                        char const *const head_end = detail::find_end_of_head(
+                            pending_begin + scan_from,
+                            pending_begin + m_pending.size());
+                        if (!head_end)
+                        {
+                            if (copied < static_cast<std::size_t>(data.size()))
+                            {
+                                m_head_too_large = true;
+                                m_pending.clear();
+                            }
+                            break;
+                        }
+                        data.pop_front(
+                            static_cast<std::ptrdiff_t>(
+                                static_cast<std::size_t>(head_end -
+                                                         pending_begin) -
+                                previously_pending));
+                        error_type error =
+                            emit(pending_begin, head_end, data);
+                        m_pending.clear();
+                        if (error)
+                        {
+                            return error;
+                        }
+                    }
+                }
+                return error_type();
+            }
+
+        private:
+            Output m_output;
+            BodyOutput m_body_output;
+            detail::body_parser m_body;
+            request_view m_result;
+            std::vector<header_view> m_arguments;
+            std::vector<char> m_pending;
+            std::size_t m_max_head_size;
+            bool m_head_too_large;
+
+            error_type emit(char const *head_begin, char const *head_end,
+                            memory_range &rest)
+            {
+                detail::parse_head(head_begin, head_end, m_result, m_arguments);
+                error_type error = m_output.append(
+                    Si::make_iterator_range(&m_result, &m_result + 1));
+                if (error)
+                {
+                    return error;
+                }
+                m_body.begin(m_result.arguments);
+                // a request without a body is finished right away
+                return m_body.consume(rest, m_body_output);
+            }
+        };
+
+        template <class Output>
+        auto make_request_view_parser_sink(Output &&output)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+            -> request_view_parser_sink<typename std::decay<Output>::type>
+#endif
+        {
+            return request_view_parser_sink<typename std::decay<Output>::type>(
+                std::forward<Output>(output));
+        }
+
+        template <class Output, class BodyOutput>
+        auto make_request_view_parser_sink(Output &&output,
+                                           BodyOutput &&body_output)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+            -> request_view_parser_sink<typename std::decay<Output>::type,
+                                        typename std::decay<BodyOutput>::type>
+#endif
+        {
+            return request_view_parser_sink<
+                typename std::decay<Output>::type,
+                typename std::decay<BodyOutput>::type>(
+                std::forward<Output>(output),
+                std::forward<BodyOutput>(body_output));
+        }
+    }
+}
+#endif
+
+#endif
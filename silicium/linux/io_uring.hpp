@@ -0,0 +1,421 @@
+#ifndef SILICIUM_LINUX_IO_URING_HPP
+#define SILICIUM_LINUX_IO_URING_HPP
+
+#include <silicium/error_or.hpp>
+#include <silicium/file_handle.hpp>
+#include <silicium/get_last_error.hpp>
+#include <silicium/memory_range.hpp>
+#include <silicium/exchange.hpp>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define SILICIUM_HAS_IO_URING 1
+#endif
+#endif
+#ifndef SILICIUM_HAS_IO_URING
+#define SILICIUM_HAS_IO_URING 0
+#endif
+
+#if SILICIUM_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace Si
+{
+    namespace uring
+    {
+        namespace detail
+        {
+            inline int setup(unsigned entries, io_uring_params &parameters)
+            {
+                return static_cast<int>(
+                    syscall(__NR_io_uring_setup, entries, &parameters));
+            }
+
+            inline int enter(int ring, unsigned to_submit,
+                             unsigned min_complete, unsigned flags)
+            {
+                return static_cast<int>(syscall(__NR_io_uring_enter, ring,
+                                                to_submit, min_complete,
+                                                flags, nullptr, 0));
+            }
+
+            inline int register_(int ring, unsigned opcode,
+                                 void const *arguments, unsigned count)
+            {
+                return static_cast<int>(syscall(__NR_io_uring_register, ring,
+                                                opcode, arguments, count));
+            }
+
+            /// A shared memory region of the kernel.
+            struct mapping
+            {
+                void *address;
+                std::size_t size;
+
+                mapping() BOOST_NOEXCEPT : address(MAP_FAILED), size(0)
+                {
+                }
+
+                mapping(mapping &&other) BOOST_NOEXCEPT
+                    : address(Si::exchange(other.address, MAP_FAILED)),
+                      size(other.size)
+                {
+                }
+
+                mapping &operator=(mapping &&other) BOOST_NOEXCEPT
+                {
+                    std::swap(address, other.address);
+                    std::swap(size, other.size);
+                    return *this;
+                }
+
+                ~mapping() BOOST_NOEXCEPT
+                {
+                    if (address != MAP_FAILED)
+                    {
+                        munmap(address, size);
+                    }
+                }
+
+                bool map(int ring, std::size_t length, off_t offset)
+                {
+                    address = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, ring, offset);
+                    size = length;
+                    return address != MAP_FAILED;
+                }
+
+                template <class T>
+                T *at(unsigned offset) const BOOST_NOEXCEPT
+                {
+                    return reinterpret_cast<T *>(static_cast<char *>(address) +
+                                                 offset);
+                }
+
+            private:
+                SILICIUM_DELETED_FUNCTION(mapping(mapping const &))
+                SILICIUM_DELETED_FUNCTION(mapping &operator=(mapping const &))
+            };
+        }
+
+        /// A thin wrapper around the submission and completion queues of an
+        /// io_uring instance (see io_uring(7)). Entries obtained with
+        /// get_sqe are collected until submit is called, so that any number
+        /// of operations can be started with a single system call.
+        ///
+        /// A ring is not thread-safe.
+        struct ring
+        {
+            ring() BOOST_NOEXCEPT : m_sq_head(nullptr),
+                                    m_sq_tail(nullptr),
+                                    m_sq_mask(0),
+                                    m_sq_entries(0),
+                                    m_sqes(nullptr),
+                                    m_cq_head(nullptr),
+                                    m_cq_tail(nullptr),
+                                    m_cq_mask(0),
+                                    m_cqes(nullptr),
+                                    m_local_tail(0)
+            {
+            }
+
+            ring(ring &&other) BOOST_NOEXCEPT : ring()
+            {
+                swap(other);
+            }
+
+            ring &operator=(ring &&other) BOOST_NOEXCEPT
+            {
+                swap(other);
+                return *this;
+            }
+
+            void swap(ring &other) BOOST_NOEXCEPT
+            {
+                using std::swap;
+                m_file.swap(other.m_file);
+                swap(m_sq_mapping, other.m_sq_mapping);
+                swap(m_cq_mapping, other.m_cq_mapping);
+                swap(m_sqe_mapping, other.m_sqe_mapping);
+                swap(m_sq_head, other.m_sq_head);
+                swap(m_sq_tail, other.m_sq_tail);
+                swap(m_sq_mask, other.m_sq_mask);
+                swap(m_sq_entries, other.m_sq_entries);
+                swap(m_sqes, other.m_sqes);
+                swap(m_cq_head, other.m_cq_head);
+                swap(m_cq_tail, other.m_cq_tail);
+                swap(m_cq_mask, other.m_cq_mask);
+                swap(m_cqes, other.m_cqes);
+                swap(m_local_tail, other.m_local_tail);
+            }
+
+            /// Fails with ENOSYS on kernels without io_uring and with EPERM
+            /// where it has been disabled.
+            static error_or<ring> create(unsigned entries)
+            {
+                io_uring_params parameters;
+                std::memset(&parameters, 0, sizeof(parameters));
+                int const descriptor = detail::setup(entries, parameters);
+                if (descriptor < 0)
+                {
+                    return get_last_error();
+                }
+                ring result;
+                result.m_file = file_handle(descriptor);
+
+                std::size_t const sq_size =
+                    parameters.sq_off.array +
+                    (parameters.sq_entries * sizeof(unsigned));
+                std::size_t const cq_size =
+                    parameters.cq_off.cqes +
+                    (parameters.cq_entries * sizeof(io_uring_cqe));
+                bool const single_mapping =
+                    (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (!result.m_sq_mapping.map(
+                        descriptor,
+                        single_mapping ? (std::max)(sq_size, cq_size) : sq_size,
+                        IORING_OFF_SQ_RING))
+                {
+                    return get_last_error();
+                }
+                detail::mapping const &cq_mapping =
+                    single_mapping ? result.m_sq_mapping : result.m_cq_mapping;
+                if (!single_mapping &&
+                    !result.m_cq_mapping.map(
+                        descriptor, cq_size, IORING_OFF_CQ_RING))
+                {
+                    return get_last_error();
+                }
+                if (!result.m_sqe_mapping.map(
+                        descriptor,
+                        parameters.sq_entries * sizeof(io_uring_sqe),
+                        IORING_OFF_SQES))
+                {
+                    return get_last_error();
+                }
+
+                detail::mapping const &sq = result.m_sq_mapping;
+                result.m_sq_head = sq.at<unsigned>(parameters.sq_off.head);
+                result.m_sq_tail = sq.at<unsigned>(parameters.sq_off.tail);
+                result.m_sq_mask =
+                    *sq.at<unsigned>(parameters.sq_off.ring_mask);
+                result.m_sq_entries =
+                    *sq.at<unsigned>(parameters.sq_off.ring_entries);
+                result.m_sqes = result.m_sqe_mapping.at<io_uring_sqe>(0);
+                // the indirection array always maps slot i to entry i, so
+                // that submitting is just a matter of moving the tail
+                unsigned *const array =
+                    sq.at<unsigned>(parameters.sq_off.array);
+                for (unsigned i = 0; i < result.m_sq_entries; ++i)
+                {
+                    array[i] = i;
+                }
+                result.m_local_tail = *result.m_sq_tail;
+
+                result.m_cq_head =
+                    cq_mapping.at<unsigned>(parameters.cq_off.head);
+                result.m_cq_tail =
+                    cq_mapping.at<unsigned>(parameters.cq_off.tail);
+                result.m_cq_mask =
+                    *cq_mapping.at<unsigned>(parameters.cq_off.ring_mask);
+                result.m_cqes =
+                    cq_mapping.at<io_uring_cqe>(parameters.cq_off.cqes);
+                return result;
+            }
+
+            native_file_descriptor handle() const BOOST_NOEXCEPT
+            {
+                return m_file.handle;
+            }
+
+            /// Returns a zeroed submission queue entry or nullptr if the
+            /// queue is full. The entry is passed to the kernel by the next
+            /// call to submit.
+            io_uring_sqe *get_sqe() BOOST_NOEXCEPT
+            {
+                unsigned const head =
+                    __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+                if ((m_local_tail - head) >= m_sq_entries)
+                {
+                    return nullptr;
+                }
+                io_uring_sqe *const entry = &m_sqes[m_local_tail & m_sq_mask];
+                ++m_local_tail;
+                std::memset(entry, 0, sizeof(*entry));
+                return entry;
+            }
+
+            /// The number of entries that have been prepared, but not
+            /// consumed by the kernel yet.
+            unsigned unsubmitted() const BOOST_NOEXCEPT
+            {
+                return m_local_tail -
+                       __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+            }
+
+            /// Passes all prepared entries to the kernel and optionally waits
+            /// for completions. Returns the number of submitted entries.
+            /// Interrupted calls are repeated. When the kernel refuses new
+            /// entries because the completion queue is full (EBUSY), the
+            /// available completions are passed to handle_completion like in
+            /// reap before the entries are submitted again.
+            template <class CompletionHandler>
+            error_or<unsigned> submit(CompletionHandler &&handle_completion,
+                                      unsigned wait_for = 0)
+            {
+                __atomic_store_n(m_sq_tail, m_local_tail, __ATOMIC_RELEASE);
+                bool retry_with_empty_queue = true;
+                for (;;)
+                {
+                    unsigned const to_submit = unsubmitted();
+                    if ((to_submit == 0) && (wait_for == 0))
+                    {
+                        return 0u;
+                    }
+                    int const submitted =
+                        detail::enter(m_file.handle, to_submit, wait_for,
+                                      wait_for ? IORING_ENTER_GETEVENTS : 0);
+                    if (submitted >= 0)
+                    {
+                        return static_cast<unsigned>(submitted);
+                    }
+                    int const error = errno;
+                    if (error == EINTR)
+                    {
+                        continue;
+                    }
+                    // the kernel moves completions that did not fit into
+                    // the queue once there is space again, so an empty
+                    // queue is worth one more try
+                    if ((error == EBUSY) &&
+                        ((reap(handle_completion) > 0) ||
+                         Si::exchange(retry_with_empty_queue, false)))
+                    {
+                        continue;
+                    }
+                    return boost::system::error_code(
+                        error, boost::system::system_category());
+                }
+            }
+
+            /// Takes back the prepared entries that the kernel has not
+            /// consumed, for example after submit failed, and passes each of
+            /// them to handle_entry. This is only possible because the ring
+            /// is not set up for kernel-side polling, so the kernel looks at
+            /// the submission queue only during submit.
+            template <class EntryHandler>
+            void discard_unsubmitted(EntryHandler &&handle_entry)
+            {
+                unsigned const head =
+                    __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+                unsigned const tail = m_local_tail;
+                m_local_tail = head;
+                __atomic_store_n(m_sq_tail, head, __ATOMIC_RELEASE);
+                for (unsigned i = head; i != tail; ++i)
+                {
+                    handle_entry(m_sqes[i & m_sq_mask]);
+                }
+            }
+
+            /// Calls handle_completion for every available completion queue
+            /// entry and returns their number. A handler may call reap or
+            /// submit itself.
+            template <class CompletionHandler>
+            std::size_t reap(CompletionHandler &&handle_completion)
+            {
+                std::size_t count = 0;
+                for (;;)
+                {
+                    // the head is read again in every iteration because a
+                    // handler may have reaped entries already
+                    unsigned const head = *m_cq_head;
+                    if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+                    {
+                        return count;
+                    }
+                    io_uring_cqe const completion = m_cqes[head & m_cq_mask];
+                    // free the entry before the handler runs, because the
+                    // handler may start more operations
+                    __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+                    ++count;
+                    handle_completion(completion);
+                }
+            }
+
+            /// Makes buffers known to the kernel so that the *_FIXED
+            /// operations can skip mapping them for every request.
+            boost::system::error_code register_buffers(
+                iterator_range<mutable_memory_range const *> buffers)
+            {
+                std::vector<iovec> vectors;
+                vectors.reserve(static_cast<std::size_t>(buffers.size()));
+                for (mutable_memory_range const &buffer : buffers)
+                {
+                    iovec vector;
+                    vector.iov_base = buffer.begin();
+                    vector.iov_len = static_cast<std::size_t>(buffer.size());
+                    vectors.emplace_back(vector);
+                }
+                return check(detail::register_(
+                    m_file.handle, IORING_REGISTER_BUFFERS, vectors.data(),
+                    static_cast<unsigned>(vectors.size())));
+            }
+
+            /// Makes file descriptors known to the kernel so that they can be
+            /// referred to by their index with IOSQE_FIXED_FILE, which saves
+            /// the reference counting of the file for every request.
+            boost::system::error_code
+            register_files(iterator_range<native_file_descriptor const *> files)
+            {
+                return check(detail::register_(
+                    m_file.handle, IORING_REGISTER_FILES, files.begin(),
+                    static_cast<unsigned>(files.size())));
+            }
+
+            /// The kernel signals every completion on this eventfd.
+            boost::system::error_code
+            register_eventfd(native_file_descriptor event)
+            {
+                return check(detail::register_(
+                    m_file.handle, IORING_REGISTER_EVENTFD, &event, 1));
+            }
+
+        private:
+            file_handle m_file;
+            detail::mapping m_sq_mapping;
+            detail::mapping m_cq_mapping;
+            detail::mapping m_sqe_mapping;
+            unsigned *m_sq_head;
+            unsigned *m_sq_tail;
+            unsigned m_sq_mask;
+            unsigned m_sq_entries;
+            io_uring_sqe *m_sqes;
+            unsigned *m_cq_head;
+            unsigned *m_cq_tail;
+            unsigned m_cq_mask;
+            io_uring_cqe *m_cqes;
+            unsigned m_local_tail;
+
+            static boost::system::error_code check(int result)
+            {
+                if (result < 0)
+                {
+                    return get_last_error();
+                }
+                return boost::system::error_code();
+            }
+
+            SILICIUM_DELETED_FUNCTION(ring(ring const &))
+            SILICIUM_DELETED_FUNCTION(ring &operator=(ring const &))
+        };
+    }
+}
+#endif
+
+#endif
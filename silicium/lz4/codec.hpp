@@ -0,0 +1,401 @@
+#ifndef SILICIUM_LZ4_CODEC_HPP
+#define SILICIUM_LZ4_CODEC_HPP
+
+#include <silicium/compression/codec.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#define SILICIUM_HAS_LZ4_CODEC                                                 \
+    (SILICIUM_HAS_COMPRESSION_CODEC && !SILICIUM_AVOID_LZ4)
+
+#if SILICIUM_HAS_LZ4_CODEC
+#include <lz4frame.h>
+
+namespace Si
+{
+    struct lz4_error_category : boost::system::error_category
+    {
+        lz4_error_category()
+        {
+        }
+
+        virtual const char *name() const BOOST_NOEXCEPT SILICIUM_OVERRIDE
+        {
+            return "lz4";
+        }
+
+        virtual std::string message(int ev) const SILICIUM_OVERRIDE
+        {
+            // LZ4F error codes are negated enum values
+            return LZ4F_getErrorName(
+                static_cast<LZ4F_errorCode_t>(0) -
+                static_cast<LZ4F_errorCode_t>(ev));
+        }
+    };
+
+    inline boost::system::error_category const &lz4_category()
+    {
+        static lz4_error_category const instance;
+        return instance;
+    }
+
+    /// Converts the result of an LZ4F function that failed.
+    inline boost::system::error_code make_lz4_error(std::size_t result)
+    {
+        assert(LZ4F_isError(result));
+        return boost::system::error_code(
+            static_cast<int>(static_cast<std::size_t>(0) - result),
+            lz4_category());
+    }
+
+    inline void handle_lz4_status(std::size_t result)
+    {
+        if (!LZ4F_isError(result))
+        {
+            return;
+        }
+        boost::throw_exception(
+            boost::system::system_error(make_lz4_error(result)));
+    }
+
+    namespace detail
+    {
+        struct lz4_cctx_deleter
+        {
+            void operator()(LZ4F_cctx *context) const BOOST_NOEXCEPT
+            {
+                LZ4F_freeCompressionContext(context);
+            }
+        };
+
+        struct lz4_dctx_deleter
+        {
+            void operator()(LZ4F_dctx *context) const BOOST_NOEXCEPT
+            {
+                LZ4F_freeDecompressionContext(context);
+            }
+        };
+    }
+
+    /// A Codec that produces LZ4 frames with linked 64 KiB blocks. LZ4 is
+    /// much faster than deflate at a lower ratio. full_flush ends the
+    /// current frame. Output that does not fit into the space offered is
+    /// kept until the next call.
+    struct lz4_compressor
+    {
+        lz4_compressor() BOOST_NOEXCEPT : m_preferences(),
+                                          m_pending_begin(0),
+                                          m_state(state::idle)
+        {
+        }
+
+        explicit lz4_compressor(int level)
+            : m_preferences()
+            , m_pending_begin(0)
+            , m_state(state::idle)
+        {
+            LZ4F_cctx *context = nullptr;
+            handle_lz4_status(
+                LZ4F_createCompressionContext(&context, LZ4F_VERSION));
+            m_context.reset(context);
+            m_preferences.frameInfo.blockSizeID = LZ4F_max64KB;
+            m_preferences.compressionLevel = level;
+        }
+
+        lz4_compressor(lz4_compressor &&other) BOOST_NOEXCEPT
+            : m_context(std::move(other.m_context)),
+              m_preferences(other.m_preferences),
+              m_pending(std::move(other.m_pending)),
+              m_pending_begin(other.m_pending_begin),
+              m_state(other.m_state)
+        {
+        }
+
+        lz4_compressor &operator=(lz4_compressor &&other) BOOST_NOEXCEPT
+        {
+            m_context = std::move(other.m_context);
+            m_preferences = other.m_preferences;
+            m_pending = std::move(other.m_pending);
+            m_pending_begin = other.m_pending_begin;
+            m_state = other.m_state;
+            return *this;
+        }
+
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush flush)
+        {
+            assert(m_context);
+            codec_progress progress = {0, 0, false};
+            bool flushed = false;
+            for (;;)
+            {
+                take_pending(output, progress);
+                if (m_pending_begin < m_pending.size())
+                {
+                    return progress;
+                }
+                std::size_t const rest =
+                    static_cast<std::size_t>(input.size()) - progress.consumed;
+                if ((m_state == state::ended) && (rest > 0))
+                {
+                    m_state = state::idle;
+                }
+                if (m_state == state::idle)
+                {
+                    if ((rest == 0) && (flush == codec_flush::none))
+                    {
+                        return progress;
+                    }
+                    std::size_t const written = write(
+                        output, progress, LZ4F_HEADER_SIZE_MAX,
+                        [this](char *destination, std::size_t capacity)
+                        {
+                            return LZ4F_compressBegin(
+                                m_context.get(), destination, capacity,
+                                &m_preferences);
+                        });
+                    if (LZ4F_isError(written))
+                    {
+                        return make_lz4_error(written);
+                    }
+                    m_state = state::started;
+                    continue;
+                }
+                if (rest > 0)
+                {
+                    // LZ4F_compressBound grows with the size of the input,
+                    // so it is fed in blocks
+                    std::size_t const chunk =
+                        (std::min<std::size_t>)(rest, 64 * 1024);
+                    char const *const source =
+                        input.begin() + progress.consumed;
+                    std::size_t const written = write(
+                        output, progress,
+                        LZ4F_compressBound(chunk, &m_preferences),
+                        [this, source, chunk](char *destination,
+                                              std::size_t capacity)
+                        {
+                            return LZ4F_compressUpdate(m_context.get(),
+                                                       destination, capacity,
+                                                       source, chunk, nullptr);
+                        });
+                    if (LZ4F_isError(written))
+                    {
+                        return make_lz4_error(written);
+                    }
+                    progress.consumed += chunk;
+                    continue;
+                }
+                if (m_state == state::ended)
+                {
+                    progress.is_end = (flush == codec_flush::finish);
+                    return progress;
+                }
+                switch (flush)
+                {
+                case codec_flush::none:
+                    return progress;
+
+                case codec_flush::sync:
+                {
+                    if (flushed)
+                    {
+                        return progress;
+                    }
+                    std::size_t const written = write(
+                        output, progress,
+                        LZ4F_compressBound(0, &m_preferences),
+                        [this](char *destination, std::size_t capacity)
+                        {
+                            return LZ4F_flush(m_context.get(), destination,
+                                              capacity, nullptr);
+                        });
+                    if (LZ4F_isError(written))
+                    {
+                        return make_lz4_error(written);
+                    }
+                    flushed = true;
+                    break;
+                }
+
+                case codec_flush::full:
+                case codec_flush::finish:
+                {
+                    std::size_t const written = write(
+                        output, progress,
+                        LZ4F_compressBound(0, &m_preferences),
+                        [this](char *destination, std::size_t capacity)
+                        {
+                            return LZ4F_compressEnd(m_context.get(),
+                                                    destination, capacity,
+                                                    nullptr);
+                        });
+                    if (LZ4F_isError(written))
+                    {
+                        return make_lz4_error(written);
+                    }
+                    m_state = state::ended;
+                    break;
+                }
+                }
+            }
+        }
+
+    private:
+        enum class state
+        {
+            idle,
+            started,
+            ended
+        };
+
+        std::unique_ptr<LZ4F_cctx, detail::lz4_cctx_deleter> m_context;
+        LZ4F_preferences_t m_preferences;
+        std::vector<char> m_pending;
+        std::size_t m_pending_begin;
+        state m_state;
+
+        void take_pending(mutable_memory_range output,
+                          codec_progress &progress)
+        {
+            if (m_pending.empty())
+            {
+                return;
+            }
+            std::size_t const size = (std::min)(
+                m_pending.size() - m_pending_begin,
+                static_cast<std::size_t>(output.size()) - progress.produced);
+            std::memcpy(output.begin() + progress.produced,
+                        m_pending.data() + m_pending_begin, size);
+            progress.produced += size;
+            m_pending_begin += size;
+            if (m_pending_begin == m_pending.size())
+            {
+                m_pending.clear();
+                m_pending_begin = 0;
+            }
+        }
+
+        /// Lets produce write directly into output if bound bytes fit, and
+        /// into the pending buffer otherwise.
+        template <class Producer>
+        std::size_t write(mutable_memory_range output,
+                          codec_progress &progress, std::size_t bound,
+                          Producer const &produce)
+        {
+            assert(m_pending.empty());
+            std::size_t const space =
+                static_cast<std::size_t>(output.size()) - progress.produced;
+            if (space >= bound)
+            {
+                std::size_t const written =
+                    produce(output.begin() + progress.produced, space);
+                if (!LZ4F_isError(written))
+                {
+                    progress.produced += written;
+                }
+                return written;
+            }
+            m_pending.resize(bound);
+            std::size_t const written = produce(m_pending.data(), bound);
+            m_pending.resize(LZ4F_isError(written) ? 0 : written);
+            return written;
+        }
+
+        SILICIUM_DELETED_FUNCTION(lz4_compressor(lz4_compressor const &))
+        SILICIUM_DELETED_FUNCTION(
+            lz4_compressor &operator=(lz4_compressor const &))
+    };
+
+    /// A Codec that decompresses concatenated LZ4 frames.
+    struct lz4_decompressor
+    {
+        lz4_decompressor() BOOST_NOEXCEPT : m_is_end(false)
+        {
+        }
+
+        static lz4_decompressor initialize()
+        {
+            LZ4F_dctx *context = nullptr;
+            handle_lz4_status(
+                LZ4F_createDecompressionContext(&context, LZ4F_VERSION));
+            lz4_decompressor result;
+            result.m_context.reset(context);
+            return result;
+        }
+
+        lz4_decompressor(lz4_decompressor &&other) BOOST_NOEXCEPT
+            : m_context(std::move(other.m_context)),
+              m_is_end(other.m_is_end)
+        {
+        }
+
+        lz4_decompressor &operator=(lz4_decompressor &&other) BOOST_NOEXCEPT
+        {
+            m_context = std::move(other.m_context);
+            m_is_end = other.m_is_end;
+            return *this;
+        }
+
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush)
+        {
+            assert(m_context);
+            codec_progress progress = {0, 0, m_is_end};
+            for (;;)
+            {
+                std::size_t source_size =
+                    static_cast<std::size_t>(input.size()) - progress.consumed;
+                std::size_t destination_size =
+                    static_cast<std::size_t>(output.size()) - progress.produced;
+                std::size_t const hint = LZ4F_decompress(
+                    m_context.get(), output.begin() + progress.produced,
+                    &destination_size, input.begin() + progress.consumed,
+                    &source_size, nullptr);
+                if (LZ4F_isError(hint))
+                {
+                    return make_lz4_error(hint);
+                }
+                progress.consumed += source_size;
+                progress.produced += destination_size;
+                if (hint == 0)
+                {
+                    // a frame has been decoded and flushed completely
+                    m_is_end = true;
+                    break;
+                }
+                if (source_size > 0)
+                {
+                    m_is_end = false;
+                }
+                if ((progress.consumed == static_cast<std::size_t>(
+                                              input.size())) ||
+                    (progress.produced ==
+                     static_cast<std::size_t>(output.size())) ||
+                    ((source_size == 0) && (destination_size == 0)))
+                {
+                    break;
+                }
+            }
+            progress.is_end = m_is_end;
+            return progress;
+        }
+
+    private:
+        std::unique_ptr<LZ4F_dctx, detail::lz4_dctx_deleter> m_context;
+        bool m_is_end;
+
+        SILICIUM_DELETED_FUNCTION(lz4_decompressor(lz4_decompressor const &))
+        SILICIUM_DELETED_FUNCTION(
+            lz4_decompressor &operator=(lz4_decompressor const &))
+    };
+}
+#endif
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef SILICIUM_MPMC_QUEUE_HPP
+#define SILICIUM_MPMC_QUEUE_HPP
+
+#include <silicium/spsc_ring.hpp>
+#include <memory>
+
+namespace Si
+{
+    /// A bounded lock-free queue for any number of producer and consumer
+    /// threads (D. Vyukov's algorithm). Every slot carries a sequence number
+    /// that tells whether it is free or full in the current lap around the
+    /// ring. push and pop claim a whole run of consecutive slots with a
+    /// single compare-and-swap, so batches cost about as much as single
+    /// elements.
+    template <class Element>
+    struct mpmc_queue
+    {
+        typedef Element element_type;
+
+        static bool const is_multi_producer = true;
+        static bool const is_multi_consumer = true;
+
+        /// capacity is rounded up to a power of two.
+        explicit mpmc_queue(std::size_t capacity)
+            : m_capacity(detail::round_up_to_power_of_two(
+                  (std::max)(capacity, std::size_t(2))))
+            , m_mask(m_capacity - 1)
+            , m_slots(new slot[m_capacity])
+            , m_push_position(0)
+            , m_pop_position(0)
+        {
+            for (std::size_t i = 0; i < m_capacity; ++i)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t capacity() const BOOST_NOEXCEPT
+        {
+            return m_capacity;
+        }
+
+        /// Copies as many elements as fit into the queue and returns their
+        /// number.
+        std::size_t push(iterator_range<element_type const *> elements)
+        {
+            if (elements.empty())
+            {
+                return 0;
+            }
+            std::size_t position =
+                m_push_position.load(std::memory_order_relaxed);
+            std::size_t count = 0;
+            for (;;)
+            {
+                // a slot is free for position if its sequence equals
+                // position
+                count = count_ready(position,
+                                    static_cast<std::size_t>(elements.size()),
+                                    0);
+                if (count == 0)
+                {
+                    std::size_t const current =
+                        m_push_position.load(std::memory_order_relaxed);
+                    if (current == position)
+                    {
+                        return 0;
+                    }
+                    position = current;
+                    continue;
+                }
+                if (m_push_position.compare_exchange_weak(
+                        position, position + count, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                slot &destination = m_slots[(position + i) & m_mask];
+                destination.value = elements.begin()[i];
+                destination.sequence.store(
+                    position + i + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        /// Moves as many elements as are available into destination and
+        /// returns the end of the written part.
+        element_type *pop(iterator_range<element_type *> destination)
+        {
+            if (destination.empty())
+            {
+                return destination.begin();
+            }
+            std::size_t position =
+                m_pop_position.load(std::memory_order_relaxed);
+            std::size_t count = 0;
+            for (;;)
+            {
+                // a slot is full for position if its sequence equals
+                // position + 1
+                count = count_ready(
+                    position, static_cast<std::size_t>(destination.size()), 1);
+                if (count == 0)
+                {
+                    std::size_t const current =
+                        m_pop_position.load(std::memory_order_relaxed);
+                    if (current == position)
+                    {
+                        return destination.begin();
+                    }
+                    position = current;
+                    continue;
+                }
+                if (m_pop_position.compare_exchange_weak(
+                        position, position + count, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                slot &source = m_slots[(position + i) & m_mask];
+                destination.begin()[i] = std::move(source.value);
+                source.sequence.store(
+                    position + i + m_capacity, std::memory_order_release);
+            }
+            return destination.begin() + count;
+        }
+
+        /// Whether push would transfer at least one element at the moment.
+        bool can_push() const BOOST_NOEXCEPT
+        {
+            std::size_t const position =
+                m_push_position.load(std::memory_order_relaxed);
+            return m_slots[position & m_mask].sequence.load(
+                       std::memory_order_acquire) == position;
+        }
+
+        /// Whether pop would transfer at least one element at the moment.
+        bool can_pop() const BOOST_NOEXCEPT
+        {
+            std::size_t const position =
+                m_pop_position.load(std::memory_order_relaxed);
+            return m_slots[position & m_mask].sequence.load(
+                       std::memory_order_acquire) == (position + 1);
+        }
+
+    private:
+        struct slot
+        {
+            std::atomic<std::size_t> sequence;
+            element_type value;
+        };
+
+        std::size_t const m_capacity;
+        std::size_t const m_mask;
+        std::unique_ptr<slot[]> m_slots;
+        char m_padding0[detail::cache_line_size];
+        std::atomic<std::size_t> m_push_position;
+        char m_padding1[detail::cache_line_size];
+        std::atomic<std::size_t> m_pop_position;
+        char m_padding2[detail::cache_line_size];
+
+        /// Counts the consecutive slots from position on whose sequence is
+        /// what the caller needs. No other thread can change these slots
+        /// before the caller has claimed or given up position.
+        std::size_t count_ready(std::size_t position, std::size_t maximum,
+                                std::size_t lag) const BOOST_NOEXCEPT
+        {
+            std::size_t count = 0;
+            while ((count < maximum) && (count < m_capacity) &&
+                   (m_slots[(position + count) & m_mask].sequence.load(
+                        std::memory_order_acquire) ==
+                    (position + count + lag)))
+            {
+                ++count;
+            }
+            return count;
+        }
+
+        SILICIUM_DELETED_FUNCTION(mpmc_queue(mpmc_queue const &))
+        SILICIUM_DELETED_FUNCTION(mpmc_queue &operator=(mpmc_queue const &))
+    };
+}
+
+#endif
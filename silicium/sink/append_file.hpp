@@ -0,0 +1,93 @@
+#ifndef SILICIUM_SINK_APPEND_FILE_HPP
+#define SILICIUM_SINK_APPEND_FILE_HPP
+
+#include <silicium/sink/sink.hpp>
+#include <silicium/read.hpp>
+#include <array>
+#include <type_traits>
+
+namespace Si
+{
+    namespace detail
+    {
+        template <class Sink>
+        struct has_append_file
+        {
+        private:
+            typedef typename std::decay<Sink>::type clean;
+
+            template <class T>
+            static std::true_type
+            check(T *, decltype(std::declval<T &>().append_file(
+                           std::declval<native_file_descriptor>(),
+                           std::declval<std::size_t>())) * = nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<clean *>(nullptr))) type;
+            static bool const value = type::value;
+        };
+
+        template <class Sink>
+        boost::system::error_code append_file(Sink &out,
+                                              native_file_descriptor file,
+                                              std::size_t size, std::true_type)
+        {
+            return out.append_file(file, size);
+        }
+
+        template <class Sink>
+        boost::system::error_code append_file(Sink &out,
+                                              native_file_descriptor file,
+                                              std::size_t size,
+                                              std::false_type)
+        {
+            std::array<char, 1U << 14U> buffer;
+            std::size_t copied = 0;
+            while (copied < size)
+            {
+                error_or<std::size_t> const read_bytes =
+                    read(file, make_iterator_range(
+                                   buffer.data(),
+                                   buffer.data() +
+                                       (std::min)(buffer.size(),
+                                                  size - copied)));
+                if (read_bytes.is_error())
+                {
+                    return read_bytes.error();
+                }
+                if (read_bytes.get() == 0)
+                {
+                    break;
+                }
+                boost::system::error_code const error =
+                    out.append(make_iterator_range(
+                        buffer.data(), buffer.data() + read_bytes.get()));
+                if (error)
+                {
+                    return error;
+                }
+                copied += read_bytes.get();
+            }
+            return boost::system::error_code();
+        }
+    }
+
+    /// Appends up to size bytes from the current position of file to a sink
+    /// of char, stopping early at the end of the file. A sink with a member
+    /// function append_file can do that without copying the data through
+    /// user memory (see transfer_file), every other sink gets the data in
+    /// chunks through append.
+    template <class Sink>
+    boost::system::error_code
+    append_file(Sink &&out, native_file_descriptor file, std::size_t size)
+    {
+        BOOST_STATIC_ASSERT((std::is_same<
+            typename std::decay<Sink>::type::element_type, char>::value));
+        return detail::append_file(
+            out, file, size, typename detail::has_append_file<Sink>::type());
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef SILICIUM_SINK_APPEND_RANGES_HPP
+#define SILICIUM_SINK_APPEND_RANGES_HPP
+
+#include <silicium/sink/sink.hpp>
+#include <type_traits>
+
+namespace Si
+{
+    /// A sequence of ranges that a sink can write with a single operation
+    /// (scatter/gather I/O).
+    template <class Element>
+    struct range_sequence
+    {
+        typedef iterator_range<iterator_range<Element const *> const *> type;
+    };
+
+    namespace detail
+    {
+        template <class Sink>
+        struct has_append_ranges
+        {
+        private:
+            typedef typename std::decay<Sink>::type clean;
+            typedef typename range_sequence<typename clean::element_type>::type
+                ranges;
+
+            template <class T>
+            static std::true_type
+            check(T *, decltype(std::declval<T &>().append_ranges(
+                           std::declval<ranges>())) * = nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<clean *>(nullptr))) type;
+            static bool const value = type::value;
+        };
+
+        template <class Sink>
+        typename error_type<Sink>::type append_ranges(
+            Sink &out,
+            typename range_sequence<
+                typename std::decay<Sink>::type::element_type>::type ranges,
+            std::true_type)
+        {
+            return out.append_ranges(ranges);
+        }
+
+        template <class Sink>
+        typename error_type<Sink>::type append_ranges(
+            Sink &out,
+            typename range_sequence<
+                typename std::decay<Sink>::type::element_type>::type ranges,
+            std::false_type)
+        {
+            for (auto const &range : ranges)
+            {
+                auto error = out.append(range);
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return typename error_type<Sink>::type();
+        }
+    }
+
+    /// Appends several ranges to a sink. A sink that has a member function
+    /// append_ranges can write all of them at once (for example with
+    /// writev), every other sink gets one call of append per range.
+    template <class Sink>
+    typename error_type<Sink>::type append_ranges(
+        Sink &&out,
+        typename range_sequence<
+            typename std::decay<Sink>::type::element_type>::type ranges)
+    {
+        return detail::append_ranges(
+            out, ranges, typename detail::has_append_ranges<Sink>::type());
+    }
+}
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef SILICIUM_BUFFERING_SINK_HPP
 #define SILICIUM_BUFFERING_SINK_HPP
 
-#include <silicium/sink/sink.hpp>
+#include <silicium/sink/append_ranges.hpp>
+#include <silicium/sink/append_file.hpp>
+#include <silicium/sink/flush_policy.hpp>
 #include <silicium/detail/then.hpp>
 #include <array>
 #include <boost/range/algorithm/copy.hpp>
@@ -11,40 +13,110 @@
 namespace Si
 {
 #if SILICIUM_HAS_BUFFERING_SINK
+    namespace detail
+    {
+        /// An adaptive buffer can change its size. buffering_sink calls
+        /// prepare() before it copies anything into the buffer and
+        /// flushed(overflowed, used) after the buffer has been emptied.
+        /// overflowed tells whether the data did not fit into the buffer and
+        /// used is the number of elements that had been buffered.
+        template <class Buffer>
+        struct is_adaptive_buffer
+        {
+        private:
+            template <class T>
+            static std::true_type
+            check(T *, decltype(std::declval<T &>().prepare()) * = nullptr,
+                  decltype(std::declval<T &>().flushed(true, std::size_t())) * =
+                      nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<Buffer *>(nullptr))) type;
+            static bool const value = type::value;
+        };
+
+        template <class Buffer>
+        void prepare_buffer(Buffer &buffer, std::true_type)
+        {
+            buffer.prepare();
+        }
+
+        template <class Buffer>
+        void prepare_buffer(Buffer &, std::false_type)
+        {
+        }
+
+        template <class Buffer>
+        void buffer_flushed(Buffer &buffer, bool overflowed, std::size_t used,
+                            std::true_type)
+        {
+            buffer.flushed(overflowed, used);
+        }
+
+        template <class Buffer>
+        void buffer_flushed(Buffer &, bool, std::size_t, std::false_type)
+        {
+        }
+    }
+
+    /// Collects small appends and passes them on to Next in larger pieces.
+    /// Data is passed on when it does not fit into the buffer, when flush()
+    /// is called or when the FlushPolicy asks for it.
     template <class Next, class Error = typename Next::error_type,
               class Buffer = std::array<typename Next::element_type,
                                         ((1U << 13U) /
-                                         sizeof(typename Next::element_type))>>
+                                         sizeof(typename Next::element_type))>,
+              class FlushPolicy = manual_flush>
     struct buffering_sink
     {
         typedef typename Next::element_type element_type;
         typedef typename Next::error_type error_type;
+        typedef Buffer buffer_type;
 
         buffering_sink()
             : m_buffer_used(0)
+            , m_append_space(0)
+            , m_corked(false)
         {
         }
 
-        explicit buffering_sink(Next destination, Buffer buffer = Buffer())
+        explicit buffering_sink(Next destination, Buffer buffer = Buffer(),
+                                FlushPolicy policy = FlushPolicy())
             : m_destination(std::move(destination))
             , m_fallback_buffer(std::move(buffer))
+            , m_policy(std::move(policy))
             , m_buffer_used(0)
+            , m_append_space(0)
+            , m_corked(false)
         {
         }
 
+        /// Returns space behind the data that is already buffered. Calling
+        /// this again resizes the space. The result is empty when the
+        /// buffer is full.
         iterator_range<element_type *> make_append_space(std::size_t size)
         {
-            m_buffer_used = (std::min)(size, m_fallback_buffer.size());
-            return make_iterator_range(
-                m_fallback_buffer.data(),
-                m_fallback_buffer.data() + m_buffer_used);
+            detail::prepare_buffer(m_fallback_buffer, is_adaptive());
+            m_append_space =
+                (std::min)(size, m_fallback_buffer.size() - m_buffer_used);
+            element_type *const begin =
+                m_fallback_buffer.data() + m_buffer_used;
+            return make_iterator_range(begin, begin + m_append_space);
         }
 
+        /// Keeps what has been written into the append space and passes
+        /// everything buffered on to the destination. A corked sink only
+        /// does that when the buffer is full.
         Error flush_append_space()
         {
-            if (m_buffer_used)
+            m_buffer_used += m_append_space;
+            m_append_space = 0;
+            if (m_buffer_used &&
+                (!m_corked || (m_buffer_used == m_fallback_buffer.size())))
             {
-                return flush();
+                return flush_buffer(m_buffer_used == m_fallback_buffer.size());
             }
             else
             {
@@ -54,27 +126,113 @@ namespace Si
 
         Error append(iterator_range<element_type const *> data)
         {
+            detail::prepare_buffer(m_fallback_buffer, is_adaptive());
             if (static_cast<size_t>(data.size()) <=
                 (m_fallback_buffer.size() - m_buffer_used))
             {
                 boost::range::copy(
                     data, m_fallback_buffer.begin() + m_buffer_used);
                 m_buffer_used += static_cast<size_t>(data.size());
+                if (!m_corked &&
+                    m_policy.should_flush(
+                        *this, m_buffer_used, m_fallback_buffer.size()))
+                {
+                    return flush();
+                }
                 return detail::default_construct<Error>();
             }
 
+            return append_unbuffered(
+                data, typename detail::has_append_ranges<Next>::type());
+        }
+
+        /// Small ranges are copied into the buffer. A range that does not
+        /// fit is written together with the buffered data.
+        Error append_ranges(typename range_sequence<element_type>::type ranges)
+        {
+            for (auto const &range : ranges)
+            {
+                Error error = append(range);
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return Error();
+        }
+
+        /// The buffered data has to be written first, so that the content
+        /// of the file can be passed on without copying.
+        Error append_file(native_file_descriptor file, std::size_t size)
+        {
             return detail::then(
                 [this]
                 {
                     return this->flush();
                 },
-                [this, &data]
+                [this, file, size]
                 {
-                    return m_destination.append(data);
+                    return Si::append_file(m_destination, file, size);
                 });
         }
 
         Error flush()
+        {
+            return flush_buffer(false);
+        }
+
+        /// Marks the end of a message like an HTTP response. The message is
+        /// passed on unless the sink is corked.
+        Error end_message()
+        {
+            if (m_corked)
+            {
+                return detail::default_construct<Error>();
+            }
+            return flush();
+        }
+
+        /// Like TCP_CORK: until uncork() is called, data is only passed on
+        /// when the buffer is full. Neither the flush policy nor
+        /// end_message() cause partial writes. flush() still works.
+        void cork() BOOST_NOEXCEPT
+        {
+            m_corked = true;
+        }
+
+        /// Passes on everything that has been held back by cork().
+        Error uncork()
+        {
+            m_corked = false;
+            return flush();
+        }
+
+        bool is_corked() const BOOST_NOEXCEPT
+        {
+            return m_corked;
+        }
+
+        Buffer const &buffer() const
+        {
+            return m_fallback_buffer;
+        }
+
+        FlushPolicy &flush_policy()
+        {
+            return m_policy;
+        }
+
+    private:
+        typedef typename detail::is_adaptive_buffer<Buffer>::type is_adaptive;
+
+        Next m_destination;
+        Buffer m_fallback_buffer;
+        FlushPolicy m_policy;
+        std::size_t m_buffer_used;
+        std::size_t m_append_space;
+        bool m_corked;
+
+        Error flush_buffer(bool overflowed)
         {
             return detail::then(
                 [this]
@@ -83,17 +241,69 @@ namespace Si
                         m_fallback_buffer.data(),
                         m_fallback_buffer.data() + m_buffer_used));
                 },
-                [this]
+                [this, overflowed]
                 {
-                    m_buffer_used = 0;
+                    emptied(overflowed);
                     return Error();
                 });
         }
 
-    private:
-        Next m_destination;
-        Buffer m_fallback_buffer;
-        std::size_t m_buffer_used;
+        void emptied(bool overflowed)
+        {
+            std::size_t const used = m_buffer_used;
+            m_buffer_used = 0;
+            m_policy.flushed();
+            detail::buffer_flushed(
+                m_fallback_buffer, overflowed, used, is_adaptive());
+        }
+
+        /// The destination can write the buffered data and the new data in
+        /// one operation, so there is no need for a separate flush.
+        Error append_unbuffered(iterator_range<element_type const *> data,
+                                std::true_type)
+        {
+            if (m_buffer_used == 0)
+            {
+                return detail::then(
+                    [this, &data]
+                    {
+                        return m_destination.append(data);
+                    },
+                    [this]
+                    {
+                        emptied(true);
+                        return Error();
+                    });
+            }
+            std::array<iterator_range<element_type const *>, 2> const
+                ranges = {{make_iterator_range(m_fallback_buffer.data(),
+                                               m_fallback_buffer.data() +
+                                                   m_buffer_used),
+                           data}};
+            Error error = Si::append_ranges(
+                m_destination,
+                make_iterator_range(ranges.data(),
+                                    ranges.data() + ranges.size()));
+            if (!error)
+            {
+                emptied(true);
+            }
+            return error;
+        }
+
+        Error append_unbuffered(iterator_range<element_type const *> data,
+                                std::false_type)
+        {
+            return detail::then(
+                [this]
+                {
+                    return this->flush_buffer(true);
+                },
+                [this, &data]
+                {
+                    return m_destination.append(data);
+                });
+        }
     };
 
     template <class Next>
@@ -105,6 +315,28 @@ namespace Si
         return buffering_sink<typename std::decay<Next>::type>(
             std::forward<Next>(next));
     }
+
+    template <class Next, class FlushPolicy>
+    auto make_buffering_sink(Next &&next, FlushPolicy policy)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> buffering_sink<
+            typename std::decay<Next>::type,
+            typename std::decay<Next>::type::error_type,
+            std::array<typename std::decay<Next>::type::element_type,
+                       ((1U << 13U) / sizeof(typename std::decay<
+                                             Next>::type::element_type))>,
+            FlushPolicy>
+#endif
+    {
+        typedef typename std::decay<Next>::type clean;
+        typedef buffering_sink<
+            clean, typename clean::error_type,
+            std::array<typename clean::element_type,
+                       ((1U << 13U) / sizeof(typename clean::element_type))>,
+            FlushPolicy> result;
+        return result(std::forward<Next>(next), typename result::buffer_type(),
+                      std::move(policy));
+    }
 #endif
 }
 
@@ -3,26 +3,277 @@
 
 #include <silicium/sink/append.hpp>
 #include <silicium/source/source.hpp>
+#include <array>
+#include <limits>
 
 namespace Si
 {
+    template <class Error>
+    struct copy_result
+    {
+        /// The number of elements that the sink has accepted.
+        std::size_t copied;
+
+        /// The first error returned by the sink. Copying stops there.
+        Error error;
+    };
+
+    namespace detail
+    {
+        template <class Sink>
+        struct has_append_space
+        {
+        private:
+            typedef typename std::decay<Sink>::type clean;
+
+            template <class T>
+            static std::true_type
+            check(T *, decltype(std::declval<T &>().make_append_space(
+                           std::size_t())) * = nullptr,
+                  decltype(std::declval<T &>().flush_append_space()) * =
+                      nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<clean *>(nullptr))) type;
+            static bool const value = type::value;
+        };
+
+        /// Lets the source write directly into the memory of a buffering
+        /// sink. The space is filled completely before it is handed back so
+        /// that a sink that passes its buffer on in flush_append_space() only
+        /// does so for full buffers and once more when the source has ended.
+        /// Returns the number of elements moved or nothing if the sink has no
+        /// space to offer.
+        template <class Source, class Sink, class Error>
+        optional<std::size_t> copy_block_into_sink(Source &from, Sink &to,
+                                                   std::size_t size,
+                                                   Error &error,
+                                                   std::true_type)
+        {
+            typedef typename std::decay<Sink>::type::element_type element;
+            iterator_range<element *> space = to.make_append_space(size);
+            if (space.empty())
+            {
+                error = to.flush_append_space();
+                if (error)
+                {
+                    return std::size_t(0);
+                }
+                space = to.make_append_space(size);
+                if (space.empty())
+                {
+                    return none;
+                }
+            }
+            element *end = space.begin();
+            while (end != space.end())
+            {
+                element *const filled =
+                    from.copy_next(make_iterator_range(end, space.end()));
+                if (filled == end)
+                {
+                    break;
+                }
+                end = filled;
+            }
+            std::size_t const moved =
+                static_cast<std::size_t>(end - space.begin());
+            to.make_append_space(moved);
+            error = to.flush_append_space();
+            return moved;
+        }
+
+        template <class Source, class Sink, class Error>
+        optional<std::size_t> copy_block_into_sink(Source &, Sink &,
+                                                   std::size_t, Error &,
+                                                   std::false_type)
+        {
+            return none;
+        }
+
+        template <class Source, class Sink>
+        copy_result<typename error_type<Sink>::type>
+        copy_blocks(Source &from, Sink &to, std::size_t limit, std::true_type)
+        {
+            typedef typename std::decay<Source>::type::element_type element;
+            typedef typename error_type<Sink>::type error;
+            copy_result<error> result = {0, error()};
+            std::array<element, copy_block_size<element>::value> buffer;
+            while (result.copied < limit)
+            {
+                std::size_t const wanted = limit - result.copied;
+                std::size_t const block = (std::min)(wanted, buffer.size());
+
+                // the source has the elements in memory already. Asking for
+                // more than a block could make a source like
+                // mapped_file_source map the whole rest of its input.
+                iterator_range<element const *> const mapped =
+                    Si::try_map_next(from, block);
+                if (!mapped.empty())
+                {
+                    std::size_t const count = (std::min)(
+                        wanted, static_cast<std::size_t>(mapped.size()));
+                    result.error = to.append(make_iterator_range(
+                        mapped.begin(), mapped.begin() + count));
+                    if (result.error)
+                    {
+                        break;
+                    }
+                    Si::skip(from, count);
+                    result.copied += count;
+                    continue;
+                }
+
+                optional<std::size_t> const moved_into_sink =
+                    copy_block_into_sink(
+                        from, to, block, result.error,
+                        typename has_append_space<Sink>::type());
+                if (moved_into_sink)
+                {
+                    if (result.error || (*moved_into_sink == 0))
+                    {
+                        break;
+                    }
+                    result.copied += *moved_into_sink;
+                    continue;
+                }
+
+                element *const end = from.copy_next(
+                    make_iterator_range(buffer.data(), buffer.data() + block));
+                if (end == buffer.data())
+                {
+                    break;
+                }
+                result.error = to.append(
+                    iterator_range<element const *>(buffer.data(), end));
+                if (result.error)
+                {
+                    break;
+                }
+                result.copied += static_cast<std::size_t>(end - buffer.data());
+            }
+            return result;
+        }
+
+        /// Appends what the source has mapped. Returns false if nothing could
+        /// be mapped.
+        template <class Source, class Sink, class Error>
+        bool copy_mapped(Source &from, Sink &to, std::size_t limit,
+                         copy_result<Error> &result, std::true_type)
+        {
+            typedef typename std::decay<Source>::type::element_type element;
+            std::size_t const wanted = limit - result.copied;
+            auto const mapped = Si::try_map_next(
+                from, (std::min)(wanted, copy_block_size<element>::value));
+            if (mapped.empty())
+            {
+                return false;
+            }
+            std::size_t const count =
+                (std::min)(wanted, static_cast<std::size_t>(mapped.size()));
+            result.error = to.append(
+                make_iterator_range(mapped.begin(), mapped.begin() + count));
+            if (!result.error)
+            {
+                Si::skip(from, count);
+                result.copied += count;
+            }
+            return true;
+        }
+
+        template <class Source, class Sink, class Error>
+        bool copy_mapped(Source &, Sink &, std::size_t, copy_result<Error> &,
+                         std::false_type)
+        {
+            return false;
+        }
+
+        template <class Source>
+        optional<typename Source::element_type> get_one(Source &from,
+                                                        std::true_type)
+        {
+            return Si::get(from);
+        }
+
+        /// copy_next needs constructed elements to write into, so a source
+        /// that cannot map its elements has nothing to offer here.
+        template <class Source>
+        optional<typename Source::element_type> get_one(Source &,
+                                                        std::false_type)
+        {
+            return none;
+        }
+
+        /// Copies element by element for element types that cannot live in
+        /// a stack buffer because they are not default-constructible or
+        /// that have to be converted.
+        template <class Source, class Sink>
+        copy_result<typename error_type<Sink>::type>
+        copy_blocks(Source &from, Sink &to, std::size_t limit, std::false_type)
+        {
+            typedef typename std::decay<Source>::type::element_type
+                source_element;
+            typedef typename error_type<Sink>::type error;
+            copy_result<error> result = {0, error()};
+            while (result.copied < limit)
+            {
+                if (copy_mapped(
+                        from, to, limit, result,
+                        std::is_same<
+                            source_element,
+                            typename std::decay<Sink>::type::element_type>()))
+                {
+                    if (result.error)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                auto element = get_one(
+                    from, std::is_default_constructible<source_element>());
+                if (!element)
+                {
+                    break;
+                }
+                result.error = Si::append(to, std::move(*element));
+                if (result.error)
+                {
+                    break;
+                }
+                ++result.copied;
+            }
+            return result;
+        }
+    }
+
+    /// Appends the elements of from to to until the source ends, limit
+    /// elements have been copied or the sink fails. Elements are moved in
+    /// blocks: straight from where the source has them in memory if it
+    /// supports map_next and skip, into the buffer of the sink if it has
+    /// make_append_space, or through a buffer on the stack otherwise.
+    /// Elements that are not default-constructible are copied one by one
+    /// unless the source can map them.
     template <class Source, class Sink>
     typename std::enable_if<
         std::is_convertible<
             typename std::decay<Source>::type::element_type,
             typename std::decay<Sink>::type::element_type>::value,
-        void>::type
-    copy(Source &&from, Sink &&to)
+        copy_result<typename error_type<Sink>::type>>::type
+    copy(Source &&from, Sink &&to,
+         std::size_t limit = (std::numeric_limits<std::size_t>::max)())
     {
-        for (;;)
-        {
-            auto element = Si::get(from);
-            if (!element)
-            {
-                break;
-            }
-            Si::append(to, std::move(*element));
-        }
+        typedef typename std::decay<Source>::type::element_type
+            source_element;
+        return detail::copy_blocks(
+            from, to, limit,
+            std::integral_constant<
+                bool,
+                std::is_same<source_element,
+                             typename std::decay<Sink>::type::element_type>::
+                        value &&
+                    std::is_default_constructible<source_element>::value>());
     }
 }
 
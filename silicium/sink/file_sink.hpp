@@ -3,6 +3,7 @@
 
 #include <silicium/native_file_descriptor.hpp>
 #include <silicium/write.hpp>
+#include <silicium/transfer_file.hpp>
 
 namespace Si
 {
@@ -21,6 +22,18 @@ namespace Si
             return write(m_file, data).error();
         }
 
+        error_type append_ranges(
+            iterator_range<iterator_range<element_type const *> const *>
+                ranges)
+        {
+            return write_ranges(m_file, ranges).error();
+        }
+
+        error_type append_file(native_file_descriptor file, std::size_t size)
+        {
+            return transfer_file(file, m_file, size).error();
+        }
+
     private:
         native_file_descriptor m_file;
     };
@@ -0,0 +1,54 @@
+#ifndef SILICIUM_SINK_FLUSH_POLICY_HPP
+#define SILICIUM_SINK_FLUSH_POLICY_HPP
+
+#include <silicium/config.hpp>
+#include <cstddef>
+
+namespace Si
+{
+    /// A flush policy decides when buffering_sink passes its data on before
+    /// the buffer is full. should_flush is called with the sink after data
+    /// has been buffered. flushed is called whenever the buffer has been
+    /// emptied, regardless of what caused it.
+    ///
+    /// manual_flush leaves that to explicit calls of flush().
+    struct manual_flush
+    {
+        template <class Sink>
+        bool should_flush(Sink &, std::size_t, std::size_t) BOOST_NOEXCEPT
+        {
+            return false;
+        }
+
+        void flushed() BOOST_NOEXCEPT
+        {
+        }
+    };
+
+    /// Flushes as soon as high_watermark elements are buffered, so that a
+    /// large buffer can absorb bursts without delaying a steady stream by a
+    /// whole buffer.
+    struct watermark_flush
+    {
+        explicit watermark_flush(std::size_t high_watermark) BOOST_NOEXCEPT
+            : m_high_watermark(high_watermark)
+        {
+        }
+
+        template <class Sink>
+        bool should_flush(Sink &, std::size_t buffered,
+                          std::size_t) const BOOST_NOEXCEPT
+        {
+            return buffered >= m_high_watermark;
+        }
+
+        void flushed() BOOST_NOEXCEPT
+        {
+        }
+
+    private:
+        std::size_t m_high_watermark;
+    };
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef SILICIUM_SINK_POOLED_BUFFER_HPP
+#define SILICIUM_SINK_POOLED_BUFFER_HPP
+
+#include <silicium/sink/buffering_sink.hpp>
+#include <silicium/buffer_pool.hpp>
+
+namespace Si
+{
+#if SILICIUM_HAS_BUFFERING_SINK
+    /// A buffer for buffering_sink that borrows its memory from a
+    /// buffer_pool. It only holds a block while there is data to buffer and
+    /// gives it back when the sink is flushed explicitly, for example at the
+    /// end of a response. When data keeps overflowing the buffer, the next
+    /// block is twice as large, up to the ceiling. A message that fits
+    /// into less than half of the block makes the next block half as large.
+    template <class Element>
+    struct pooled_buffer
+    {
+        static_assert(std::is_trivial<Element>::value,
+                      "The pool hands out uninitialized memory");
+
+        pooled_buffer()
+            : m_pool(nullptr)
+            , m_ceiling(0)
+            , m_preferred_size(0)
+            , m_overflows(0)
+        {
+        }
+
+        /// ceiling is the largest block in bytes that the buffer grows to.
+        explicit pooled_buffer(buffer_pool &pool,
+                               std::size_t ceiling = 256 * 1024)
+            : m_pool(&pool)
+            , m_ceiling((std::min)(ceiling, pool.maximum_size()))
+            , m_preferred_size(pool.minimum_size())
+            , m_overflows(0)
+        {
+        }
+
+        Element *data() const BOOST_NOEXCEPT
+        {
+            return reinterpret_cast<Element *>(m_block.data());
+        }
+
+        Element *begin() const BOOST_NOEXCEPT
+        {
+            return data();
+        }
+
+        /// The number of elements in the current block or zero.
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return m_block.size() / sizeof(Element);
+        }
+
+        /// The size in bytes of the next block that will be acquired.
+        std::size_t preferred_size() const BOOST_NOEXCEPT
+        {
+            return m_preferred_size;
+        }
+
+        void prepare()
+        {
+            if (m_block.data() || !m_pool)
+            {
+                return;
+            }
+            m_block = m_pool->acquire(m_preferred_size);
+        }
+
+        /// used is the number of elements that were in the block.
+        void flushed(bool overflowed, std::size_t used)
+        {
+            if (overflowed)
+            {
+                // a single large append is not a reason to grow yet
+                ++m_overflows;
+                if ((m_overflows >= 2) && (m_preferred_size < m_ceiling))
+                {
+                    m_preferred_size =
+                        (std::min)(m_preferred_size * 2, m_ceiling);
+                    m_overflows = 0;
+                    m_block = pooled_block();
+                }
+                return;
+            }
+            if ((m_overflows == 0) && m_pool &&
+                (m_preferred_size > m_pool->minimum_size()) &&
+                (used < (size() / 2)))
+            {
+                m_preferred_size /= 2;
+            }
+            m_overflows = 0;
+            m_block = pooled_block();
+        }
+
+    private:
+        buffer_pool *m_pool;
+        std::size_t m_ceiling;
+        std::size_t m_preferred_size;
+        std::size_t m_overflows;
+        pooled_block m_block;
+    };
+
+    template <class Next>
+    auto make_pooled_buffering_sink(Next &&next, buffer_pool &pool,
+                                    std::size_t ceiling = 256 * 1024)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> buffering_sink<
+            typename std::decay<Next>::type,
+            typename std::decay<Next>::type::error_type,
+            pooled_buffer<typename std::decay<Next>::type::element_type>>
+#endif
+    {
+        typedef typename std::decay<Next>::type clean;
+        typedef pooled_buffer<typename clean::element_type> buffer;
+        return buffering_sink<clean, typename clean::error_type, buffer>(
+            std::forward<Next>(next), buffer(pool, ceiling));
+    }
+#endif
+}
+
+#endif
@@ -1,7 +1,8 @@
 #ifndef SILICIUM_PTR_SINK_HPP
 #define SILICIUM_PTR_SINK_HPP
 
-#include <silicium/sink/sink.hpp>
+#include <silicium/sink/append_ranges.hpp>
+#include <silicium/sink/append_file.hpp>
 
 namespace Si
 {
@@ -26,6 +27,18 @@ namespace Si
             return next->append(data);
         }
 
+        error_type append_ranges(
+            typename range_sequence<element_type>::type ranges) const
+        {
+            return Si::append_ranges(*next, ranges);
+        }
+
+        error_type append_file(native_file_descriptor file,
+                               std::size_t size) const
+        {
+            return Si::append_file(*next, file, size);
+        }
+
     private:
         Pointer next;
     };
@@ -8,10 +8,38 @@
 
 namespace Si
 {
+    namespace detail
+    {
+        /// The default of Sink::append_ranges.
+        template <class Sink>
+        typename Sink::error_type append_each_range(
+            Sink &out,
+            iterator_range<iterator_range<typename Sink::element_type const *>
+                               const *> ranges)
+        {
+            for (auto const &range : ranges)
+            {
+                auto error = out.append(range);
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return typename Sink::error_type();
+        }
+    }
+
+    /// Sinks do not have to implement append_ranges. An erased sink passes
+    /// all ranges to the implementation with one virtual call, and the
+    /// implementation appends them one after another if it cannot do
+    /// better.
     template <class Element, class Error = success>
-    SILICIUM_TRAIT_WITH_TYPEDEFS(
+    SILICIUM_TRAIT_WITH_DEFAULTS(
         Sink, typedef Element element_type; typedef Error error_type;
-        , ((append, (1, (iterator_range<element_type const *>)), error_type)))
+        , ((append, (1, (iterator_range<element_type const *>)), error_type)),
+        ((append_ranges,
+          (1, (iterator_range<iterator_range<element_type const *> const *>)),
+          error_type, , Si::detail::append_each_range)))
 
 #if SILICIUM_COMPILER_HAS_USING
     template <class Element, class Error = boost::system::error_code>
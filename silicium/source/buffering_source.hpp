@@ -64,6 +64,12 @@ namespace Si
             return result;
         }
 
+        /// map_next pulls into the buffer, so mapping always works.
+        virtual bool can_map() const SILICIUM_OVERRIDE
+        {
+            return true;
+        }
+
         virtual std::size_t skip(std::size_t count) SILICIUM_OVERRIDE
         {
             assert(m_next);
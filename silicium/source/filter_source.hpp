@@ -3,10 +3,23 @@
 
 #include <silicium/source/source.hpp>
 #include <silicium/detail/proper_value_function.hpp>
+#include <silicium/detail/pull_buffer.hpp>
 #include <boost/concept_check.hpp>
+#include <algorithm>
+#include <type_traits>
 
 namespace Si
 {
+    /// Forwards the elements of another source for which a predicate
+    /// returns true. The input is pulled in batches that are filtered in
+    /// place in a tight loop. Propagated elements that do not fit into the
+    /// destination are kept for the next call, and map_next makes them
+    /// available without another copy.
+    ///
+    /// Batches need elements that can be default-constructed. Without that,
+    /// the input is filtered element by element, map_next returns nothing
+    /// and there is no skip, because an element can only be tested after it
+    /// has been copied into a slot of the caller.
     template <class Input, class Predicate>
     struct filter_source
     {
@@ -16,35 +29,52 @@ namespace Si
         {
         }
 
-        filter_source(Input input, Predicate is_propagated)
+        filter_source(Input input, Predicate is_propagated,
+                      std::size_t batch_size = detail::default_pull_batch_size)
             : input(std::move(input))
             , is_propagated(std::move(is_propagated))
+            , pulled(batch_size)
         {
         }
 
+        /// Maps the propagated elements of the current batch.
         iterator_range<element_type const *> map_next(std::size_t size)
         {
             boost::ignore_unused_variable_warning(size);
-            throw std::logic_error("todo");
+            return map_next(is_batched());
         }
 
         element_type *copy_next(iterator_range<element_type *> destination)
         {
-            element_type *copied = destination.begin();
-            for (; copied != destination.end();)
+            return copy_next(destination, is_batched());
+        }
+
+        /// Only available with batches.
+        template <class Element = element_type>
+        typename std::enable_if<std::is_default_constructible<Element>::value,
+                                std::size_t>::type
+        skip(std::size_t count)
+        {
+            std::size_t skipped = 0;
+            while (skipped < count)
             {
-                auto element = Si::get(input);
-                if (!element)
+                std::size_t const available =
+                    static_cast<std::size_t>(map_next(count - skipped).size());
+                if (available == 0)
                 {
                     break;
                 }
-                if (is_propagated(*element))
-                {
-                    *copied = std::move(*element);
-                    ++copied;
-                }
+                std::size_t const step = (std::min)(count - skipped, available);
+                pulled.consume(step);
+                skipped += step;
             }
-            return copied;
+            return skipped;
+        }
+
+        /// Upstream is read in batches of this size anyway.
+        std::size_t preferred_batch_size() const
+        {
+            return pulled.batch_size();
         }
 
     private:
@@ -57,8 +87,102 @@ namespace Si
 #endif
                 proper_predicate;
 
+        typedef std::is_default_constructible<element_type> is_batched;
+
         Input input;
         proper_predicate is_propagated;
+        detail::pull_buffer<element_type> pulled;
+
+        iterator_range<element_type const *> map_next(std::true_type)
+        {
+            if (pulled.available().empty())
+            {
+                refill();
+            }
+            iterator_range<element_type *> const available = pulled.available();
+            return iterator_range<element_type const *>(
+                available.begin(), available.end());
+        }
+
+        iterator_range<element_type const *> map_next(std::false_type)
+        {
+            return iterator_range<element_type const *>();
+        }
+
+        element_type *copy_next(iterator_range<element_type *> destination,
+                                std::true_type)
+        {
+            element_type *copied = destination.begin();
+            while (copied != destination.end())
+            {
+                iterator_range<element_type *> available = pulled.available();
+                if (available.empty())
+                {
+                    if (!refill())
+                    {
+                        break;
+                    }
+                    available = pulled.available();
+                }
+                std::size_t const count = (std::min)(
+                    static_cast<std::size_t>(available.size()),
+                    static_cast<std::size_t>(destination.end() - copied));
+                copied = std::move(
+                    available.begin(), available.begin() + count, copied);
+                pulled.consume(count);
+            }
+            return copied;
+        }
+
+        /// Every element is read into the next free slot of destination,
+        /// which is used again if the element is not propagated.
+        element_type *copy_next(iterator_range<element_type *> destination,
+                                std::false_type)
+        {
+            element_type *copied = destination.begin();
+            while (copied != destination.end())
+            {
+                if (input.copy_next(make_iterator_range(copied, copied + 1)) ==
+                    copied)
+                {
+                    break;
+                }
+                if (is_propagated(*copied))
+                {
+                    ++copied;
+                }
+            }
+            return copied;
+        }
+
+        /// Pulls batches until one of them contains a propagated element.
+        /// The batch is filtered in place, so that it only contains the
+        /// propagated elements afterwards.
+        bool refill()
+        {
+            return pulled.refill_with(
+                [this](iterator_range<element_type *> batch) -> element_type *
+                {
+                    for (;;)
+                    {
+                        element_type *const end = input.copy_next(batch);
+                        if (end == batch.begin())
+                        {
+                            return end;
+                        }
+                        element_type *const kept = std::remove_if(
+                            batch.begin(), end,
+                            [this](element_type const &element)
+                            {
+                                return !is_propagated(element);
+                            });
+                        if (kept != batch.begin())
+                        {
+                            return kept;
+                        }
+                    }
+                });
+        }
     };
 
     template <class Input, class Predicate>
@@ -0,0 +1,204 @@
+#ifndef SILICIUM_LINE_VIEW_SOURCE_HPP
+#define SILICIUM_LINE_VIEW_SOURCE_HPP
+
+#include <silicium/source/source.hpp>
+#include <silicium/memory_range.hpp>
+#include <cstring>
+#include <vector>
+
+namespace Si
+{
+    /// Splits a source of characters into lines that end with LF or CR LF.
+    /// The lines are views without the terminator. A line that lies within
+    /// the window the input maps points directly into the input. Only a
+    /// line that spans several windows is assembled in an internal buffer
+    /// that is reused for the next such line. The views are valid until the
+    /// next call to this source.
+    ///
+    /// Lines are found with memchr in whatever the input maps. Inputs that
+    /// cannot map and skip are read one character at a time. The input is
+    /// not consumed beyond the lines that have been read, so that it can be
+    /// used directly after them, for example for an HTTP body. Only a last
+    /// line without a terminator is consumed without being returned.
+    template <class Next>
+    struct line_view_source
+    {
+        typedef memory_range element_type;
+
+        line_view_source()
+            : m_next(nullptr)
+            , m_window_size(0)
+            , m_has_peeked(false)
+        {
+        }
+
+        /// window_size is the number of characters requested from
+        /// next.map_next at once.
+        explicit line_view_source(Next &next, std::size_t window_size = 4096)
+            : m_next(&next)
+            , m_window_size(window_size)
+            , m_has_peeked(false)
+        {
+        }
+
+        /// Maps the next line without consuming it.
+        iterator_range<memory_range const *> map_next(std::size_t size)
+        {
+            if ((size == 0) || (!m_has_peeked && !read_line(m_peeked, true)))
+            {
+                return iterator_range<memory_range const *>();
+            }
+            m_has_peeked = true;
+            return make_iterator_range(&m_peeked, &m_peeked + 1);
+        }
+
+        /// Returns the lines that fit into the destination. Only the first
+        /// line may cause the input to be asked for more characters, so
+        /// that the other views stay valid. All lines after the first one
+        /// therefore come from the current window of the input.
+        memory_range *copy_next(iterator_range<memory_range *> destination)
+        {
+            memory_range *i = destination.begin();
+            bool may_refill = true;
+            if (m_has_peeked && (i != destination.end()))
+            {
+                *i = m_peeked;
+                m_has_peeked = false;
+                may_refill = false;
+                ++i;
+            }
+            for (; i != destination.end(); ++i)
+            {
+                if (!read_line(*i, may_refill))
+                {
+                    break;
+                }
+                may_refill = false;
+            }
+            return i;
+        }
+
+        std::size_t skip(std::size_t count)
+        {
+            std::size_t skipped = 0;
+            if (m_has_peeked && (count > 0))
+            {
+                m_has_peeked = false;
+                ++skipped;
+            }
+            memory_range discarded;
+            for (; skipped < count; ++skipped)
+            {
+                if (!read_line(discarded, true))
+                {
+                    break;
+                }
+            }
+            return skipped;
+        }
+
+    private:
+        Next *m_next;
+        std::size_t m_window_size;
+        memory_range m_window;
+        std::vector<char> m_spanning;
+        memory_range m_peeked;
+        bool m_has_peeked;
+
+        bool read_line(memory_range &line, bool may_refill)
+        {
+            assert(m_next);
+            if (!may_refill)
+            {
+                char const *const lf = find_lf();
+                if (!lf)
+                {
+                    return false;
+                }
+                line = without_cr(make_memory_range(m_window.begin(), lf));
+                consume(static_cast<std::size_t>(lf + 1 - m_window.begin()));
+                return true;
+            }
+            m_spanning.clear();
+            bool spans = false;
+            // the input may have been used directly since the last call
+            m_window = memory_range();
+            for (;;)
+            {
+                if (m_window.empty())
+                {
+                    m_window = try_map_next(*m_next, m_window_size);
+                }
+                if (m_window.empty())
+                {
+                    auto c = get(*m_next);
+                    if (!c)
+                    {
+                        return false;
+                    }
+                    if (*c == '\n')
+                    {
+                        break;
+                    }
+                    m_spanning.push_back(*c);
+                    spans = true;
+                    continue;
+                }
+                char const *const lf = find_lf();
+                if (lf && !spans)
+                {
+                    line = without_cr(make_memory_range(m_window.begin(), lf));
+                    consume(
+                        static_cast<std::size_t>(lf + 1 - m_window.begin()));
+                    return true;
+                }
+                char const *const end = lf ? lf : m_window.end();
+                m_spanning.insert(m_spanning.end(), m_window.begin(), end);
+                spans = true;
+                consume(static_cast<std::size_t>(
+                    (lf ? (lf + 1) : end) - m_window.begin()));
+                if (lf)
+                {
+                    break;
+                }
+            }
+            line = without_cr(make_memory_range(
+                m_spanning.data(), m_spanning.data() + m_spanning.size()));
+            return true;
+        }
+
+        char const *find_lf() const
+        {
+            if (m_window.empty())
+            {
+                return nullptr;
+            }
+            return static_cast<char const *>(
+                std::memchr(m_window.begin(), '\n',
+                            static_cast<std::size_t>(m_window.size())));
+        }
+
+        void consume(std::size_t count)
+        {
+            m_window.pop_front(static_cast<std::ptrdiff_t>(count));
+            Si::skip(*m_next, count);
+        }
+
+        static memory_range without_cr(memory_range line)
+        {
+            if (!line.empty() && (line.end()[-1] == '\r'))
+            {
+                return memory_range(line.begin(), line.end() - 1);
+            }
+            return line;
+        }
+    };
+
+    template <class Next>
+    line_view_source<Next> make_line_view_source(Next &next)
+    {
+        return line_view_source<Next>(next);
+    }
+}
+
+#endif
@@ -0,0 +1,351 @@
+#ifndef SILICIUM_MAPPED_FILE_SOURCE_HPP
+#define SILICIUM_MAPPED_FILE_SOURCE_HPP
+
+#include <silicium/source/source.hpp>
+#include <silicium/native_file_descriptor.hpp>
+#include <silicium/throw_last_error.hpp>
+#include <silicium/error_or.hpp>
+#include <silicium/exchange.hpp>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define SILICIUM_HAS_MAPPED_FILE_SOURCE 0
+#else
+#define SILICIUM_HAS_MAPPED_FILE_SOURCE SILICIUM_HAS_EXCEPTIONS
+#endif
+
+#if SILICIUM_HAS_MAPPED_FILE_SOURCE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Si
+{
+    /// Tells the kernel how a mapped_file_source is going to be read.
+    enum class mapping_advice
+    {
+        normal,
+
+        /// The file is read from the front to the back (MADV_SEQUENTIAL).
+        /// A limited range in front of the current position is prefetched
+        /// while the source is being read.
+        sequential,
+
+        /// Read-ahead is useless (MADV_RANDOM).
+        random
+    };
+
+    /// A source of the bytes of a file that maps the file into memory
+    /// instead of reading it. map_next returns ranges that point directly
+    /// into the mapping, so a parser can work on the file without copying
+    /// anything.
+    ///
+    /// Only a window of the file is mapped at a time, so that files larger
+    /// than the available address space can be read. The file has to stay
+    /// open and must not be truncated while the source exists.
+    struct mapped_file_source
+    {
+        typedef char element_type;
+
+        static std::size_t const default_window_size =
+            (sizeof(void *) >= 8) ? (std::size_t(1) << 30U)
+                                  : (std::size_t(1) << 24U);
+
+        /// How far ahead of the current position the kernel is asked to
+        /// read when the advice is sequential.
+        static std::size_t const read_ahead_size = std::size_t(4) << 20U;
+
+        mapped_file_source() BOOST_NOEXCEPT
+            : m_file(no_file_handle),
+              m_file_size(0),
+              m_position(0),
+              m_window_size(0),
+              m_advice(mapping_advice::normal),
+              m_page_size(1),
+              m_window(nullptr),
+              m_window_offset(0),
+              m_window_length(0),
+              m_advised_end(0)
+        {
+        }
+
+        /// file_size is the number of bytes that will be read from file.
+        mapped_file_source(native_file_descriptor file,
+                           boost::uint64_t file_size,
+                           std::size_t window_size = default_window_size,
+                           mapping_advice advice = mapping_advice::sequential)
+            : m_file(file)
+            , m_file_size(file_size)
+            , m_position(0)
+            , m_window_size(window_size)
+            , m_advice(advice)
+            , m_page_size(static_cast<std::size_t>(sysconf(_SC_PAGESIZE)))
+            , m_window(nullptr)
+            , m_window_offset(0)
+            , m_window_length(0)
+            , m_advised_end(0)
+        {
+            // a window has to cover at least one page
+            m_window_size = (std::max)(m_window_size, m_page_size);
+        }
+
+        mapped_file_source(mapped_file_source &&other) BOOST_NOEXCEPT
+            : m_file(other.m_file),
+              m_file_size(other.m_file_size),
+              m_position(other.m_position),
+              m_window_size(other.m_window_size),
+              m_advice(other.m_advice),
+              m_page_size(other.m_page_size),
+              m_window(Si::exchange(other.m_window, nullptr)),
+              m_window_offset(other.m_window_offset),
+              m_window_length(Si::exchange(other.m_window_length, 0)),
+              m_advised_end(other.m_advised_end)
+        {
+        }
+
+        mapped_file_source &operator=(mapped_file_source &&other)
+            BOOST_NOEXCEPT
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~mapped_file_source() BOOST_NOEXCEPT
+        {
+            unmap();
+        }
+
+        void swap(mapped_file_source &other) BOOST_NOEXCEPT
+        {
+            using std::swap;
+            swap(m_file, other.m_file);
+            swap(m_file_size, other.m_file_size);
+            swap(m_position, other.m_position);
+            swap(m_window_size, other.m_window_size);
+            swap(m_advice, other.m_advice);
+            swap(m_page_size, other.m_page_size);
+            swap(m_window, other.m_window);
+            swap(m_window_offset, other.m_window_offset);
+            swap(m_window_length, other.m_window_length);
+            swap(m_advised_end, other.m_advised_end);
+        }
+
+        /// Returns the next size bytes (or the rest of the file) without
+        /// consuming them. If they are not contiguous in the current window,
+        /// the window is moved. Throws boost::system::system_error if mapping
+        /// fails.
+        iterator_range<element_type const *> map_next(std::size_t size)
+        {
+            boost::uint64_t const left = m_file_size - m_position;
+            if (left == 0)
+            {
+                return iterator_range<element_type const *>();
+            }
+            std::size_t const wanted = static_cast<std::size_t>(
+                (std::min)(left, static_cast<boost::uint64_t>(
+                                     (std::max)(size, std::size_t(1)))));
+            if (!is_mapped(m_position, wanted))
+            {
+                map_window(wanted);
+            }
+            read_ahead();
+            char const *const begin =
+                m_window +
+                static_cast<std::size_t>(m_position - m_window_offset);
+            return make_iterator_range(begin, begin + wanted);
+        }
+
+        element_type *copy_next(iterator_range<element_type *> destination)
+        {
+            element_type *next = destination.begin();
+            while (next != destination.end())
+            {
+                // a destination larger than a window is filled window by
+                // window
+                std::size_t const wanted = (std::min)(
+                    static_cast<std::size_t>(destination.end() - next),
+                    m_window_size);
+                iterator_range<element_type const *> const available =
+                    map_next(wanted);
+                if (available.empty())
+                {
+                    break;
+                }
+                std::size_t const copied = (std::min)(
+                    static_cast<std::size_t>(available.size()),
+                    static_cast<std::size_t>(destination.end() - next));
+                std::memcpy(next, available.begin(), copied);
+                next += copied;
+                m_position += copied;
+            }
+            return next;
+        }
+
+        /// Consumes up to count bytes without copying them, for example
+        /// after they have been looked at with map_next. Returns the number
+        /// of bytes skipped.
+        std::size_t skip(std::size_t count) BOOST_NOEXCEPT
+        {
+            std::size_t const skipped = static_cast<std::size_t>((std::min)(
+                static_cast<boost::uint64_t>(count), m_file_size - m_position));
+            m_position += skipped;
+            return skipped;
+        }
+
+        boost::uint64_t position() const BOOST_NOEXCEPT
+        {
+            return m_position;
+        }
+
+        boost::uint64_t size() const BOOST_NOEXCEPT
+        {
+            return m_file_size;
+        }
+
+    private:
+        native_file_descriptor m_file;
+        boost::uint64_t m_file_size;
+        boost::uint64_t m_position;
+        std::size_t m_window_size;
+        mapping_advice m_advice;
+        std::size_t m_page_size;
+        char const *m_window;
+        boost::uint64_t m_window_offset;
+        std::size_t m_window_length;
+
+        /// the end of the range that MADV_WILLNEED has been applied to
+        boost::uint64_t m_advised_end;
+
+        SILICIUM_DELETED_FUNCTION(
+            mapped_file_source(mapped_file_source const &))
+        SILICIUM_DELETED_FUNCTION(
+            mapped_file_source &operator=(mapped_file_source const &))
+
+        bool is_mapped(boost::uint64_t position, std::size_t length) const
+            BOOST_NOEXCEPT
+        {
+            return m_window && (position >= m_window_offset) &&
+                   ((position + length) <= (m_window_offset + m_window_length));
+        }
+
+        void map_window(std::size_t minimum_length)
+        {
+            unmap();
+            // mmap requires the offset to be a multiple of the page size
+            boost::uint64_t const offset =
+                m_position - (m_position % m_page_size);
+            std::size_t const in_front =
+                static_cast<std::size_t>(m_position - offset);
+            std::size_t const length = static_cast<std::size_t>((std::min)(
+                static_cast<boost::uint64_t>((std::max)(
+                    m_window_size, in_front + minimum_length)),
+                m_file_size - offset));
+            void *const mapped =
+                mmap(nullptr, length, PROT_READ, MAP_PRIVATE, m_file,
+                     static_cast<off_t>(offset));
+            if (mapped == MAP_FAILED)
+            {
+                throw_last_error();
+            }
+            m_window = static_cast<char const *>(mapped);
+            m_window_offset = offset;
+            m_window_length = length;
+            m_advised_end = offset;
+            advise();
+        }
+
+        void advise() BOOST_NOEXCEPT
+        {
+            void *const window =
+                const_cast<void *>(static_cast<void const *>(m_window));
+            switch (m_advice)
+            {
+            case mapping_advice::normal:
+                break;
+
+            case mapping_advice::sequential:
+                madvise(window, m_window_length, MADV_SEQUENTIAL);
+                break;
+
+            case mapping_advice::random:
+                madvise(window, m_window_length, MADV_RANDOM);
+                break;
+            }
+        }
+
+        /// Asks the kernel to read read_ahead_size bytes in front of the
+        /// current position once less than half of that is left of the
+        /// range advised before. A window can be much larger than the
+        /// memory that should be spent on prefetching.
+        void read_ahead() BOOST_NOEXCEPT
+        {
+            if ((m_advice != mapping_advice::sequential) ||
+                ((m_position + (read_ahead_size / 2)) < m_advised_end))
+            {
+                return;
+            }
+            boost::uint64_t const from = (std::max)(m_advised_end, m_position);
+            boost::uint64_t const to = (std::min)(
+                m_position + read_ahead_size, m_file_size);
+            m_advised_end = to;
+            boost::uint64_t const window_end =
+                m_window_offset + m_window_length;
+            if (from < window_end)
+            {
+                // madvise requires an address aligned to a page
+                std::size_t const begin = static_cast<std::size_t>(
+                    from - m_window_offset -
+                    ((from - m_window_offset) % m_page_size));
+                std::size_t const end = static_cast<std::size_t>(
+                    (std::min)(to, window_end) - m_window_offset);
+                madvise(const_cast<char *>(m_window) + begin, end - begin,
+                        MADV_WILLNEED);
+            }
+#ifdef POSIX_FADV_WILLNEED
+            // the part behind the window is read into the page cache so
+            // that it is ready when the next window is mapped
+            if (to > window_end)
+            {
+                boost::uint64_t const beyond = (std::max)(from, window_end);
+                posix_fadvise(m_file, static_cast<off_t>(beyond),
+                              static_cast<off_t>(to - beyond),
+                              POSIX_FADV_WILLNEED);
+            }
+#endif
+        }
+
+        void unmap() BOOST_NOEXCEPT
+        {
+            if (!m_window)
+            {
+                return;
+            }
+            munmap(const_cast<void *>(static_cast<void const *>(m_window)),
+                   m_window_length);
+            m_window = nullptr;
+            m_window_length = 0;
+        }
+    };
+
+    /// Creates a mapped_file_source for the whole file.
+    inline error_or<mapped_file_source>
+    make_mapped_file_source(native_file_descriptor file,
+                            std::size_t window_size =
+                                mapped_file_source::default_window_size,
+                            mapping_advice advice = mapping_advice::sequential)
+    {
+        struct stat status;
+        if (fstat(file, &status) < 0)
+        {
+            return get_last_error();
+        }
+        return mapped_file_source(
+            file, static_cast<boost::uint64_t>(status.st_size), window_size,
+            advice);
+    }
+}
+#endif
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <silicium/source/source.hpp>
 #include <boost/concept_check.hpp>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <array>
@@ -40,6 +41,14 @@ namespace Si
             return destination.begin();
         }
 
+        std::size_t skip(std::size_t count)
+        {
+            std::size_t const skipped =
+                (std::min)(count, static_cast<std::size_t>(m_elements.size()));
+            m_elements.pop_front(static_cast<std::ptrdiff_t>(skipped));
+            return skipped;
+        }
+
     private:
         iterator_range<Element const *> m_elements;
     };
@@ -61,7 +70,8 @@ namespace Si
         iterator_range<Element const *> map_next(std::size_t size)
         {
             boost::ignore_unused_variable_warning(size);
-            return {};
+            return iterator_range<Element const *>(
+                m_elements.begin(), m_elements.end());
         }
 
         Element *copy_next(iterator_range<Element *> destination)
@@ -75,6 +85,14 @@ namespace Si
             return destination.begin();
         }
 
+        std::size_t skip(std::size_t count)
+        {
+            std::size_t const skipped =
+                (std::min)(count, static_cast<std::size_t>(m_elements.size()));
+            m_elements.pop_front(static_cast<std::ptrdiff_t>(skipped));
+            return skipped;
+        }
+
     private:
         iterator_range<Element *> m_elements;
     };
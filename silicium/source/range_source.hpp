@@ -48,6 +48,17 @@ namespace Si
             return copied;
         }
 
+        std::size_t skip(std::size_t count)
+        {
+            std::size_t skipped = 0;
+            while (!m_range.empty() && (skipped < count))
+            {
+                m_range.pop_front();
+                ++skipped;
+            }
+            return skipped;
+        }
+
     private:
         typedef typename boost::range_iterator<ForwardRange>::type iterator;
 
@@ -78,25 +78,28 @@ namespace Si
             return copied;
         }
 
-    private:
-        Source<error_or<memory_range>>::interface *original;
-        memory_range rest;
-
         std::size_t skip(std::size_t count)
         {
             std::size_t skipped = 0;
-            std::size_t const rest_size = static_cast<std::size_t>(rest.size());
-            std::size_t const rest_skipped = std::min(count, rest_size);
-            rest.pop_front(static_cast<std::ptrdiff_t>(rest_skipped));
-            count -= rest_skipped;
-            skipped += rest_skipped;
-            if (count > 0)
+            while (skipped < count)
             {
-                // TODO
-                SILICIUM_UNREACHABLE();
+                std::size_t const available =
+                    static_cast<std::size_t>(map_next(count - skipped).size());
+                if (available == 0)
+                {
+                    break;
+                }
+                std::size_t const rest_skipped =
+                    (std::min)(count - skipped, available);
+                rest.pop_front(static_cast<std::ptrdiff_t>(rest_skipped));
+                skipped += rest_skipped;
             }
             return skipped;
         }
+
+    private:
+        Source<error_or<memory_range>>::interface *original;
+        memory_range rest;
     };
 }
 
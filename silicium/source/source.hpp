@@ -6,22 +6,249 @@
 #include <silicium/iterator_range.hpp>
 #include <silicium/optional.hpp>
 #include <boost/cstdint.hpp>
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace Si
 {
+    namespace detail
+    {
+        template <class Source>
+        struct has_skip
+        {
+        private:
+            typedef typename std::decay<Source>::type clean;
+
+            template <class T>
+            static std::true_type check(
+                T *, decltype(std::declval<T &>().skip(std::size_t())) * =
+                         nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<clean *>(nullptr))) type;
+            static bool const value = type::value;
+        };
+
+        /// The number of elements that are copied at once when neither side
+        /// provides memory for it.
+        template <class Element>
+        struct copy_block_size
+            : std::integral_constant<std::size_t,
+                                     (sizeof(Element) < 8192)
+                                         ? (8192 / sizeof(Element))
+                                         : 1>
+        {
+        };
+
+        template <class Source>
+        std::size_t skip_by_copying(Source &from, std::size_t count,
+                                    std::true_type)
+        {
+            typedef typename Source::element_type element;
+            std::array<element, copy_block_size<element>::value> discarded;
+            std::size_t skipped = 0;
+            while (skipped < count)
+            {
+                std::size_t const chunk =
+                    (std::min)(count - skipped, discarded.size());
+                element *const end = from.copy_next(
+                    make_iterator_range(discarded.data(),
+                                        discarded.data() + chunk));
+                std::size_t const copied =
+                    static_cast<std::size_t>(end - discarded.data());
+                skipped += copied;
+                if (copied < chunk)
+                {
+                    break;
+                }
+            }
+            return skipped;
+        }
+
+        /// There is no memory to copy elements into that cannot be
+        /// default-constructed.
+        template <class Source>
+        std::size_t skip_by_copying(Source &, std::size_t, std::false_type)
+        {
+            return 0;
+        }
+
+        /// The default of Source::skip.
+        template <class Source>
+        std::size_t skip_by_copying(Source &from, std::size_t count)
+        {
+            return skip_by_copying(
+                from, count,
+                std::is_default_constructible<
+                    typename Source::element_type>());
+        }
+
+        /// The default of Source::can_map. A class that derives from the
+        /// interface has to override can_map to be mapped, because older
+        /// implementations consume what they map.
+        template <class Source>
+        bool can_map_if_skippable(Source const &)
+        {
+            return has_skip<Source>::value && !std::is_abstract<Source>::value;
+        }
+
+        /// The default of Source::preferred_batch_size.
+        template <class Source>
+        std::size_t no_preferred_batch_size(Source const &)
+        {
+            return 0;
+        }
+    }
+
+    /// map_next(size) shows the next elements where they already are in
+    /// memory without consuming them, or returns an empty range if they are
+    /// not available that way. Sources that have a skip(count) member let
+    /// the caller consume what it has mapped, so that the elements never
+    /// have to be copied. copy_next consumes by copying and always works.
+    ///
+    /// Implementations do not need the other methods. Through the erased
+    /// types they let a caller skip, find out whether mapping is possible
+    /// and how many elements the source likes to deliver per call (zero if
+    /// it does not care) with a single virtual call.
     template <class Element>
-    SILICIUM_TRAIT_WITH_TYPEDEFS(
+    SILICIUM_TRAIT_WITH_DEFAULTS(
         Source, typedef Element element_type;
         ,
         ((map_next, (1, (std::size_t)), iterator_range<element_type const *>))(
-            (copy_next, (1, (iterator_range<element_type *>)), element_type *)))
+            (copy_next, (1, (iterator_range<element_type *>)), element_type *)),
+        ((skip, (1, (std::size_t)), std::size_t, ,
+          Si::detail::skip_by_copying))(
+            (can_map, (0, ()), bool, const, Si::detail::can_map_if_skippable))(
+            (preferred_batch_size, (0, ()), std::size_t, const,
+             Si::detail::no_preferred_batch_size)))
 
 #if SILICIUM_COMPILER_HAS_USING
     template <class Element>
     using source = typename Source<Element>::interface;
 #endif
 
+    namespace detail
+    {
+        template <class Source>
+        std::size_t skip(Source &from, std::size_t count, std::true_type)
+        {
+            return from.skip(count);
+        }
+
+        template <class Source>
+        std::size_t skip(Source &from, std::size_t count, std::false_type)
+        {
+            return skip_by_copying(from, count);
+        }
+
+        template <class Source>
+        struct has_can_map
+        {
+        private:
+            template <class T>
+            static std::true_type
+            check(T *, decltype(std::declval<T const &>().can_map()) * =
+                           nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<Source *>(nullptr))) type;
+        };
+
+        template <class Source>
+        bool can_map(Source const &from, std::true_type)
+        {
+            return from.can_map();
+        }
+
+        template <class Source>
+        bool can_map(Source const &, std::false_type)
+        {
+            return true;
+        }
+
+        template <class Source>
+        struct has_preferred_batch_size
+        {
+        private:
+            template <class T>
+            static std::true_type
+            check(T *,
+                  decltype(std::declval<T const &>().preferred_batch_size()) * =
+                      nullptr);
+
+            static std::false_type check(...);
+
+        public:
+            typedef decltype(check(static_cast<Source *>(nullptr))) type;
+        };
+
+        template <class Source>
+        std::size_t preferred_batch_size(Source const &from, std::true_type)
+        {
+            return from.preferred_batch_size();
+        }
+
+        template <class Source>
+        std::size_t preferred_batch_size(Source const &, std::false_type)
+        {
+            return 0;
+        }
+
+        template <class Source>
+        iterator_range<typename Source::element_type const *>
+        try_map_next(Source &from, std::size_t size, std::true_type)
+        {
+            // an erased source knows only at runtime
+            if (!can_map(from, typename has_can_map<Source>::type()))
+            {
+                return iterator_range<typename Source::element_type const *>();
+            }
+            return from.map_next(size);
+        }
+
+        template <class Source>
+        iterator_range<typename Source::element_type const *>
+        try_map_next(Source &, std::size_t, std::false_type)
+        {
+            return iterator_range<typename Source::element_type const *>();
+        }
+    }
+
+    /// Consumes up to count elements without looking at them. Uses the skip
+    /// member of the source if there is one. Returns the number of elements
+    /// skipped, which is less than count only at the end of the source.
+    template <class Source>
+    std::size_t skip(Source &from, std::size_t count)
+    {
+        return detail::skip(from, count,
+                            typename detail::has_skip<Source>::type());
+    }
+
+    /// Returns from.map_next(size) if the source can skip the mapped
+    /// elements afterwards, and an empty range otherwise. Callers that get
+    /// elements this way have to pass the number they used to Si::skip.
+    template <class Source>
+    iterator_range<typename Source::element_type const *>
+    try_map_next(Source &from, std::size_t size)
+    {
+        return detail::try_map_next(from, size,
+                                    typename detail::has_skip<Source>::type());
+    }
+
+    /// The number of elements that from likes to deliver per call of
+    /// copy_next, or zero if it does not say.
+    template <class Source>
+    std::size_t preferred_batch_size(Source const &from)
+    {
+        return detail::preferred_batch_size(
+            from, typename detail::has_preferred_batch_size<Source>::type());
+    }
+
     template <class Source>
     optional<typename Source::element_type> get(Source &from)
     {
@@ -44,9 +271,28 @@ namespace Si
     auto take(Source &from, std::size_t count) -> Sequence
     {
         Sequence taken;
+        for (;;)
+        {
+            std::size_t const rest = count - taken.size();
+            if (rest == 0)
+            {
+                return taken;
+            }
+            iterator_range<typename Source::element_type const *> const
+                mapped = try_map_next(from, rest);
+            if (mapped.empty())
+            {
+                break;
+            }
+            std::size_t const used =
+                (std::min)(rest, static_cast<std::size_t>(mapped.size()));
+            taken.insert(taken.end(), mapped.begin(), mapped.begin() + used);
+            Si::skip(from, used);
+        }
+        std::size_t const mapped_size = taken.size();
         taken.resize(count);
-        auto end = from.copy_next(
-            make_iterator_range(data(taken), data(taken) + taken.size()));
+        auto end = from.copy_next(make_iterator_range(
+            data(taken) + mapped_size, data(taken) + taken.size()));
         taken.resize(std::distance(data(taken), end));
         return taken;
     }
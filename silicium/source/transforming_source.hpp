@@ -3,11 +3,23 @@
 
 #include <silicium/iterator_range.hpp>
 #include <silicium/source/source.hpp>
+#include <silicium/detail/pull_buffer.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <algorithm>
+#include <type_traits>
 
 namespace Si
 {
+    /// Applies a transformation to every element of another source. The
+    /// elements are pulled from the original source in batches, so that the
+    /// transformation runs in a tight loop over contiguous memory. Elements
+    /// that have been pulled, but not requested yet, are kept until the next
+    /// call to copy_next. Elements that are consumed with map_next and skip
+    /// are transformed into an internal buffer first.
+    ///
+    /// Batches need elements that can be default-constructed. Without that,
+    /// the input is pulled element by element and map_next returns nothing.
     template <class From, class Transformation, class To>
     struct transforming_source
     {
@@ -18,21 +30,141 @@ namespace Si
         }
 
         template <class Transformation2>
-        explicit transforming_source(From original, Transformation2 &&transform)
+        explicit transforming_source(
+            From original, Transformation2 &&transform,
+            std::size_t batch_size = detail::default_pull_batch_size)
             : original(std::move(original))
             , transform(std::forward<Transformation2>(transform))
+            , pulled(batch_size)
         {
         }
 
+        /// Transforms the next batch into an internal buffer and maps it.
         iterator_range<To const *> map_next(std::size_t size)
         {
-            (void)size;
-            return {};
+            return map_next(size, std::is_default_constructible<To>());
         }
 
         To *copy_next(iterator_range<To *> destination)
         {
-            auto i = boost::begin(destination);
+            iterator_range<To *> const available = mapped.available();
+            std::size_t const count = (std::min)(
+                static_cast<std::size_t>(available.size()),
+                static_cast<std::size_t>(destination.size()));
+            To *const copied = std::move(available.begin(),
+                                         available.begin() + count,
+                                         boost::begin(destination));
+            mapped.consume(count);
+            return transform_next(
+                make_iterator_range(copied, boost::end(destination)),
+                std::is_default_constructible<from_element>());
+        }
+
+        std::size_t skip(std::size_t count)
+        {
+            return skip(count, std::is_default_constructible<To>());
+        }
+
+        /// Upstream is read in batches of this size anyway.
+        std::size_t preferred_batch_size() const
+        {
+            return pulled.batch_size();
+        }
+
+    private:
+        typedef typename From::element_type from_element;
+
+        From original;
+        Transformation transform;
+        detail::pull_buffer<from_element> pulled;
+        detail::pull_buffer<To> mapped;
+
+        iterator_range<To const *> map_next(std::size_t size, std::true_type)
+        {
+            if (mapped.available().empty())
+            {
+                mapped.refill_with([this](iterator_range<To *> batch)
+                                   {
+                                       return transform_next(
+                                           batch,
+                                           std::is_default_constructible<
+                                               from_element>());
+                                   });
+            }
+            iterator_range<To *> const available = mapped.available();
+            std::size_t const count = (std::min)(
+                size, static_cast<std::size_t>(available.size()));
+            return iterator_range<To const *>(
+                available.begin(), available.begin() + count);
+        }
+
+        iterator_range<To const *> map_next(std::size_t, std::false_type)
+        {
+            return iterator_range<To const *>();
+        }
+
+        std::size_t skip(std::size_t count, std::true_type)
+        {
+            std::size_t skipped = 0;
+            while (skipped < count)
+            {
+                std::size_t const available =
+                    static_cast<std::size_t>(map_next(count - skipped).size());
+                if (available == 0)
+                {
+                    break;
+                }
+                mapped.consume(available);
+                skipped += available;
+            }
+            return skipped;
+        }
+
+        /// The skipped elements are transformed anyway in case the
+        /// transformation has side effects.
+        std::size_t skip(std::size_t count, std::false_type)
+        {
+            std::size_t skipped = 0;
+            for (; skipped < count; ++skipped)
+            {
+                auto next = Si::get(original);
+                if (!next)
+                {
+                    break;
+                }
+                transform(std::move(*next));
+            }
+            return skipped;
+        }
+
+        To *transform_next(iterator_range<To *> destination, std::true_type)
+        {
+            To *i = boost::begin(destination);
+            if (i == boost::end(destination))
+            {
+                return i;
+            }
+            detail::pull_blocks(
+                pulled, original, [this, &i, &destination](
+                                      iterator_range<from_element *> block)
+                {
+                    std::size_t const count = (std::min)(
+                        static_cast<std::size_t>(block.size()),
+                        static_cast<std::size_t>(boost::end(destination) - i));
+                    from_element *const input = block.begin();
+                    for (std::size_t k = 0; k < count; ++k)
+                    {
+                        i[k] = transform(std::move(input[k]));
+                    }
+                    i += count;
+                    return std::make_pair(count, i != boost::end(destination));
+                });
+            return i;
+        }
+
+        To *transform_next(iterator_range<To *> destination, std::false_type)
+        {
+            To *i = boost::begin(destination);
             for (; i != boost::end(destination); ++i)
             {
                 auto next = Si::get(original);
@@ -44,10 +176,6 @@ namespace Si
             }
             return i;
         }
-
-    private:
-        From original;
-        Transformation transform;
     };
 
     template <class From, class Transformation>
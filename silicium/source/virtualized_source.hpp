@@ -7,7 +7,7 @@
 namespace Si
 {
     template <class Original>
-    struct virtualized_source
+    struct virtualized_source SILICIUM_FINAL
         : Source<typename Original::element_type>::interface
     {
         typedef typename Original::element_type element_type;
@@ -33,6 +33,23 @@ namespace Si
             return original.copy_next(destination);
         }
 
+        virtual std::size_t skip(std::size_t count) SILICIUM_OVERRIDE
+        {
+            return Si::skip(original, count);
+        }
+
+        virtual bool can_map() const SILICIUM_OVERRIDE
+        {
+            return detail::has_skip<Original>::value &&
+                   detail::can_map(
+                       original, typename detail::has_can_map<Original>::type());
+        }
+
+        virtual std::size_t preferred_batch_size() const SILICIUM_OVERRIDE
+        {
+            return Si::preferred_batch_size(original);
+        }
+
     private:
         Original original;
     };
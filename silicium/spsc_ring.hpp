@@ -0,0 +1,139 @@
+#ifndef SILICIUM_SPSC_RING_HPP
+#define SILICIUM_SPSC_RING_HPP
+
+#include <silicium/iterator_range.hpp>
+#include <silicium/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace Si
+{
+    namespace detail
+    {
+        /// Keeps the variables written by different threads apart so that
+        /// they do not invalidate each other's cache lines.
+        std::size_t const cache_line_size = 64;
+
+        inline std::size_t round_up_to_power_of_two(std::size_t value)
+        {
+            std::size_t result = 1;
+            while (result < value)
+            {
+                result *= 2;
+            }
+            return result;
+        }
+    }
+
+    /// A wait-free ring buffer for exactly one producer thread and one
+    /// consumer thread. push and pop transfer as many elements as possible
+    /// with a single atomic store, so batching amortizes the cost of the
+    /// synchronization.
+    template <class Element>
+    struct spsc_ring
+    {
+        typedef Element element_type;
+
+        static bool const is_multi_producer = false;
+        static bool const is_multi_consumer = false;
+
+        /// capacity is rounded up to a power of two.
+        explicit spsc_ring(std::size_t capacity)
+            : m_elements(detail::round_up_to_power_of_two(
+                  (std::max)(capacity, std::size_t(1))))
+            , m_mask(m_elements.size() - 1)
+            , m_head(0)
+            , m_cached_tail(0)
+            , m_tail(0)
+            , m_cached_head(0)
+        {
+        }
+
+        std::size_t capacity() const BOOST_NOEXCEPT
+        {
+            return m_elements.size();
+        }
+
+        /// Copies as many elements as fit into the ring and returns their
+        /// number. Only the producer thread may call this.
+        std::size_t push(iterator_range<element_type const *> elements)
+        {
+            std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+            std::size_t free = capacity() - (tail - m_cached_head);
+            if (free < static_cast<std::size_t>(elements.size()))
+            {
+                // the consumer may have made space since we last looked
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                free = capacity() - (tail - m_cached_head);
+            }
+            std::size_t const count =
+                (std::min)(free, static_cast<std::size_t>(elements.size()));
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                m_elements[(tail + i) & m_mask] = elements.begin()[i];
+            }
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /// Moves as many elements as are available into destination and
+        /// returns the end of the written part. Only the consumer thread may
+        /// call this.
+        element_type *pop(iterator_range<element_type *> destination)
+        {
+            std::size_t const head = m_head.load(std::memory_order_relaxed);
+            std::size_t available = m_cached_tail - head;
+            if (available < static_cast<std::size_t>(destination.size()))
+            {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                available = m_cached_tail - head;
+            }
+            std::size_t const count = (std::min)(
+                available, static_cast<std::size_t>(destination.size()));
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                destination.begin()[i] =
+                    std::move(m_elements[(head + i) & m_mask]);
+            }
+            m_head.store(head + count, std::memory_order_release);
+            return destination.begin() + count;
+        }
+
+        /// Whether push would transfer at least one element. The answer may
+        /// be outdated immediately unless the caller is the producer.
+        bool can_push() const BOOST_NOEXCEPT
+        {
+            return (m_tail.load(std::memory_order_acquire) -
+                    m_head.load(std::memory_order_acquire)) < capacity();
+        }
+
+        /// Whether pop would transfer at least one element. The answer may
+        /// be outdated immediately unless the caller is the consumer.
+        bool can_pop() const BOOST_NOEXCEPT
+        {
+            return m_tail.load(std::memory_order_acquire) !=
+                   m_head.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::vector<element_type> m_elements;
+        std::size_t const m_mask;
+
+        // written by the consumer
+        char m_padding0[detail::cache_line_size];
+        std::atomic<std::size_t> m_head;
+        std::size_t m_cached_tail;
+
+        // written by the producer
+        char m_padding1[detail::cache_line_size];
+        std::atomic<std::size_t> m_tail;
+        std::size_t m_cached_head;
+        char m_padding2[detail::cache_line_size];
+
+        SILICIUM_DELETED_FUNCTION(spsc_ring(spsc_ring const &))
+        SILICIUM_DELETED_FUNCTION(spsc_ring &operator=(spsc_ring const &))
+    };
+}
+
+#endif
@@ -2,11 +2,66 @@
 #define SILICIUM_TRAIT_HPP
 
 #include <silicium/to_unique.hpp>
+#include <silicium/alignment_of.hpp>
 #include <boost/preprocessor/repetition/repeat_from_to.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
 #include <boost/preprocessor/array/size.hpp>
 #include <boost/preprocessor/array/elem.hpp>
 #include <boost/preprocessor/enum_params.hpp>
+#include <boost/preprocessor/control/iif.hpp>
+#include <boost/preprocessor/logical/bool.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+namespace Si
+{
+    namespace detail
+    {
+        template <class Original, class Argument>
+        void *construct_erased_object(void *storage, Argument &&argument,
+                                      std::true_type)
+        {
+            return new (storage) Original(std::forward<Argument>(argument));
+        }
+
+        template <class Original, class Argument>
+        void *construct_erased_object(void *, Argument &&argument,
+                                      std::false_type)
+        {
+            return new Original(std::forward<Argument>(argument));
+        }
+
+        template <class Original>
+        void *move_inline_object(void *object, void *storage)
+        {
+            Original &moved = *static_cast<Original *>(object);
+            void *const result = new (storage) Original(std::move(moved));
+            moved.~Original();
+            return result;
+        }
+
+        template <class Original>
+        void *move_heap_object(void *object, void *)
+        {
+            return object;
+        }
+
+        template <class Original>
+        void destroy_inline_object(void *object)
+        {
+            static_cast<Original *>(object)->~Original();
+        }
+
+        template <class Original>
+        void destroy_heap_object(void *object)
+        {
+            delete static_cast<Original *>(object);
+        }
+    }
+}
 
 #if SILICIUM_COMPILER_GENERATES_MOVES
 #define SILICIUM_MOVABLE_MEMBER(struct_name, member_name)                      \
@@ -34,12 +89,80 @@
     (BOOST_PP_REPEAT(                                                          \
         BOOST_PP_ARRAY_SIZE(array), SILICIUM_DETAIL_MAKE_PARAMETER, array))
 
+#define SILICIUM_DETAIL_MAKE_TRAILING_PARAMETER(z, n, array)                   \
+    , BOOST_PP_ARRAY_ELEM(n, array) BOOST_PP_CAT(arg, n)
+#define SILICIUM_DETAIL_MAKE_THUNK_PARAMETERS(array)                           \
+    (void *self BOOST_PP_REPEAT(BOOST_PP_ARRAY_SIZE(array),                    \
+                                SILICIUM_DETAIL_MAKE_TRAILING_PARAMETER, array))
+
+#define SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENT(z, n, text)                     \
+    , BOOST_PP_CAT(arg, n)
+#define SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(array)                         \
+    BOOST_PP_REPEAT(BOOST_PP_ARRAY_SIZE(array),                                \
+                    SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENT, _)
+
+// A sequence cannot be empty, so the sequence of defaulted methods starts
+// with a placeholder that is skipped here.
+#define SILICIUM_DETAIL_IGNORE_DEFAULTED(r, data, i, elem)
+#define SILICIUM_DETAIL_FOR_EACH_DEFAULTED(r, macro, i, elem)                  \
+    BOOST_PP_IIF(BOOST_PP_BOOL(i), macro,                                      \
+                 SILICIUM_DETAIL_IGNORE_DEFAULTED)(r, _, i, elem)
+
+// Defaulted methods are (name, (arity, (parameters)), result, qualifiers,
+// default). The default is called with the implementation and the
+// arguments when the implementation does not have the method itself.
+#define SILICIUM_DETAIL_MAKE_DEFAULT_DISPATCH(r, data, i, elem)                \
+    template <class Original>                                                  \
+    static auto BOOST_PP_CAT(call_, i)(                                        \
+        Original &original,                                                    \
+        int BOOST_PP_REPEAT(                                                   \
+            BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(5, 1, elem)),              \
+            SILICIUM_DETAIL_MAKE_TRAILING_PARAMETER,                           \
+            BOOST_PP_TUPLE_ELEM(5, 1, elem)))                                  \
+        -> decltype(original.BOOST_PP_TUPLE_ELEM(5, 0, elem)(                  \
+            BOOST_PP_ENUM_PARAMS(                                              \
+                BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(5, 1, elem)), arg)))   \
+    {                                                                          \
+        return original.BOOST_PP_TUPLE_ELEM(5, 0, elem)(BOOST_PP_ENUM_PARAMS(  \
+            BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(5, 1, elem)), arg));       \
+    }                                                                          \
+    template <class Original>                                                  \
+    static BOOST_PP_TUPLE_ELEM(5, 2, elem) BOOST_PP_CAT(call_, i)(             \
+        Original &original,                                                    \
+        long BOOST_PP_REPEAT(                                                  \
+            BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(5, 1, elem)),              \
+            SILICIUM_DETAIL_MAKE_TRAILING_PARAMETER,                           \
+            BOOST_PP_TUPLE_ELEM(5, 1, elem)))                                  \
+    {                                                                          \
+        return BOOST_PP_TUPLE_ELEM(5, 4, elem)(                                \
+            original SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(                  \
+                BOOST_PP_TUPLE_ELEM(5, 1, elem)));                             \
+    }
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTS(typedefs, defaulted)                     \
+    struct default_dispatch                                                    \
+    {                                                                          \
+        typedefs BOOST_PP_SEQ_FOR_EACH_I(                                      \
+            SILICIUM_DETAIL_FOR_EACH_DEFAULTED,                                \
+            SILICIUM_DETAIL_MAKE_DEFAULT_DISPATCH, defaulted)                  \
+    };
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_VIRTUAL_METHOD(r, data, i, elem)        \
+    virtual BOOST_PP_TUPLE_ELEM(5, 2, elem) BOOST_PP_TUPLE_ELEM(5, 0, elem)    \
+        SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem))       \
+            BOOST_PP_TUPLE_ELEM(5, 3, elem)                                    \
+    {                                                                          \
+        return BOOST_PP_TUPLE_ELEM(5, 4, elem)(                                \
+            *this SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(                     \
+                BOOST_PP_TUPLE_ELEM(5, 1, elem)));                             \
+    }
+
 #define SILICIUM_DETAIL_MAKE_PURE_VIRTUAL_METHOD(r, data, elem)                \
     virtual BOOST_PP_TUPLE_ELEM(4, 2, elem) BOOST_PP_TUPLE_ELEM(4, 0, elem)    \
         SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(4, 1, elem))       \
             BOOST_PP_TUPLE_ELEM(4, 3, elem) = 0;
 
-#define SILICIUM_DETAIL_MAKE_INTERFACE(name, typedefs, methods)                \
+#define SILICIUM_DETAIL_MAKE_INTERFACE(name, typedefs, methods, defaulted)     \
     struct name                                                                \
     {                                                                          \
         virtual ~name()                                                        \
@@ -48,6 +171,9 @@
         typedefs                                                               \
             BOOST_PP_SEQ_FOR_EACH(SILICIUM_DETAIL_MAKE_PURE_VIRTUAL_METHOD, _, \
                                   methods)                                     \
+                BOOST_PP_SEQ_FOR_EACH_I(                                       \
+                    SILICIUM_DETAIL_FOR_EACH_DEFAULTED,                        \
+                    SILICIUM_DETAIL_MAKE_DEFAULTED_VIRTUAL_METHOD, defaulted)  \
     };
 
 #define SILICIUM_DETAIL_ERASER_METHOD_ARGUMENT(z, n, text) , BOOST_PP_CAT(_, n)
@@ -72,9 +198,30 @@
             BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(4, 1, elem)), arg));       \
     }
 
-#define SILICIUM_DETAIL_MAKE_ERASER(name, typedefs, methods)                   \
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_ERASER_METHOD(r, data, i, elem)         \
+    virtual BOOST_PP_TUPLE_ELEM(5, 2, elem) BOOST_PP_TUPLE_ELEM(5, 0, elem)    \
+        SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem))       \
+            BOOST_PP_TUPLE_ELEM(5, 3, elem) SILICIUM_OVERRIDE                  \
+    {                                                                          \
+        return default_dispatch::BOOST_PP_CAT(call_, i)(                       \
+            original, 0 SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(               \
+                          BOOST_PP_TUPLE_ELEM(5, 1, elem)));                   \
+    }
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_BOX_METHOD(r, data, i, elem)            \
+    BOOST_PP_TUPLE_ELEM(5, 2, elem)                                            \
+    BOOST_PP_TUPLE_ELEM(5, 0, elem)                                            \
+    SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem))           \
+    BOOST_PP_TUPLE_ELEM(5, 3, elem)                                            \
+    {                                                                          \
+        assert(original);                                                      \
+        return original->BOOST_PP_TUPLE_ELEM(5, 0, elem)(BOOST_PP_ENUM_PARAMS( \
+            BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(5, 1, elem)), arg));       \
+    }
+
+#define SILICIUM_DETAIL_MAKE_ERASER(name, typedefs, methods, defaulted)        \
     template <class Original>                                                  \
-    struct name : interface                                                    \
+    struct name SILICIUM_FINAL : interface                                     \
     {                                                                          \
         typedefs Original original;                                            \
         SILICIUM_MOVABLE_MEMBER(name, original)                                \
@@ -83,9 +230,12 @@
         {                                                                      \
         }                                                                      \
         BOOST_PP_SEQ_FOR_EACH(SILICIUM_DETAIL_MAKE_ERASER_METHOD, _, methods)  \
+        BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_FOR_EACH_DEFAULTED,            \
+                                SILICIUM_DETAIL_MAKE_DEFAULTED_ERASER_METHOD,  \
+                                defaulted)                                     \
     };
 
-#define SILICIUM_DETAIL_MAKE_BOX(typedefs, methods)                            \
+#define SILICIUM_DETAIL_MAKE_BOX(typedefs, methods, defaulted)                 \
     struct box                                                                 \
     {                                                                          \
         typedefs std::unique_ptr<interface> original;                          \
@@ -95,15 +245,229 @@
         {                                                                      \
         }                                                                      \
         BOOST_PP_SEQ_FOR_EACH(SILICIUM_DETAIL_MAKE_BOX_METHOD, _, methods)     \
+        BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_FOR_EACH_DEFAULTED,            \
+                                SILICIUM_DETAIL_MAKE_DEFAULTED_BOX_METHOD,     \
+                                defaulted)                                     \
         SILICIUM_DISABLE_COPY(box)                                             \
     };
 
-#define SILICIUM_SPECIALIZED_TRAIT(name, specialization, typedefs, methods)    \
+#define SILICIUM_DETAIL_MAKE_VTABLE_ENTRY(r, data, i, elem)                    \
+    BOOST_PP_TUPLE_ELEM(4, 2, elem)                                            \
+    (*BOOST_PP_CAT(method_, i))                                                \
+        SILICIUM_DETAIL_MAKE_THUNK_PARAMETERS(BOOST_PP_TUPLE_ELEM(4, 1, elem));
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_VTABLE_ENTRY(r, data, i, elem)          \
+    BOOST_PP_TUPLE_ELEM(5, 2, elem)                                            \
+    (*BOOST_PP_CAT(defaulted_, i))                                             \
+        SILICIUM_DETAIL_MAKE_THUNK_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem));
+
+#define SILICIUM_DETAIL_MAKE_VTABLE(typedefs, methods, defaulted)              \
+    struct inline_vtable                                                       \
+    {                                                                          \
+        typedefs void *(*move)(void *object, void *storage);                   \
+        void (*destroy)(void *object);                                         \
+        BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_MAKE_VTABLE_ENTRY, _, methods) \
+        BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_FOR_EACH_DEFAULTED,            \
+                                SILICIUM_DETAIL_MAKE_DEFAULTED_VTABLE_ENTRY,   \
+                                defaulted)                                     \
+    };
+
+#define SILICIUM_DETAIL_MAKE_THUNK(r, data, i, elem)                           \
+    static BOOST_PP_TUPLE_ELEM(4, 2, elem) BOOST_PP_CAT(method_, i)            \
+        SILICIUM_DETAIL_MAKE_THUNK_PARAMETERS(BOOST_PP_TUPLE_ELEM(4, 1, elem)) \
+    {                                                                          \
+        return static_cast<Original *>(self)                                   \
+            ->BOOST_PP_TUPLE_ELEM(4, 0, elem)(BOOST_PP_ENUM_PARAMS(            \
+                BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(4, 1, elem)), arg));   \
+    }
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_THUNK(r, data, i, elem)                 \
+    static BOOST_PP_TUPLE_ELEM(5, 2, elem) BOOST_PP_CAT(defaulted_, i)         \
+        SILICIUM_DETAIL_MAKE_THUNK_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem)) \
+    {                                                                          \
+        return default_dispatch::BOOST_PP_CAT(call_, i)(                       \
+            *static_cast<Original *>(self),                                    \
+            0 SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(                         \
+                BOOST_PP_TUPLE_ELEM(5, 1, elem)));                             \
+    }
+
+#define SILICIUM_DETAIL_MAKE_THUNK_POINTER(r, data, i, elem)                   \
+    , &inline_thunks<Original>::BOOST_PP_CAT(method_, i)
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_THUNK_POINTER(r, data, i, elem)         \
+    , &inline_thunks<Original>::BOOST_PP_CAT(defaulted_, i)
+
+#define SILICIUM_DETAIL_MAKE_THUNKS(typedefs, methods, defaulted)              \
+    template <class Original>                                                  \
+    struct inline_thunks                                                       \
+    {                                                                          \
+        typedefs BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_MAKE_THUNK, _,        \
+                                         methods)                              \
+            BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_FOR_EACH_DEFAULTED,        \
+                                    SILICIUM_DETAIL_MAKE_DEFAULTED_THUNK,      \
+                                    defaulted)                                 \
+    };                                                                         \
+    template <class Original>                                                  \
+    static inline_vtable const &get_inline_vtable(std::true_type)              \
+    {                                                                          \
+        static inline_vtable const vtable = {                                  \
+            &Si::detail::move_inline_object<Original>,                         \
+            &Si::detail::destroy_inline_object<Original>                       \
+                BOOST_PP_SEQ_FOR_EACH_I(                                       \
+                    SILICIUM_DETAIL_MAKE_THUNK_POINTER, _, methods)            \
+                    BOOST_PP_SEQ_FOR_EACH_I(                                   \
+                        SILICIUM_DETAIL_FOR_EACH_DEFAULTED,                    \
+                        SILICIUM_DETAIL_MAKE_DEFAULTED_THUNK_POINTER,          \
+                        defaulted)};                                           \
+        return vtable;                                                         \
+    }                                                                          \
+    template <class Original>                                                  \
+    static inline_vtable const &get_inline_vtable(std::false_type)             \
+    {                                                                          \
+        static inline_vtable const vtable = {                                  \
+            &Si::detail::move_heap_object<Original>,                           \
+            &Si::detail::destroy_heap_object<Original>                         \
+                BOOST_PP_SEQ_FOR_EACH_I(                                       \
+                    SILICIUM_DETAIL_MAKE_THUNK_POINTER, _, methods)            \
+                    BOOST_PP_SEQ_FOR_EACH_I(                                   \
+                        SILICIUM_DETAIL_FOR_EACH_DEFAULTED,                    \
+                        SILICIUM_DETAIL_MAKE_DEFAULTED_THUNK_POINTER,          \
+                        defaulted)};                                           \
+        return vtable;                                                         \
+    }
+
+#define SILICIUM_DETAIL_MAKE_INLINE_BOX_METHOD(r, data, i, elem)               \
+    BOOST_PP_TUPLE_ELEM(4, 2, elem)                                            \
+    BOOST_PP_TUPLE_ELEM(4, 0, elem)                                            \
+    SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(4, 1, elem))           \
+    BOOST_PP_TUPLE_ELEM(4, 3, elem)                                            \
+    {                                                                          \
+        assert(m_vtable);                                                      \
+        return m_vtable->BOOST_PP_CAT(method_, i)(                             \
+            m_object BOOST_PP_COMMA_IF(                                        \
+                BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(4, 1, elem)))          \
+                BOOST_PP_ENUM_PARAMS(                                          \
+                    BOOST_PP_ARRAY_SIZE(BOOST_PP_TUPLE_ELEM(4, 1, elem)),      \
+                    arg));                                                     \
+    }
+
+#define SILICIUM_DETAIL_MAKE_DEFAULTED_INLINE_BOX_METHOD(r, data, i, elem)     \
+    BOOST_PP_TUPLE_ELEM(5, 2, elem)                                            \
+    BOOST_PP_TUPLE_ELEM(5, 0, elem)                                            \
+    SILICIUM_DETAIL_MAKE_PARAMETERS(BOOST_PP_TUPLE_ELEM(5, 1, elem))           \
+    BOOST_PP_TUPLE_ELEM(5, 3, elem)                                            \
+    {                                                                          \
+        assert(m_vtable);                                                      \
+        return m_vtable->BOOST_PP_CAT(defaulted_, i)(                          \
+            m_object SILICIUM_DETAIL_MAKE_TRAILING_ARGUMENTS(                  \
+                BOOST_PP_TUPLE_ELEM(5, 1, elem)));                             \
+    }
+
+#define SILICIUM_DETAIL_MAKE_INLINE_BOX(typedefs, methods, defaulted)          \
+    template <std::size_t InlineSize>                                          \
+    struct basic_inline_box                                                    \
+    {                                                                          \
+        typedefs basic_inline_box() BOOST_NOEXCEPT : m_vtable(nullptr),        \
+                                                     m_object(nullptr)         \
+        {                                                                      \
+        }                                                                      \
+        template <class Original>                                              \
+        explicit basic_inline_box(                                             \
+            Original &&original,                                               \
+            typename std::enable_if<                                           \
+                !std::is_same<basic_inline_box,                                \
+                              typename std::decay<Original>::type>::value,     \
+                void>::type * = nullptr)                                       \
+            : m_vtable(nullptr)                                                \
+            , m_object(nullptr)                                                \
+        {                                                                      \
+            typedef typename std::decay<Original>::type clean;                 \
+            typedef std::integral_constant<                                    \
+                bool, (sizeof(clean) <= InlineSize) &&                         \
+                          (Si::alignment_of<clean>::value <=                   \
+                           Si::alignment_of<storage_type>::value) &&           \
+                          std::is_nothrow_move_constructible<clean>::value>    \
+                is_inline;                                                     \
+            m_object = Si::detail::construct_erased_object<clean>(             \
+                &m_storage, std::forward<Original>(original), is_inline());    \
+            m_vtable = &get_inline_vtable<clean>(is_inline());                 \
+        }                                                                      \
+        basic_inline_box(basic_inline_box &&other) BOOST_NOEXCEPT              \
+            : m_vtable(other.m_vtable),                                        \
+              m_object(nullptr)                                                \
+        {                                                                      \
+            if (m_vtable)                                                      \
+            {                                                                  \
+                m_object = m_vtable->move(other.m_object, &m_storage);         \
+                other.m_vtable = nullptr;                                      \
+                other.m_object = nullptr;                                      \
+            }                                                                  \
+        }                                                                      \
+        basic_inline_box &operator=(basic_inline_box &&other) BOOST_NOEXCEPT   \
+        {                                                                      \
+            if (this != &other)                                                \
+            {                                                                  \
+                reset();                                                       \
+                if (other.m_vtable)                                            \
+                {                                                              \
+                    m_object =                                                 \
+                        other.m_vtable->move(other.m_object, &m_storage);      \
+                    m_vtable = other.m_vtable;                                 \
+                    other.m_vtable = nullptr;                                  \
+                    other.m_object = nullptr;                                  \
+                }                                                              \
+            }                                                                  \
+            return *this;                                                      \
+        }                                                                      \
+        ~basic_inline_box()                                                    \
+        {                                                                      \
+            reset();                                                           \
+        }                                                                      \
+        bool operator!() const BOOST_NOEXCEPT                                  \
+        {                                                                      \
+            return !m_vtable;                                                  \
+        }                                                                      \
+        /* whether the implementation lives inside of the box */               \
+        bool is_inline() const BOOST_NOEXCEPT                                  \
+        {                                                                      \
+            return m_object == static_cast<void const *>(&m_storage);          \
+        }                                                                      \
+        BOOST_PP_SEQ_FOR_EACH_I(SILICIUM_DETAIL_MAKE_INLINE_BOX_METHOD, _,     \
+                                methods)                                       \
+        BOOST_PP_SEQ_FOR_EACH_I(                                               \
+            SILICIUM_DETAIL_FOR_EACH_DEFAULTED,                                \
+            SILICIUM_DETAIL_MAKE_DEFAULTED_INLINE_BOX_METHOD, defaulted)       \
+    private:                                                                   \
+        typedef typename std::aligned_storage<                                 \
+            InlineSize, Si::alignment_of<void *>::value>::type storage_type;   \
+        storage_type m_storage;                                                \
+        inline_vtable const *m_vtable;                                         \
+        void *m_object;                                                        \
+        void reset() BOOST_NOEXCEPT                                            \
+        {                                                                      \
+            if (m_vtable)                                                      \
+            {                                                                  \
+                m_vtable->destroy(m_object);                                   \
+                m_vtable = nullptr;                                            \
+                m_object = nullptr;                                            \
+            }                                                                  \
+        }                                                                      \
+        SILICIUM_DISABLE_COPY(basic_inline_box)                                \
+    };                                                                         \
+    typedef basic_inline_box<4 * sizeof(void *)> inline_box;
+
+#define SILICIUM_DETAIL_MAKE_TRAIT(name, specialization, typedefs, methods,    \
+                                   defaulted)                                  \
     struct name specialization                                                 \
     {                                                                          \
-        SILICIUM_DETAIL_MAKE_INTERFACE(interface, typedefs, methods)           \
-        SILICIUM_DETAIL_MAKE_ERASER(eraser, typedefs, methods)                 \
-        SILICIUM_DETAIL_MAKE_BOX(typedefs, methods)                            \
+        SILICIUM_DETAIL_MAKE_DEFAULTS(typedefs, defaulted)                     \
+        SILICIUM_DETAIL_MAKE_INTERFACE(                                        \
+            interface, typedefs, methods, defaulted)                           \
+        SILICIUM_DETAIL_MAKE_ERASER(eraser, typedefs, methods, defaulted)      \
+        SILICIUM_DETAIL_MAKE_BOX(typedefs, methods, defaulted)                 \
+        SILICIUM_DETAIL_MAKE_VTABLE(typedefs, methods, defaulted)              \
+        SILICIUM_DETAIL_MAKE_THUNKS(typedefs, methods, defaulted)              \
+        SILICIUM_DETAIL_MAKE_INLINE_BOX(typedefs, methods, defaulted)          \
         template <class Original>                                              \
         static eraser<typename std::decay<Original>::type>                     \
         erase(Original &&original)                                             \
@@ -117,8 +481,26 @@
             return box(                                                        \
                 Si::to_unique(erase(std::forward<Original>(original))));       \
         }                                                                      \
+        template <class Original>                                              \
+        static inline_box make_inline_box(Original &&original)                 \
+        {                                                                      \
+            return inline_box(std::forward<Original>(original));               \
+        }                                                                      \
     };
 
+#define SILICIUM_SPECIALIZED_TRAIT(name, specialization, typedefs, methods)    \
+    SILICIUM_DETAIL_MAKE_TRAIT(name, specialization, typedefs, methods, (_))
+
+/// Like SILICIUM_TRAIT_WITH_TYPEDEFS with additional methods that
+/// implementations do not have to provide. The methods in defaulted have
+/// a fifth element: a function that is called with the implementation and
+/// the arguments instead. Classes that derive from the interface inherit
+/// the default called with the interface itself. This way a trait can
+/// offer batch operations and capability queries without breaking the
+/// existing implementations.
+#define SILICIUM_TRAIT_WITH_DEFAULTS(name, typedefs, methods, defaulted)       \
+    SILICIUM_DETAIL_MAKE_TRAIT(name, , typedefs, methods, (_)defaulted)
+
 #define SILICIUM_TRAIT(name, methods)                                          \
     SILICIUM_SPECIALIZED_TRAIT(name, , , methods)
 
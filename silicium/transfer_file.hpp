@@ -0,0 +1,214 @@
+#ifndef SILICIUM_TRANSFER_FILE_HPP
+#define SILICIUM_TRANSFER_FILE_HPP
+
+#include <silicium/read.hpp>
+#include <silicium/write.hpp>
+#include <array>
+#include <cerrno>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#define SILICIUM_HAS_ZERO_COPY_TRANSFER 1
+#else
+#define SILICIUM_HAS_ZERO_COPY_TRANSFER 0
+#endif
+
+namespace Si
+{
+    namespace detail
+    {
+        enum class transfer_method
+        {
+            /// sendfile(2) from a regular file
+            sendfile,
+
+            /// splice(2) if one of the ends is a pipe
+            splice,
+
+            /// read and write through a buffer in user memory
+            copy
+        };
+
+        inline transfer_method
+        choose_transfer_method(native_file_descriptor from,
+                               native_file_descriptor to) BOOST_NOEXCEPT
+        {
+#if SILICIUM_HAS_ZERO_COPY_TRANSFER
+            struct stat from_status, to_status;
+            if ((fstat(from, &from_status) < 0) ||
+                (fstat(to, &to_status) < 0))
+            {
+                return transfer_method::copy;
+            }
+            if (S_ISFIFO(from_status.st_mode) || S_ISFIFO(to_status.st_mode))
+            {
+                return transfer_method::splice;
+            }
+            return transfer_method::sendfile;
+#else
+            ignore_unused_variable_warning(from);
+            ignore_unused_variable_warning(to);
+            return transfer_method::copy;
+#endif
+        }
+
+        /// Whether a zero-copy system call refused to work with the kind of
+        /// files it was given, so that copying is the only option left.
+        inline bool is_transfer_unsupported(boost::system::error_code error)
+            BOOST_NOEXCEPT
+        {
+            return (error == boost::system::errc::invalid_argument) ||
+                   (error == boost::system::errc::function_not_supported) ||
+                   (error == boost::system::errc::operation_not_supported);
+        }
+
+        /// Moves at most size bytes with a single zero-copy system call.
+        /// Returns 0 at the end of from. With non_blocking, splice fails
+        /// with EAGAIN instead of waiting for an empty pipe. A call that is
+        /// interrupted by a signal is repeated.
+        SILICIUM_USE_RESULT
+        inline error_or<std::size_t>
+        transfer_once(native_file_descriptor from, native_file_descriptor to,
+                      std::size_t size, transfer_method method,
+                      bool non_blocking = false)
+        {
+#if SILICIUM_HAS_ZERO_COPY_TRANSFER
+            for (;;)
+            {
+                ssize_t transferred = -1;
+                switch (method)
+                {
+                case transfer_method::sendfile:
+                    transferred = ::sendfile(to, from, nullptr, size);
+                    break;
+
+                case transfer_method::splice:
+                    transferred = ::splice(
+                        from, nullptr, to, nullptr, size,
+                        SPLICE_F_MOVE | SPLICE_F_MORE |
+                            (non_blocking ? SPLICE_F_NONBLOCK : 0u));
+                    break;
+
+                case transfer_method::copy:
+                    SILICIUM_UNREACHABLE();
+                }
+                if (transferred >= 0)
+                {
+                    return static_cast<std::size_t>(transferred);
+                }
+                if (errno != EINTR)
+                {
+                    return get_last_error();
+                }
+            }
+#else
+            ignore_unused_variable_warning(from);
+            ignore_unused_variable_warning(to);
+            ignore_unused_variable_warning(size);
+            ignore_unused_variable_warning(method);
+            ignore_unused_variable_warning(non_blocking);
+            SILICIUM_UNREACHABLE();
+#endif
+        }
+
+        /// Whether reading from file would return without waiting.
+        inline bool is_readable(native_file_descriptor file) BOOST_NOEXCEPT
+        {
+#if SILICIUM_HAS_ZERO_COPY_TRANSFER
+            pollfd request = {file, POLLIN, 0};
+            int result;
+            do
+            {
+                result = ::poll(&request, 1, 0);
+            } while ((result < 0) && (errno == EINTR));
+            // errors and hang-ups are reported by the next read
+            return (result != 0);
+#else
+            ignore_unused_variable_warning(file);
+            return true;
+#endif
+        }
+
+        SILICIUM_USE_RESULT
+        inline error_or<std::size_t> copy_file(native_file_descriptor from,
+                                               native_file_descriptor to,
+                                               std::size_t size)
+        {
+            std::array<char, 1U << 14U> buffer;
+            std::size_t copied = 0;
+            while (copied < size)
+            {
+                error_or<std::size_t> const read_bytes =
+                    read(from, make_iterator_range(
+                                   buffer.data(),
+                                   buffer.data() +
+                                       (std::min)(buffer.size(),
+                                                  size - copied)));
+                if (read_bytes.is_error())
+                {
+                    return read_bytes.error();
+                }
+                if (read_bytes.get() == 0)
+                {
+                    break;
+                }
+                error_or<std::size_t> const written =
+                    write(to, make_memory_range(buffer.data(),
+                                                read_bytes.get()));
+                if (written.is_error())
+                {
+                    return written.error();
+                }
+                copied += written.get();
+            }
+            return copied;
+        }
+    }
+
+    /// Copies up to size bytes from the current position of from to to.
+    /// On Linux the data does not pass through user memory: sendfile(2) is
+    /// used for regular files and splice(2) when one of the ends is a pipe.
+    /// Everything else is copied with read and write. Returns the number of
+    /// bytes transferred, which is less than size only at the end of from.
+    SILICIUM_USE_RESULT
+    inline error_or<std::size_t> transfer_file(native_file_descriptor from,
+                                               native_file_descriptor to,
+                                               std::size_t size)
+    {
+        detail::transfer_method const method =
+            detail::choose_transfer_method(from, to);
+        std::size_t transferred = 0;
+        if (method != detail::transfer_method::copy)
+        {
+            while (transferred < size)
+            {
+                error_or<std::size_t> const step = detail::transfer_once(
+                    from, to, size - transferred, method);
+                if (step.is_error())
+                {
+                    if ((transferred == 0) &&
+                        detail::is_transfer_unsupported(step.error()))
+                    {
+                        break;
+                    }
+                    return step.error();
+                }
+                if (step.get() == 0)
+                {
+                    return transferred;
+                }
+                transferred += step.get();
+            }
+            if (transferred != 0)
+            {
+                return transferred;
+            }
+        }
+        return detail::copy_file(from, to, size);
+    }
+}
+
+#endif
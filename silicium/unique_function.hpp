@@ -0,0 +1,232 @@
+#ifndef SILICIUM_UNIQUE_FUNCTION_HPP
+#define SILICIUM_UNIQUE_FUNCTION_HPP
+
+#include <silicium/config.hpp>
+#include <silicium/alignment_of.hpp>
+#include <silicium/explicit_operator_bool.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+#define SILICIUM_HAS_UNIQUE_FUNCTION SILICIUM_COMPILER_HAS_VARIADIC_TEMPLATES
+
+namespace Si
+{
+#if SILICIUM_HAS_UNIQUE_FUNCTION
+    namespace detail
+    {
+        template <class Result, class... Args>
+        struct unique_function_vtable
+        {
+            Result (*call)(void *, Args &&...);
+
+            /// Move-constructs the callable at to and destroys it at from.
+            void (*move)(void *from, void *to);
+
+            void (*destroy)(void *);
+        };
+
+        /// The callable lives in the inline storage of the unique_function.
+        template <class F, class Result, class... Args>
+        struct inline_callable
+        {
+            static Result call(void *storage, Args &&... arguments)
+            {
+                return (*static_cast<F *>(storage))(
+                    std::forward<Args>(arguments)...);
+            }
+
+            static void move(void *from, void *to)
+            {
+                F &moved = *static_cast<F *>(from);
+                new (to) F(std::move(moved));
+                moved.~F();
+            }
+
+            static void destroy(void *storage)
+            {
+                static_cast<F *>(storage)->~F();
+            }
+
+            static unique_function_vtable<Result, Args...> const vtable;
+        };
+
+        template <class F, class Result, class... Args>
+        unique_function_vtable<Result, Args...> const
+            inline_callable<F, Result, Args...>::vtable = {
+                &inline_callable::call, &inline_callable::move,
+                &inline_callable::destroy};
+
+        /// The inline storage only holds a pointer to the callable.
+        template <class F, class Result, class... Args>
+        struct heap_callable
+        {
+            static F *&get(void *storage)
+            {
+                return *static_cast<F **>(storage);
+            }
+
+            static Result call(void *storage, Args &&... arguments)
+            {
+                return (*get(storage))(std::forward<Args>(arguments)...);
+            }
+
+            static void move(void *from, void *to)
+            {
+                new (to) F *(get(from));
+            }
+
+            static void destroy(void *storage)
+            {
+                delete get(storage);
+            }
+
+            static unique_function_vtable<Result, Args...> const vtable;
+        };
+
+        template <class F, class Result, class... Args>
+        unique_function_vtable<Result, Args...> const
+            heap_callable<F, Result, Args...>::vtable = {
+                &heap_callable::call, &heap_callable::move,
+                &heap_callable::destroy};
+    }
+
+    template <class Signature, std::size_t InlineSize = 4 * sizeof(void *)>
+    struct unique_function;
+
+    /// A move-only alternative to Si::function. Callables of up to
+    /// InlineSize bytes that can be moved without throwing are stored
+    /// inside the object, so that constructing, moving and calling it does
+    /// not allocate. Larger callables are allocated on the heap.
+    template <class Result, class... Args, std::size_t InlineSize>
+    struct unique_function<Result(Args...), InlineSize>
+    {
+        static_assert(InlineSize >= sizeof(void *),
+                      "The storage has to be able to hold a pointer");
+
+    private:
+        typedef typename std::aligned_storage<InlineSize,
+                                              alignment_of<void *>::value>::type
+            storage_type;
+
+    public:
+        unique_function() BOOST_NOEXCEPT : m_vtable(nullptr)
+        {
+        }
+
+        unique_function(std::nullptr_t) BOOST_NOEXCEPT : m_vtable(nullptr)
+        {
+        }
+
+        unique_function(unique_function &&other) BOOST_NOEXCEPT
+            : m_vtable(other.m_vtable)
+        {
+            if (m_vtable)
+            {
+                m_vtable->move(&other.m_storage, &m_storage);
+                other.m_vtable = nullptr;
+            }
+        }
+
+        template <class F>
+        unique_function(
+            F &&content,
+            typename boost::enable_if_c<
+                !std::is_same<unique_function,
+                              typename std::decay<F>::type>::value,
+                void>::type * = nullptr)
+            : m_vtable(nullptr)
+        {
+            typedef typename std::decay<F>::type clean;
+            static_assert(!std::is_same<std::nullptr_t, clean>::value, "");
+            store<clean>(std::forward<F>(content), is_inline<clean>());
+        }
+
+        ~unique_function()
+        {
+            reset();
+        }
+
+        unique_function &operator=(unique_function &&other) BOOST_NOEXCEPT
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.m_vtable)
+                {
+                    other.m_vtable->move(&other.m_storage, &m_storage);
+                    m_vtable = other.m_vtable;
+                    other.m_vtable = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        unique_function &operator=(std::nullptr_t) BOOST_NOEXCEPT
+        {
+            reset();
+            return *this;
+        }
+
+        bool operator!() const BOOST_NOEXCEPT
+        {
+            return !m_vtable;
+        }
+
+        SILICIUM_EXPLICIT_OPERATOR_BOOL()
+
+        Result operator()(Args... arguments) const
+        {
+            assert(m_vtable);
+            return m_vtable->call(&m_storage, std::forward<Args>(arguments)...);
+        }
+
+        /// Whether a callable of type F would be stored without allocating.
+        template <class F>
+        struct is_inline
+            : std::integral_constant<
+                  bool, (sizeof(F) <= InlineSize) &&
+                            (alignment_of<F>::value <=
+                             alignment_of<storage_type>::value) &&
+                            std::is_nothrow_move_constructible<F>::value>
+        {
+        };
+
+    private:
+        typedef detail::unique_function_vtable<Result, Args...> vtable_type;
+
+        vtable_type const *m_vtable;
+        mutable storage_type m_storage;
+
+        template <class F, class G>
+        void store(G &&content, std::true_type)
+        {
+            new (&m_storage) F(std::forward<G>(content));
+            m_vtable = &detail::inline_callable<F, Result, Args...>::vtable;
+        }
+
+        template <class F, class G>
+        void store(G &&content, std::false_type)
+        {
+            new (&m_storage) F *(new F(std::forward<G>(content)));
+            m_vtable = &detail::heap_callable<F, Result, Args...>::vtable;
+        }
+
+        void reset() BOOST_NOEXCEPT
+        {
+            if (m_vtable)
+            {
+                m_vtable->destroy(&m_storage);
+                m_vtable = nullptr;
+            }
+        }
+
+        SILICIUM_DELETED_FUNCTION(unique_function(unique_function const &))
+        SILICIUM_DELETED_FUNCTION(
+            unique_function &operator=(unique_function const &))
+    };
+#endif
+}
+
+#endif
@@ -29,6 +29,106 @@ namespace Si
             .apply_visitor(std::forward<Visitor>(visitor));
     }
 
+    namespace detail
+    {
+        template <class... Variants>
+        struct variant_list;
+
+        template <>
+        struct variant_list<>
+        {
+        };
+
+        template <class Head, class... Tail>
+        struct variant_list<Head, Tail...>
+        {
+            Head *head;
+            variant_list<Tail...> tail;
+
+            explicit variant_list(Head &head, Tail &... tail)
+                : head(&head)
+                , tail(tail...)
+            {
+            }
+        };
+
+        /// Calls the visitor with the element and the arguments given to
+        /// the call operator.
+        template <class Visitor, class Element>
+        struct bound_visitor
+        {
+            typedef typename std::decay<Visitor>::type::result_type
+                result_type;
+
+            typename std::remove_reference<Visitor>::type *visitor;
+            Element *element;
+
+            template <class... Rest>
+            result_type operator()(Rest &... rest) const
+            {
+                return std::forward<Visitor>(*visitor)(*element, rest...);
+            }
+        };
+
+        template <class Visitor>
+        typename std::decay<Visitor>::type::result_type
+        visit_all(Visitor &&visitor, variant_list<> const &)
+        {
+            return std::forward<Visitor>(visitor)();
+        }
+
+        template <class Visitor, class Head, class... Tail>
+        typename std::decay<Visitor>::type::result_type
+        visit_all(Visitor &&visitor,
+                  variant_list<Head, Tail...> const &variants);
+
+        /// Visits the remaining variants with the element of the current
+        /// one bound to the visitor.
+        template <class Visitor, class... Tail>
+        struct visit_tail
+        {
+            typedef typename std::decay<Visitor>::type::result_type
+                result_type;
+
+            typename std::remove_reference<Visitor>::type *visitor;
+            variant_list<Tail...> const *tail;
+
+            template <class Element>
+            result_type operator()(Element &element) const
+            {
+                bound_visitor<Visitor, Element> const bound = {visitor,
+                                                               &element};
+                return visit_all(bound, *tail);
+            }
+        };
+
+        template <class Visitor, class Head, class... Tail>
+        typename std::decay<Visitor>::type::result_type
+        visit_all(Visitor &&visitor,
+                  variant_list<Head, Tail...> const &variants)
+        {
+            visit_tail<Visitor, Tail...> const next = {&visitor,
+                                                      &variants.tail};
+            return ::Si::apply_visitor(next, *variants.head);
+        }
+    }
+
+    /// Calls visitor(a, b, ...) with the current elements of all the
+    /// variants. Every variant is dispatched with a switch, so the
+    /// compiler can inline the whole call.
+    template <class Visitor, class First, class Second, class... Rest>
+    auto apply_visitor(Visitor &&visitor, First &&first, Second &&second,
+                       Rest &&... rest) ->
+        typename std::decay<Visitor>::type::result_type
+    {
+        typedef detail::variant_list<
+            typename std::remove_reference<First>::type,
+            typename std::remove_reference<Second>::type,
+            typename std::remove_reference<Rest>::type...> list;
+        list const variants(first, second, rest...);
+        return detail::visit_all(std::forward<Visitor>(visitor), variants);
+    }
+
     template <class T>
     struct inplace
     {
@@ -328,19 +428,200 @@ namespace Si
             return left_ < right_;
         }
 
-        template <class Visitor, class T, class Result>
-        Result apply_visitor_impl(Visitor &&visitor, void *element)
+        template <std::size_t Index, class... T>
+        struct nth_type;
+
+        template <class Head, class... Tail>
+        struct nth_type<0, Head, Tail...>
         {
-            return std::forward<Visitor>(visitor)(*static_cast<T *>(element));
-        }
+            typedef Head type;
+        };
+
+        template <std::size_t Index, class Head, class... Tail>
+        struct nth_type<Index, Head, Tail...> : nth_type<Index - 1, Tail...>
+        {
+        };
 
-        template <class Visitor, class T, class Result>
-        Result apply_visitor_const_impl(Visitor &&visitor, void const *element)
+        template <class Result, std::size_t Index, bool Exists, class... T>
+        struct dispatch_case
         {
-            return std::forward<Visitor>(visitor)(
-                *static_cast<T const *>(element));
+            template <class Operation>
+            static Result apply(Operation const &operation)
+            {
+                return operation.template apply<
+                    typename nth_type<Index, T...>::type>();
+            }
+        };
+
+        template <class Result, std::size_t Index, class... T>
+        struct dispatch_case<Result, Index, false, T...>
+        {
+            template <class Operation>
+            static Result apply(Operation const &)
+            {
+                SILICIUM_UNREACHABLE();
+            }
+        };
+
+        /// Calls operation.apply<T>() for the index-th of the types T with
+        /// a switch instead of a table of function pointers, so that the
+        /// compiler can inline the operation. Every switch handles eight
+        /// types and passes larger indices on to the next one.
+        template <class Result, std::size_t Offset, class... T>
+        struct switch_dispatch
+        {
+            template <class Operation>
+            static Result apply(std::size_t index, Operation const &operation)
+            {
+#define SILICIUM_DETAIL_DISPATCH_CASE(i)                                       \
+    case i:                                                                    \
+        return dispatch_case<Result, (Offset + i),                             \
+                             ((Offset + i) < sizeof...(T)),                    \
+                             T...>::apply(operation);
+                switch (index - Offset)
+                {
+                    SILICIUM_DETAIL_DISPATCH_CASE(0)
+                    SILICIUM_DETAIL_DISPATCH_CASE(1)
+                    SILICIUM_DETAIL_DISPATCH_CASE(2)
+                    SILICIUM_DETAIL_DISPATCH_CASE(3)
+                    SILICIUM_DETAIL_DISPATCH_CASE(4)
+                    SILICIUM_DETAIL_DISPATCH_CASE(5)
+                    SILICIUM_DETAIL_DISPATCH_CASE(6)
+                    SILICIUM_DETAIL_DISPATCH_CASE(7)
+                default:
+                    return apply_rest(
+                        index, operation,
+                        std::integral_constant<bool, ((Offset + 8) <
+                                                      sizeof...(T))>());
+                }
+#undef SILICIUM_DETAIL_DISPATCH_CASE
+            }
+
+        private:
+            template <class Operation>
+            static Result apply_rest(std::size_t index,
+                                     Operation const &operation,
+                                     std::true_type)
+            {
+                return switch_dispatch<Result, (Offset + 8), T...>::apply(
+                    index, operation);
+            }
+
+            template <class Operation>
+            static Result apply_rest(std::size_t, Operation const &,
+                                     std::false_type)
+            {
+                SILICIUM_UNREACHABLE();
+            }
+        };
+
+        template <class Result, class... T, class Operation>
+        Result dispatch(std::size_t index, Operation const &operation)
+        {
+            return switch_dispatch<Result, 0, T...>::apply(index, operation);
         }
 
+        /// Storage is void for mutable and void const for const variants.
+        template <class Visitor, class Storage, class Result>
+        struct visit_operation
+        {
+            typename std::remove_reference<Visitor>::type *visitor;
+            Storage *element;
+
+            template <class T>
+            Result apply() const
+            {
+                typedef typename std::conditional<
+                    std::is_const<Storage>::value, T const, T>::type
+                    element_type;
+                return std::forward<Visitor>(*visitor)(
+                    *static_cast<element_type *>(element));
+            }
+        };
+
+        struct destroy_operation
+        {
+            void *destroyed;
+
+            template <class T>
+            void apply() const BOOST_NOEXCEPT
+            {
+                destroy_storage<T>(destroyed);
+            }
+        };
+
+        struct move_construct_operation
+        {
+            void *destination;
+            void *source;
+
+            template <class T>
+            void apply() const
+            {
+                move_construct_storage<T>(destination, source);
+            }
+        };
+
+        struct copy_construct_operation
+        {
+            void *destination;
+            void const *source;
+
+            template <class T>
+            void apply() const
+            {
+                copy_construct_storage<T>(destination, source);
+            }
+        };
+
+        struct move_operation
+        {
+            void *destination;
+            void *source;
+
+            template <class T>
+            void apply() const BOOST_NOEXCEPT
+            {
+                move_storage<T>(destination, source);
+            }
+        };
+
+        struct copy_operation
+        {
+            void *destination;
+            void const *source;
+
+            template <class T>
+            void apply() const
+            {
+                copy_storage<T>(destination, source);
+            }
+        };
+
+        struct equals_operation
+        {
+            void const *left;
+            void const *right;
+
+            template <class T>
+            bool apply() const
+            {
+                return equals<T>(left, right);
+            }
+        };
+
+        struct less_operation
+        {
+            void const *left;
+            void const *right;
+
+            template <class T>
+            bool apply() const
+            {
+                return less<T>(left, right);
+            }
+        };
+
 #if SILICIUM_COMPILER_HAS_VARIADIC_PACK_EXPANSION
         template <class First, class... Rest>
         struct first
@@ -560,11 +841,9 @@ namespace Si
             {
                 throw_if_invalid();
                 typedef typename std::decay<Visitor>::type::result_type result;
-                static std::array<result (*)(Visitor &&, void *),
-                                  sizeof...(T)> const f{
-                    {&apply_visitor_impl<Visitor, T, result>...}};
-                return f[this->index()](
-                    std::forward<Visitor>(visitor), &this->storage());
+                visit_operation<Visitor, void, result> const operation = {
+                    &visitor, &this->storage()};
+                return dispatch<result, T...>(this->index(), operation);
             }
 
             template <class Visitor>
@@ -573,11 +852,9 @@ namespace Si
             {
                 throw_if_invalid();
                 typedef typename std::decay<Visitor>::type::result_type result;
-                static std::array<result (*)(Visitor &&, void const *),
-                                  sizeof...(T)> const f{
-                    {&apply_visitor_const_impl<Visitor, T, result>...}};
-                return f[this->index()](
-                    std::forward<Visitor>(visitor), &this->storage());
+                visit_operation<Visitor, void const, result> const operation =
+                    {&visitor, &this->storage()};
+                return dispatch<result, T...>(this->index(), operation);
             }
 
             bool operator==(variant_base const &other) const
@@ -586,9 +863,9 @@ namespace Si
                 {
                     return false;
                 }
-                static std::array<bool (*)(void const *, void const *),
-                                  sizeof...(T)> const f = {{&equals<T>...}};
-                return f[this->index()](&this->storage(), &other.storage());
+                equals_operation const operation = {&this->storage(),
+                                                    &other.storage()};
+                return dispatch<bool, T...>(this->index(), operation);
             }
 
             bool operator<(variant_base const &other) const
@@ -601,9 +878,9 @@ namespace Si
                 {
                     return true;
                 }
-                static std::array<bool (*)(void const *, void const *),
-                                  sizeof...(T)> const f = {{&less<T>...}};
-                return f[this->index()](&this->storage(), &other.storage());
+                less_operation const operation = {&this->storage(),
+                                                  &other.storage()};
+                return dispatch<bool, T...>(this->index(), operation);
             }
 
             template <bool IsOtherCopyable, class... U>
@@ -649,9 +926,9 @@ namespace Si
             static void move_construct_storage(index_type index,
                                                char &destination, char &source)
             {
-                static std::array<void (*)(void *, void *), sizeof...(T)> const
-                    f = {{&::Si::detail::move_construct_storage<T>...}};
-                f[index](&destination, &source);
+                move_construct_operation const operation = {&destination,
+                                                             &source};
+                dispatch<void, T...>(index, operation);
             }
 
             template <class From>
@@ -674,17 +951,15 @@ namespace Si
             static void destroy_storage(index_type index,
                                         char &destroyed) BOOST_NOEXCEPT
             {
-                static std::array<void (*)(void *), sizeof...(T)> const f = {
-                    {&::Si::detail::destroy_storage<T>...}};
-                f[index](&destroyed);
+                destroy_operation const operation = {&destroyed};
+                dispatch<void, T...>(index, operation);
             }
 
             static void move_storage(index_type index, char &destination,
                                      char &source) BOOST_NOEXCEPT
             {
-                static std::array<void (*)(void *, void *), sizeof...(T)> const
-                    f = {{&::Si::detail::move_storage<T>...}};
-                f[index](&destination, &source);
+                move_operation const operation = {&destination, &source};
+                dispatch<void, T...>(index, operation);
             }
 
             SILICIUM_DELETED_FUNCTION(variant_base(variant_base const &))
@@ -794,19 +1069,16 @@ namespace Si
                                                char &destination,
                                                char const &source)
             {
-                static std::array<void (*)(void *, void const *),
-                                  sizeof...(T)> const f = {
-                    {&::Si::detail::copy_construct_storage<T>...}};
-                f[index](&destination, &source);
+                copy_construct_operation const operation = {&destination,
+                                                             &source};
+                dispatch<void, T...>(index, operation);
             }
 
             static void copy_storage(index_type index, char &destination,
                                      char const &source)
             {
-                static std::array<void (*)(void *, void const *),
-                                  sizeof...(T)> const f = {
-                    {&::Si::detail::copy_storage<T>...}};
-                f[index](&destination, &source);
+                copy_operation const operation = {&destination, &source};
+                dispatch<void, T...>(index, operation);
             }
         };
 
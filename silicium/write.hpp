@@ -6,6 +6,11 @@
 #include <silicium/native_file_descriptor.hpp>
 #include <silicium/memory_range.hpp>
 #include <limits>
+#include <array>
+#ifndef _WIN32
+#include <sys/uio.h>
+#include <cerrno>
+#endif
 
 namespace Si
 {
@@ -34,6 +39,10 @@ namespace Si
                         static_cast<std::size_t>(data.size()) - total_written);
             if (written < 0)
             {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
                 return Si::get_last_error();
             }
 #endif
@@ -45,6 +54,91 @@ namespace Si
         } while (total_written < static_cast<std::size_t>(data.size()));
         return total_written;
     }
+
+    /// Writes all of the ranges in order. On POSIX this needs only one
+    /// writev call for up to 16 ranges if the file accepts all of the data.
+    SILICIUM_USE_RESULT
+    inline Si::error_or<std::size_t>
+    write_ranges(Si::native_file_descriptor file,
+                 iterator_range<Si::memory_range const *> ranges)
+    {
+        std::size_t total_written = 0;
+#ifdef _WIN32
+        for (Si::memory_range const &range : ranges)
+        {
+            Si::error_or<std::size_t> const written = write(file, range);
+            if (written.is_error())
+            {
+                return written;
+            }
+            total_written += written.get();
+            if (written.get() < static_cast<std::size_t>(range.size()))
+            {
+                break;
+            }
+        }
+#else
+        Si::memory_range const *next = ranges.begin();
+        std::size_t offset = 0;
+        for (;;)
+        {
+            while ((next != ranges.end()) &&
+                   (offset == static_cast<std::size_t>(next->size())))
+            {
+                ++next;
+                offset = 0;
+            }
+            if (next == ranges.end())
+            {
+                break;
+            }
+            std::array<iovec, 16> vectors;
+            int count = 0;
+            for (Si::memory_range const *range = next;
+                 (range != ranges.end()) &&
+                 (count < static_cast<int>(vectors.size()));
+                 ++range, ++count)
+            {
+                std::size_t const skipped = (range == next) ? offset : 0;
+                iovec &vector = vectors[static_cast<std::size_t>(count)];
+                vector.iov_base = const_cast<char *>(range->begin() + skipped);
+                vector.iov_len =
+                    static_cast<std::size_t>(range->size()) - skipped;
+            }
+            ssize_t const written = ::writev(file, vectors.data(), count);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    // nothing has been written, so the same vectors are
+                    // built again
+                    continue;
+                }
+                return Si::get_last_error();
+            }
+            if (written == 0)
+            {
+                break;
+            }
+            total_written += static_cast<std::size_t>(written);
+            std::size_t consumed = static_cast<std::size_t>(written);
+            while (consumed != 0)
+            {
+                std::size_t const rest =
+                    static_cast<std::size_t>(next->size()) - offset;
+                if (consumed < rest)
+                {
+                    offset += consumed;
+                    break;
+                }
+                consumed -= rest;
+                ++next;
+                offset = 0;
+            }
+        }
+#endif
+        return total_written;
+    }
 }
 
 #endif
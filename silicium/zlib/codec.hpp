@@ -0,0 +1,12 @@
+#ifndef SILICIUM_ZLIB_CODEC_HPP
+#define SILICIUM_ZLIB_CODEC_HPP
+
+#include <silicium/compression/codec.hpp>
+#include <silicium/zlib/deflating_sink.hpp>
+#include <silicium/zlib/inflating_sink.hpp>
+
+// zlib_compressor is defined in deflating_sink.hpp and zlib_decompressor
+// in inflating_sink.hpp, because the zlib sinks are built on them.
+#define SILICIUM_HAS_ZLIB_CODEC SILICIUM_HAS_DEFLATING_SINK
+
+#endif
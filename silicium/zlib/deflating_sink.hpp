@@ -1,13 +1,15 @@
 #ifndef SILICIUM_ZLIB_DEFLATING_SINK_HPP
 #define SILICIUM_ZLIB_DEFLATING_SINK_HPP
 
-#include <silicium/variant.hpp>
+#include <silicium/compression/codec.hpp>
 #include <silicium/sink/sink.hpp>
 #include <silicium/zlib/zlib.hpp>
 #include <silicium/optional.hpp>
 #include <silicium/iterator_range.hpp>
 #include <silicium/memory_range.hpp>
-#include <cstring>
+#include <boost/cstdint.hpp>
+#include <memory>
+#include <vector>
 
 #define SILICIUM_HAS_DEFLATING_SINK                                            \
     (SILICIUM_HAS_VARIANT && !SILICIUM_AVOID_ZLIB)
@@ -15,10 +17,6 @@
 #if SILICIUM_HAS_DEFLATING_SINK
 namespace Si
 {
-    struct flush
-    {
-    };
-
     struct zlib_deflate_stream
     {
         zlib_deflate_stream() BOOST_NOEXCEPT
@@ -26,17 +24,23 @@ namespace Si
         }
 
         explicit zlib_deflate_stream(int level)
+            : m_stream(new z_stream())
         {
-            z_stream zero;
-            std::memset(&zero, 0, sizeof(zero));
-            m_stream = zero;
-            handle_zlib_status(deflateInit(&*m_stream, level));
+            handle_zlib_status(deflateInit(m_stream.get(), level));
+        }
+
+        zlib_deflate_stream(int level, zlib_format format)
+            : m_stream(new z_stream())
+        {
+            assert(format != zlib_format::automatic);
+            handle_zlib_status(deflateInit2(m_stream.get(), level, Z_DEFLATED,
+                                            zlib_window_bits(format), 8,
+                                            Z_DEFAULT_STRATEGY));
         }
 
         zlib_deflate_stream(zlib_deflate_stream &&other) BOOST_NOEXCEPT
+            : m_stream(std::move(other.m_stream))
         {
-            using std::swap;
-            swap(m_stream, other.m_stream);
         }
 
         zlib_deflate_stream &
@@ -53,12 +57,16 @@ namespace Si
             {
                 return;
             }
-            deflateEnd(&*m_stream);
+            deflateEnd(m_stream.get());
         }
 
+        /// Returns the number of bytes left in original and in deflated.
+        /// status is what ::deflate returned: Z_STREAM_END once Z_FINISH has
+        /// produced everything, Z_STREAM_ERROR if the stream is unusable.
         std::pair<std::size_t, std::size_t>
         deflate(iterator_range<char const *> original,
-                iterator_range<char *> deflated, int flush) BOOST_NOEXCEPT
+                iterator_range<char *> deflated, int flush,
+                int &status) BOOST_NOEXCEPT
         {
             assert(m_stream);
             assert(deflated.begin());
@@ -68,16 +76,56 @@ namespace Si
             m_stream->avail_in = static_cast<uInt>(original.size());
             m_stream->next_out = reinterpret_cast<Bytef *>(deflated.begin());
             m_stream->avail_out = static_cast<uInt>(deflated.size());
-            int rc = ::deflate(&*m_stream, flush);
-            assert(rc != Z_STREAM_ERROR);
-            assert(rc != Z_BUF_ERROR);
-            assert(rc == Z_OK);
-            ignore_unused_variable_warning(rc);
+            status = ::deflate(m_stream.get(), flush);
             return std::make_pair(m_stream->avail_in, m_stream->avail_out);
         }
 
+        /// Like the other overload, but throws boost::system::system_error
+        /// on errors.
+        std::pair<std::size_t, std::size_t>
+        deflate(iterator_range<char const *> original,
+                iterator_range<char *> deflated, int flush)
+        {
+            int status = Z_OK;
+            std::pair<std::size_t, std::size_t> const rest =
+                deflate(original, deflated, flush, status);
+            // Z_BUF_ERROR only means that no progress was possible
+            if ((status != Z_STREAM_END) && (status != Z_BUF_ERROR))
+            {
+                handle_zlib_status(status);
+            }
+            return rest;
+        }
+
+        /// Starts a new stream with the same settings.
+        void reset()
+        {
+            assert(m_stream);
+            handle_zlib_status(deflateReset(m_stream.get()));
+        }
+
+        /// Lets the next data refer back to dictionary as if it had been
+        /// compressed just before. Only useful directly after construction
+        /// or reset().
+        void set_dictionary(iterator_range<char const *> dictionary)
+        {
+            assert(m_stream);
+            handle_zlib_status(deflateSetDictionary(
+                m_stream.get(), reinterpret_cast<Bytef const *>(
+                                    dictionary.begin()),
+                static_cast<uInt>(dictionary.size())));
+        }
+
+        /// An upper limit for the output of deflating size more bytes.
+        std::size_t bound(std::size_t size) const BOOST_NOEXCEPT
+        {
+            assert(m_stream);
+            return deflateBound(m_stream.get(), static_cast<uLong>(size));
+        }
+
     private:
-        optional<z_stream> m_stream;
+        // zlib keeps a pointer to the z_stream, so it must never move
+        std::unique_ptr<z_stream> m_stream;
 
         SILICIUM_DELETED_FUNCTION(
             zlib_deflate_stream(zlib_deflate_stream const &))
@@ -85,87 +133,134 @@ namespace Si
             zlib_deflate_stream &operator=(zlib_deflate_stream const &))
     };
 
-    typedef variant<flush, memory_range> zlib_sink_element;
+    typedef compression_sink_element zlib_sink_element;
 
-    template <class Next>
-    struct zlib_deflating_sink
+    inline int to_zlib_flush(codec_flush flush)
     {
-        typedef zlib_sink_element element_type;
-        typedef boost::system::error_code error_type;
+        switch (flush)
+        {
+        case codec_flush::none:
+            return Z_NO_FLUSH;
 
-        zlib_deflating_sink()
+        case codec_flush::sync:
+            return Z_SYNC_FLUSH;
+
+        case codec_flush::full:
+            return Z_FULL_FLUSH;
+
+        case codec_flush::finish:
+            return Z_FINISH;
+        }
+        SILICIUM_UNREACHABLE();
+    }
+
+    /// A Codec that compresses with a zlib_deflate_stream.
+    struct zlib_compressor
+    {
+        zlib_compressor()
         {
         }
 
-        explicit zlib_deflating_sink(Next next, zlib_deflate_stream stream)
-            : m_next(std::move(next))
-            , m_stream(std::move(stream))
+        explicit zlib_compressor(zlib_deflate_stream stream)
+            : m_stream(std::move(stream))
         {
         }
 
-#if SILICIUM_COMPILER_GENERATES_MOVES
-        zlib_deflating_sink(zlib_deflating_sink &&) = default;
-#else
-        zlib_deflating_sink(zlib_deflating_sink &&other)
-            : m_next(std::move(other.m_next))
-            , m_stream(std::move(other.m_stream))
+        zlib_compressor(int level, zlib_format format)
+            : m_stream(level, format)
+        {
+        }
+
+#if !SILICIUM_COMPILER_GENERATES_MOVES
+        zlib_compressor(zlib_compressor &&other) BOOST_NOEXCEPT
+            : m_stream(std::move(other.m_stream))
+        {
+        }
+
+        zlib_compressor &operator=(zlib_compressor &&other) BOOST_NOEXCEPT
         {
+            m_stream = std::move(other.m_stream);
+            return *this;
         }
 #endif
 
-        boost::system::error_code
-        append(iterator_range<element_type const *> data)
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush flush)
         {
-            for (element_type const &piece : data)
+            int status = Z_OK;
+            std::pair<std::size_t, std::size_t> const rest =
+                m_stream.deflate(input, output, to_zlib_flush(flush), status);
+            switch (status)
             {
-                auto piece_content_and_flag =
-                    visit<std::pair<iterator_range<char const *>, int>>(
-                        piece,
-                        [](flush)
-                        {
-                            return std::make_pair(
-                                iterator_range<char const *>(),
-                                Z_FULL_FLUSH /* ?? */);
-                        },
-                        [](iterator_range<char const *> content)
-                        {
-                            return std::make_pair(content, Z_NO_FLUSH);
-                        });
-                char const *next_in = piece_content_and_flag.first.begin();
-                do
-                {
-                    auto rest = make_iterator_range(
-                        next_in, piece_content_and_flag.first.end());
-                    Si::iterator_range<char *> buffer =
-                        m_next.make_append_space(std::max<size_t>(
-                            static_cast<std::size_t>(rest.size()), 4096));
-                    assert(!buffer.empty());
-                    auto result = m_stream.deflate(
-                        rest, buffer, piece_content_and_flag.second);
-                    std::size_t written =
-                        static_cast<std::size_t>(buffer.size()) - result.second;
-                    m_next.make_append_space(written);
-                    m_next.flush_append_space();
-                    next_in +=
-                        (static_cast<std::size_t>(rest.size()) - result.first);
-                } while (next_in != piece_content_and_flag.first.end());
+            case Z_OK:
+            case Z_STREAM_END:
+            case Z_BUF_ERROR: // no progress possible
+                break;
+
+            default:
+                return boost::system::error_code(status, zlib_category());
             }
-            return {};
+            codec_progress progress;
+            progress.consumed =
+                static_cast<std::size_t>(input.size()) - rest.first;
+            progress.produced =
+                static_cast<std::size_t>(output.size()) - rest.second;
+            progress.is_end = (status == Z_STREAM_END);
+            return progress;
         }
 
     private:
-        Next m_next;
         zlib_deflate_stream m_stream;
     };
 
+    /// Compresses the memory ranges appended to it into Next. Small ranges
+    /// are collected in a staging buffer of staging_size bytes and
+    /// deflated together, so that many small pieces do not cost one
+    /// deflate call and one flush_append_space of Next each. A
+    /// staging_size of zero deflates every range on its own.
+    template <class Next>
+    struct zlib_deflating_sink : compressing_sink<Next, zlib_compressor>
+    {
+        zlib_deflating_sink()
+        {
+        }
+
+        explicit zlib_deflating_sink(Next next, zlib_deflate_stream stream,
+                                     std::size_t staging_size = 16 * 1024)
+            : compressing_sink<Next, zlib_compressor>(
+                  std::move(next), zlib_compressor(std::move(stream)),
+                  staging_size)
+        {
+        }
+
+#if SILICIUM_COMPILER_GENERATES_MOVES
+        zlib_deflating_sink(zlib_deflating_sink &&) = default;
+        zlib_deflating_sink &operator=(zlib_deflating_sink &&) = default;
+#else
+        zlib_deflating_sink(zlib_deflating_sink &&other)
+            : compressing_sink<Next, zlib_compressor>(std::move(other))
+        {
+        }
+
+        zlib_deflating_sink &operator=(zlib_deflating_sink &&other)
+        {
+            compressing_sink<Next, zlib_compressor>::operator=(
+                std::move(other));
+            return *this;
+        }
+#endif
+    };
+
     template <class Next>
-    auto make_deflating_sink(Next &&next, zlib_deflate_stream stream)
+    auto make_deflating_sink(Next &&next, zlib_deflate_stream stream,
+                             std::size_t staging_size = 16 * 1024)
 #if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
         -> zlib_deflating_sink<typename std::decay<Next>::type>
 #endif
     {
         return zlib_deflating_sink<typename std::decay<Next>::type>(
-            std::forward<Next>(next), std::move(stream));
+            std::forward<Next>(next), std::move(stream), staging_size);
     }
 }
 #endif
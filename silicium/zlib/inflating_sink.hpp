@@ -3,32 +3,41 @@
 
 #include <silicium/sink/sink.hpp>
 #include <silicium/zlib/zlib.hpp>
+#include <silicium/compression/codec.hpp>
 #include <silicium/iterator_range.hpp>
-#include <silicium/optional.hpp>
-#include <cstring>
+#include <boost/system/error_code.hpp>
+#include <memory>
 
 #if !SILICIUM_AVOID_ZLIB
 namespace Si
 {
     struct zlib_inflate_stream
     {
-        zlib_inflate_stream() BOOST_NOEXCEPT
+        zlib_inflate_stream() BOOST_NOEXCEPT : m_is_end(false)
         {
         }
 
+        explicit zlib_inflate_stream(zlib_format format)
+            : m_stream(new z_stream())
+            , m_is_end(false)
+        {
+            handle_zlib_status(
+                inflateInit2(m_stream.get(), zlib_window_bits(format)));
+        }
+
         ~zlib_inflate_stream() BOOST_NOEXCEPT
         {
             if (!m_stream)
             {
                 return;
             }
-            inflateEnd(&*m_stream);
+            inflateEnd(m_stream.get());
         }
 
         zlib_inflate_stream(zlib_inflate_stream &&other) BOOST_NOEXCEPT
+            : m_stream(std::move(other.m_stream)),
+              m_is_end(other.m_is_end)
         {
-            using std::swap;
-            swap(m_stream, other.m_stream);
         }
 
         zlib_inflate_stream &
@@ -36,52 +45,201 @@ namespace Si
         {
             using std::swap;
             swap(m_stream, other.m_stream);
+            swap(m_is_end, other.m_is_end);
             return *this;
         }
 
+        /// Returns the number of bytes left in deflated and in original.
+        /// Input that ends in the middle of the stream is not an error.
+        /// Corrupted input, a stream that needs a preset dictionary and
+        /// running out of memory are reported in ec.
         std::pair<std::size_t, std::size_t>
         inflate(iterator_range<char const *> deflated,
-                iterator_range<char *> original, int flush) BOOST_NOEXCEPT
+                iterator_range<char *> original, int flush,
+                boost::system::error_code &ec) BOOST_NOEXCEPT
         {
             assert(m_stream);
             assert(original.begin());
             assert(original.size());
-            assert(deflated.begin());
-            assert(deflated.size());
             m_stream->next_in =
                 reinterpret_cast<Bytef *>(const_cast<char *>(deflated.begin()));
             m_stream->avail_in = static_cast<uInt>(deflated.size());
             m_stream->next_out = reinterpret_cast<Bytef *>(original.begin());
             m_stream->avail_out = static_cast<uInt>(original.size());
-            int rc = ::inflate(&*m_stream, flush);
-            assert(rc != Z_STREAM_ERROR);
-            assert(rc != Z_BUF_ERROR);
-            assert(rc == Z_OK);
-            ignore_unused_variable_warning(rc);
+            int const rc = ::inflate(m_stream.get(), flush);
+            switch (rc)
+            {
+            case Z_STREAM_END:
+                m_is_end = true;
+                ec = boost::system::error_code();
+                break;
+
+            case Z_OK:
+            case Z_BUF_ERROR: // no progress possible, needs more input
+                ec = boost::system::error_code();
+                break;
+
+            default:
+                assert(rc != Z_STREAM_ERROR);
+                ec = boost::system::error_code(rc, zlib_category());
+                break;
+            }
             return std::make_pair(m_stream->avail_in, m_stream->avail_out);
         }
 
-        static zlib_inflate_stream initialize()
+        /// Like the other overload, but throws boost::system::system_error.
+        std::pair<std::size_t, std::size_t>
+        inflate(iterator_range<char const *> deflated,
+                iterator_range<char *> original, int flush)
         {
-            z_stream stream;
-            std::memset(&stream, 0, sizeof(stream));
-            handle_zlib_status(inflateInit(&stream));
-            return zlib_inflate_stream(stream);
+            boost::system::error_code ec;
+            std::pair<std::size_t, std::size_t> const rest =
+                inflate(deflated, original, flush, ec);
+            if (ec)
+            {
+                boost::throw_exception(boost::system::system_error(ec));
+            }
+            return rest;
         }
 
-    private:
-        optional<z_stream> m_stream;
+        /// Whether the end of the deflated stream has been reached.
+        bool is_end() const BOOST_NOEXCEPT
+        {
+            return m_is_end;
+        }
+
+        /// Prepares for another stream of the same format, for example the
+        /// next member of a concatenated gzip file.
+        void reset()
+        {
+            assert(m_stream);
+            handle_zlib_status(inflateReset(m_stream.get()));
+            m_is_end = false;
+        }
 
-        explicit zlib_inflate_stream(z_stream stream) BOOST_NOEXCEPT
-            : m_stream(stream)
+        static zlib_inflate_stream initialize()
         {
+            return zlib_inflate_stream(zlib_format::zlib);
         }
 
+    private:
+        // zlib keeps a pointer to the z_stream, so it must never move
+        std::unique_ptr<z_stream> m_stream;
+        bool m_is_end;
+
         SILICIUM_DELETED_FUNCTION(
             zlib_inflate_stream(zlib_inflate_stream const &))
         SILICIUM_DELETED_FUNCTION(
             zlib_inflate_stream &operator=(zlib_inflate_stream const &))
     };
+
+#if SILICIUM_HAS_COMPRESSION_CODEC
+    /// A Codec that decompresses with a zlib_inflate_stream. Concatenated
+    /// streams are decompressed one after another.
+    struct zlib_decompressor
+    {
+        zlib_decompressor()
+        {
+        }
+
+        explicit zlib_decompressor(zlib_inflate_stream stream)
+            : m_stream(std::move(stream))
+        {
+        }
+
+        explicit zlib_decompressor(zlib_format format)
+            : m_stream(format)
+        {
+        }
+
+#if !SILICIUM_COMPILER_GENERATES_MOVES
+        zlib_decompressor(zlib_decompressor &&other) BOOST_NOEXCEPT
+            : m_stream(std::move(other.m_stream))
+        {
+        }
+
+        zlib_decompressor &operator=(zlib_decompressor &&other) BOOST_NOEXCEPT
+        {
+            m_stream = std::move(other.m_stream);
+            return *this;
+        }
+#endif
+
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush)
+        {
+            if (m_stream.is_end() && !input.empty())
+            {
+                m_stream.reset();
+            }
+            boost::system::error_code ec;
+            std::pair<std::size_t, std::size_t> const rest =
+                m_stream.inflate(input, output, Z_NO_FLUSH, ec);
+            if (ec)
+            {
+                return ec;
+            }
+            codec_progress progress;
+            progress.consumed =
+                static_cast<std::size_t>(input.size()) - rest.first;
+            progress.produced =
+                static_cast<std::size_t>(output.size()) - rest.second;
+            progress.is_end = m_stream.is_end();
+            return progress;
+        }
+
+    private:
+        zlib_inflate_stream m_stream;
+    };
+    /// Decompresses what is appended and writes the result into the append
+    /// space of Next, at most max_output bytes at a time. Concatenated
+    /// streams (like the members of a gzip file) are decompressed one after
+    /// another.
+    template <class Next>
+    struct zlib_inflating_sink : decompressing_sink<Next, zlib_decompressor>
+    {
+        zlib_inflating_sink()
+        {
+        }
+
+        explicit zlib_inflating_sink(Next next, zlib_inflate_stream stream,
+                                     std::size_t max_output = 16 * 1024)
+            : decompressing_sink<Next, zlib_decompressor>(
+                  std::move(next), zlib_decompressor(std::move(stream)),
+                  max_output)
+        {
+        }
+
+#if SILICIUM_COMPILER_GENERATES_MOVES
+        zlib_inflating_sink(zlib_inflating_sink &&) = default;
+        zlib_inflating_sink &operator=(zlib_inflating_sink &&) = default;
+#else
+        zlib_inflating_sink(zlib_inflating_sink &&other)
+            : decompressing_sink<Next, zlib_decompressor>(std::move(other))
+        {
+        }
+
+        zlib_inflating_sink &operator=(zlib_inflating_sink &&other)
+        {
+            decompressing_sink<Next, zlib_decompressor>::operator=(
+                std::move(other));
+            return *this;
+        }
+#endif
+    };
+
+    template <class Next>
+    auto make_inflating_sink(Next &&next, zlib_inflate_stream stream,
+                             std::size_t max_output = 16 * 1024)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> zlib_inflating_sink<typename std::decay<Next>::type>
+#endif
+    {
+        return zlib_inflating_sink<typename std::decay<Next>::type>(
+            std::forward<Next>(next), std::move(stream), max_output);
+    }
+#endif
 }
 #endif
 
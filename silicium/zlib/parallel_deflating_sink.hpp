@@ -0,0 +1,696 @@
+#ifndef SILICIUM_ZLIB_PARALLEL_DEFLATING_SINK_HPP
+#define SILICIUM_ZLIB_PARALLEL_DEFLATING_SINK_HPP
+
+#include <silicium/zlib/deflating_sink.hpp>
+#include <silicium/error_or.hpp>
+#include <boost/array.hpp>
+#include <boost/system/system_error.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#define SILICIUM_HAS_PARALLEL_DEFLATING_SINK                                   \
+    (SILICIUM_HAS_DEFLATING_SINK && SILICIUM_HAS_EXCEPTIONS)
+
+#if SILICIUM_HAS_PARALLEL_DEFLATING_SINK
+namespace Si
+{
+    namespace detail
+    {
+        struct deflated_block
+        {
+            std::vector<char> output;
+
+            /// crc32 or adler32 of the input, depending on the format
+            uLong check;
+
+            std::size_t input_size;
+        };
+
+        struct deflate_job
+        {
+            std::vector<char> input;
+            std::vector<char> dictionary;
+            int level;
+            zlib_format format;
+            int flush;
+            std::promise<deflated_block> result;
+        };
+    }
+
+    /// Threads that compress blocks into raw deflate data for any number
+    /// of parallel_deflating_sink. Every thread keeps its own z_stream and
+    /// only creates a new one when a block asks for a different level. The
+    /// pool has to outlive the sinks that use it.
+    struct deflate_worker_pool
+    {
+        /// threads defaults to the number of processors.
+        explicit deflate_worker_pool(std::size_t threads = 0)
+            : m_stopping(false)
+        {
+            if (threads == 0)
+            {
+                threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+            }
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                m_threads.emplace_back([this]
+                                       {
+                                           run();
+                                       });
+            }
+        }
+
+        ~deflate_worker_pool()
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (std::thread &thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        std::size_t thread_count() const BOOST_NOEXCEPT
+        {
+            return m_threads.size();
+        }
+
+        /// dictionary is the data that came before input, if any.
+        /// flush is Z_SYNC_FLUSH or Z_FINISH for the last block.
+        std::future<detail::deflated_block>
+        submit(std::vector<char> input, std::vector<char> dictionary,
+               int level, zlib_format format, int flush)
+        {
+            detail::deflate_job job;
+            job.input = std::move(input);
+            job.dictionary = std::move(dictionary);
+            job.level = level;
+            job.format = format;
+            job.flush = flush;
+            std::future<detail::deflated_block> result =
+                job.result.get_future();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobs.push_back(std::move(job));
+            }
+            m_wake.notify_one();
+            return result;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<detail::deflate_job> m_jobs;
+        bool m_stopping;
+        std::vector<std::thread> m_threads;
+
+        void run()
+        {
+            zlib_deflate_stream stream;
+            optional<int> stream_level;
+            for (;;)
+            {
+                detail::deflate_job job;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    while (!m_stopping && m_jobs.empty())
+                    {
+                        m_wake.wait(lock);
+                    }
+                    if (m_stopping)
+                    {
+                        return;
+                    }
+                    job = std::move(m_jobs.front());
+                    m_jobs.pop_front();
+                }
+                try
+                {
+                    if (!stream_level || (*stream_level != job.level))
+                    {
+                        stream_level = none;
+                        stream =
+                            zlib_deflate_stream(job.level, zlib_format::raw);
+                        stream_level = job.level;
+                    }
+                    job.result.set_value(deflate(stream, job));
+                }
+                catch (...)
+                {
+                    job.result.set_exception(std::current_exception());
+                }
+            }
+        }
+
+        static detail::deflated_block deflate(zlib_deflate_stream &stream,
+                                              detail::deflate_job const &job)
+        {
+            detail::deflated_block block;
+            block.input_size = job.input.size();
+            block.check = checksum(job.format, job.input);
+            stream.reset();
+            if (!job.dictionary.empty())
+            {
+                stream.set_dictionary(make_iterator_range(
+                    job.dictionary.data(),
+                    job.dictionary.data() + job.dictionary.size()));
+            }
+            char const *const input_end = job.input.data() + job.input.size();
+            char const *next_in = job.input.data();
+            std::size_t written = 0;
+            block.output.resize(stream.bound(job.input.size()) + 16);
+            for (;;)
+            {
+                std::pair<std::size_t, std::size_t> const rest = stream.deflate(
+                    make_iterator_range(next_in, input_end),
+                    make_iterator_range(block.output.data() + written,
+                                        block.output.data() +
+                                            block.output.size()),
+                    job.flush);
+                next_in = input_end - rest.first;
+                written = block.output.size() - rest.second;
+                if ((next_in == input_end) && (rest.second > 0))
+                {
+                    break;
+                }
+                block.output.resize(block.output.size() * 2);
+            }
+            block.output.resize(written);
+            return block;
+        }
+
+        static uLong checksum(zlib_format format,
+                              std::vector<char> const &input)
+        {
+            Bytef const *const data =
+                reinterpret_cast<Bytef const *>(input.data());
+            uInt const size = static_cast<uInt>(input.size());
+            switch (format)
+            {
+            case zlib_format::gzip:
+                return crc32(crc32(0, Z_NULL, 0), data, size);
+
+            case zlib_format::zlib:
+                return adler32(adler32(0, Z_NULL, 0), data, size);
+
+            default:
+                return 0;
+            }
+        }
+
+        SILICIUM_DELETED_FUNCTION(
+            deflate_worker_pool(deflate_worker_pool const &))
+        SILICIUM_DELETED_FUNCTION(
+            deflate_worker_pool &operator=(deflate_worker_pool const &))
+    };
+
+    /// Compresses like zlib_deflating_sink, but splits the input into
+    /// blocks of block_size bytes and deflates them on several threads
+    /// the way pigz does. Every block starts with the last 32 KiB of the
+    /// input before it as its dictionary, so the ratio is almost that of
+    /// a single stream. The blocks are written to Next in their original
+    /// order as one valid zlib, gzip or raw deflate stream.
+    ///
+    /// flush and full_flush wait until everything appended so far has been
+    /// written. full_flush also starts the next block without a
+    /// dictionary. finish writes the trailer with the combined checksum.
+    ///
+    /// The sink either starts its own deflate_worker_pool or uses one that
+    /// is shared with other sinks. A block that fails to compress makes
+    /// append return the error, for example from the zlib category.
+    template <class Next>
+    struct parallel_deflating_sink
+    {
+        typedef zlib_sink_element element_type;
+        typedef boost::system::error_code error_type;
+
+        parallel_deflating_sink()
+            : m_level(Z_DEFAULT_COMPRESSION)
+            , m_format(zlib_format::raw)
+            , m_block_size(0)
+            , m_check(0)
+            , m_uncompressed(0)
+            , m_compressed(0)
+            , m_started(false)
+            , m_finished(false)
+        {
+        }
+
+        /// Starts a pool of threads for this sink alone. threads defaults
+        /// to the number of processors.
+        parallel_deflating_sink(Next next, int level, zlib_format format,
+                                std::size_t threads = 0,
+                                std::size_t block_size = 128 * 1024)
+            : m_next(std::move(next))
+            , m_level(level)
+            , m_format(format)
+            , m_block_size(block_size)
+            , m_check(initial_check(format))
+            , m_uncompressed(0)
+            , m_compressed(0)
+            , m_started(false)
+            , m_finished(false)
+            , m_owned_workers(new deflate_worker_pool(threads))
+            , m_workers(m_owned_workers.get())
+        {
+            assert(format != zlib_format::automatic);
+            assert(m_block_size > 0);
+            m_block.reserve(m_block_size);
+        }
+
+        /// Compresses on the threads of workers, which has to outlive the
+        /// sink.
+        parallel_deflating_sink(Next next, deflate_worker_pool &workers,
+                                int level, zlib_format format,
+                                std::size_t block_size = 128 * 1024)
+            : m_next(std::move(next))
+            , m_level(level)
+            , m_format(format)
+            , m_block_size(block_size)
+            , m_check(initial_check(format))
+            , m_uncompressed(0)
+            , m_compressed(0)
+            , m_started(false)
+            , m_finished(false)
+            , m_workers(&workers)
+        {
+            assert(format != zlib_format::automatic);
+            assert(m_block_size > 0);
+            m_block.reserve(m_block_size);
+        }
+
+#if SILICIUM_COMPILER_GENERATES_MOVES
+        parallel_deflating_sink(parallel_deflating_sink &&) = default;
+        parallel_deflating_sink &
+        operator=(parallel_deflating_sink &&) = default;
+#else
+        parallel_deflating_sink(parallel_deflating_sink &&other)
+            : m_next(std::move(other.m_next))
+            , m_level(other.m_level)
+            , m_format(other.m_format)
+            , m_block_size(other.m_block_size)
+            , m_check(other.m_check)
+            , m_uncompressed(other.m_uncompressed)
+            , m_compressed(other.m_compressed)
+            , m_started(other.m_started)
+            , m_finished(other.m_finished)
+            , m_block(std::move(other.m_block))
+            , m_dictionary(std::move(other.m_dictionary))
+            , m_pending(std::move(other.m_pending))
+            , m_owned_workers(std::move(other.m_owned_workers))
+            , m_workers(other.m_workers)
+        {
+        }
+#endif
+
+        error_type append(iterator_range<element_type const *> data)
+        {
+            assert(m_workers);
+            for (element_type const &piece : data)
+            {
+                error_type const error = visit<error_type>(
+                    piece,
+                    [this](flush)
+                    {
+                        return end_block(false);
+                    },
+                    [this](memory_range content)
+                    {
+                        return add(content);
+                    },
+                    [this](full_flush)
+                    {
+                        return end_block(true);
+                    },
+                    [this](finish)
+                    {
+                        return end_stream();
+                    });
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return {};
+        }
+
+        /// The number of bytes appended so far.
+        boost::uint64_t uncompressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_uncompressed + m_block.size();
+        }
+
+        /// The number of bytes written into Next so far.
+        boost::uint64_t compressed_bytes() const BOOST_NOEXCEPT
+        {
+            return m_compressed;
+        }
+
+    private:
+        enum
+        {
+            window_size = 32 * 1024
+        };
+
+        Next m_next;
+        int m_level;
+        zlib_format m_format;
+        std::size_t m_block_size;
+        uLong m_check;
+        boost::uint64_t m_uncompressed;
+        boost::uint64_t m_compressed;
+        bool m_started;
+        bool m_finished;
+        std::vector<char> m_block;
+        std::vector<char> m_dictionary;
+        std::deque<std::future<detail::deflated_block>> m_pending;
+        std::unique_ptr<deflate_worker_pool> m_owned_workers;
+        deflate_worker_pool *m_workers;
+
+        static uLong initial_check(zlib_format format)
+        {
+            return (format == zlib_format::zlib) ? adler32(0, Z_NULL, 0)
+                                                 : crc32(0, Z_NULL, 0);
+        }
+
+        error_type add(memory_range content)
+        {
+            assert(!m_finished);
+            char const *next = content.begin();
+            while (next != content.end())
+            {
+                std::size_t const taken = (std::min)(
+                    m_block_size - m_block.size(),
+                    static_cast<std::size_t>(content.end() - next));
+                m_block.insert(m_block.end(), next, next + taken);
+                next += taken;
+                if (m_block.size() == m_block_size)
+                {
+                    submit(Z_SYNC_FLUSH);
+                    error_type const error = write_finished_blocks(false);
+                    if (error)
+                    {
+                        return error;
+                    }
+                }
+            }
+            return {};
+        }
+
+        error_type end_block(bool forget_dictionary)
+        {
+            assert(!m_finished);
+            if (!m_block.empty())
+            {
+                submit(Z_SYNC_FLUSH);
+            }
+            if (forget_dictionary)
+            {
+                m_dictionary.clear();
+            }
+            return write_finished_blocks(true);
+        }
+
+        error_type end_stream()
+        {
+            assert(!m_finished);
+            submit(Z_FINISH);
+            m_finished = true;
+            error_type const error = write_finished_blocks(true);
+            if (error)
+            {
+                return error;
+            }
+            return write_trailer();
+        }
+
+        void submit(int flush)
+        {
+            std::vector<char> dictionary = m_dictionary;
+            m_dictionary.insert(m_dictionary.end(), m_block.begin(),
+                                m_block.end());
+            if (m_dictionary.size() > window_size)
+            {
+                m_dictionary.erase(m_dictionary.begin(),
+                                   m_dictionary.end() - window_size);
+            }
+            m_uncompressed += m_block.size();
+            m_pending.push_back(
+                m_workers->submit(std::move(m_block), std::move(dictionary),
+                                  m_level, m_format, flush));
+            m_block = std::vector<char>();
+            m_block.reserve(m_block_size);
+        }
+
+        /// Writes the blocks that are done in order. Waits for the oldest
+        /// one when all threads are busy, so that the amount of memory in
+        /// use stays bounded.
+        error_type write_finished_blocks(bool wait_for_all)
+        {
+            std::size_t const max_pending = 2 * m_workers->thread_count();
+            while (!m_pending.empty())
+            {
+                if (!wait_for_all && (m_pending.size() < max_pending) &&
+                    (m_pending.front().wait_for(std::chrono::seconds(0)) !=
+                     std::future_status::ready))
+                {
+                    break;
+                }
+                error_or<detail::deflated_block> finished =
+                    take_block(m_pending.front());
+                m_pending.pop_front();
+                if (finished.is_error())
+                {
+                    return finished.error();
+                }
+                detail::deflated_block const &block = finished.get();
+                m_check = combine_check(m_check, block);
+                if (!m_started)
+                {
+                    m_started = true;
+                    error_type const error = write_header();
+                    if (error)
+                    {
+                        return error;
+                    }
+                }
+                error_type const error = write(make_iterator_range(
+                    block.output.data(),
+                    block.output.data() + block.output.size()));
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return {};
+        }
+
+        /// Turns what a worker has thrown into an error.
+        static error_or<detail::deflated_block>
+        take_block(std::future<detail::deflated_block> &pending)
+        {
+            try
+            {
+                return pending.get();
+            }
+            catch (boost::system::system_error const &ex)
+            {
+                // zlib statuses come as errors of the zlib category
+                return ex.code();
+            }
+            catch (std::bad_alloc const &)
+            {
+                return boost::system::errc::make_error_code(
+                    boost::system::errc::not_enough_memory);
+            }
+            catch (std::future_error const &)
+            {
+                // the pool stopped before it got to the block
+                return boost::system::errc::make_error_code(
+                    boost::system::errc::operation_canceled);
+            }
+        }
+
+        uLong combine_check(uLong check,
+                            detail::deflated_block const &block) const
+        {
+            z_off_t const size = static_cast<z_off_t>(block.input_size);
+            switch (m_format)
+            {
+            case zlib_format::gzip:
+                return crc32_combine(check, block.check, size);
+
+            case zlib_format::zlib:
+                return adler32_combine(check, block.check, size);
+
+            default:
+                return check;
+            }
+        }
+
+        error_type write_header()
+        {
+            switch (m_format)
+            {
+            case zlib_format::gzip:
+            {
+                // no file name, no modification time, unknown OS
+                char const extra_flags =
+                    (m_level == 9) ? 2 : ((m_level == 1) ? 4 : 0);
+                boost::array<char, 10> const header = {
+                    {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, extra_flags, '\xff'}};
+                return write(make_iterator_range(
+                    header.data(), header.data() + header.size()));
+            }
+
+            case zlib_format::zlib:
+            {
+                // 32 KiB window, deflate
+                unsigned const method = 0x78;
+                unsigned flags = level_flags(m_level) << 6;
+                flags += 31 - (((method << 8) + flags) % 31);
+                boost::array<char, 2> const header = {
+                    {static_cast<char>(method), static_cast<char>(flags)}};
+                return write(make_iterator_range(
+                    header.data(), header.data() + header.size()));
+            }
+
+            default:
+                return {};
+            }
+        }
+
+        /// The FLEVEL field of the zlib header, computed like deflate does.
+        static unsigned level_flags(int level)
+        {
+            if (level == Z_DEFAULT_COMPRESSION)
+            {
+                level = 6;
+            }
+            if (level < 2)
+            {
+                return 0;
+            }
+            if (level < 6)
+            {
+                return 1;
+            }
+            if (level == 6)
+            {
+                return 2;
+            }
+            return 3;
+        }
+
+        error_type write_trailer()
+        {
+            boost::uint32_t const check = static_cast<boost::uint32_t>(m_check);
+            boost::uint32_t const size =
+                static_cast<boost::uint32_t>(m_uncompressed);
+            switch (m_format)
+            {
+            case zlib_format::gzip:
+            {
+                boost::array<char, 8> const trailer = {
+                    {static_cast<char>(check), static_cast<char>(check >> 8),
+                     static_cast<char>(check >> 16),
+                     static_cast<char>(check >> 24), static_cast<char>(size),
+                     static_cast<char>(size >> 8),
+                     static_cast<char>(size >> 16),
+                     static_cast<char>(size >> 24)}};
+                return write(make_iterator_range(
+                    trailer.data(), trailer.data() + trailer.size()));
+            }
+
+            case zlib_format::zlib:
+            {
+                boost::array<char, 4> const trailer = {
+                    {static_cast<char>(check >> 24),
+                     static_cast<char>(check >> 16),
+                     static_cast<char>(check >> 8), static_cast<char>(check)}};
+                return write(make_iterator_range(
+                    trailer.data(), trailer.data() + trailer.size()));
+            }
+
+            default:
+                return {};
+            }
+        }
+
+        error_type write(memory_range data)
+        {
+            char const *next = data.begin();
+            while (next != data.end())
+            {
+                std::size_t const wanted =
+                    static_cast<std::size_t>(data.end() - next);
+                iterator_range<char *> space = m_next.make_append_space(wanted);
+                if (space.empty())
+                {
+                    error_type const error =
+                        detail::to_error_code(m_next.flush_append_space());
+                    if (error)
+                    {
+                        return error;
+                    }
+                    space = m_next.make_append_space(wanted);
+                    if (space.empty())
+                    {
+                        return boost::system::errc::make_error_code(
+                            boost::system::errc::no_buffer_space);
+                    }
+                }
+                std::size_t const copied =
+                    static_cast<std::size_t>(space.size());
+                std::copy(next, next + copied, space.begin());
+                next += copied;
+                m_compressed += copied;
+                error_type const error =
+                    detail::to_error_code(m_next.flush_append_space());
+                if (error)
+                {
+                    return error;
+                }
+            }
+            return {};
+        }
+    };
+
+    template <class Next>
+    auto make_parallel_deflating_sink(Next &&next, int level,
+                                      zlib_format format,
+                                      std::size_t threads = 0,
+                                      std::size_t block_size = 128 * 1024)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> parallel_deflating_sink<typename std::decay<Next>::type>
+#endif
+    {
+        return parallel_deflating_sink<typename std::decay<Next>::type>(
+            std::forward<Next>(next), level, format, threads, block_size);
+    }
+
+    template <class Next>
+    auto make_parallel_deflating_sink(Next &&next,
+                                      deflate_worker_pool &workers, int level,
+                                      zlib_format format,
+                                      std::size_t block_size = 128 * 1024)
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> parallel_deflating_sink<typename std::decay<Next>::type>
+#endif
+    {
+        return parallel_deflating_sink<typename std::decay<Next>::type>(
+            std::forward<Next>(next), workers, level, format, block_size);
+    }
+}
+#endif
+
+#endif
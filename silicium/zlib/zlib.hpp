@@ -28,6 +28,7 @@ namespace Si
 #define SILICIUM_HANDLE_ERROR_CASE(error)                                      \
     case error:                                                                \
         return BOOST_STRINGIZE(error);
+                SILICIUM_HANDLE_ERROR_CASE(Z_NEED_DICT)
                 SILICIUM_HANDLE_ERROR_CASE(Z_ERRNO)
                 SILICIUM_HANDLE_ERROR_CASE(Z_STREAM_ERROR)
                 SILICIUM_HANDLE_ERROR_CASE(Z_DATA_ERROR)
@@ -47,6 +48,42 @@ namespace Si
         return instance;
     }
 
+    /// The header and trailer around deflated data.
+    enum class zlib_format
+    {
+        /// RFC 1950, what deflateInit produces
+        zlib,
+
+        /// RFC 1952, used by gzip and Content-Encoding: gzip
+        gzip,
+
+        /// RFC 1951 without any header
+        raw,
+
+        /// zlib or gzip, detected from the header (inflating only)
+        automatic
+    };
+
+    /// The windowBits argument of deflateInit2 and inflateInit2 for format.
+    inline int zlib_window_bits(zlib_format format)
+    {
+        switch (format)
+        {
+        case zlib_format::zlib:
+            return MAX_WBITS;
+
+        case zlib_format::gzip:
+            return MAX_WBITS + 16;
+
+        case zlib_format::raw:
+            return -MAX_WBITS;
+
+        case zlib_format::automatic:
+            return MAX_WBITS + 32;
+        }
+        SILICIUM_UNREACHABLE();
+    }
+
     inline void handle_zlib_status(int status)
     {
         if (status == Z_OK)
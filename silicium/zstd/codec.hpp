@@ -0,0 +1,286 @@
+#ifndef SILICIUM_ZSTD_CODEC_HPP
+#define SILICIUM_ZSTD_CODEC_HPP
+
+#include <silicium/compression/codec.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/throw_exception.hpp>
+#include <memory>
+
+#define SILICIUM_HAS_ZSTD_CODEC                                                \
+    (SILICIUM_HAS_COMPRESSION_CODEC && !SILICIUM_AVOID_ZSTD)
+
+#if SILICIUM_HAS_ZSTD_CODEC
+#include <zstd.h>
+#include <zstd_errors.h>
+
+namespace Si
+{
+    struct zstd_error_category : boost::system::error_category
+    {
+        zstd_error_category()
+        {
+        }
+
+        virtual const char *name() const BOOST_NOEXCEPT SILICIUM_OVERRIDE
+        {
+            return "zstd";
+        }
+
+        virtual std::string message(int ev) const SILICIUM_OVERRIDE
+        {
+            return ZSTD_getErrorString(static_cast<ZSTD_ErrorCode>(ev));
+        }
+    };
+
+    inline boost::system::error_category const &zstd_category()
+    {
+        static zstd_error_category const instance;
+        return instance;
+    }
+
+    /// Converts the result of a zstd function that failed.
+    inline boost::system::error_code make_zstd_error(std::size_t result)
+    {
+        assert(ZSTD_isError(result));
+        return boost::system::error_code(
+            static_cast<int>(ZSTD_getErrorCode(result)), zstd_category());
+    }
+
+    inline void handle_zstd_status(std::size_t result)
+    {
+        if (!ZSTD_isError(result))
+        {
+            return;
+        }
+        boost::throw_exception(
+            boost::system::system_error(make_zstd_error(result)));
+    }
+
+    namespace detail
+    {
+        struct zstd_cctx_deleter
+        {
+            void operator()(ZSTD_CCtx *context) const BOOST_NOEXCEPT
+            {
+                ZSTD_freeCCtx(context);
+            }
+        };
+
+        struct zstd_dctx_deleter
+        {
+            void operator()(ZSTD_DCtx *context) const BOOST_NOEXCEPT
+            {
+                ZSTD_freeDCtx(context);
+            }
+        };
+
+        inline void throw_if_null(void const *context)
+        {
+            if (context)
+            {
+                return;
+            }
+            boost::throw_exception(std::bad_alloc());
+        }
+    }
+
+    /// A Codec that produces zstd frames. With threads > 0, zstd compresses
+    /// on that many threads of its own, which needs a libzstd that was built
+    /// with multi-threading. A dictionary (for example from zstd --train)
+    /// improves the ratio for small messages a lot, and the reader has to
+    /// use the same one. full_flush ends the current frame.
+    struct zstd_compressor
+    {
+        zstd_compressor() BOOST_NOEXCEPT : m_frame_ended(false)
+        {
+        }
+
+        explicit zstd_compressor(int level, unsigned threads = 0,
+                                 memory_range dictionary = memory_range())
+            : m_context(ZSTD_createCCtx())
+            , m_frame_ended(false)
+        {
+            detail::throw_if_null(m_context.get());
+            handle_zstd_status(ZSTD_CCtx_setParameter(
+                m_context.get(), ZSTD_c_compressionLevel, level));
+            if (threads > 0)
+            {
+                handle_zstd_status(ZSTD_CCtx_setParameter(
+                    m_context.get(), ZSTD_c_nbWorkers,
+                    static_cast<int>(threads)));
+            }
+            if (!dictionary.empty())
+            {
+                handle_zstd_status(ZSTD_CCtx_loadDictionary(
+                    m_context.get(), dictionary.begin(),
+                    static_cast<std::size_t>(dictionary.size())));
+            }
+        }
+
+        zstd_compressor(zstd_compressor &&other) BOOST_NOEXCEPT
+            : m_context(std::move(other.m_context)),
+              m_frame_ended(other.m_frame_ended)
+        {
+        }
+
+        zstd_compressor &operator=(zstd_compressor &&other) BOOST_NOEXCEPT
+        {
+            m_context = std::move(other.m_context);
+            m_frame_ended = other.m_frame_ended;
+            return *this;
+        }
+
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush flush)
+        {
+            assert(m_context);
+            ZSTD_inBuffer in = {input.begin(),
+                                static_cast<std::size_t>(input.size()), 0};
+            ZSTD_outBuffer out = {output.begin(),
+                                  static_cast<std::size_t>(output.size()), 0};
+            ZSTD_EndDirective const directive = to_directive(flush);
+            if ((directive == ZSTD_e_end) && input.empty() && m_frame_ended)
+            {
+                // do not start an empty frame when asked to end the frame
+                // again because the output was full last time
+                codec_progress progress = {0, 0, flush == codec_flush::finish};
+                return progress;
+            }
+            std::size_t remaining = 0;
+            do
+            {
+                remaining = ZSTD_compressStream2(m_context.get(), &out, &in,
+                                                 directive);
+                if (ZSTD_isError(remaining))
+                {
+                    return make_zstd_error(remaining);
+                }
+            } while (
+                (out.pos < out.size) &&
+                ((in.pos < in.size) ||
+                 ((directive != ZSTD_e_continue) && (remaining > 0))));
+            bool const ended = (directive == ZSTD_e_end) &&
+                               (in.pos == in.size) && (remaining == 0);
+            if (ended || (in.pos > 0))
+            {
+                m_frame_ended = ended;
+            }
+            codec_progress progress;
+            progress.consumed = in.pos;
+            progress.produced = out.pos;
+            progress.is_end = ended && (flush == codec_flush::finish);
+            return progress;
+        }
+
+    private:
+        std::unique_ptr<ZSTD_CCtx, detail::zstd_cctx_deleter> m_context;
+        bool m_frame_ended;
+
+        static ZSTD_EndDirective to_directive(codec_flush flush)
+        {
+            switch (flush)
+            {
+            case codec_flush::none:
+                return ZSTD_e_continue;
+
+            case codec_flush::sync:
+                return ZSTD_e_flush;
+
+            case codec_flush::full:
+            case codec_flush::finish:
+                return ZSTD_e_end;
+            }
+            SILICIUM_UNREACHABLE();
+        }
+
+        SILICIUM_DELETED_FUNCTION(zstd_compressor(zstd_compressor const &))
+        SILICIUM_DELETED_FUNCTION(
+            zstd_compressor &operator=(zstd_compressor const &))
+    };
+
+    /// A Codec that decompresses concatenated zstd frames.
+    struct zstd_decompressor
+    {
+        zstd_decompressor() BOOST_NOEXCEPT : m_is_end(false)
+        {
+        }
+
+        explicit zstd_decompressor(memory_range dictionary)
+            : m_context(ZSTD_createDCtx())
+            , m_is_end(false)
+        {
+            detail::throw_if_null(m_context.get());
+            if (!dictionary.empty())
+            {
+                handle_zstd_status(ZSTD_DCtx_loadDictionary(
+                    m_context.get(), dictionary.begin(),
+                    static_cast<std::size_t>(dictionary.size())));
+            }
+        }
+
+        zstd_decompressor(zstd_decompressor &&other) BOOST_NOEXCEPT
+            : m_context(std::move(other.m_context)),
+              m_is_end(other.m_is_end)
+        {
+        }
+
+        zstd_decompressor &operator=(zstd_decompressor &&other) BOOST_NOEXCEPT
+        {
+            m_context = std::move(other.m_context);
+            m_is_end = other.m_is_end;
+            return *this;
+        }
+
+        error_or<codec_progress> process(memory_range input,
+                                         mutable_memory_range output,
+                                         codec_flush)
+        {
+            assert(m_context);
+            ZSTD_inBuffer in = {input.begin(),
+                                static_cast<std::size_t>(input.size()), 0};
+            ZSTD_outBuffer out = {output.begin(),
+                                  static_cast<std::size_t>(output.size()), 0};
+            for (;;)
+            {
+                std::size_t const consumed_before = in.pos;
+                std::size_t const hint =
+                    ZSTD_decompressStream(m_context.get(), &out, &in);
+                if (ZSTD_isError(hint))
+                {
+                    return make_zstd_error(hint);
+                }
+                if (hint == 0)
+                {
+                    // a frame has been decoded and flushed completely
+                    m_is_end = true;
+                    break;
+                }
+                if (in.pos > consumed_before)
+                {
+                    m_is_end = false;
+                }
+                if ((in.pos == in.size) || (out.pos == out.size))
+                {
+                    break;
+                }
+            }
+            codec_progress progress;
+            progress.consumed = in.pos;
+            progress.produced = out.pos;
+            progress.is_end = m_is_end;
+            return progress;
+        }
+
+    private:
+        std::unique_ptr<ZSTD_DCtx, detail::zstd_dctx_deleter> m_context;
+        bool m_is_end;
+
+        SILICIUM_DELETED_FUNCTION(zstd_decompressor(zstd_decompressor const &))
+        SILICIUM_DELETED_FUNCTION(
+            zstd_decompressor &operator=(zstd_decompressor const &))
+    };
+}
+#endif
+
+#endif
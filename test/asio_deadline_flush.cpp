@@ -0,0 +1,107 @@
+#include <silicium/asio/deadline_flush.hpp>
+#include <silicium/sink/buffering_sink.hpp>
+#include <silicium/sink/iterator_sink.hpp>
+#include <silicium/sink/append.hpp>
+#include <silicium/sink/function_sink.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(asio_deadline_flush_after_delay)
+{
+    boost::asio::io_service io;
+    std::string output;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_container_sink(output),
+        Si::asio::deadline_flush(io, std::chrono::microseconds(1000)));
+    Si::append(buffer, "abc");
+    Si::append(buffer, "def");
+    BOOST_CHECK_EQUAL("", output);
+    BOOST_CHECK_EQUAL(1u, io.run());
+    BOOST_CHECK_EQUAL("abcdef", output);
+}
+
+BOOST_AUTO_TEST_CASE(asio_deadline_flush_cancelled_by_flush)
+{
+    boost::asio::io_service io;
+    std::string output;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_container_sink(output),
+        Si::asio::deadline_flush(io, std::chrono::microseconds(1000)));
+    Si::append(buffer, "abc");
+    buffer.flush();
+    BOOST_CHECK_EQUAL("abc", output);
+    Si::append(buffer, "def");
+    io.run();
+    BOOST_CHECK_EQUAL("abcdef", output);
+}
+
+BOOST_AUTO_TEST_CASE(asio_deadline_flush_corked_after_append)
+{
+    boost::asio::io_service io;
+    std::string output;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_container_sink(output),
+        Si::asio::deadline_flush(io, std::chrono::microseconds(1000)));
+    Si::append(buffer, "abc");
+    buffer.cork();
+    io.run();
+    BOOST_CHECK_EQUAL("", output);
+    buffer.uncork();
+    BOOST_CHECK_EQUAL("abc", output);
+    Si::append(buffer, "def");
+    io.reset();
+    BOOST_CHECK_EQUAL(1u, io.run());
+    BOOST_CHECK_EQUAL("abcdef", output);
+}
+
+BOOST_AUTO_TEST_CASE(asio_deadline_flush_keeps_error)
+{
+    boost::asio::io_service io;
+    std::string output;
+    bool fail = true;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_function_sink<char>(
+            [&output, &fail](Si::iterator_range<char const *> data)
+                -> boost::system::error_code
+            {
+                if (fail)
+                {
+                    return boost::system::errc::make_error_code(
+                        boost::system::errc::broken_pipe);
+                }
+                output.append(data.begin(), data.end());
+                return boost::system::error_code();
+            }),
+        Si::asio::deadline_flush(io, std::chrono::microseconds(1000)));
+    Si::append(buffer, "abc");
+    io.run();
+    BOOST_CHECK_EQUAL("", output);
+    BOOST_CHECK(boost::system::errc::broken_pipe ==
+                buffer.flush_policy().error());
+
+    // the next append flushes again right away
+    fail = false;
+    BOOST_CHECK(!Si::append(buffer, "d"));
+    BOOST_CHECK_EQUAL("abcd", output);
+    BOOST_CHECK(!buffer.flush_policy().error());
+}
+
+BOOST_AUTO_TEST_CASE(asio_deadline_flush_moved_sink)
+{
+    boost::asio::io_service io;
+    std::string output;
+    auto original = Si::make_buffering_sink(
+        Si::make_container_sink(output),
+        Si::asio::deadline_flush(io, std::chrono::microseconds(1000)));
+    Si::append(original, "abc");
+    auto moved = std::move(original);
+    io.run();
+    BOOST_CHECK_EQUAL("", output);
+    io.reset();
+
+    // the moved sink arms its timer with the next append
+    Si::append(moved, "d");
+    io.run();
+    BOOST_CHECK_EQUAL("abcd", output);
+}
+#endif
@@ -0,0 +1,89 @@
+#include <silicium/asio/server_pool.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if SILICIUM_HAS_ASIO_SERVER_POOL
+namespace
+{
+    void test_server_pool(Si::asio::accept_sharding sharding)
+    {
+        std::size_t const loop_count = 3;
+        Si::asio::server_pool pool(
+            boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0),
+            loop_count,
+            [](std::shared_ptr<boost::asio::ip::tcp::socket> client,
+               boost::asio::yield_context yield)
+            {
+                char const greeting = 'x';
+                boost::asio::async_write(
+                    *client, boost::asio::buffer(&greeting, 1), yield);
+            },
+            sharding);
+        BOOST_CHECK(pool.sharding() == sharding);
+        BOOST_REQUIRE_EQUAL(loop_count, pool.loop_count());
+        boost::asio::ip::tcp::endpoint const server = pool.local_endpoint();
+        BOOST_REQUIRE_NE(0, server.port());
+
+        std::thread running([&pool]
+                            {
+                                pool.run();
+                            });
+
+        std::size_t const client_count = 12;
+        boost::asio::io_service client_io;
+        for (std::size_t i = 0; i < client_count; ++i)
+        {
+            boost::asio::ip::tcp::socket client(client_io);
+            client.connect(server);
+            char received = 0;
+            boost::asio::read(client, boost::asio::buffer(&received, 1));
+            BOOST_CHECK_EQUAL('x', received);
+        }
+
+        std::size_t accepted = 0;
+        for (std::size_t i = 0; i < loop_count; ++i)
+        {
+            Si::asio::loop_statistics const statistics =
+                pool.get_statistics(i);
+            accepted += statistics.accepted;
+            BOOST_CHECK_EQUAL(0u, statistics.queued_connections);
+        }
+        BOOST_CHECK_EQUAL(client_count, accepted);
+
+        pool.stop();
+        running.join();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(asio_server_pool_shared_acceptor)
+{
+    test_server_pool(Si::asio::accept_sharding::shared_acceptor);
+}
+
+#if SILICIUM_HAS_ASIO_REUSE_PORT
+BOOST_AUTO_TEST_CASE(asio_server_pool_reuse_port)
+{
+    test_server_pool(Si::asio::accept_sharding::reuse_port);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(asio_server_pool_classify_accept_error)
+{
+    using Si::asio::accept_error_kind;
+    using Si::asio::classify_accept_error;
+    BOOST_CHECK(accept_error_kind::resources ==
+                classify_accept_error(boost::asio::error::no_descriptors));
+    BOOST_CHECK(accept_error_kind::resources ==
+                classify_accept_error(boost::system::errc::make_error_code(
+                    boost::system::errc::too_many_files_open_in_system)));
+    BOOST_CHECK(accept_error_kind::client ==
+                classify_accept_error(boost::asio::error::connection_aborted));
+    BOOST_CHECK(accept_error_kind::fatal ==
+                classify_accept_error(boost::asio::error::operation_aborted));
+    BOOST_CHECK(accept_error_kind::fatal ==
+                classify_accept_error(boost::asio::error::bad_descriptor));
+}
+#endif
@@ -0,0 +1,111 @@
+#include <silicium/asio/accepting_source.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(asio_socket_pool_recycles)
+{
+    boost::asio::io_service io;
+    Si::asio::socket_pool pool(io);
+    BOOST_CHECK_EQUAL(0u, pool.free_count());
+    boost::asio::ip::tcp::socket const *first_address = nullptr;
+    {
+        Si::asio::pooled_socket first = pool.acquire();
+        BOOST_REQUIRE(first);
+        BOOST_CHECK(!first->is_open());
+        BOOST_CHECK_EQUAL(1u, first.use_count());
+        BOOST_CHECK_EQUAL(1u, pool.in_use());
+        first_address = first.get();
+        first->open(boost::asio::ip::tcp::v4());
+
+        Si::asio::pooled_socket copy = first;
+        BOOST_CHECK_EQUAL(2u, first.use_count());
+        first.reset();
+        BOOST_CHECK(!first);
+        BOOST_CHECK_EQUAL(1u, pool.in_use());
+    }
+    BOOST_CHECK_EQUAL(0u, pool.in_use());
+    BOOST_CHECK_EQUAL(1u, pool.free_count());
+
+    // the socket was closed when it was returned
+    Si::asio::pooled_socket second = pool.acquire();
+    BOOST_CHECK_EQUAL(first_address, second.get());
+    BOOST_CHECK(!second->is_open());
+    BOOST_CHECK_EQUAL(0u, pool.free_count());
+}
+
+BOOST_AUTO_TEST_CASE(asio_socket_pool_reserve)
+{
+    boost::asio::io_service io;
+    Si::asio::socket_pool pool(io);
+    pool.reserve(3);
+    BOOST_CHECK_EQUAL(3u, pool.free_count());
+    Si::asio::pooled_socket a = pool.acquire();
+    Si::asio::pooled_socket b = pool.acquire();
+    BOOST_CHECK_NE(a.get(), b.get());
+    BOOST_CHECK_EQUAL(1u, pool.free_count());
+}
+
+BOOST_AUTO_TEST_CASE(asio_socket_pool_outlived_by_socket)
+{
+    boost::asio::io_service io;
+    Si::asio::pooled_socket survivor;
+    {
+        Si::asio::socket_pool pool(io);
+        pool.reserve(2);
+        survivor = pool.acquire();
+    }
+    BOOST_REQUIRE(survivor);
+    survivor->open(boost::asio::ip::tcp::v4());
+    survivor.reset();
+}
+
+#if SILICIUM_HAS_ASIO_ACCEPTING_SOURCE
+BOOST_AUTO_TEST_CASE(asio_pooled_accepting_source)
+{
+    boost::asio::io_service io;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io, boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0));
+    Si::asio::socket_pool pool(io);
+    std::size_t const client_count = 3;
+    std::size_t served = 0;
+    boost::asio::spawn(io, [&](boost::asio::yield_context yield)
+                       {
+                           Si::asio::pooled_accepting_source clients(
+                               acceptor, yield, pool);
+                           for (std::size_t i = 0; i < client_count; ++i)
+                           {
+                               Si::asio::pooled_socket client;
+                               clients.copy_next(Si::make_iterator_range(
+                                   &client, &client + 1));
+                               char const greeting = 'x';
+                               boost::asio::async_write(
+                                   *client, boost::asio::buffer(&greeting, 1),
+                                   yield);
+                               ++served;
+                           }
+                       });
+    for (std::size_t i = 0; i < client_count; ++i)
+    {
+        boost::asio::ip::tcp::socket client(io);
+        client.async_connect(acceptor.local_endpoint(),
+                             [](boost::system::error_code ec)
+                             {
+                                 BOOST_REQUIRE(!ec);
+                             });
+        while (served == i)
+        {
+            io.run_one();
+        }
+        char received = 0;
+        boost::asio::read(client, boost::asio::buffer(&received, 1));
+        BOOST_CHECK_EQUAL('x', received);
+    }
+    io.run();
+    BOOST_CHECK_EQUAL(client_count, served);
+    // the accepted sockets were reused
+    BOOST_CHECK_EQUAL(0u, pool.in_use());
+    BOOST_CHECK_EQUAL(1u, pool.free_count());
+}
+#endif
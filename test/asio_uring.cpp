@@ -0,0 +1,249 @@
+#include "temporary_file.hpp"
+#include <silicium/asio/uring_service.hpp>
+#include <silicium/pipe.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if SILICIUM_HAS_ASIO_URING_SERVICE
+namespace
+{
+    /// Returns nullptr where io_uring is not available, for example in
+    /// containers that forbid it.
+    std::unique_ptr<Si::asio::uring_service>
+    make_service(boost::asio::io_service &io)
+    {
+        Si::error_or<std::unique_ptr<Si::asio::uring_service>> service =
+            Si::asio::uring_service::create(io);
+        if (service.is_error())
+        {
+            BOOST_TEST_MESSAGE("io_uring is not available: "
+                               << service.error().message());
+            return nullptr;
+        }
+        return service.move_value();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_batched_operations)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    temporary_file file;
+    file.write("0123456789");
+    std::array<std::array<char, 2>, 5> buffers;
+    std::size_t completed = 0;
+    for (std::size_t i = 0; i < buffers.size(); ++i)
+    {
+        service->async_read(
+            Si::asio::plain_file(file.handle()),
+            Si::make_contiguous_range(buffers[i]), i * 2,
+            [&completed](boost::system::error_code ec, std::size_t read)
+            {
+                BOOST_CHECK(!ec);
+                BOOST_CHECK_EQUAL(2u, read);
+                ++completed;
+            });
+    }
+    // nothing completes within the initiating functions
+    BOOST_CHECK_EQUAL(0u, completed);
+    BOOST_CHECK_EQUAL(buffers.size(), service->pending());
+    io.run();
+    BOOST_CHECK_EQUAL(buffers.size(), completed);
+    BOOST_CHECK_EQUAL(0u, service->pending());
+    for (std::size_t i = 0; i < buffers.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<char>('0' + (i * 2)), buffers[i][0]);
+        BOOST_CHECK_EQUAL(static_cast<char>('1' + (i * 2)), buffers[i][1]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_registered_file_and_buffer)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    temporary_file file;
+    std::array<Si::native_file_descriptor, 1> const files = {{file.handle()}};
+    BOOST_REQUIRE(!service->register_files(Si::make_contiguous_range(files)));
+    std::array<char, 4096> buffer;
+    std::array<Si::mutable_memory_range, 1> const buffers = {
+        {Si::make_contiguous_range(buffer)}};
+    BOOST_REQUIRE(
+        !service->register_buffers(Si::make_contiguous_range(buffers)));
+
+    std::memcpy(buffer.data(), "hello", 5);
+    bool written = false;
+    service->async_write_fixed(
+        Si::asio::registered_file(0),
+        Si::make_memory_range(buffer.data(), buffer.data() + 5), 0, 0,
+        [&](boost::system::error_code ec, std::size_t count)
+        {
+            BOOST_REQUIRE(!ec);
+            BOOST_CHECK_EQUAL(5u, count);
+            written = true;
+            service->async_read_fixed(
+                Si::asio::registered_file(0),
+                Si::make_iterator_range(buffer.data() + 100,
+                                        buffer.data() + 200),
+                0, 1, [&](boost::system::error_code ec, std::size_t count)
+                {
+                    BOOST_REQUIRE(!ec);
+                    BOOST_CHECK_EQUAL(4u, count);
+                    BOOST_CHECK_EQUAL(
+                        "ello", std::string(buffer.data() + 100, count));
+                });
+        });
+    io.run();
+    BOOST_CHECK(written);
+    BOOST_CHECK_EQUAL("hello", file.read_all());
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_source_and_sink)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    Si::pipe pipe = Si::make_pipe().move_value();
+    std::string received;
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            Si::asio::uring_source source(
+                *service, Si::asio::plain_file(pipe.read.handle), yield);
+            std::array<char, 3> buffer;
+            for (;;)
+            {
+                char *const end =
+                    source.copy_next(Si::make_contiguous_range(buffer));
+                if (end == buffer.data())
+                {
+                    break;
+                }
+                received.append(buffer.data(), end);
+            }
+        });
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            Si::asio::uring_sink sink(
+                *service, Si::asio::plain_file(pipe.write.handle), yield);
+            BOOST_REQUIRE(!sink.append(Si::make_c_str_range("hello, ")));
+            std::array<Si::memory_range, 2> const ranges = {
+                {Si::make_c_str_range("wor"), Si::make_c_str_range("ld")}};
+            BOOST_REQUIRE(
+                !sink.append_ranges(Si::make_contiguous_range(ranges)));
+            pipe.write.close();
+        });
+    io.run();
+    BOOST_CHECK_EQUAL("hello, world", received);
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_sink_with_offset)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    temporary_file file;
+    file.write("..........");
+    boost::asio::spawn(io, [&](boost::asio::yield_context yield)
+                       {
+                           Si::asio::uring_sink sink(
+                               *service, Si::asio::plain_file(file.handle()),
+                               yield, 2);
+                           BOOST_REQUIRE(
+                               !sink.append(Si::make_c_str_range("ab")));
+                           BOOST_REQUIRE(
+                               !sink.append(Si::make_c_str_range("cd")));
+                       });
+    io.run();
+    BOOST_CHECK_EQUAL("..abcd....", file.read_all());
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_handler_executor)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    temporary_file file;
+    file.write("abc");
+    boost::asio::io_service::strand strand(io);
+    std::array<char, 3> buffer;
+    bool in_strand = false;
+    service->async_read(
+        Si::asio::plain_file(file.handle()), Si::make_contiguous_range(buffer),
+        0, boost::asio::bind_executor(
+               strand, [&](boost::system::error_code ec, std::size_t read)
+               {
+                   BOOST_CHECK(!ec);
+                   BOOST_CHECK_EQUAL(3u, read);
+                   in_strand = strand.running_in_this_thread();
+               }));
+    io.run();
+    BOOST_CHECK(in_strand);
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_sink_more_ranges_than_iov_max)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> const service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    temporary_file file;
+    std::vector<Si::memory_range> ranges(
+        Si::asio::uring_sink::max_vectors * 2 + 3, Si::make_c_str_range("x"));
+    ranges[1] = Si::memory_range();
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            Si::asio::uring_sink sink(
+                *service, Si::asio::plain_file(file.handle()), yield, 0);
+            BOOST_CHECK(!sink.append_ranges(Si::make_iterator_range(
+                ranges.data(), ranges.data() + ranges.size())));
+        });
+    io.run();
+    BOOST_CHECK_EQUAL(std::string(ranges.size() - 1, 'x'), file.read_all());
+}
+
+BOOST_AUTO_TEST_CASE(asio_uring_destroy_with_pending_operation)
+{
+    boost::asio::io_service io;
+    std::unique_ptr<Si::asio::uring_service> service = make_service(io);
+    if (!service)
+    {
+        return;
+    }
+    Si::pipe pipe = Si::make_pipe().move_value();
+    std::array<char, 1> buffer;
+    bool called = false;
+    service->async_read(Si::asio::plain_file(pipe.read.handle),
+                        Si::make_contiguous_range(buffer),
+                        Si::asio::uring_service::current_position,
+                        [&called](boost::system::error_code, std::size_t)
+                        {
+                            called = true;
+                        });
+    io.poll();
+    BOOST_CHECK_EQUAL(1u, service->pending());
+    service.reset();
+    io.run();
+    BOOST_CHECK(!called);
+}
+#endif
@@ -0,0 +1,84 @@
+#include <silicium/asio/accepting_source.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <iostream>
+#include <thread>
+
+#if SILICIUM_HAS_ASIO_ACCEPTING_SOURCE
+namespace
+{
+    /// Connects client_count times to the server. Every client waits until
+    /// the server closes the connection, so that the TIME_WAIT state ends
+    /// up on the server side and the client does not run out of ports.
+    void connect_clients(boost::asio::ip::tcp::endpoint const &server,
+                         std::size_t client_count)
+    {
+        boost::asio::io_service io;
+        for (std::size_t i = 0; i < client_count; ++i)
+        {
+            boost::asio::ip::tcp::socket client(io);
+            client.connect(server);
+            char ignored;
+            boost::system::error_code ec;
+            boost::asio::read(client, boost::asio::buffer(&ignored, 1), ec);
+        }
+    }
+
+    template <class MakeSource>
+    void measure(char const *name, std::size_t client_count,
+                 MakeSource &&make_source)
+    {
+        boost::asio::io_service io;
+        boost::asio::ip::tcp::acceptor acceptor(
+            io, boost::asio::ip::tcp::endpoint(
+                    boost::asio::ip::address_v4::loopback(), 0));
+        Si::asio::socket_pool pool(io);
+        boost::asio::spawn(
+            io, [&](boost::asio::yield_context yield)
+            {
+                auto clients = make_source(acceptor, yield, pool);
+                typedef typename decltype(clients)::element_type client_type;
+                for (std::size_t i = 0; i < client_count; ++i)
+                {
+                    // the client is closed at the end of the iteration
+                    client_type client;
+                    clients.copy_next(
+                        Si::make_iterator_range(&client, &client + 1));
+                }
+            });
+        auto const started = boost::chrono::steady_clock::now();
+        std::thread clients(
+            connect_clients, acceptor.local_endpoint(), client_count);
+        io.run();
+        clients.join();
+        auto const duration =
+            boost::chrono::duration_cast<boost::chrono::microseconds>(
+                boost::chrono::steady_clock::now() - started);
+        std::cout << name << ": "
+                  << (static_cast<double>(client_count) * 1000000.0 /
+                      static_cast<double>(duration.count()))
+                  << " accepts per second\n";
+    }
+}
+#endif
+
+int main()
+{
+#if SILICIUM_HAS_ASIO_ACCEPTING_SOURCE
+    std::size_t const client_count = 20000;
+    measure("accepting_source", client_count,
+            [](boost::asio::ip::tcp::acceptor &acceptor,
+               boost::asio::yield_context &yield, Si::asio::socket_pool &)
+            {
+                return Si::asio::accepting_source(acceptor, yield);
+            });
+    measure("pooled_accepting_source", client_count,
+            [](boost::asio::ip::tcp::acceptor &acceptor,
+               boost::asio::yield_context &yield, Si::asio::socket_pool &pool)
+            {
+                return Si::asio::pooled_accepting_source(acceptor, yield, pool);
+            });
+#else
+    std::cerr << "This benchmark requires boost::asio::spawn\n";
+#endif
+}
@@ -0,0 +1,120 @@
+#include <silicium/compression/select.hpp>
+#include <silicium/sink/container_buffer.hpp>
+#include <silicium/sink/append.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+
+#if SILICIUM_HAS_COMPRESSION_CODEC
+namespace
+{
+    /// Looks like the HTML and JSON that services send each other.
+    std::vector<std::string> make_fragments()
+    {
+        std::vector<std::string> fragments;
+        for (std::size_t i = 0; i < 40000; ++i)
+        {
+            std::string const id = boost::lexical_cast<std::string>(i);
+            if (i % 2)
+            {
+                fragments.push_back("<li><a href=\"/item/" + id + "\">" +
+                                    boost::lexical_cast<std::string>(i * 7) +
+                                    "</a></li>\n");
+            }
+            else
+            {
+                fragments.push_back(
+                    "{\"id\": " + id + ", \"price\": " +
+                    boost::lexical_cast<std::string>(i * 37 % 1000) +
+                    ", \"tags\": [\"a\", \"b\"]}\n");
+            }
+        }
+        return fragments;
+    }
+
+    double megabytes_per_second(std::size_t bytes,
+                                boost::chrono::microseconds duration)
+    {
+        return static_cast<double>(bytes) /
+               static_cast<double>((std::max)(duration.count(),
+                                              static_cast<boost::int64_t>(1)));
+    }
+
+    void measure(Si::compression_settings const &settings,
+                 std::vector<std::string> const &fragments,
+                 std::size_t repetitions)
+    {
+        std::size_t uncompressed = 0;
+        std::vector<char> compressed;
+        auto const compress_started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            compressed.clear();
+            auto compressor = Si::make_compressing_sink(
+                Si::make_container_buffer(compressed),
+                Si::make_compressor(settings));
+            for (std::string const &fragment : fragments)
+            {
+                Si::append(compressor,
+                           Si::compression_sink_element{Si::make_memory_range(
+                               fragment.data(),
+                               fragment.data() + fragment.size())});
+            }
+            Si::append(compressor,
+                       Si::compression_sink_element{Si::finish()});
+            uncompressed =
+                static_cast<std::size_t>(compressor.uncompressed_bytes());
+        }
+        auto const compress_duration =
+            boost::chrono::duration_cast<boost::chrono::microseconds>(
+                boost::chrono::steady_clock::now() - compress_started);
+
+        std::size_t decompressed_size = 0;
+        auto const decompress_started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            std::vector<char> decompressed;
+            decompressed.reserve(uncompressed);
+            auto decompressor = Si::make_decompressing_sink(
+                Si::make_container_buffer(decompressed),
+                Si::make_decompressor(settings.format));
+            Si::append_range(decompressor,
+                             Si::make_memory_range(compressed.data(),
+                                                   compressed.data() +
+                                                       compressed.size()));
+            decompressed_size = decompressed.size();
+        }
+        auto const decompress_duration =
+            boost::chrono::duration_cast<boost::chrono::microseconds>(
+                boost::chrono::steady_clock::now() - decompress_started);
+
+        std::cout << Si::to_string(settings.format) << ": " << uncompressed
+                  << " -> " << compressed.size() << " bytes, ratio "
+                  << (static_cast<double>(uncompressed) /
+                      static_cast<double>(compressed.size()))
+                  << ", compress "
+                  << megabytes_per_second(uncompressed * repetitions,
+                                          compress_duration)
+                  << " MB/s, decompress "
+                  << megabytes_per_second(decompressed_size * repetitions,
+                                          decompress_duration)
+                  << " MB/s\n";
+    }
+}
+#endif
+
+int main()
+{
+#if SILICIUM_HAS_COMPRESSION_CODEC
+    std::vector<std::string> const fragments = make_fragments();
+    for (Si::compression_format format :
+         {Si::compression_format::gzip, Si::compression_format::zstd,
+          Si::compression_format::lz4})
+    {
+        if (Si::is_available(format))
+        {
+            measure(Si::compression_settings(format), fragments, 10);
+        }
+    }
+#endif
+}
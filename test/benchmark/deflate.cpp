@@ -0,0 +1,88 @@
+#include <silicium/zlib/deflating_sink.hpp>
+#include <silicium/zlib/parallel_deflating_sink.hpp>
+#include <silicium/sink/container_buffer.hpp>
+#include <silicium/sink/append.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+
+#if SILICIUM_HAS_DEFLATING_SINK
+namespace
+{
+    std::vector<std::string> make_fragments()
+    {
+        std::vector<std::string> fragments;
+        for (std::size_t i = 0; i < 20000; ++i)
+        {
+            fragments.push_back("<li><a href=\"/item/" +
+                                boost::lexical_cast<std::string>(i) + "\">" +
+                                boost::lexical_cast<std::string>(i * 7) +
+                                "</a></li>\n");
+        }
+        return fragments;
+    }
+
+    template <class Compressor>
+    void measure(char const *name, std::vector<std::string> const &fragments,
+                 std::size_t repetitions, Compressor &&make_compressor)
+    {
+        std::size_t uncompressed = 0;
+        std::size_t compressed_size = 0;
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            std::vector<char> compressed;
+            auto compressor =
+                make_compressor(Si::make_container_buffer(compressed));
+            for (std::string const &fragment : fragments)
+            {
+                Si::append(compressor,
+                           Si::zlib_sink_element{Si::make_memory_range(
+                               fragment.data(),
+                               fragment.data() + fragment.size())});
+            }
+            Si::append(compressor, Si::zlib_sink_element{Si::finish()});
+            uncompressed = static_cast<std::size_t>(
+                compressor.uncompressed_bytes());
+            compressed_size = compressed.size();
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::microseconds>(boost::chrono::steady_clock::now() -
+                                         started);
+        std::cout << name << ": " << uncompressed << " -> " << compressed_size
+                  << " bytes, "
+                  << (duration.count() /
+                      static_cast<boost::int64_t>(repetitions))
+                  << " us\n";
+    }
+}
+
+#endif
+
+int main()
+{
+#if SILICIUM_HAS_DEFLATING_SINK
+    std::vector<std::string> const fragments = make_fragments();
+    typedef Si::container_buffer<std::vector<char>> buffer;
+    measure("deflate every fragment", fragments, 20, [](buffer next)
+            {
+                return Si::make_deflating_sink(
+                    next, Si::zlib_deflate_stream(Z_DEFAULT_COMPRESSION,
+                                                  Si::zlib_format::gzip),
+                    0);
+            });
+    measure("coalesce fragments", fragments, 20, [](buffer next)
+            {
+                return Si::make_deflating_sink(
+                    next, Si::zlib_deflate_stream(Z_DEFAULT_COMPRESSION,
+                                                  Si::zlib_format::gzip));
+            });
+#if SILICIUM_HAS_PARALLEL_DEFLATING_SINK
+    measure("deflate in parallel", fragments, 20, [](buffer next)
+            {
+                return Si::make_parallel_deflating_sink(
+                    next, Z_DEFAULT_COMPRESSION, Si::zlib_format::gzip);
+            });
+#endif
+#endif
+}
@@ -0,0 +1,77 @@
+#include <silicium/source/source.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <iostream>
+
+namespace
+{
+    /// Produces one element per call, which is the worst case for the cost
+    /// of an erased call.
+    struct counting_source
+    {
+        typedef int element_type;
+
+        int next;
+
+        counting_source()
+            : next(0)
+        {
+        }
+
+        Si::iterator_range<int const *> map_next(std::size_t)
+        {
+            return Si::iterator_range<int const *>();
+        }
+
+        int *copy_next(Si::iterator_range<int *> destination)
+        {
+            if (destination.empty())
+            {
+                return destination.begin();
+            }
+            destination.front() = next++;
+            return destination.begin() + 1;
+        }
+    };
+
+    template <class Source>
+    void measure(char const *name, std::size_t repetitions, Source &source,
+                 long long &sum)
+    {
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            int element;
+            source.copy_next(Si::make_iterator_range(&element, &element + 1));
+            sum += element;
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() -
+                                        started);
+        std::cout << name << ": "
+                  << (static_cast<double>(duration.count()) /
+                      static_cast<double>(repetitions))
+                  << " ns per element\n";
+    }
+}
+
+int main()
+{
+    std::size_t const repetitions = 100000000;
+    long long sum = 0;
+
+    counting_source direct;
+    measure("direct", repetitions, direct, sum);
+
+    Si::Source<int>::eraser<counting_source> eraser =
+        Si::Source<int>::erase(counting_source());
+    measure("eraser (final)", repetitions, eraser, sum);
+
+    Si::Source<int>::box box = Si::Source<int>::make_box(counting_source());
+    measure("box", repetitions, box, sum);
+
+    Si::Source<int>::inline_box inline_box =
+        Si::Source<int>::make_inline_box(counting_source());
+    measure("inline_box", repetitions, inline_box, sum);
+
+    std::cout << sum << '\n';
+}
@@ -0,0 +1,112 @@
+#include <silicium/function.hpp>
+#include <silicium/unique_function.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <functional>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::size_t allocations = 0;
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) BOOST_NOEXCEPT
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) BOOST_NOEXCEPT
+{
+    std::free(memory);
+}
+
+namespace
+{
+    template <class Action>
+    void measure(char const *name, std::size_t repetitions, Action &&action)
+    {
+        std::size_t const allocations_before = allocations;
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            action(i);
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() -
+                                        started);
+        std::cout << name << ": "
+                  << static_cast<double>(allocations - allocations_before) /
+                         static_cast<double>(repetitions)
+                  << " allocations, "
+                  << (static_cast<double>(duration.count()) /
+                      static_cast<double>(repetitions))
+                  << " ns\n";
+    }
+
+    /// Constructs a function from a lambda that captures two pointers like
+    /// a typical completion callback, moves it once and calls it.
+    template <class Function>
+    void construct_move_call(char const *name, std::size_t repetitions,
+                             std::size_t &sum)
+    {
+        measure(name, repetitions, [&sum](std::size_t i)
+                {
+                    std::size_t *const destination = &sum;
+                    std::size_t const *const source = &i;
+                    Function f = [destination, source](std::size_t factor)
+                    {
+                        *destination += *source * factor;
+                    };
+                    Function moved = std::move(f);
+                    moved(2);
+                });
+    }
+
+    template <class Function>
+    void call(char const *name, std::size_t repetitions, std::size_t &sum)
+    {
+        std::size_t *const destination = &sum;
+        Function const f = [destination](std::size_t value)
+        {
+            *destination += value;
+        };
+        measure(name, repetitions, [&f](std::size_t i)
+                {
+                    f(i);
+                });
+    }
+}
+
+int main()
+{
+    std::size_t const repetitions = 10000000;
+    std::size_t sum = 0;
+
+    construct_move_call<std::function<void(std::size_t)>>(
+        "construct std::function", repetitions, sum);
+    construct_move_call<Si::function<void(std::size_t)>>(
+        "construct Si::function", repetitions, sum);
+    construct_move_call<Si::unique_function<void(std::size_t)>>(
+        "construct Si::unique_function", repetitions, sum);
+
+    call<std::function<void(std::size_t)>>(
+        "call std::function", repetitions, sum);
+    call<Si::function<void(std::size_t)>>(
+        "call Si::function", repetitions, sum);
+    call<Si::unique_function<void(std::size_t)>>(
+        "call Si::unique_function", repetitions, sum);
+
+    std::cout << sum << '\n';
+}
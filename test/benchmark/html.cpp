@@ -0,0 +1,77 @@
+#include <silicium/html/tree.hpp>
+#include <silicium/sink/iterator_sink.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <iostream>
+
+#if SILICIUM_HAS_HTML_TREE
+namespace
+{
+    template <class Action>
+    void measure(char const *name, std::size_t repetitions, Action &&action)
+    {
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            action();
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() -
+                                        started);
+        std::cout << name << ": "
+                  << (static_cast<double>(duration.count()) /
+                      static_cast<double>(repetitions))
+                  << " ns\n";
+    }
+
+    /// A page of a dashboard with a mostly static layout.
+    auto make_row()
+#if !SILICIUM_COMPILER_HAS_AUTO_RETURN_TYPE
+        -> decltype(Si::html::tag(
+            "tr", Si::html::attribute("class", "row"),
+            Si::html::tag("td", Si::html::text("build")) +
+                Si::html::tag("td", Si::html::raw("<b>passed</b>")) +
+                Si::html::tag("td", Si::html::text("42 tests, 0 failures"))))
+#endif
+    {
+        using namespace Si::html;
+        return tag("tr", attribute("class", "row"),
+                   tag("td", text("build")) +
+                       tag("td", raw("<b>passed</b>")) +
+                       tag("td", text("42 tests, 0 failures")));
+    }
+}
+#endif
+
+int main()
+{
+#if SILICIUM_HAS_HTML_TREE
+    using namespace Si::html;
+    auto const document = tag(
+        "html",
+        tag("head", tag("title", text("Dashboard"))) +
+            tag("body",
+                tag("table",
+                    make_row() + make_row() + make_row() + make_row() +
+                        make_row() + make_row() + make_row() + make_row()) +
+                    tag("p", attribute("id", std::string("footer")),
+                        text(std::string("generated by Silicium")))));
+    std::size_t const repetitions = 200000;
+    std::size_t sum = 0;
+
+    measure("generate into an erased sink", repetitions, [&]
+            {
+                std::string generated;
+                auto sink = Si::Sink<char, Si::success>::erase(
+                    Si::make_container_sink(generated));
+                document.generate(sink);
+                sum += generated.size();
+            });
+
+    measure("generate<std::string>", repetitions, [&]
+            {
+                sum += generate<std::string>(document).size();
+            });
+
+    std::cout << sum << '\n';
+#endif
+}
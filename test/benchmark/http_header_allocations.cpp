@@ -0,0 +1,130 @@
+#include <silicium/http/parse_request.hpp>
+#include <silicium/http/request_parser_sink.hpp>
+#include <silicium/http/request_view_parser_sink.hpp>
+#include <silicium/source/memory_source.hpp>
+#include <silicium/detail/line_source.hpp>
+#include <silicium/sink/append.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <map>
+
+namespace
+{
+    std::size_t allocations = 0;
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) BOOST_NOEXCEPT
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) BOOST_NOEXCEPT
+{
+    std::free(memory);
+}
+
+namespace
+{
+    std::string const typical_request =
+        "GET /index.html HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:40.0) "
+        "Gecko/20100101 Firefox/40.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/"
+        "*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "\r\n";
+
+    /// how parse_request stored the header before header_table existed
+    std::map<Si::noexcept_string, Si::noexcept_string>
+    parse_into_map(std::string const &incoming)
+    {
+        auto source = Si::make_container_source(incoming);
+        auto lines = Si::detail::make_line_source(source);
+        std::map<Si::noexcept_string, Si::noexcept_string> arguments;
+        Si::optional<std::vector<char>> line = Si::get(lines);
+        for (;;)
+        {
+            line = Si::get(lines);
+            if (!line || line->empty())
+            {
+                break;
+            }
+            auto value = Si::detail::split_value_line(*line);
+            arguments[value.first] = std::move(value.second);
+        }
+        return arguments;
+    }
+
+    template <class Parse>
+    void measure(char const *name, std::size_t repetitions, Parse &&parse)
+    {
+        std::size_t const allocations_before = allocations;
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            parse();
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() -
+                                        started);
+        std::cout << name << ": "
+                  << static_cast<double>(allocations - allocations_before) /
+                         static_cast<double>(repetitions)
+                  << " allocations, "
+                  << (duration.count() / static_cast<boost::int64_t>(repetitions))
+                  << " ns per request\n";
+    }
+}
+
+int main()
+{
+    std::size_t const repetitions = 100000;
+    std::size_t header_count = 0;
+
+    measure("std::map", repetitions, [&]
+            {
+                header_count += parse_into_map(typical_request).size();
+            });
+
+    measure("parse_request", repetitions, [&]
+            {
+                auto source = Si::make_container_source(typical_request);
+                Si::optional<Si::http::request> const parsed =
+                    Si::http::parse_request(source);
+                header_count += parsed->arguments.size();
+            });
+
+    auto reused_parser = Si::http::make_request_parser_sink(
+        Si::null_sink<Si::http::request, Si::success>());
+    measure("request_parser_sink", repetitions, [&]
+            {
+                Si::append(reused_parser, typical_request);
+            });
+
+    auto reused_view_parser = Si::http::make_request_view_parser_sink(
+        Si::null_sink<Si::http::request_view, Si::success>());
+    measure("request_view_parser_sink", repetitions, [&]
+            {
+                Si::append(reused_view_parser, typical_request);
+            });
+
+    std::cout << header_count << " headers parsed\n";
+}
@@ -0,0 +1,123 @@
+#include <silicium/variant.hpp>
+#include <boost/variant.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    template <class Action>
+    void measure(char const *name, std::size_t repetitions, Action &&action)
+    {
+        auto const started = boost::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            action(i);
+        }
+        auto const duration = boost::chrono::duration_cast<
+            boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() -
+                                        started);
+        std::cout << name << ": "
+                  << (static_cast<double>(duration.count()) /
+                      static_cast<double>(repetitions))
+                  << " ns\n";
+    }
+
+    struct length : boost::static_visitor<std::size_t>
+    {
+        std::size_t operator()(std::size_t value) const
+        {
+            return value;
+        }
+
+        std::size_t operator()(std::string const &value) const
+        {
+            return value.size();
+        }
+
+        std::size_t operator()(std::vector<char> const &value) const
+        {
+            return value.size();
+        }
+    };
+
+    struct combined_length : boost::static_visitor<std::size_t>
+    {
+        template <class Left, class Right>
+        std::size_t operator()(Left const &left, Right const &right) const
+        {
+            return length()(left) + length()(right);
+        }
+    };
+
+    /// Visits elements of a message-like variant in the order they were
+    /// stored, so the branch predictor sees a mix of alternatives.
+    template <class Variant>
+    std::vector<Variant> make_elements(std::size_t count)
+    {
+        std::vector<Variant> elements;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            switch (i % 3)
+            {
+            case 0:
+                elements.emplace_back(i);
+                break;
+
+            case 1:
+                elements.emplace_back(std::string("abc"));
+                break;
+
+            default:
+                elements.emplace_back(std::vector<char>(i % 7));
+                break;
+            }
+        }
+        return elements;
+    }
+}
+
+int main()
+{
+    std::size_t const repetitions = 10000000;
+    std::size_t sum = 0;
+
+    typedef Si::variant<std::size_t, std::string, std::vector<char>>
+        si_variant;
+    std::vector<si_variant> const si_elements =
+        make_elements<si_variant>(1024);
+    measure("visit Si::variant", repetitions, [&](std::size_t i)
+            {
+                sum += Si::apply_visitor(length(), si_elements[i % 1024]);
+            });
+
+    typedef boost::variant<std::size_t, std::string, std::vector<char>>
+        boost_variant;
+    std::vector<boost_variant> const boost_elements =
+        make_elements<boost_variant>(1024);
+    measure("visit boost::variant", repetitions, [&](std::size_t i)
+            {
+                sum += boost::apply_visitor(length(), boost_elements[i % 1024]);
+            });
+
+    measure("visit two Si::variants", repetitions, [&](std::size_t i)
+            {
+                sum += Si::apply_visitor(combined_length(),
+                                         si_elements[i % 1024],
+                                         si_elements[(i + 1) % 1024]);
+            });
+
+    measure("visit two boost::variants", repetitions, [&](std::size_t i)
+            {
+                sum += boost::apply_visitor(combined_length(),
+                                            boost_elements[i % 1024],
+                                            boost_elements[(i + 1) % 1024]);
+            });
+
+    measure("compare Si::variants", repetitions, [&](std::size_t i)
+            {
+                sum += (si_elements[i % 1024] == si_elements[(i + 3) % 1024]);
+            });
+
+    std::cout << sum << '\n';
+}
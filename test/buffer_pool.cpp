@@ -0,0 +1,36 @@
+#include <silicium/buffer_pool.hpp>
+#include <limits>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(buffer_pool_reuses_blocks)
+{
+    Si::buffer_pool pool(16, 64);
+    BOOST_CHECK_EQUAL(64u, pool.maximum_size());
+    char *first_data = nullptr;
+    {
+        Si::pooled_block const first = pool.acquire(10);
+        BOOST_CHECK_EQUAL(16u, first.size());
+        first_data = first.data();
+        BOOST_CHECK_EQUAL(0u, pool.cached_blocks());
+    }
+    BOOST_CHECK_EQUAL(1u, pool.cached_blocks());
+    Si::pooled_block const second = pool.acquire(16);
+    BOOST_CHECK_EQUAL(first_data, second.data());
+    BOOST_CHECK_EQUAL(0u, pool.cached_blocks());
+    BOOST_CHECK_EQUAL(64u, pool.acquire(1000).size());
+    BOOST_CHECK_EQUAL(1u, pool.cached_blocks());
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_zero_minimum_size)
+{
+    Si::buffer_pool const pool(0, 8);
+    BOOST_CHECK_EQUAL(1u, pool.minimum_size());
+    BOOST_CHECK_EQUAL(8u, pool.maximum_size());
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_huge_maximum_size)
+{
+    Si::buffer_pool const pool(
+        1024, (std::numeric_limits<std::size_t>::max)(), 0);
+    BOOST_CHECK_LT(1024u, pool.maximum_size());
+}
@@ -0,0 +1,195 @@
+#include <silicium/channel.hpp>
+#include <silicium/asio/yield_wait.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+    template <class Queue>
+    void check_batches(Queue &queue)
+    {
+        std::array<int, 3> const input = {{1, 2, 3}};
+        BOOST_CHECK_EQUAL(3u, queue.push(Si::make_contiguous_range(input)));
+        BOOST_CHECK(queue.can_pop());
+        std::array<int, 2> output;
+        BOOST_CHECK_EQUAL(output.data() + 2,
+                          queue.pop(Si::make_contiguous_range(output)));
+        BOOST_CHECK_EQUAL(1, output[0]);
+        BOOST_CHECK_EQUAL(2, output[1]);
+
+        // wrap around the end of the ring until it is full
+        std::size_t pushed = 0;
+        while (queue.can_push())
+        {
+            pushed += queue.push(Si::make_contiguous_range(input));
+        }
+        BOOST_CHECK_EQUAL(queue.capacity() - 1, pushed);
+        BOOST_CHECK_EQUAL(0u, queue.push(Si::make_contiguous_range(input)));
+        BOOST_CHECK_EQUAL(output.data() + 1,
+                          queue.pop(Si::make_iterator_range(
+                              output.data(), output.data() + 1)));
+        BOOST_CHECK_EQUAL(3, output[0]);
+    }
+
+    /// Sends the numbers from 1 to count in batches of varying size.
+    template <class Sink>
+    void send_numbers(Sink &sink, int count)
+    {
+        std::vector<int> batch;
+        int next = 1;
+        while (next <= count)
+        {
+            batch.clear();
+            for (int i = 0; (i < (next % 13) + 1) && (next <= count); ++i)
+            {
+                batch.push_back(next++);
+            }
+            BOOST_REQUIRE(!sink.append(Si::make_contiguous_range(batch)));
+        }
+    }
+
+    template <class Source>
+    long long receive_sum(Source &source)
+    {
+        long long sum = 0;
+        std::array<int, 17> buffer;
+        for (;;)
+        {
+            int *const end =
+                source.copy_next(Si::make_contiguous_range(buffer));
+            if (end == buffer.data())
+            {
+                return sum;
+            }
+            sum = std::accumulate(buffer.data(), end, sum);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(channel_spsc_ring_batches)
+{
+    Si::spsc_ring<int> ring(5);
+    BOOST_CHECK_EQUAL(8u, ring.capacity());
+    check_batches(ring);
+}
+
+BOOST_AUTO_TEST_CASE(channel_mpmc_queue_batches)
+{
+    Si::mpmc_queue<int> queue(5);
+    BOOST_CHECK_EQUAL(8u, queue.capacity());
+    check_batches(queue);
+}
+
+BOOST_AUTO_TEST_CASE(channel_spsc_threads)
+{
+    int const count = 200000;
+    Si::channel<Si::spsc_ring<int>> channel =
+        Si::make_spsc_channel<int>(64);
+    std::thread producer([&channel]()
+                         {
+                             Si::channel_sink<Si::spsc_ring<int>> writer =
+                                 std::move(channel.writer);
+                             send_numbers(writer, count);
+                         });
+    long long const sum = receive_sum(channel.reader);
+    producer.join();
+    BOOST_CHECK_EQUAL(static_cast<long long>(count) * (count + 1) / 2, sum);
+}
+
+BOOST_AUTO_TEST_CASE(channel_mpmc_threads)
+{
+    int const count = 50000;
+    std::size_t const producer_count = 4;
+    std::size_t const consumer_count = 3;
+    Si::channel<Si::mpmc_queue<int>> channel =
+        Si::make_mpmc_channel<int>(32);
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(consumer_count);
+    for (std::size_t i = 0; i < producer_count; ++i)
+    {
+        std::shared_ptr<Si::channel_sink<Si::mpmc_queue<int>>> const writer =
+            std::make_shared<Si::channel_sink<Si::mpmc_queue<int>>>(
+                (i + 1 == producer_count)
+                    ? std::move(channel.writer)
+                    : channel.writer.clone(Si::blocking_wait()));
+        threads.emplace_back([writer, count]()
+                             {
+                                 send_numbers(*writer, count);
+                                 writer->close();
+                             });
+    }
+    for (std::size_t i = 0; i < consumer_count; ++i)
+    {
+        std::shared_ptr<Si::channel_source<Si::mpmc_queue<int>>> const
+            reader = std::make_shared<
+                Si::channel_source<Si::mpmc_queue<int>>>(
+                (i + 1 == consumer_count)
+                    ? std::move(channel.reader)
+                    : channel.reader.clone(Si::blocking_wait()));
+        long long &sum = sums[i];
+        threads.emplace_back([reader, &sum]()
+                             {
+                                 sum = receive_sum(*reader);
+                             });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(static_cast<long long>(producer_count) * count *
+                          (count + 1) / 2,
+                      std::accumulate(sums.begin(), sums.end(), 0LL));
+}
+
+BOOST_AUTO_TEST_CASE(channel_closed_ends)
+{
+    Si::channel<Si::spsc_ring<int>> channel = Si::make_spsc_channel<int>(4);
+    std::array<int, 2> const input = {{1, 2}};
+    BOOST_REQUIRE(!channel.writer.append(Si::make_contiguous_range(input)));
+    channel.writer.close();
+
+    // the rest can still be read after the writer is gone
+    std::array<int, 4> output;
+    Si::iterator_range<int *> const destination =
+        Si::make_contiguous_range(output);
+    BOOST_CHECK_EQUAL(
+        output.data() + 2, channel.reader.copy_next(destination));
+    BOOST_CHECK_EQUAL(output.data(), channel.reader.copy_next(destination));
+
+    Si::channel<Si::spsc_ring<int>> other = Si::make_spsc_channel<int>(4);
+    other.reader.close();
+    BOOST_CHECK(boost::system::errc::broken_pipe ==
+                other.writer.append(Si::make_contiguous_range(input)));
+}
+
+#if SILICIUM_HAS_ASIO_YIELD_WAIT
+BOOST_AUTO_TEST_CASE(channel_yield_wait)
+{
+    int const count = 100000;
+    Si::channel<Si::spsc_ring<int>> channel =
+        Si::make_spsc_channel<int>(16);
+    boost::asio::io_service io;
+    long long sum = 0;
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            Si::channel_source<Si::spsc_ring<int>, Si::asio::yield_wait>
+                reader = channel.reader.with_wait(Si::asio::yield_wait(yield));
+            sum = receive_sum(reader);
+        });
+    // the writer thread must not be started before the coroutine has taken
+    // the reader
+    io.poll();
+    std::thread producer([&channel]()
+                         {
+                             Si::channel_sink<Si::spsc_ring<int>> writer =
+                                 std::move(channel.writer);
+                             send_numbers(writer, count);
+                         });
+    io.run();
+    producer.join();
+    BOOST_CHECK_EQUAL(static_cast<long long>(count) * (count + 1) / 2, sum);
+}
+#endif
@@ -0,0 +1,332 @@
+#include <silicium/compression/select.hpp>
+#include <silicium/sink/container_buffer.hpp>
+#include <silicium/sink/append.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+
+#if SILICIUM_HAS_COMPRESSION_CODEC
+namespace
+{
+    std::vector<Si::compression_format> available_formats()
+    {
+        std::vector<Si::compression_format> formats;
+        for (Si::compression_format format :
+             {Si::compression_format::zlib, Si::compression_format::gzip,
+              Si::compression_format::raw_deflate,
+              Si::compression_format::zstd, Si::compression_format::lz4})
+        {
+            if (Si::is_available(format))
+            {
+                formats.push_back(format);
+            }
+        }
+        return formats;
+    }
+
+    std::string make_text(std::size_t length)
+    {
+        std::string text;
+        for (std::size_t i = 0; text.size() < length; ++i)
+        {
+            text += "{\"id\": " + boost::lexical_cast<std::string>(i) +
+                    ", \"name\": \"item " +
+                    boost::lexical_cast<std::string>(i * 31 % 1000) + "\"}\n";
+        }
+        text.resize(length);
+        return text;
+    }
+
+    template <class Compressor>
+    void append_in_pieces(Compressor &compressor, std::string const &original,
+                          std::size_t piece_size)
+    {
+        for (std::size_t i = 0; i < original.size(); i += piece_size)
+        {
+            std::size_t const end = (std::min)(original.size(), i + piece_size);
+            BOOST_REQUIRE(!Si::append(
+                compressor, Si::compression_sink_element{Si::make_memory_range(
+                                original.data() + i, original.data() + end)}));
+        }
+    }
+
+    std::vector<char> compress(Si::compression_settings const &settings,
+                               std::string const &original,
+                               std::size_t piece_size)
+    {
+        std::vector<char> compressed;
+        auto compressor =
+            Si::make_compressing_sink(Si::make_container_buffer(compressed),
+                                      Si::make_compressor(settings));
+        append_in_pieces(compressor, original, piece_size);
+        BOOST_REQUIRE(!Si::append(compressor,
+                                  Si::compression_sink_element{Si::finish()}));
+        BOOST_CHECK_EQUAL(original.size(), compressor.uncompressed_bytes());
+        BOOST_CHECK_EQUAL(compressed.size(), compressor.compressed_bytes());
+        return compressed;
+    }
+
+    struct decompressed
+    {
+        std::string content;
+        boost::system::error_code error;
+        bool is_complete;
+    };
+
+    decompressed decompress(Si::compression_format format,
+                            std::vector<char> const &compressed,
+                            std::size_t piece_size, std::size_t max_output,
+                            Si::memory_range dictionary = Si::memory_range())
+    {
+        std::vector<char> content;
+        Si::decompressing_sink<Si::container_buffer<std::vector<char>>,
+                               Si::Codec::box>
+            decompressor(Si::make_container_buffer(content),
+                         Si::make_decompressor(format, dictionary),
+                         max_output);
+        decompressed result;
+        for (std::size_t i = 0; i < compressed.size(); i += piece_size)
+        {
+            std::size_t const end =
+                (std::min)(compressed.size(), i + piece_size);
+            result.error = decompressor.append(Si::make_memory_range(
+                compressed.data() + i, compressed.data() + end));
+            if (result.error)
+            {
+                break;
+            }
+        }
+        result.content.assign(content.begin(), content.end());
+        result.is_complete = decompressor.is_complete();
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_round_trip)
+{
+    std::string const original = make_text(300000);
+    for (Si::compression_format format : available_formats())
+    {
+        BOOST_TEST_MESSAGE(Si::to_string(format));
+        std::vector<char> const compressed =
+            compress(Si::compression_settings(format), original, 777);
+        BOOST_CHECK_LT(compressed.size(), original.size() / 2);
+        // a small max_output makes the codecs stop with output pending
+        decompressed const result =
+            decompress(format, compressed, 1000, 1024);
+        BOOST_CHECK(!result.error);
+        BOOST_CHECK(result.is_complete);
+        BOOST_CHECK(original == result.content);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_empty)
+{
+    for (Si::compression_format format : available_formats())
+    {
+        BOOST_TEST_MESSAGE(Si::to_string(format));
+        std::vector<char> const compressed =
+            compress(Si::compression_settings(format), "", 1);
+        BOOST_CHECK(!compressed.empty());
+        decompressed const result = decompress(format, compressed, 1, 100);
+        BOOST_CHECK(!result.error);
+        BOOST_CHECK(result.is_complete);
+        BOOST_CHECK_EQUAL("", result.content);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_flush)
+{
+    for (Si::compression_format format : available_formats())
+    {
+        BOOST_TEST_MESSAGE(Si::to_string(format));
+        for (Si::compression_sink_element const &flush :
+             {Si::compression_sink_element{Si::flush()},
+              Si::compression_sink_element{Si::full_flush()}})
+        {
+            std::vector<char> compressed;
+            auto compressor = Si::make_compressing_sink(
+                Si::make_container_buffer(compressed),
+                Si::make_compressor(Si::compression_settings(format)));
+            BOOST_REQUIRE(!Si::append(compressor,
+                                      Si::compression_sink_element{
+                                          Si::make_c_str_range("Hello")}));
+            BOOST_CHECK(compressed.empty());
+            BOOST_REQUIRE(!Si::append(compressor, flush));
+
+            // everything appended so far can be decompressed now
+            decompressed const flushed =
+                decompress(format, compressed, compressed.size(), 100);
+            BOOST_CHECK(!flushed.error);
+            BOOST_CHECK_EQUAL("Hello", flushed.content);
+
+            BOOST_REQUIRE(!Si::append(compressor,
+                                      Si::compression_sink_element{
+                                          Si::make_c_str_range(", world")}));
+            BOOST_REQUIRE(!Si::append(
+                compressor, Si::compression_sink_element{Si::finish()}));
+            decompressed const finished = decompress(format, compressed, 3, 5);
+            BOOST_CHECK(!finished.error);
+            BOOST_CHECK(finished.is_complete);
+            BOOST_CHECK_EQUAL("Hello, world", finished.content);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_truncated)
+{
+    std::string const original = make_text(10000);
+    for (Si::compression_format format : available_formats())
+    {
+        BOOST_TEST_MESSAGE(Si::to_string(format));
+        std::vector<char> compressed =
+            compress(Si::compression_settings(format), original, 100);
+        compressed.resize(compressed.size() - 4);
+        decompressed const result =
+            decompress(format, compressed, compressed.size(), 4096);
+        BOOST_CHECK(!result.error);
+        BOOST_CHECK(!result.is_complete);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_corrupted)
+{
+    std::string const original = make_text(10000);
+    for (Si::compression_format format : available_formats())
+    {
+        BOOST_TEST_MESSAGE(Si::to_string(format));
+        std::vector<char> compressed =
+            compress(Si::compression_settings(format), original, 100);
+        std::fill(compressed.begin(), compressed.begin() + 4, '\0');
+        decompressed const result =
+            decompress(format, compressed, compressed.size(), 4096);
+        BOOST_CHECK(result.error);
+        BOOST_CHECK(!result.is_complete);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_unavailable)
+{
+    for (Si::compression_format format :
+         {Si::compression_format::zlib, Si::compression_format::zstd,
+          Si::compression_format::lz4})
+    {
+        if (Si::is_available(format))
+        {
+            BOOST_CHECK_NO_THROW(
+                Si::make_compressor(Si::compression_settings(format)));
+            continue;
+        }
+        BOOST_CHECK_THROW(
+            Si::make_compressor(Si::compression_settings(format)),
+            std::invalid_argument);
+        BOOST_CHECK_THROW(Si::make_decompressor(format),
+                          std::invalid_argument);
+    }
+}
+
+#if SILICIUM_HAS_ZLIB_CODEC
+BOOST_AUTO_TEST_CASE(compression_codec_zlib_compatible)
+{
+    // the generic sink with a concrete codec produces what zlib expects
+    std::string const original = make_text(50000);
+    std::vector<char> compressed;
+    auto compressor = Si::make_compressing_sink(
+        Si::make_container_buffer(compressed),
+        Si::zlib_compressor(Z_BEST_SPEED, Si::zlib_format::gzip));
+    append_in_pieces(compressor, original, 50);
+    BOOST_REQUIRE(!Si::append(compressor,
+                              Si::compression_sink_element{Si::finish()}));
+    std::vector<char> decompressed;
+    auto decompressor = Si::make_inflating_sink(
+        Si::make_container_buffer(decompressed),
+        Si::zlib_inflate_stream(Si::zlib_format::gzip));
+    BOOST_REQUIRE(!Si::append_range(
+        decompressor,
+        Si::make_memory_range(compressed.data(),
+                              compressed.data() + compressed.size())));
+    BOOST_CHECK(decompressor.is_complete());
+    BOOST_CHECK(original ==
+                std::string(decompressed.begin(), decompressed.end()));
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_zlib_end_and_error)
+{
+    Si::zlib_compressor compressor(Z_BEST_SPEED, Si::zlib_format::zlib);
+    std::array<char, 64> output;
+    Si::error_or<Si::codec_progress> const finished = compressor.process(
+        Si::memory_range(), Si::make_memory_range(output),
+        Si::codec_flush::finish);
+    BOOST_REQUIRE(!finished.is_error());
+    BOOST_CHECK(finished.get().is_end);
+    BOOST_CHECK_LT(0u, finished.get().produced);
+
+    // a finished stream cannot take more input
+    std::string const more = "more";
+    Si::error_or<Si::codec_progress> const after_end = compressor.process(
+        Si::make_memory_range(more), Si::make_memory_range(output),
+        Si::codec_flush::none);
+    BOOST_REQUIRE(after_end.is_error());
+    BOOST_CHECK_EQUAL(
+        boost::system::error_code(Z_STREAM_ERROR, Si::zlib_category()),
+        after_end.error());
+}
+#endif
+
+#if SILICIUM_HAS_ZSTD_CODEC
+namespace
+{
+    Si::memory_range as_range(std::string const &content)
+    {
+        return Si::make_memory_range(content.data(),
+                                     content.data() + content.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_zstd_dictionary)
+{
+    std::string const dictionary = make_text(20000);
+    std::string const message = "{\"id\": 17, \"name\": \"item 527\"}\n"
+                                "{\"id\": 18, \"name\": \"item 558\"}\n";
+    Si::compression_settings settings(Si::compression_format::zstd);
+    std::vector<char> const without = compress(settings, message, 10);
+    settings.dictionary = as_range(dictionary);
+    std::vector<char> const with = compress(settings, message, 10);
+    BOOST_CHECK_LT(with.size(), without.size());
+
+    decompressed const result = decompress(Si::compression_format::zstd, with,
+                                           with.size(), 100,
+                                           as_range(dictionary));
+    BOOST_CHECK(!result.error);
+    BOOST_CHECK(result.is_complete);
+    BOOST_CHECK_EQUAL(message, result.content);
+
+    decompressed const unknown_dictionary = decompress(
+        Si::compression_format::zstd, with, with.size(), 100);
+    BOOST_CHECK(unknown_dictionary.error);
+}
+
+BOOST_AUTO_TEST_CASE(compression_codec_zstd_threads)
+{
+    std::string const original = make_text(3000000);
+    Si::compression_settings settings(Si::compression_format::zstd);
+    settings.threads = 2;
+    std::unique_ptr<Si::Codec::box> compressor;
+    try
+    {
+        compressor.reset(new Si::Codec::box(Si::make_compressor(settings)));
+    }
+    catch (boost::system::system_error const &)
+    {
+        // libzstd was built without multi-threading
+        return;
+    }
+    std::vector<char> const compressed = compress(settings, original, 100000);
+    decompressed const result = decompress(
+        Si::compression_format::zstd, compressed, compressed.size(), 65536);
+    BOOST_CHECK(!result.error);
+    BOOST_CHECK(result.is_complete);
+    BOOST_CHECK(original == result.content);
+}
+#endif
+#endif
@@ -233,6 +233,47 @@ BOOST_AUTO_TEST_CASE(html_tree_dynamic_text)
     BOOST_CHECK_EQUAL("<i>content</i>", generated);
 }
 
+BOOST_AUTO_TEST_CASE(html_tree_escapes_text)
+{
+    using namespace Si::html;
+    auto document = tag("p", attribute("title", "a\"b") +
+                                 attribute("alt", std::string("<x>")),
+                        text("&Tom & Jerry's<") + text(std::string("\"")));
+    std::string generated = generate<std::string>(document);
+    BOOST_CHECK_EQUAL("<p title=\"a&quot;b\" alt=\"&lt;x&gt;\">&amp;Tom &amp; "
+                      "Jerry&apos;s&lt;&quot;</p>",
+                      generated);
+}
+
+BOOST_AUTO_TEST_CASE(html_tree_generate_reserves_length)
+{
+    using namespace Si::html;
+    auto document = tag("html", tag("body", text("Hello") + raw("<br/>")));
+    std::string generated = generate<std::string>(document);
+    BOOST_CHECK_EQUAL("<html><body>Hello<br/></body></html>", generated);
+    BOOST_CHECK_GE(generated.capacity(),
+                   decltype(document)::length_type::value);
+}
+
+#if SILICIUM_COMPILER_CXX14
+BOOST_AUTO_TEST_CASE(html_tree_dynamic_without_erasure)
+{
+    using namespace Si::html;
+    bool was_erased = true;
+    auto document = tag("i", dynamic([&was_erased](auto &destination)
+                                     {
+                                         was_erased = std::is_base_of<
+                                             code_sink,
+                                             typename std::decay<decltype(
+                                                 destination)>::type>::value;
+                                         Si::append(destination, "content");
+                                     }));
+    std::string generated = generate<std::string>(document);
+    BOOST_CHECK_EQUAL("<i>content</i>", generated);
+    BOOST_CHECK(!was_erased);
+}
+#endif
+
 BOOST_AUTO_TEST_CASE(html_tree_produces_same_output_as_generator)
 {
     bool const build_triggered = true;
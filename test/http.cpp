@@ -1,13 +1,14 @@
 #include <silicium/http/http.hpp>
 #include <silicium/http/request_parser_sink.hpp>
+#include <silicium/http/request_view_parser_sink.hpp>
 #include <silicium/source/memory_source.hpp>
 #include <silicium/variant.hpp>
 #include <silicium/sink/iterator_sink.hpp>
 #include <silicium/sink/ptr_sink.hpp>
+#include <silicium/sink/function_sink.hpp>
 #include <silicium/error_or.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/utility/in_place_factory.hpp>
-#include <boost/assign/list_of.hpp>
 
 BOOST_AUTO_TEST_CASE(http_parse_header)
 {
@@ -21,9 +22,8 @@ BOOST_AUTO_TEST_CASE(http_parse_header)
     BOOST_CHECK_EQUAL("GET", parsed->method);
     BOOST_CHECK_EQUAL("/", parsed->path);
     BOOST_CHECK_EQUAL("HTTP/1.0", parsed->http_version);
-    std::map<Si::noexcept_string, Si::noexcept_string> const
-        expected_arguments =
-            boost::assign::list_of(std::make_pair("Key", "Value"));
+    Si::http::header_table expected_arguments;
+    expected_arguments.add("Key", "Value");
     BOOST_CHECK(expected_arguments == parsed->arguments);
 }
 
@@ -35,7 +35,7 @@ BOOST_AUTO_TEST_CASE(http_write_request_header)
     header.http_version = "HTTP/1.1";
     header.method = "POST";
     header.path = "/p";
-    header.arguments["Content-Length"] = "13";
+    header.arguments.set("Content-Length", "13");
     generate_request(sink, header);
     BOOST_CHECK_EQUAL("POST /p HTTP/1.1\r\n"
                       "Content-Length: 13\r\n"
@@ -85,8 +85,353 @@ BOOST_AUTO_TEST_CASE(http_request_parser_sink)
     BOOST_CHECK_EQUAL("HTTP/1.1", result.http_version);
     BOOST_CHECK_EQUAL(1u, result.arguments.size());
     {
-        std::map<Si::noexcept_string, Si::noexcept_string> expected_arguments;
-        expected_arguments.insert(std::make_pair("Host", "host"));
+        Si::http::header_table expected_arguments;
+        expected_arguments.add("Host", "host");
         BOOST_CHECK(expected_arguments == result.arguments);
     }
-}
\ No newline at end of file
+}
+#if SILICIUM_HAS_HTTP_REQUEST_VIEW
+namespace
+{
+    struct request_collector
+    {
+        typedef Si::http::request_view element_type;
+        typedef Si::success error_type;
+
+        std::vector<Si::http::request> *results;
+
+        explicit request_collector(std::vector<Si::http::request> &results)
+            : results(&results)
+        {
+        }
+
+        Si::success append(Si::iterator_range<element_type const *> requests)
+        {
+            for (Si::http::request_view const &request : requests)
+            {
+                results->emplace_back(Si::http::to_request(request));
+            }
+            return Si::success();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(http_request_view_parser_sink_single_append)
+{
+    std::vector<Si::http::request> results;
+    bool arguments_point_into_input = false;
+    std::string const incoming = "GET /a HTTP/1.1\r\n"
+                                 "Host: host\r\n"
+                                 "Accept:\t*/*\r\n"
+                                 "\r\n";
+    auto parser = Si::http::make_request_view_parser_sink(
+        Si::make_function_sink<Si::http::request_view>(
+            [&](Si::iterator_range<Si::http::request_view const *> requests)
+            {
+                BOOST_REQUIRE_EQUAL(1, requests.size());
+                Si::http::request_view const &request = requests.front();
+                arguments_point_into_input =
+                    (request.method.data() == incoming.data());
+                results.emplace_back(Si::http::to_request(request));
+                return Si::success();
+            }));
+    Si::append(parser, incoming);
+    BOOST_CHECK(arguments_point_into_input);
+    BOOST_REQUIRE_EQUAL(1u, results.size());
+    Si::http::request const &result = results[0];
+    BOOST_CHECK_EQUAL("GET", result.method);
+    BOOST_CHECK_EQUAL("/a", result.path);
+    BOOST_CHECK_EQUAL("HTTP/1.1", result.http_version);
+    Si::http::header_table expected_arguments;
+    expected_arguments.add("Host", "host");
+    expected_arguments.add("Accept", "*/*");
+    BOOST_CHECK(expected_arguments == result.arguments);
+}
+
+BOOST_AUTO_TEST_CASE(http_request_view_parser_sink_byte_by_byte)
+{
+    std::vector<Si::http::request> results;
+    auto parser = Si::http::make_request_view_parser_sink(
+        request_collector(results));
+    std::string const incoming = "POST /long/path/to/something HTTP/1.0\r\n"
+                                 "Content-Type: text/plain\r\n"
+                                 "\r\n";
+    for (char c : incoming)
+    {
+        BOOST_CHECK(results.empty());
+        Si::append(parser, c);
+    }
+    BOOST_REQUIRE_EQUAL(1u, results.size());
+    Si::http::request const &result = results[0];
+    BOOST_CHECK_EQUAL("POST", result.method);
+    BOOST_CHECK_EQUAL("/long/path/to/something", result.path);
+    BOOST_CHECK_EQUAL("HTTP/1.0", result.http_version);
+    BOOST_REQUIRE_EQUAL(1u, result.arguments.size());
+    BOOST_CHECK_EQUAL("text/plain",
+                      result.arguments.find("Content-Type")->second);
+}
+
+BOOST_AUTO_TEST_CASE(http_request_view_parser_sink_several_requests)
+{
+    std::vector<Si::http::request> results;
+    auto parser = Si::http::make_request_view_parser_sink(
+        request_collector(results));
+    Si::append(parser, std::string("GET /1 HTTP/1.1\r\n\r\n"
+                                   "GET /2 HTTP/1.1\r\n"
+                                   "A: b\r\n"
+                                   "\r\n"
+                                   "GET /3 HTT"));
+    BOOST_REQUIRE_EQUAL(2u, results.size());
+    Si::append(parser, std::string("P/1.1\n\n"));
+    BOOST_REQUIRE_EQUAL(3u, results.size());
+    BOOST_CHECK_EQUAL("/1", results[0].path);
+    BOOST_CHECK(results[0].arguments.empty());
+    BOOST_CHECK_EQUAL("/2", results[1].path);
+    BOOST_CHECK_EQUAL("b", results[1].arguments.find("A")->second);
+    BOOST_CHECK_EQUAL("/3", results[2].path);
+    BOOST_CHECK_EQUAL("HTTP/1.1", results[2].http_version);
+}
+
+BOOST_AUTO_TEST_CASE(http_request_view_parser_sink_head_too_large)
+{
+    typedef Si::http::request_view_parser_sink<request_collector> parser_type;
+    std::vector<Si::http::request> results;
+    parser_type parser(request_collector(results),
+                       Si::null_sink<Si::http::body_element, Si::success>(),
+                       32);
+    Si::append(parser, std::string("GET /1 HTTP/1.1\r\n\r\n"));
+    BOOST_CHECK_EQUAL(1u, results.size());
+    BOOST_CHECK(!parser.has_failed());
+    // a peer that never ends its header is stopped at the limit
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        Si::append(parser, std::string("GET /"));
+    }
+    BOOST_CHECK(parser.has_failed());
+    BOOST_CHECK_EQUAL(1u, results.size());
+
+    parser_type single(request_collector(results),
+                       Si::null_sink<Si::http::body_element, Si::success>(),
+                       32);
+    Si::append(single,
+               std::string("GET /a/long/path/that/does/not/fit HTTP/1.1"));
+    BOOST_CHECK(single.has_failed());
+    BOOST_CHECK_EQUAL(1u, results.size());
+}
+#endif
+
+#if SILICIUM_HAS_HTTP_MESSAGE_BODY
+namespace
+{
+    struct body_collector
+    {
+        typedef Si::http::body_element element_type;
+        typedef Si::success error_type;
+
+        std::vector<std::string> *bodies;
+        bool *is_complete;
+
+        body_collector(std::vector<std::string> &bodies, bool &is_complete)
+            : bodies(&bodies)
+            , is_complete(&is_complete)
+        {
+        }
+
+        Si::success append(Si::iterator_range<element_type const *> elements)
+        {
+            for (element_type const &element : elements)
+            {
+                Si::visit<void>(element,
+                                [this](Si::memory_range piece)
+                                {
+                                    if (*is_complete)
+                                    {
+                                        bodies->emplace_back();
+                                        *is_complete = false;
+                                    }
+                                    bodies->back().append(
+                                        piece.begin(), piece.end());
+                                },
+                                [this](Si::http::end_of_body)
+                                {
+                                    if (*is_complete)
+                                    {
+                                        bodies->emplace_back();
+                                    }
+                                    *is_complete = true;
+                                });
+            }
+            return Si::success();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_content_length_and_pipelining)
+{
+    std::vector<Si::http::request> results;
+    std::vector<std::string> bodies;
+    bool is_complete = true;
+    auto parser = Si::http::make_request_parser_sink(
+        Si::make_container_sink(results), body_collector(bodies, is_complete));
+    Si::append(parser, "POST /a HTTP/1.1\r\n"
+                       "Content-Length: 11\r\n"
+                       "\r\n"
+                       "hello");
+    BOOST_REQUIRE_EQUAL(1u, results.size());
+    BOOST_CHECK(!is_complete);
+    Si::append(parser, " world"
+                       "GET /b HTTP/1.1\r\n"
+                       "\r\n"
+                       "PUT /c HTTP/1.1\r\n"
+                       "content-length: 3\r\n"
+                       "\r\n"
+                       "abc");
+    BOOST_CHECK(!parser.has_failed());
+    BOOST_REQUIRE_EQUAL(3u, results.size());
+    BOOST_CHECK_EQUAL("/a", results[0].path);
+    BOOST_CHECK_EQUAL("/b", results[1].path);
+    BOOST_CHECK_EQUAL("PUT", results[2].method);
+    BOOST_CHECK_EQUAL("/c", results[2].path);
+    std::vector<std::string> const expected_bodies{"hello world", "", "abc"};
+    BOOST_CHECK(expected_bodies == bodies);
+    BOOST_CHECK(is_complete);
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_chunked)
+{
+    std::string const incoming = "POST / HTTP/1.1\r\n"
+                                 "Transfer-Encoding: gzip, chunked\r\n"
+                                 "\r\n"
+                                 "5;name=value\r\n"
+                                 "Hello\r\n"
+                                 "A\r\n"
+                                 ", chunked!\r\n"
+                                 "0\r\n"
+                                 "Trailer: ignored\r\n"
+                                 "\r\n"
+                                 "GET /next HTTP/1.1\r\n"
+                                 "\r\n";
+    std::vector<Si::http::request> results;
+    std::vector<std::string> bodies;
+    bool is_complete = true;
+    auto parser = Si::http::make_request_parser_sink(
+        Si::make_container_sink(results), body_collector(bodies, is_complete));
+    for (char c : incoming)
+    {
+        Si::append(parser, c);
+    }
+    BOOST_CHECK(!parser.has_failed());
+    BOOST_REQUIRE_EQUAL(2u, results.size());
+    BOOST_CHECK_EQUAL("/next", results[1].path);
+    std::vector<std::string> const expected_bodies{"Hello, chunked!", ""};
+    BOOST_CHECK(expected_bodies == bodies);
+    BOOST_CHECK(is_complete);
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_invalid_chunk_size)
+{
+    for (char const *chunk_size : {"1x\r\n", "x\r\n", "1-\r\n"})
+    {
+        std::vector<Si::http::request> results;
+        auto parser = Si::http::make_request_parser_sink(
+            Si::make_container_sink(results));
+        Si::append(parser, std::string("POST / HTTP/1.1\r\n"
+                                       "Transfer-Encoding: chunked\r\n"
+                                       "\r\n") +
+                               chunk_size +
+                               "a\r\n"
+                               "0\r\n"
+                               "\r\n"
+                               "GET / HTTP/1.1\r\n"
+                               "\r\n");
+        BOOST_CHECK(parser.has_failed());
+        BOOST_CHECK_EQUAL(1u, results.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_invalid_content_length)
+{
+    std::vector<Si::http::request> results;
+    auto parser =
+        Si::http::make_request_parser_sink(Si::make_container_sink(results));
+    Si::append(parser, "POST / HTTP/1.1\r\n"
+                       "Content-Length: -1\r\n"
+                       "\r\n"
+                       "GET / HTTP/1.1\r\n"
+                       "\r\n");
+    BOOST_CHECK(parser.has_failed());
+    BOOST_CHECK_EQUAL(1u, results.size());
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_conflicting_content_length)
+{
+    std::vector<Si::http::request> results;
+    auto parser =
+        Si::http::make_request_parser_sink(Si::make_container_sink(results));
+    Si::append(parser, "POST / HTTP/1.1\r\n"
+                       "Content-Length: 4\r\n"
+                       "content-length: 30\r\n"
+                       "\r\n"
+                       "1234"
+                       "GET / HTTP/1.1\r\n"
+                       "\r\n");
+    BOOST_CHECK(parser.has_failed());
+    BOOST_CHECK_EQUAL(1u, results.size());
+}
+
+BOOST_AUTO_TEST_CASE(http_request_parser_sink_repeated_content_length)
+{
+    std::vector<Si::http::request> results;
+    auto parser =
+        Si::http::make_request_parser_sink(Si::make_container_sink(results));
+    Si::append(parser, "POST / HTTP/1.1\r\n"
+                       "Content-Length: 4\r\n"
+                       "Content-Length: 4\r\n"
+                       "\r\n"
+                       "1234"
+                       "GET / HTTP/1.1\r\n"
+                       "\r\n");
+    BOOST_CHECK(!parser.has_failed());
+    BOOST_CHECK_EQUAL(2u, results.size());
+}
+
+BOOST_AUTO_TEST_CASE(http_is_keep_alive)
+{
+    Si::http::header_table headers;
+    BOOST_CHECK(Si::http::is_keep_alive("HTTP/1.1", headers));
+    BOOST_CHECK(!Si::http::is_keep_alive("HTTP/1.0", headers));
+    headers.set("Connection", "Upgrade, Close");
+    BOOST_CHECK(!Si::http::is_keep_alive("HTTP/1.1", headers));
+    headers.set("connection", "keep-alive");
+    BOOST_CHECK(Si::http::is_keep_alive("HTTP/1.0", headers));
+}
+
+#if SILICIUM_HAS_HTTP_REQUEST_VIEW
+BOOST_AUTO_TEST_CASE(http_request_view_parser_sink_bodies)
+{
+    std::vector<Si::http::request> results;
+    std::vector<std::string> bodies;
+    bool is_complete = true;
+    auto parser = Si::http::make_request_view_parser_sink(
+        request_collector(results), body_collector(bodies, is_complete));
+    Si::append(parser, std::string("POST /1 HTTP/1.1\r\n"
+                                   "Content-Length: 4\r\n"
+                                   "\r\n"
+                                   "1234"
+                                   "POST /2 HTTP/1.1\r\n"
+                                   "Transfer-Encoding: chunked\r\n"
+                                   "\r\n"
+                                   "2\r\n"
+                                   "ab\r\n"
+                                   "0\r\n"
+                                   "\r\n"
+                                   "GET /3 HTTP/1.1\r\n"
+                                   "\r\n"));
+    BOOST_CHECK(!parser.has_failed());
+    BOOST_REQUIRE_EQUAL(3u, results.size());
+    BOOST_CHECK_EQUAL("/3", results[2].path);
+    std::vector<std::string> const expected_bodies{"1234", "ab", ""};
+    BOOST_CHECK(expected_bodies == bodies);
+}
+#endif
+#endif
@@ -0,0 +1,114 @@
+#include <silicium/http/header_table.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+
+BOOST_AUTO_TEST_CASE(http_header_table_empty)
+{
+    Si::http::header_table const table;
+    BOOST_CHECK(table.empty());
+    BOOST_CHECK_EQUAL(0u, table.size());
+    BOOST_CHECK(table.begin() == table.end());
+    BOOST_CHECK(table.find("Host") == table.end());
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_case_insensitive_find)
+{
+    Si::http::header_table table;
+    table.add("Content-Length", "12");
+    table.add("Host", "localhost");
+    BOOST_REQUIRE_EQUAL(2u, table.size());
+    BOOST_REQUIRE(table.find("content-length") != table.end());
+    BOOST_CHECK_EQUAL("12", table.find("content-length")->second);
+    BOOST_CHECK_EQUAL("Content-Length", table.find("CONTENT-LENGTH")->first);
+    BOOST_CHECK_EQUAL("localhost", table.find("hOST")->second);
+    BOOST_CHECK_EQUAL(0u, table.count("Hos"));
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_set)
+{
+    Si::http::header_table table;
+    table.set("A", "1");
+    table.set("B", "2");
+    table.set("a", "a much longer value than before");
+    BOOST_REQUIRE_EQUAL(2u, table.size());
+    BOOST_CHECK_EQUAL("A", table.begin()[0].first);
+    BOOST_CHECK_EQUAL("a much longer value than before",
+                      table.begin()[0].second);
+    BOOST_CHECK_EQUAL("2", table.begin()[1].second);
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_repeated_set_is_bounded)
+{
+    Si::http::header_table table;
+    table.add("Host", "localhost");
+    table.set("Content-Length", "0");
+    std::size_t largest = 0;
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        std::string const value = boost::lexical_cast<std::string>(i);
+        table.set("Content-Length", value);
+        table.set("ETag", std::string(i % 50, 'e'));
+        BOOST_REQUIRE_EQUAL(value, table.find("content-length")->second);
+        BOOST_REQUIRE_EQUAL(std::string(i % 50, 'e'),
+                            table.find("etag")->second);
+        largest = (std::max)(largest, table.buffered_characters());
+    }
+    BOOST_CHECK_EQUAL("localhost", table.find("Host")->second);
+    BOOST_CHECK_LE(largest, 200u);
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_arrival_order_beyond_inline_capacity)
+{
+    Si::http::header_table table;
+    std::size_t const count = Si::http::header_table::inline_capacity * 3;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::string const name = "Name" + boost::lexical_cast<std::string>(i);
+        table.add(name, std::string(i, 'v'));
+    }
+    BOOST_REQUIRE_EQUAL(count, table.size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::string const name = "name" + boost::lexical_cast<std::string>(i);
+        BOOST_CHECK_EQUAL(std::string(i, 'v'), table.find(name)->second);
+        BOOST_CHECK(table.find(name) == (table.begin() + i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_copy_and_move)
+{
+    Si::http::header_table original;
+    original.add("Key", "Value");
+    Si::http::header_table copy = original;
+    BOOST_CHECK(copy == original);
+    BOOST_CHECK(copy.begin()->first.data() != original.begin()->first.data());
+    Si::http::header_table moved = std::move(original);
+    BOOST_CHECK(moved == copy);
+    copy.add("Other", "");
+    BOOST_CHECK(moved != copy);
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_add_from_itself)
+{
+    Si::http::header_table table;
+    table.add("Key", "Value");
+    for (int i = 0; i < 100; ++i)
+    {
+        Si::http::header_view const first = *table.begin();
+        table.add(first.second, first.first);
+    }
+    BOOST_REQUIRE_EQUAL(101u, table.size());
+    BOOST_CHECK_EQUAL("Value", table.begin()[100].first);
+    BOOST_CHECK_EQUAL("Key", table.begin()[100].second);
+}
+
+BOOST_AUTO_TEST_CASE(http_header_table_clear_keeps_capacity)
+{
+    Si::http::header_table table;
+    table.add("Key", "Value");
+    char const *const storage = table.begin()->first.data();
+    table.clear();
+    BOOST_CHECK(table.empty());
+    table.add("Abc", "Def");
+    BOOST_CHECK_EQUAL(storage, table.begin()->first.data());
+}
@@ -1,6 +1,7 @@
 #include <silicium/sink/iterator_sink.hpp>
 #include <silicium/sink/buffering_sink.hpp>
 #include <silicium/sink/append.hpp>
+#include <silicium/sink/ptr_sink.hpp>
 #include <boost/test/unit_test.hpp>
 
 #if SILICIUM_HAS_BUFFERING_SINK
@@ -34,3 +35,115 @@ BOOST_AUTO_TEST_CASE(buffering_sink_make_append_space)
         expected.begin(), expected.end(), v.begin(), v.end());
 }
 #endif
+
+namespace
+{
+    struct gathering_sink
+    {
+        typedef char element_type;
+        typedef Si::success error_type;
+
+        std::string written;
+        std::size_t calls;
+
+        gathering_sink()
+            : calls(0)
+        {
+        }
+
+        error_type append(Si::memory_range data)
+        {
+            ++calls;
+            written.append(data.begin(), data.end());
+            return error_type();
+        }
+
+        error_type append_ranges(Si::range_sequence<char>::type ranges)
+        {
+            ++calls;
+            for (Si::memory_range const &range : ranges)
+            {
+                written.append(range.begin(), range.end());
+            }
+            return error_type();
+        }
+    };
+}
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(buffering_sink_gathers_large_append)
+{
+    gathering_sink destination;
+    auto buffer = Si::make_buffering_sink(Si::ref_sink(destination));
+    Si::append(buffer, "header");
+    BOOST_CHECK_EQUAL(0u, destination.calls);
+    std::string const body(10000, 'b');
+    Si::append(buffer, body);
+    // the buffered header and the body are written together
+    BOOST_CHECK_EQUAL(1u, destination.calls);
+    BOOST_CHECK_EQUAL("header" + body, destination.written);
+}
+#endif
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(buffering_sink_watermark)
+{
+    std::string output;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_container_sink(output), Si::watermark_flush(10));
+    Si::append(buffer, "12345");
+    BOOST_CHECK_EQUAL("", output);
+    Si::append(buffer, "67890");
+    BOOST_CHECK_EQUAL("1234567890", output);
+    Si::append(buffer, "a");
+    BOOST_CHECK_EQUAL("1234567890", output);
+}
+
+BOOST_AUTO_TEST_CASE(buffering_sink_end_message)
+{
+    std::string output;
+    auto buffer = Si::make_buffering_sink(Si::make_container_sink(output));
+    Si::append(buffer, "response");
+    BOOST_CHECK_EQUAL("", output);
+    buffer.end_message();
+    BOOST_CHECK_EQUAL("response", output);
+}
+
+BOOST_AUTO_TEST_CASE(buffering_sink_cork)
+{
+    std::string output;
+    auto buffer = Si::make_buffering_sink(
+        Si::make_container_sink(output), Si::watermark_flush(1));
+    buffer.cork();
+    Si::append(buffer, "first");
+    buffer.end_message();
+    Si::append(buffer, "second");
+    buffer.end_message();
+    BOOST_CHECK_EQUAL("", output);
+    buffer.uncork();
+    BOOST_CHECK(!buffer.is_corked());
+    BOOST_CHECK_EQUAL("firstsecond", output);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(erased_sink_append_ranges)
+{
+    gathering_sink destination;
+    Si::Sink<char, Si::success>::box erased =
+        Si::Sink<char, Si::success>::make_box(Si::ref_sink(destination));
+    std::array<Si::memory_range, 2> const ranges = {
+        {Si::make_c_str_range("ab"), Si::make_c_str_range("cd")}};
+    Si::append_ranges(
+        erased, Si::make_iterator_range(ranges.data(), ranges.data() + 2));
+    // the implementation gets all ranges at once
+    BOOST_CHECK_EQUAL(1u, destination.calls);
+    BOOST_CHECK_EQUAL("abcd", destination.written);
+
+    std::string written;
+    Si::Sink<char, Si::success>::inline_box each =
+        Si::Sink<char, Si::success>::make_inline_box(
+            Si::make_container_sink(written));
+    Si::append_ranges(
+        each, Si::make_iterator_range(ranges.data(), ranges.data() + 2));
+    BOOST_CHECK_EQUAL("abcd", written);
+}
@@ -1,5 +1,8 @@
 #include <silicium/sink/copy.hpp>
 #include <silicium/sink/iterator_sink.hpp>
+#include <silicium/sink/buffering_sink.hpp>
+#include <silicium/sink/function_sink.hpp>
+#include <silicium/source/generator_source.hpp>
 #include <silicium/source/range_source.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -13,3 +16,176 @@ BOOST_AUTO_TEST_CASE(copy_source_to_sink)
     BOOST_CHECK_EQUAL_COLLECTIONS(
         input.begin(), input.end(), output.begin(), output.end());
 }
+
+BOOST_AUTO_TEST_CASE(copy_with_limit)
+{
+    std::string const input = "abcdef";
+    auto source = Si::make_range_source(Si::make_contiguous_range(input));
+    std::string output;
+    auto sink = Si::make_container_sink(output);
+    Si::copy_result<Si::success> const result = Si::copy(source, sink, 4);
+    BOOST_CHECK_EQUAL(4u, result.copied);
+    BOOST_CHECK_EQUAL("abcd", output);
+    BOOST_CHECK_EQUAL(2u, Si::copy(source, sink).copied);
+    BOOST_CHECK_EQUAL(input, output);
+}
+
+BOOST_AUTO_TEST_CASE(copy_unmapped_in_blocks)
+{
+    std::size_t const count = 100000;
+    std::size_t generated = 0;
+    auto source = Si::make_generator_source(
+        [&generated, count]() -> Si::optional<char>
+        {
+            if (generated == count)
+            {
+                return Si::none;
+            }
+            return static_cast<char>('a' + (generated++ % 26));
+        });
+    std::size_t appends = 0;
+    std::size_t received = 0;
+    auto sink = Si::make_function_sink<char>(
+        [&appends, &received](Si::iterator_range<char const *> data)
+        {
+            ++appends;
+            received += static_cast<std::size_t>(data.size());
+            return Si::success();
+        });
+    BOOST_CHECK_EQUAL(count, Si::copy(source, sink).copied);
+    BOOST_CHECK_EQUAL(count, received);
+    BOOST_CHECK_LT(appends, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(copy_stops_at_sink_error)
+{
+    auto source = Si::make_generator_source([]() -> Si::optional<int>
+                                            {
+                                                return 1;
+                                            });
+    auto sink = Si::make_function_sink<int>(
+        [](Si::iterator_range<int const *>) -> boost::system::error_code
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::broken_pipe);
+        });
+    auto const result = Si::copy(source, sink);
+    BOOST_CHECK_EQUAL(0u, result.copied);
+    BOOST_CHECK(boost::system::errc::broken_pipe == result.error);
+}
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(copy_into_buffering_sink)
+{
+    std::vector<int> input;
+    for (int i = 0; i < 10000; ++i)
+    {
+        input.push_back(i);
+    }
+    std::size_t next = 0;
+    auto source = Si::make_generator_source(
+        [&input, &next]() -> Si::optional<int>
+        {
+            if (next == input.size())
+            {
+                return Si::none;
+            }
+            return input[next++];
+        });
+    std::vector<int> output;
+    auto sink = Si::make_buffering_sink(Si::make_container_sink(output));
+    Si::append(sink, -1);
+    BOOST_CHECK_EQUAL(input.size(), Si::copy(source, sink).copied);
+    sink.flush();
+    BOOST_REQUIRE_EQUAL(input.size() + 1, output.size());
+    BOOST_CHECK_EQUAL(-1, output[0]);
+    BOOST_CHECK(std::equal(input.begin(), input.end(), output.begin() + 1));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(copy_converting)
+{
+    std::array<char, 3> const input = {{'a', 'b', 'c'}};
+    auto source = Si::make_range_source(Si::make_contiguous_range(input));
+    std::vector<int> output;
+    auto sink = Si::make_container_sink(output);
+    BOOST_CHECK_EQUAL(3u, Si::copy(source, sink).copied);
+    std::vector<int> const expected = {'a', 'b', 'c'};
+    BOOST_CHECK(expected == output);
+}
+
+#if SILICIUM_HAS_BUFFERING_SINK
+namespace
+{
+    /// Delivers at most a few elements per call like a socket would.
+    struct trickling_source
+    {
+        typedef char element_type;
+
+        std::size_t remaining;
+
+        Si::iterator_range<char const *> map_next(std::size_t)
+        {
+            return Si::iterator_range<char const *>();
+        }
+
+        char *copy_next(Si::iterator_range<char *> destination)
+        {
+            std::size_t const count = (std::min)(
+                remaining,
+                (std::min)(static_cast<std::size_t>(100),
+                           static_cast<std::size_t>(destination.size())));
+            std::fill(destination.begin(), destination.begin() + count, 'a');
+            remaining -= count;
+            return destination.begin() + count;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(copy_into_buffering_sink_flushes_full_buffers)
+{
+    std::size_t const count = 100000;
+    trickling_source source = {count};
+    std::size_t appends = 0;
+    std::size_t received = 0;
+    auto sink = Si::make_buffering_sink(Si::make_function_sink<char>(
+        [&appends, &received](Si::iterator_range<char const *> data)
+        {
+            ++appends;
+            received += static_cast<std::size_t>(data.size());
+            return Si::success();
+        }));
+    BOOST_CHECK_EQUAL(count, Si::copy(source, sink).copied);
+    BOOST_CHECK_EQUAL(count, received);
+    // every buffer is passed on full except for the last one
+    BOOST_CHECK_EQUAL((count + 8191) / 8192, appends);
+}
+#endif
+
+namespace
+{
+    struct not_default_constructible
+    {
+        int value;
+
+        explicit not_default_constructible(int value)
+            : value(value)
+        {
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(copy_without_default_constructor)
+{
+    std::vector<not_default_constructible> const input = {
+        not_default_constructible(1), not_default_constructible(2),
+        not_default_constructible(3)};
+    auto source = Si::make_range_source(Si::make_contiguous_range(input));
+    std::vector<not_default_constructible> output;
+    auto sink = Si::make_container_sink(output);
+    BOOST_CHECK_EQUAL(2u, Si::copy(source, sink, 2).copied);
+    BOOST_CHECK_EQUAL(1u, Si::copy(source, sink).copied);
+    BOOST_REQUIRE_EQUAL(3u, output.size());
+    BOOST_CHECK_EQUAL(1, output[0].value);
+    BOOST_CHECK_EQUAL(3, output[2].value);
+}
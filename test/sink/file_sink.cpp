@@ -1,5 +1,6 @@
 #include <silicium/sink/file_sink.hpp>
 #include <silicium/sink/append.hpp>
+#include <silicium/sink/append_ranges.hpp>
 #include <silicium/read.hpp>
 #include <silicium/pipe.hpp>
 #include <boost/test/unit_test.hpp>
@@ -18,3 +19,28 @@ BOOST_AUTO_TEST_CASE(file_sink_append)
                                   read_buffer.begin(),
                                   read_buffer.begin() + expected.size());
 }
+
+BOOST_AUTO_TEST_CASE(file_sink_append_ranges)
+{
+    Si::pipe buffer = Si::make_pipe().move_value();
+    Si::file_sink sink(buffer.write.handle);
+    // more ranges than a single writev call takes, some of them empty
+    std::vector<Si::memory_range> ranges;
+    std::string expected;
+    for (int i = 0; i < 20; ++i)
+    {
+        ranges.emplace_back(
+            Si::make_c_str_range((i % 3) == 0 ? "" : (i % 2) ? "ab" : "c"));
+        expected.append(ranges.back().begin(), ranges.back().end());
+    }
+    BOOST_REQUIRE(!Si::append_ranges(
+        sink, Si::make_iterator_range(
+                  ranges.data(), ranges.data() + ranges.size())));
+    std::array<char, 64> read_buffer;
+    std::size_t const received =
+        Si::read(buffer.read.handle, Si::make_contiguous_range(read_buffer))
+            .get();
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(),
+                                  read_buffer.begin(),
+                                  read_buffer.begin() + received);
+}
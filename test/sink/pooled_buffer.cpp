@@ -0,0 +1,72 @@
+#include <silicium/sink/pooled_buffer.hpp>
+#include <silicium/sink/iterator_sink.hpp>
+#include <silicium/sink/append.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(pooled_buffering_sink_returns_block_on_flush)
+{
+    Si::buffer_pool pool(64, 1024);
+    std::string output;
+    auto sink =
+        Si::make_pooled_buffering_sink(Si::make_container_sink(output), pool);
+    BOOST_CHECK_EQUAL(0u, sink.buffer().size());
+    Si::append(sink, "hello");
+    BOOST_CHECK_EQUAL(64u, sink.buffer().size());
+    BOOST_CHECK_EQUAL("", output);
+    sink.flush();
+    BOOST_CHECK_EQUAL("hello", output);
+    BOOST_CHECK_EQUAL(0u, sink.buffer().size());
+    BOOST_CHECK_EQUAL(1u, pool.cached_blocks());
+}
+
+BOOST_AUTO_TEST_CASE(pooled_buffering_sink_grows_and_shrinks)
+{
+    Si::buffer_pool pool(64, 1024);
+    std::string output;
+    auto sink = Si::make_pooled_buffering_sink(
+        Si::make_container_sink(output), pool, 256);
+    std::string expected;
+    std::string const chunk(40, 'a');
+    for (int i = 0; i < 20; ++i)
+    {
+        Si::append(sink, Si::make_contiguous_range(chunk));
+        expected += chunk;
+    }
+    BOOST_CHECK_EQUAL(256u, sink.buffer().preferred_size());
+    sink.flush();
+    BOOST_CHECK(expected == output);
+
+    // a short message that fits lets the buffer shrink again
+    Si::append(sink, "x");
+    sink.flush();
+    BOOST_CHECK_EQUAL(128u, sink.buffer().preferred_size());
+    Si::append(sink, "y");
+    sink.flush();
+    BOOST_CHECK_EQUAL(64u, sink.buffer().preferred_size());
+    BOOST_CHECK(expected + "xy" == output);
+}
+#endif
+
+#if SILICIUM_HAS_BUFFERING_SINK
+BOOST_AUTO_TEST_CASE(pooled_buffering_sink_keeps_size_of_well_used_blocks)
+{
+    Si::buffer_pool pool(64, 1024);
+    std::string output;
+    auto sink = Si::make_pooled_buffering_sink(
+        Si::make_container_sink(output), pool, 256);
+    std::string const chunk(40, 'a');
+    for (int i = 0; i < 20; ++i)
+    {
+        Si::append(sink, Si::make_contiguous_range(chunk));
+    }
+    sink.flush();
+    BOOST_REQUIRE_EQUAL(256u, sink.buffer().preferred_size());
+
+    // more than half of the block was used, so it is still the right size
+    std::string const message(200, 'b');
+    Si::append(sink, Si::make_contiguous_range(message));
+    sink.flush();
+    BOOST_CHECK_EQUAL(256u, sink.buffer().preferred_size());
+}
+#endif
@@ -3,6 +3,7 @@
 #include <silicium/source/memory_source.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/assign/list_of.hpp>
+#include <array>
 
 BOOST_AUTO_TEST_CASE(filter_source_true)
 {
@@ -33,3 +34,160 @@ BOOST_AUTO_TEST_CASE(filter_source_false)
     auto finish = Si::get(f);
     BOOST_CHECK(!finish);
 }
+
+namespace
+{
+    /// Counts how often copy_next is called on the wrapped source.
+    template <class Input>
+    struct counting_source
+    {
+        typedef typename Input::element_type element_type;
+
+        Input input;
+        std::size_t *calls;
+
+        counting_source(Input input, std::size_t &calls)
+            : input(std::move(input))
+            , calls(&calls)
+        {
+        }
+
+        Si::iterator_range<element_type const *> map_next(std::size_t)
+        {
+            return Si::iterator_range<element_type const *>();
+        }
+
+        element_type *copy_next(Si::iterator_range<element_type *> destination)
+        {
+            ++*calls;
+            return input.copy_next(destination);
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(filter_source_batches)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(i);
+    }
+    std::size_t calls = 0;
+    auto f = Si::make_filter_source(
+        counting_source<Si::memory_source<int>>(
+            Si::make_container_source(elements), calls),
+        [](int element)
+        {
+            return (element % 3) == 0;
+        });
+    std::vector<int> received;
+    std::array<int, 7> buffer;
+    for (;;)
+    {
+        int *const end = f.copy_next(Si::make_contiguous_range(buffer));
+        if (end == buffer.data())
+        {
+            break;
+        }
+        received.insert(received.end(), buffer.data(), end);
+    }
+    BOOST_REQUIRE_EQUAL(334u, received.size());
+    for (std::size_t i = 0; i < received.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<int>(i * 3), received[i]);
+    }
+    // 1000 elements in batches of 256 plus one call for each of the last two
+    // copy_next that run into the end
+    BOOST_CHECK_EQUAL(6u, calls);
+}
+
+BOOST_AUTO_TEST_CASE(filter_source_batch_size_one)
+{
+    std::vector<int> const elements = boost::assign::list_of(1)(2)(3)(4);
+    Si::filter_source<Si::memory_source<int>, bool (*)(int)> f(
+        Si::make_container_source(elements),
+        [](int element)
+        {
+            return (element % 2) == 0;
+        },
+        1);
+    std::array<int, 3> buffer;
+    BOOST_REQUIRE_EQUAL(buffer.data() + 2,
+                        f.copy_next(Si::make_contiguous_range(buffer)));
+    BOOST_CHECK_EQUAL(2, buffer[0]);
+    BOOST_CHECK_EQUAL(4, buffer[1]);
+    BOOST_CHECK_EQUAL(buffer.data(),
+                      f.copy_next(Si::make_contiguous_range(buffer)));
+}
+
+BOOST_AUTO_TEST_CASE(filter_source_map_next_and_skip)
+{
+    std::vector<int> const elements = boost::assign::list_of(1)(2)(3)(4)(6);
+    auto f = Si::make_filter_source(Si::make_container_source(elements),
+                                    [](int element)
+                                    {
+                                        return (element % 2) == 0;
+                                    });
+    Si::iterator_range<int const *> const mapped = f.map_next(10);
+    BOOST_REQUIRE_EQUAL(3, mapped.size());
+    BOOST_CHECK_EQUAL(2, mapped[0]);
+    BOOST_CHECK_EQUAL(4, mapped[1]);
+    BOOST_CHECK_EQUAL(6, mapped[2]);
+
+    // mapping does not consume anything
+    BOOST_CHECK_EQUAL(mapped.begin(), f.map_next(10).begin());
+    BOOST_CHECK_EQUAL(1u, f.skip(1));
+    BOOST_CHECK_EQUAL(4, Si::get(f));
+    BOOST_CHECK_EQUAL(1u, f.skip(5));
+    BOOST_CHECK(f.map_next(10).empty());
+}
+
+namespace
+{
+    struct without_default_constructor
+    {
+        int value;
+
+        explicit without_default_constructor(int value)
+            : value(value)
+        {
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(filter_source_skip_across_batches)
+{
+    std::vector<int> const elements = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto f = Si::filter_source<Si::memory_source<int>, bool (*)(int)>(
+        Si::make_container_source(elements), [](int element)
+        {
+            return (element % 2) == 0;
+        },
+        1);
+    BOOST_CHECK_EQUAL(2u, Si::skip(f, 2));
+    BOOST_CHECK_EQUAL(6, Si::get(f));
+    BOOST_CHECK_EQUAL(8, Si::get(f));
+    BOOST_CHECK_EQUAL(0u, Si::skip(f, 2));
+}
+
+BOOST_AUTO_TEST_CASE(filter_source_without_default_constructor)
+{
+    std::vector<without_default_constructor> const elements = {
+        without_default_constructor(1), without_default_constructor(2),
+        without_default_constructor(3), without_default_constructor(4)};
+    auto f = Si::make_filter_source(
+        Si::make_container_source(elements),
+        [](without_default_constructor const &element)
+        {
+            return (element.value % 2) == 0;
+        });
+    BOOST_STATIC_ASSERT(!Si::detail::has_skip<decltype(f)>::value);
+    BOOST_CHECK(f.map_next(10).empty());
+    std::vector<without_default_constructor> buffer(
+        3, without_default_constructor(0));
+    without_default_constructor *const end = f.copy_next(
+        Si::make_iterator_range(buffer.data(), buffer.data() + buffer.size()));
+    BOOST_REQUIRE_EQUAL(2, end - buffer.data());
+    BOOST_CHECK_EQUAL(2, buffer[0].value);
+    BOOST_CHECK_EQUAL(4, buffer[1].value);
+}
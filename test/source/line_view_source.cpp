@@ -0,0 +1,96 @@
+#include <silicium/source/line_view_source.hpp>
+#include <silicium/source/memory_source.hpp>
+#include <silicium/source/virtualized_source.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+
+namespace
+{
+    /// Maps at most three characters at a time to make lines span windows.
+    struct narrow_source
+    {
+        typedef char element_type;
+
+        Si::memory_source<char> input;
+
+        explicit narrow_source(std::string const &content)
+            : input(Si::make_container_source(content))
+        {
+        }
+
+        Si::iterator_range<char const *> map_next(std::size_t)
+        {
+            Si::iterator_range<char const *> const all = input.map_next(1);
+            return Si::make_iterator_range(
+                all.begin(), all.begin() + (std::min)(all.size(), 3L));
+        }
+
+        char *copy_next(Si::iterator_range<char *> destination)
+        {
+            return input.copy_next(destination);
+        }
+
+        std::size_t skip(std::size_t count)
+        {
+            return input.skip(count);
+        }
+    };
+
+    std::string to_string(Si::memory_range line)
+    {
+        return std::string(line.begin(), line.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(line_view_source_views_into_input)
+{
+    std::string const content = "first\r\nsecond\nincomplete";
+    auto input = Si::make_container_source(content);
+    auto lines = Si::make_line_view_source(input);
+    std::array<Si::memory_range, 3> received;
+    Si::memory_range *const end =
+        lines.copy_next(Si::make_contiguous_range(received));
+    BOOST_REQUIRE_EQUAL(received.data() + 2, end);
+    BOOST_CHECK_EQUAL("first", to_string(received[0]));
+    BOOST_CHECK_EQUAL(content.data(), received[0].begin());
+    BOOST_CHECK_EQUAL("second", to_string(received[1]));
+    BOOST_CHECK_EQUAL(content.data() + 7, received[1].begin());
+
+    // the lines have been consumed, the rest has not
+    BOOST_CHECK_EQUAL("incomplete", to_string(input.map_next(100)));
+    BOOST_CHECK(!Si::get(lines));
+}
+
+BOOST_AUTO_TEST_CASE(line_view_source_spanning_windows)
+{
+    narrow_source input("abcdefg\r\nxy\n\nz\n");
+    auto lines = Si::make_line_view_source(input);
+    std::vector<std::string> received;
+    for (;;)
+    {
+        Si::optional<Si::memory_range> const line = Si::get(lines);
+        if (!line)
+        {
+            break;
+        }
+        received.push_back(to_string(*line));
+    }
+    std::vector<std::string> const expected = {"abcdefg", "xy", "", "z"};
+    BOOST_CHECK(expected == received);
+}
+
+BOOST_AUTO_TEST_CASE(line_view_source_unmapped_input)
+{
+    std::string const content = "a\nbc\r\n";
+    auto input = Si::virtualize_source(Si::make_container_source(content));
+    auto lines = Si::make_line_view_source(input);
+    Si::iterator_range<Si::memory_range const *> const peeked =
+        lines.map_next(1);
+    BOOST_REQUIRE_EQUAL(1, peeked.size());
+    BOOST_CHECK_EQUAL("a", to_string(peeked.front()));
+    BOOST_CHECK_EQUAL(1u, lines.skip(1));
+    Si::optional<Si::memory_range> const second = Si::get(lines);
+    BOOST_REQUIRE(second);
+    BOOST_CHECK_EQUAL("bc", to_string(*second));
+    BOOST_CHECK(!Si::get(lines));
+}
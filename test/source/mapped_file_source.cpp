@@ -0,0 +1,98 @@
+#include "temporary_file.hpp"
+#include <silicium/source/mapped_file_source.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if SILICIUM_HAS_MAPPED_FILE_SOURCE
+namespace
+{
+    std::string make_content(std::size_t size)
+    {
+        std::string content;
+        content.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            content.push_back(static_cast<char>('a' + (i % 26)));
+        }
+        return content;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_source_empty)
+{
+    temporary_file file;
+    Si::mapped_file_source source =
+        Si::make_mapped_file_source(file.handle()).move_value();
+    BOOST_CHECK_EQUAL(0u, source.size());
+    BOOST_CHECK(source.map_next(1).empty());
+    std::array<char, 1> buffer;
+    BOOST_CHECK_EQUAL(buffer.data(),
+                      source.copy_next(Si::make_contiguous_range(buffer)));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_source_map_next_and_skip)
+{
+    std::string const content = make_content(10000);
+    temporary_file file;
+    file.write(content);
+    Si::mapped_file_source source =
+        Si::make_mapped_file_source(file.handle()).move_value();
+    BOOST_REQUIRE_EQUAL(content.size(), source.size());
+    Si::iterator_range<char const *> mapped = source.map_next(1);
+    BOOST_CHECK_EQUAL(1, mapped.size());
+    mapped = source.map_next(content.size() * 2);
+    BOOST_REQUIRE_EQUAL(
+        content.size(), static_cast<std::size_t>(mapped.size()));
+    BOOST_CHECK(std::equal(mapped.begin(), mapped.end(), content.begin()));
+
+    // map_next does not consume anything
+    BOOST_CHECK(mapped.begin() == source.map_next(1).begin());
+    BOOST_CHECK_EQUAL(300, source.map_next(300).size());
+    BOOST_CHECK_EQUAL(100u, source.skip(100));
+    BOOST_CHECK_EQUAL(100u, source.position());
+    BOOST_CHECK_EQUAL(content[100], source.map_next(1).front());
+
+    BOOST_CHECK_EQUAL(content.size() - 100, source.skip(content.size()));
+    BOOST_CHECK(source.map_next(1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_source_small_windows)
+{
+    std::size_t const page_size =
+        static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::string const content = make_content(page_size * 5 + 123);
+    temporary_file file;
+    file.write(content);
+    Si::mapped_file_source source =
+        Si::make_mapped_file_source(file.handle(), page_size).move_value();
+
+    // the window moves so that the requested size is contiguous even if it
+    // crosses a page boundary
+    source.skip(page_size - 10);
+    Si::iterator_range<char const *> const crossing = source.map_next(20);
+    BOOST_REQUIRE_EQUAL(20, crossing.size());
+    BOOST_CHECK(std::equal(crossing.begin(), crossing.begin() + 20,
+                           content.begin() + (page_size - 10)));
+
+    // copying works across all windows
+    std::string copied(content.size(), '\0');
+    char *const copied_end = source.copy_next(
+        Si::make_iterator_range(&copied[0], &copied[0] + copied.size()));
+    copied.resize(static_cast<std::size_t>(copied_end - &copied[0]));
+    BOOST_CHECK(copied == content.substr(page_size - 10));
+    BOOST_CHECK_EQUAL(content.size(), source.position());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_source_move)
+{
+    std::string const content = make_content(100);
+    temporary_file file;
+    file.write(content);
+    Si::mapped_file_source first =
+        Si::make_mapped_file_source(file.handle()).move_value();
+    first.skip(10);
+    Si::iterator_range<char const *> const mapped = first.map_next(1);
+    Si::mapped_file_source second = std::move(first);
+    BOOST_CHECK(mapped.begin() == second.map_next(1).begin());
+    BOOST_CHECK_EQUAL(10u, second.position());
+}
+#endif
@@ -4,6 +4,7 @@
 #include <silicium/detail/line_source.hpp>
 #include <silicium/source/buffering_source.hpp>
 #include <boost/test/unit_test.hpp>
+#include <array>
 
 using namespace Si;
 
@@ -23,11 +24,160 @@ BOOST_AUTO_TEST_CASE(line_source_cr_lf)
     memory_source<char> source(make_iterator_range(
         original.data(), original.data() + original.size()));
     auto lines = Si::detail::make_line_source(source);
-    BOOST_CHECK(lines.map_next(1).empty());
+    auto const mapped = lines.map_next(1);
+    BOOST_REQUIRE_EQUAL(1, mapped.size());
+    BOOST_CHECK_EQUAL("abc", std::string(mapped.front().begin(),
+                                         mapped.front().end()));
     std::vector<char> line;
     auto *const result = lines.copy_next(make_iterator_range(&line, &line + 1));
     BOOST_CHECK_EQUAL(&line + 1, result);
     BOOST_CHECK_EQUAL("abc", std::string(begin(line), end(line)));
+
+    // the last line is incomplete
+    BOOST_CHECK(lines.map_next(1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(line_source_consumes_only_complete_lines)
+{
+    std::string const original = "GET / HTTP/1.1\r\n\r\nbody";
+    memory_source<char> source(make_iterator_range(
+        original.data(), original.data() + original.size()));
+    auto lines = Si::detail::make_line_source(source);
+    auto first = Si::get(lines);
+    BOOST_REQUIRE(first);
+    BOOST_CHECK_EQUAL("GET / HTTP/1.1", std::string(first->begin(),
+                                                    first->end()));
+    BOOST_CHECK_EQUAL(1u, lines.skip(1));
+    auto const rest = source.map_next(100);
+    BOOST_CHECK_EQUAL("body", std::string(rest.begin(), rest.end()));
+}
+
+BOOST_AUTO_TEST_CASE(take_mapped_and_copied)
+{
+    std::string const original = "abcdef";
+    memory_source<char> source(make_iterator_range(
+        original.data(), original.data() + original.size()));
+    BOOST_CHECK_EQUAL("abcd", Si::take<std::string>(source, 4));
+    BOOST_CHECK_EQUAL("ef", Si::take<std::string>(source, 4));
+
+    char next = 'a';
+    auto generated = Si::make_generator_source([&next]() -> Si::optional<char>
+                                               {
+                                                   return next++;
+                                               });
+    BOOST_CHECK_EQUAL("abc", Si::take<std::string>(generated, 3));
+}
+
+BOOST_AUTO_TEST_CASE(skip_with_and_without_member)
+{
+    std::array<int, 5> const elements = {{1, 2, 3, 4, 5}};
+    auto source = Si::make_container_source(elements);
+    BOOST_CHECK_EQUAL(2u, Si::skip(source, 2));
+    BOOST_CHECK_EQUAL(3, Si::get(source));
+
+    // virtualized sources skip the way the wrapped source does
+    auto virtualized = Si::virtualize_source(source);
+    BOOST_CHECK_EQUAL(2u, Si::skip(virtualized, 100));
+    BOOST_CHECK(!Si::get(virtualized));
+}
+
+namespace
+{
+    struct legacy_source
+    {
+        typedef char element_type;
+
+        char next;
+
+        legacy_source()
+            : next('a')
+        {
+        }
+
+        Si::iterator_range<char const *> map_next(std::size_t)
+        {
+            return Si::iterator_range<char const *>();
+        }
+
+        char *copy_next(Si::iterator_range<char *> destination)
+        {
+            for (char &element : destination)
+            {
+                element = next++;
+            }
+            return destination.end();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(erased_source_capabilities)
+{
+    std::string const original = "abcdef";
+    Si::Source<char>::box mappable =
+        Si::Source<char>::make_box(memory_source<char>(make_iterator_range(
+            original.data(), original.data() + original.size())));
+    BOOST_CHECK(mappable.can_map());
+    BOOST_CHECK_EQUAL(0u, Si::preferred_batch_size(mappable));
+    Si::iterator_range<char const *> const mapped =
+        Si::try_map_next(mappable, 2);
+    BOOST_REQUIRE(!mapped.empty());
+    BOOST_CHECK_EQUAL(original.data(), mapped.begin());
+    BOOST_CHECK_EQUAL(3u, Si::skip(mappable, 3));
+    BOOST_CHECK_EQUAL('d', Si::get(mappable));
+
+    // a source without skip may consume what it maps, so it is not mapped
+    Si::Source<char>::inline_box legacy =
+        Si::Source<char>::make_inline_box(legacy_source());
+    BOOST_CHECK(!legacy.can_map());
+    BOOST_CHECK(Si::try_map_next(legacy, 1).empty());
+    BOOST_CHECK_EQUAL(2u, legacy.skip(2));
+    BOOST_CHECK_EQUAL('c', Si::get(legacy));
+
+    // virtualized_source asks the source it wraps
+    auto virtualized = Si::virtualize_source(memory_source<char>());
+    BOOST_CHECK(virtualized.can_map());
+    BOOST_CHECK_EQUAL(0u, virtualized.preferred_batch_size());
+}
+
+namespace
+{
+    struct without_default_constructor
+    {
+        int value;
+
+        explicit without_default_constructor(int value)
+            : value(value)
+        {
+        }
+    };
+
+    struct erased_without_default_constructor
+        : Si::Source<without_default_constructor>::interface
+    {
+        virtual Si::iterator_range<without_default_constructor const *>
+        map_next(std::size_t) SILICIUM_OVERRIDE
+        {
+            return Si::iterator_range<without_default_constructor const *>();
+        }
+
+        virtual without_default_constructor *copy_next(
+            Si::iterator_range<without_default_constructor *> destination)
+            SILICIUM_OVERRIDE
+        {
+            return destination.begin();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(skip_by_copying_in_blocks)
+{
+    legacy_source source;
+    BOOST_CHECK_EQUAL(10000u, Si::skip(source, 10000));
+    BOOST_CHECK_EQUAL(static_cast<char>('a' + 10000 % 256), Si::get(source));
+
+    // there is nothing to copy into
+    erased_without_default_constructor erased;
+    BOOST_CHECK_EQUAL(0u, erased.skip(3));
 }
 
 BOOST_AUTO_TEST_CASE(buffering_source_empty)
@@ -53,6 +203,21 @@ BOOST_AUTO_TEST_CASE(buffering_source_non_empty)
         &c + 1, buffer.copy_next(make_iterator_range(&c, &c + 1)));
 }
 
+BOOST_AUTO_TEST_CASE(buffering_source_can_map)
+{
+    std::string const original = "abc";
+    memory_source<char> source(make_iterator_range(
+        original.data(), original.data() + original.size()));
+    auto buffer = Si::make_buffer(source, 2);
+    BOOST_CHECK(buffer.can_map());
+    Si::iterator_range<char const *> const mapped =
+        Si::try_map_next(buffer, 2);
+    BOOST_REQUIRE_EQUAL(2, mapped.size());
+    BOOST_CHECK_EQUAL('a', mapped.front());
+    BOOST_CHECK_EQUAL(2u, Si::skip(buffer, 2));
+    BOOST_CHECK_EQUAL('c', Si::get(buffer));
+}
+
 BOOST_AUTO_TEST_CASE(mutable_source_iterator_empty)
 {
     memory_source<char> source;
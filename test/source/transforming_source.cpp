@@ -0,0 +1,114 @@
+#include <silicium/source/transforming_source.hpp>
+#include <silicium/source/memory_source.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+
+BOOST_AUTO_TEST_CASE(transforming_source_leftovers)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 600; ++i)
+    {
+        elements.push_back(i);
+    }
+    auto transformed = Si::make_transforming_source(
+        Si::make_container_source(elements), [](int element)
+        {
+            return element * 2;
+        });
+    std::vector<int> received;
+    std::array<int, 100> buffer;
+    for (;;)
+    {
+        int *const end =
+            transformed.copy_next(Si::make_contiguous_range(buffer));
+        if (end == buffer.data())
+        {
+            break;
+        }
+        received.insert(received.end(), buffer.data(), end);
+    }
+    BOOST_REQUIRE_EQUAL(elements.size(), received.size());
+    for (std::size_t i = 0; i < received.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<int>(i * 2), received[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transforming_source_batch_size_one)
+{
+    std::array<int, 3> const elements = {{1, 2, 3}};
+    Si::transforming_source<Si::memory_source<int>, long (*)(int), long>
+        transformed(Si::make_container_source(elements),
+                    [](int element) -> long
+                    {
+                        return element + 1;
+                    },
+                    1);
+    std::array<long, 2> buffer;
+    Si::iterator_range<long *> const destination =
+        Si::make_contiguous_range(buffer);
+    BOOST_REQUIRE_EQUAL(buffer.data() + 2, transformed.copy_next(destination));
+    BOOST_CHECK_EQUAL(2, buffer[0]);
+    BOOST_CHECK_EQUAL(3, buffer[1]);
+    BOOST_REQUIRE_EQUAL(buffer.data() + 1, transformed.copy_next(destination));
+    BOOST_CHECK_EQUAL(4, buffer[0]);
+    BOOST_CHECK_EQUAL(buffer.data(), transformed.copy_next(destination));
+}
+
+BOOST_AUTO_TEST_CASE(transforming_source_map_next_and_skip)
+{
+    std::array<int, 4> const elements = {{1, 2, 3, 4}};
+    auto transformed = Si::make_transforming_source(
+        Si::make_container_source(elements), [](int element)
+        {
+            return element * 10;
+        });
+    Si::iterator_range<int const *> const mapped = transformed.map_next(3);
+    BOOST_REQUIRE_EQUAL(3, mapped.size());
+    BOOST_CHECK_EQUAL(10, mapped[0]);
+    BOOST_CHECK_EQUAL(30, mapped[2]);
+    BOOST_CHECK_EQUAL(2u, transformed.skip(2));
+
+    // copy_next continues with what has been mapped but not skipped
+    std::array<int, 4> buffer;
+    Si::iterator_range<int *> const destination =
+        Si::make_contiguous_range(buffer);
+    BOOST_REQUIRE_EQUAL(buffer.data() + 2, transformed.copy_next(destination));
+    BOOST_CHECK_EQUAL(30, buffer[0]);
+    BOOST_CHECK_EQUAL(40, buffer[1]);
+    BOOST_CHECK_EQUAL(0u, transformed.skip(1));
+}
+
+namespace
+{
+    struct without_default_constructor
+    {
+        int value;
+
+        explicit without_default_constructor(int value)
+            : value(value)
+        {
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(transforming_source_without_default_constructor)
+{
+    std::array<int, 4> const elements = {{1, 2, 3, 4}};
+    auto transformed = Si::make_transforming_source(
+        Si::make_container_source(elements), [](int element)
+        {
+            return without_default_constructor(element * 2);
+        });
+    BOOST_CHECK(transformed.map_next(10).empty());
+    BOOST_CHECK_EQUAL(1u, transformed.skip(1));
+    std::vector<without_default_constructor> buffer(
+        5, without_default_constructor(0));
+    without_default_constructor *const end =
+        transformed.copy_next(Si::make_iterator_range(
+            buffer.data(), buffer.data() + buffer.size()));
+    BOOST_REQUIRE_EQUAL(3, end - buffer.data());
+    BOOST_CHECK_EQUAL(4, buffer[0].value);
+    BOOST_CHECK_EQUAL(6, buffer[1].value);
+    BOOST_CHECK_EQUAL(8, buffer[2].value);
+}
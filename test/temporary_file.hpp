@@ -0,0 +1,68 @@
+#ifndef SILICIUM_TEST_TEMPORARY_FILE_HPP
+#define SILICIUM_TEST_TEMPORARY_FILE_HPP
+
+#include <silicium/read.hpp>
+#include <silicium/write.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <cstdio>
+
+#ifndef _WIN32
+/// An anonymous file that is deleted when it is closed.
+struct temporary_file
+{
+    temporary_file()
+        : m_file(std::tmpfile())
+    {
+        BOOST_REQUIRE(m_file);
+    }
+
+    ~temporary_file()
+    {
+        std::fclose(m_file);
+    }
+
+    Si::native_file_descriptor handle() const
+    {
+        return fileno(m_file);
+    }
+
+    void write(std::string const &content)
+    {
+        BOOST_REQUIRE_EQUAL(
+            content.size(),
+            Si::write(handle(), Si::make_memory_range(content)).get());
+    }
+
+    void seek(off_t position)
+    {
+        BOOST_REQUIRE_EQUAL(position, lseek(handle(), position, SEEK_SET));
+    }
+
+    std::string read_all()
+    {
+        seek(0);
+        std::string content;
+        std::array<char, 4096> buffer;
+        for (;;)
+        {
+            std::size_t const read_bytes =
+                Si::read(handle(), Si::make_contiguous_range(buffer)).get();
+            if (read_bytes == 0)
+            {
+                return content;
+            }
+            content.append(buffer.data(), read_bytes);
+        }
+    }
+
+private:
+    std::FILE *m_file;
+
+    SILICIUM_DELETED_FUNCTION(temporary_file(temporary_file const &))
+    SILICIUM_DELETED_FUNCTION(
+        temporary_file &operator=(temporary_file const &))
+};
+#endif
+
+#endif
@@ -1,6 +1,7 @@
 #include <silicium/trait.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/assign/list_of.hpp>
+#include <array>
 
 typedef long element;
 
@@ -158,3 +159,127 @@ BOOST_AUTO_TEST_CASE(trait_with_typedefs)
         (std::is_same<float, WithTypedefs::box::element_type>::value));
     BOOST_CHECK_EQUAL(12.0f, b.get());
 }
+
+BOOST_AUTO_TEST_CASE(trait_inline_box)
+{
+    Container<int>::inline_box container;
+    BOOST_CHECK(!container);
+    {
+        Container<int>::inline_box container2 =
+            Container<int>::make_inline_box(std::vector<int>());
+        BOOST_REQUIRE(!!container2);
+        BOOST_CHECK(container2.is_inline());
+        container = std::move(container2);
+        BOOST_CHECK(!container2);
+    }
+    BOOST_REQUIRE(!!container);
+    BOOST_CHECK(container.is_inline());
+    container.emplace_back(3);
+    container.resize(3, 7);
+    auto const &const_ref = container;
+    BOOST_CHECK(!const_ref.empty());
+    BOOST_CHECK_EQUAL(3u, const_ref.size());
+}
+
+namespace
+{
+    struct large_producer
+    {
+        std::array<element, 16> values;
+
+        element get()
+        {
+            return values[15];
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(trait_inline_box_falls_back_to_heap)
+{
+    large_producer original;
+    original.values.fill(7);
+    Producer::inline_box p = Producer::make_inline_box(original);
+    BOOST_CHECK(!p.is_inline());
+    Producer::inline_box q = std::move(p);
+    BOOST_CHECK(!p);
+    BOOST_CHECK_EQUAL(7, q.get());
+}
+
+BOOST_AUTO_TEST_CASE(trait_inline_box_with_typedefs)
+{
+    WithTypedefs::inline_box b =
+        WithTypedefs::make_inline_box(impl_with_typedefs());
+    BOOST_STATIC_ASSERT(
+        (std::is_same<float, WithTypedefs::inline_box::element_type>::value));
+    BOOST_CHECK_EQUAL(12.0f, b.get());
+}
+
+namespace defaults
+{
+    template <class Producer>
+    element get_scaled(Producer &producer, element factor)
+    {
+        return producer.get() * factor;
+    }
+
+    template <class Producer>
+    bool is_not_fancy(Producer const &)
+    {
+        return false;
+    }
+}
+
+SILICIUM_TRAIT_WITH_DEFAULTS(
+    ProducerWithDefaults, typedef element element_type;
+    , ((get, (0, ()), element)),
+    ((get_times, (1, (element)), element, , defaults::get_scaled))(
+        (is_fancy, (0, ()), bool, const, defaults::is_not_fancy)))
+
+namespace
+{
+    struct fancy_producer
+    {
+        element get()
+        {
+            return 2;
+        }
+
+        element get_times(element factor)
+        {
+            return 100 * factor;
+        }
+
+        bool is_fancy() const
+        {
+            return true;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(trait_default_used)
+{
+    auto erased = ProducerWithDefaults::erase(test_producer());
+    BOOST_CHECK_EQUAL(84, erased.get_times(2));
+    BOOST_CHECK(!erased.is_fancy());
+
+    ProducerWithDefaults::box boxed =
+        ProducerWithDefaults::make_box(test_producer());
+    BOOST_CHECK_EQUAL(126, boxed.get_times(3));
+
+    ProducerWithDefaults::inline_box inline_boxed =
+        ProducerWithDefaults::make_inline_box(test_producer());
+    BOOST_CHECK_EQUAL(42, inline_boxed.get_times(1));
+    BOOST_CHECK(!inline_boxed.is_fancy());
+}
+
+BOOST_AUTO_TEST_CASE(trait_default_overridden)
+{
+    auto erased = ProducerWithDefaults::erase(fancy_producer());
+    BOOST_CHECK_EQUAL(200, erased.get_times(2));
+    BOOST_CHECK(erased.is_fancy());
+
+    ProducerWithDefaults::inline_box inline_boxed =
+        ProducerWithDefaults::make_inline_box(fancy_producer());
+    BOOST_CHECK_EQUAL(300, inline_boxed.get_times(3));
+    BOOST_CHECK(inline_boxed.is_fancy());
+}
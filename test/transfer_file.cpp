@@ -0,0 +1,205 @@
+#include "temporary_file.hpp"
+#include <silicium/transfer_file.hpp>
+#include <silicium/pipe.hpp>
+#include <silicium/sink/append_file.hpp>
+#include <silicium/sink/file_sink.hpp>
+#include <silicium/asio/socket_sink.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/test/unit_test.hpp>
+
+#ifndef _WIN32
+namespace
+{
+    struct string_sink
+    {
+        typedef char element_type;
+        typedef boost::system::error_code error_type;
+
+        std::string content;
+
+        error_type append(Si::memory_range data)
+        {
+            content.append(data.begin(), data.end());
+            return error_type();
+        }
+    };
+
+    std::string read_some(Si::native_file_descriptor file)
+    {
+        std::array<char, 4096> buffer;
+        std::size_t const read_bytes =
+            Si::read(file, Si::make_contiguous_range(buffer)).get();
+        return std::string(buffer.data(), read_bytes);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_regular_to_regular)
+{
+    temporary_file from;
+    from.write("hello world");
+    from.seek(6);
+    temporary_file to;
+    Si::error_or<std::size_t> const transferred =
+        Si::transfer_file(from.handle(), to.handle(), 100);
+    BOOST_REQUIRE(!transferred.is_error());
+    BOOST_CHECK_EQUAL(5u, transferred.get());
+    BOOST_CHECK_EQUAL("world", to.read_all());
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_regular_to_pipe)
+{
+    temporary_file from;
+    from.write("hello world");
+    from.seek(0);
+    Si::pipe to = Si::make_pipe().move_value();
+    Si::error_or<std::size_t> const transferred =
+        Si::transfer_file(from.handle(), to.write.handle, 5);
+    BOOST_REQUIRE(!transferred.is_error());
+    BOOST_CHECK_EQUAL(5u, transferred.get());
+    BOOST_CHECK_EQUAL("hello", read_some(to.read.handle));
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_pipe_to_pipe)
+{
+    Si::pipe from = Si::make_pipe().move_value();
+    BOOST_REQUIRE_EQUAL(
+        3u, Si::write(from.write.handle, Si::make_c_str_range("abc")).get());
+    from.write.close();
+    Si::pipe to = Si::make_pipe().move_value();
+    Si::error_or<std::size_t> const transferred =
+        Si::transfer_file(from.read.handle, to.write.handle, 100);
+    BOOST_REQUIRE(!transferred.is_error());
+    BOOST_CHECK_EQUAL(3u, transferred.get());
+    BOOST_CHECK_EQUAL("abc", read_some(to.read.handle));
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_append_file_fallback)
+{
+    temporary_file from;
+    from.write("hello world");
+    from.seek(0);
+    string_sink received;
+    BOOST_REQUIRE(!Si::append_file(received, from.handle(), 5));
+    BOOST_CHECK_EQUAL("hello", received.content);
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_file_sink_append_file)
+{
+    temporary_file from;
+    from.write("hello world");
+    from.seek(0);
+    temporary_file to;
+    Si::file_sink sink(to.handle());
+    BOOST_REQUIRE(!Si::append_file(sink, from.handle(), 100));
+    BOOST_CHECK_EQUAL("hello world", to.read_all());
+}
+
+#if SILICIUM_HAS_ASIO_SOCKET_SINK
+BOOST_AUTO_TEST_CASE(transfer_file_socket_sink_append_file)
+{
+    // large enough to fill the socket buffers, so that the sender has to
+    // wait for the receiver
+    std::string content(8 * 1024 * 1024, 'a');
+    for (std::size_t i = 0; i < content.size(); i += 1000)
+    {
+        content[i] = static_cast<char>('b' + (i % 20));
+    }
+    temporary_file from;
+    from.write(content);
+    from.seek(0);
+
+    boost::asio::io_service io;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io, boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0));
+    boost::asio::ip::tcp::socket server(io);
+    boost::asio::ip::tcp::socket client(io);
+    bool sent = false;
+    boost::asio::spawn(io, [&](boost::asio::yield_context yield)
+                       {
+                           acceptor.async_accept(server, yield);
+                           Si::asio::socket_sink sink(server, yield);
+                           BOOST_REQUIRE(!Si::append_file(
+                               sink, from.handle(), content.size()));
+                           server.shutdown(
+                               boost::asio::ip::tcp::socket::shutdown_send);
+                           sent = true;
+                       });
+    std::string received;
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            client.async_connect(acceptor.local_endpoint(), yield);
+            std::array<char, 65536> buffer;
+            for (;;)
+            {
+                boost::system::error_code ec;
+                std::size_t const read_bytes = client.async_read_some(
+                    boost::asio::buffer(buffer), yield[ec]);
+                received.append(buffer.data(), read_bytes);
+                if (ec)
+                {
+                    BOOST_REQUIRE(ec == boost::asio::error::eof);
+                    break;
+                }
+            }
+        });
+    io.run();
+    BOOST_CHECK(sent);
+    BOOST_CHECK(content == received);
+}
+
+BOOST_AUTO_TEST_CASE(transfer_file_socket_sink_append_empty_pipe)
+{
+    // the pipe is filled by the same io_service, so the sink must not block
+    // the thread while the pipe is empty
+    Si::pipe from = Si::make_pipe().move_value();
+    boost::asio::io_service io;
+    boost::asio::steady_timer fill(io);
+    fill.expires_from_now(std::chrono::milliseconds(10));
+    fill.async_wait([&from](boost::system::error_code const &)
+                    {
+                        BOOST_REQUIRE_EQUAL(
+                            3u, Si::write(from.write.handle,
+                                          Si::make_c_str_range("abc"))
+                                    .get());
+                        from.write.close();
+                    });
+    boost::asio::ip::tcp::acceptor acceptor(
+        io, boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0));
+    boost::asio::ip::tcp::socket server(io);
+    boost::asio::ip::tcp::socket client(io);
+    boost::asio::spawn(io, [&](boost::asio::yield_context yield)
+                       {
+                           acceptor.async_accept(server, yield);
+                           Si::asio::socket_sink sink(server, yield);
+                           BOOST_REQUIRE(
+                               !Si::append_file(sink, from.read.handle, 100));
+                           server.shutdown(
+                               boost::asio::ip::tcp::socket::shutdown_send);
+                       });
+    std::string received;
+    boost::asio::spawn(
+        io, [&](boost::asio::yield_context yield)
+        {
+            client.async_connect(acceptor.local_endpoint(), yield);
+            std::array<char, 16> buffer;
+            for (;;)
+            {
+                boost::system::error_code ec;
+                std::size_t const read_bytes = client.async_read_some(
+                    boost::asio::buffer(buffer), yield[ec]);
+                received.append(buffer.data(), read_bytes);
+                if (ec)
+                {
+                    break;
+                }
+            }
+        });
+    io.run();
+    BOOST_CHECK_EQUAL("abc", received);
+}
+#endif
+#endif
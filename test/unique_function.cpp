@@ -0,0 +1,76 @@
+#include <silicium/unique_function.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <memory>
+
+#if SILICIUM_HAS_UNIQUE_FUNCTION
+BOOST_AUTO_TEST_CASE(unique_function_default_constructor)
+{
+    Si::unique_function<void()> f;
+    BOOST_CHECK(!f);
+    Si::unique_function<void()> g{std::move(f)};
+    BOOST_CHECK(!f);
+    BOOST_CHECK(!g);
+    f = std::move(g);
+    BOOST_CHECK(!f);
+    BOOST_CHECK(!g);
+}
+
+BOOST_AUTO_TEST_CASE(unique_function_call)
+{
+    Si::unique_function<int(int)> inc = [](int a)
+    {
+        return a + 1;
+    };
+    BOOST_CHECK(inc);
+    BOOST_CHECK_EQUAL(3, inc(2));
+}
+
+BOOST_AUTO_TEST_CASE(unique_function_move_only_callable)
+{
+    std::unique_ptr<int> captured(new int(42));
+    int *const address = captured.get();
+    Si::unique_function<int *()> f = [captured = std::move(captured)]
+    {
+        return captured.get();
+    };
+    typedef Si::unique_function<int *()> function_type;
+    BOOST_CHECK((function_type::is_inline<std::unique_ptr<int>>::value));
+    function_type g = std::move(f);
+    BOOST_CHECK(!f);
+    BOOST_REQUIRE(g);
+    BOOST_CHECK_EQUAL(address, g());
+    g = nullptr;
+    BOOST_CHECK(!g);
+}
+
+BOOST_AUTO_TEST_CASE(unique_function_large_callable)
+{
+    std::array<long, 16> numbers;
+    numbers.fill(3);
+    typedef Si::unique_function<long()> function_type;
+    BOOST_CHECK((!function_type::is_inline<std::array<long, 16>>::value));
+    function_type f = [numbers]
+    {
+        return numbers[15];
+    };
+    function_type g = std::move(f);
+    BOOST_CHECK(!f);
+    BOOST_CHECK_EQUAL(3, g());
+}
+
+BOOST_AUTO_TEST_CASE(unique_function_destroys_callable)
+{
+    std::shared_ptr<int> counted = std::make_shared<int>(0);
+    {
+        Si::unique_function<void()> f = [counted]
+        {
+        };
+        BOOST_CHECK_EQUAL(2, counted.use_count());
+        Si::unique_function<void()> g;
+        g = std::move(f);
+        BOOST_CHECK_EQUAL(2, counted.use_count());
+    }
+    BOOST_CHECK_EQUAL(1, counted.use_count());
+}
+#endif
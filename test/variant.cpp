@@ -880,4 +880,146 @@ BOOST_AUTO_TEST_CASE(variant_switch_break)
     }
     BOOST_CHECK(ok);
 }
+
+namespace
+{
+    template <int N>
+    struct alternative
+    {
+        int value;
+
+        bool operator==(alternative const &other) const
+        {
+            return value == other.value;
+        }
+
+        bool operator<(alternative const &other) const
+        {
+            return value < other.value;
+        }
+    };
+
+    typedef Si::variant<
+        alternative<0>, alternative<1>, alternative<2>, alternative<3>,
+        alternative<4>, alternative<5>, alternative<6>, alternative<7>,
+        alternative<8>, alternative<9>, std::string> many_alternatives;
+
+    struct alternative_number : boost::static_visitor<int>
+    {
+        template <int N>
+        int operator()(alternative<N> const &element) const
+        {
+            return N * 100 + element.value;
+        }
+
+        int operator()(std::string const &) const
+        {
+            return -1;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(variant_more_than_eight_alternatives)
+{
+    many_alternatives v = alternative<3>{1};
+    BOOST_CHECK_EQUAL(301, Si::apply_visitor(alternative_number(), v));
+    v = alternative<9>{2};
+    BOOST_CHECK_EQUAL(9u, v.index());
+    BOOST_CHECK_EQUAL(902, Si::apply_visitor(alternative_number(), v));
+    many_alternatives const w = std::string(100, 'a');
+    BOOST_CHECK_EQUAL(-1, Si::apply_visitor(alternative_number(), w));
+    BOOST_CHECK(v != w);
+    BOOST_CHECK(v < w);
+    v = w;
+    BOOST_CHECK(v == w);
+    BOOST_CHECK(!(v < w));
+    many_alternatives const x = alternative<9>{3};
+    v = x;
+    BOOST_CHECK(v == x);
+}
+
+namespace
+{
+    struct describe_pair : boost::static_visitor<std::string>
+    {
+        std::string operator()(int left, int right) const
+        {
+            return boost::lexical_cast<std::string>(left + right);
+        }
+
+        std::string operator()(int left, std::string const &right) const
+        {
+            return boost::lexical_cast<std::string>(left) + right;
+        }
+
+        std::string operator()(std::string const &left, int right) const
+        {
+            return left + boost::lexical_cast<std::string>(right);
+        }
+
+        std::string operator()(std::string const &left,
+                               std::string const &right) const
+        {
+            return left + right;
+        }
+    };
+
+    struct sum_three : boost::static_visitor<int>
+    {
+        int operator()(int a, long b, int c) const
+        {
+            return a + static_cast<int>(b) + c;
+        }
+
+        template <class A, class B, class C>
+        int operator()(A const &, B const &, C const &) const
+        {
+            return -1;
+        }
+    };
+
+    struct increment_both : boost::static_visitor<void>
+    {
+        void operator()(int &left, int &right) const
+        {
+            ++left;
+            ++right;
+        }
+
+        template <class A, class B>
+        void operator()(A &, B &) const
+        {
+            BOOST_FAIL("wrong type");
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(variant_multi_visit)
+{
+    Si::variant<int, std::string> a = 1;
+    Si::variant<int, std::string> const b = std::string("b");
+    BOOST_CHECK_EQUAL("1b", Si::apply_visitor(describe_pair(), a, b));
+    BOOST_CHECK_EQUAL("b1", Si::apply_visitor(describe_pair(), b, a));
+    BOOST_CHECK_EQUAL("2", Si::apply_visitor(describe_pair(), a, a));
+    BOOST_CHECK_EQUAL("bb", Si::apply_visitor(describe_pair(), b, b));
+}
+
+BOOST_AUTO_TEST_CASE(variant_multi_visit_three)
+{
+    Si::variant<std::string, int> a = 1;
+    Si::variant<long, std::string> b = 2L;
+    Si::variant<int> const c = 3;
+    BOOST_CHECK_EQUAL(6, Si::apply_visitor(sum_three(), a, b, c));
+    a = std::string("a");
+    BOOST_CHECK_EQUAL(-1, Si::apply_visitor(sum_three(), a, b, c));
+}
+
+BOOST_AUTO_TEST_CASE(variant_multi_visit_mutable)
+{
+    Si::variant<int, std::string> a = 1;
+    Si::variant<std::string, int> b = 2;
+    Si::apply_visitor(increment_both(), a, b);
+    BOOST_CHECK_EQUAL(2, *Si::try_get_ptr<int>(a));
+    BOOST_CHECK_EQUAL(3, *Si::try_get_ptr<int>(b));
+}
 #endif
@@ -36,3 +36,24 @@ BOOST_AUTO_TEST_CASE(write_non_empty)
                                   read_buffer.begin(),
                                   read_buffer.begin() + result.get());
 }
+
+BOOST_AUTO_TEST_CASE(write_ranges)
+{
+    auto buffer = Si::make_pipe().move_value();
+    std::array<Si::memory_range, 3> const ranges = {
+        {Si::make_c_str_range("te"), Si::make_c_str_range(""),
+         Si::make_c_str_range("st")}};
+    Si::error_or<std::size_t> result = Si::write_ranges(
+        buffer.write.handle,
+        Si::make_iterator_range(ranges.data(), ranges.data() + ranges.size()));
+    BOOST_REQUIRE(!result.is_error());
+    BOOST_CHECK_EQUAL(4U, result.get());
+    std::array<char, 4096> read_buffer;
+    result =
+        Si::read(buffer.read.handle, Si::make_contiguous_range(read_buffer));
+    BOOST_REQUIRE(!result.is_error());
+    std::string const expected = "test";
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(),
+                                  read_buffer.begin(),
+                                  read_buffer.begin() + result.get());
+}
@@ -1,7 +1,12 @@
 #include <silicium/sink/container_buffer.hpp>
 #include <silicium/zlib/deflating_sink.hpp>
 #include <silicium/zlib/inflating_sink.hpp>
+#include <silicium/zlib/parallel_deflating_sink.hpp>
 #include <silicium/sink/append.hpp>
+#include <silicium/sink/buffering_sink.hpp>
+#include <silicium/sink/function_sink.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 
 #if SILICIUM_HAS_DEFLATING_SINK
@@ -46,4 +51,391 @@ BOOST_AUTO_TEST_CASE(zlib_deflating_sink_test)
     Si::append(compressor, Si::zlib_sink_element{Si::flush{}});
     BOOST_CHECK_GE(compressed.size(), 1u);
 }
+
+namespace
+{
+    std::vector<char> compress(std::string const &original,
+                               Si::zlib_format format)
+    {
+        z_stream stream = z_stream();
+        BOOST_REQUIRE_EQUAL(
+            Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               Si::zlib_window_bits(format), 8,
+                               Z_DEFAULT_STRATEGY));
+        std::vector<char> compressed(deflateBound(
+            &stream, static_cast<uLong>(original.size())));
+        stream.next_in =
+            reinterpret_cast<Bytef *>(const_cast<char *>(original.data()));
+        stream.avail_in = static_cast<uInt>(original.size());
+        stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+        stream.avail_out = static_cast<uInt>(compressed.size());
+        BOOST_REQUIRE_EQUAL(Z_STREAM_END, deflate(&stream, Z_FINISH));
+        compressed.resize(compressed.size() - stream.avail_out);
+        deflateEnd(&stream);
+        return compressed;
+    }
+
+    std::string make_text(std::size_t length)
+    {
+        std::string text;
+        for (std::size_t i = 0; text.size() < length; ++i)
+        {
+            text += "line ";
+            text += static_cast<char>('a' + (i * 7) % 26);
+            text += '\n';
+        }
+        text.resize(length);
+        return text;
+    }
+
+    std::string inflate_in_pieces(std::vector<char> const &compressed,
+                                  Si::zlib_format format,
+                                  std::size_t piece_size,
+                                  std::size_t max_output)
+    {
+        std::vector<char> decompressed;
+        auto decompressor = Si::make_inflating_sink(
+            Si::make_container_buffer(decompressed),
+            Si::zlib_inflate_stream(format), max_output);
+        for (std::size_t i = 0; i < compressed.size(); i += piece_size)
+        {
+            std::size_t const end =
+                (std::min)(compressed.size(), i + piece_size);
+            BOOST_REQUIRE(!decompressor.append(Si::make_iterator_range(
+                compressed.data() + i, compressed.data() + end)));
+        }
+        BOOST_CHECK(decompressor.is_complete());
+        return std::string(decompressed.begin(), decompressed.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zlib_inflating_sink_formats)
+{
+    std::string const original = make_text(100000);
+    Si::zlib_format const formats[] = {
+        Si::zlib_format::zlib, Si::zlib_format::gzip, Si::zlib_format::raw};
+    for (Si::zlib_format format : formats)
+    {
+        std::vector<char> const compressed = compress(original, format);
+        BOOST_CHECK(original ==
+                    inflate_in_pieces(compressed, format,
+                                      compressed.size(), 16 * 1024));
+        BOOST_CHECK(original == inflate_in_pieces(compressed, format, 1, 7));
+        if (format != Si::zlib_format::raw)
+        {
+            BOOST_CHECK(original ==
+                        inflate_in_pieces(compressed,
+                                          Si::zlib_format::automatic, 100,
+                                          1000));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zlib_inflating_sink_bounded_output)
+{
+    std::string const original(1000000, 'a');
+    std::vector<char> const compressed =
+        compress(original, Si::zlib_format::gzip);
+    std::vector<std::size_t> requested;
+    auto decompressor = Si::make_inflating_sink(
+        Si::make_buffering_sink(Si::make_function_sink<char>(
+            [&requested](Si::iterator_range<char const *> data)
+            {
+                requested.push_back(static_cast<std::size_t>(data.size()));
+                return Si::success();
+            })),
+        Si::zlib_inflate_stream(Si::zlib_format::gzip), 4096);
+    BOOST_REQUIRE(!decompressor.append(
+        Si::make_iterator_range(compressed.data(),
+                                compressed.data() + compressed.size())));
+    BOOST_CHECK(decompressor.is_complete());
+    decompressor.next().flush();
+    std::size_t total = 0;
+    for (std::size_t size : requested)
+    {
+        BOOST_CHECK_LE(size, 8192u);
+        total += size;
+    }
+    BOOST_CHECK_EQUAL(original.size(), total);
+}
+
+BOOST_AUTO_TEST_CASE(zlib_inflating_sink_concatenated_gzip)
+{
+    std::vector<char> compressed = compress("Hello, ", Si::zlib_format::gzip);
+    std::vector<char> const second = compress("world", Si::zlib_format::gzip);
+    compressed.insert(compressed.end(), second.begin(), second.end());
+    BOOST_CHECK_EQUAL("Hello, world",
+                      inflate_in_pieces(compressed, Si::zlib_format::gzip, 3,
+                                        100));
+}
+
+BOOST_AUTO_TEST_CASE(zlib_inflating_sink_truncated)
+{
+    std::vector<char> const compressed =
+        compress(make_text(1000), Si::zlib_format::gzip);
+    std::vector<char> decompressed;
+    auto decompressor = Si::make_inflating_sink(
+        Si::make_container_buffer(decompressed),
+        Si::zlib_inflate_stream(Si::zlib_format::gzip));
+    BOOST_REQUIRE(!decompressor.append(Si::make_iterator_range(
+        compressed.data(), compressed.data() + compressed.size() / 2)));
+    BOOST_CHECK(!decompressor.is_complete());
+}
+
+BOOST_AUTO_TEST_CASE(zlib_inflating_sink_corrupted)
+{
+    std::vector<char> compressed =
+        compress(make_text(1000), Si::zlib_format::zlib);
+    compressed[0] = 0;
+    std::vector<char> decompressed;
+    auto decompressor = Si::make_inflating_sink(
+        Si::make_container_buffer(decompressed),
+        Si::zlib_inflate_stream(Si::zlib_format::zlib));
+    boost::system::error_code const error =
+        decompressor.append(Si::make_iterator_range(
+            compressed.data(), compressed.data() + compressed.size()));
+    BOOST_CHECK_EQUAL(boost::system::error_code(Z_DATA_ERROR,
+                                                Si::zlib_category()),
+                      error);
+}
+
+namespace
+{
+    /// Counts how often the deflating sink asks for space, which it does
+    /// once for every deflate call.
+    struct counting_buffer
+    {
+        typedef char element_type;
+        typedef Si::success error_type;
+
+        Si::container_buffer<std::vector<char>> next;
+        std::size_t *requests;
+
+        Si::iterator_range<char *> make_append_space(std::size_t size)
+        {
+            if (size > 0)
+            {
+                ++*requests;
+            }
+            return next.make_append_space(size);
+        }
+
+        error_type flush_append_space()
+        {
+            return next.flush_append_space();
+        }
+    };
+
+    std::vector<std::string> make_fragments()
+    {
+        std::vector<std::string> fragments;
+        for (std::size_t i = 0; i < 5000; ++i)
+        {
+            fragments.push_back("<li>item " +
+                                boost::lexical_cast<std::string>(i) +
+                                "</li>");
+        }
+        return fragments;
+    }
+
+    std::size_t deflate_fragments(std::vector<std::string> const &fragments,
+                                  std::size_t staging_size,
+                                  std::vector<char> &compressed)
+    {
+        std::size_t requests = 0;
+        counting_buffer buffer = {Si::make_container_buffer(compressed),
+                                  &requests};
+        auto compressor = Si::make_deflating_sink(
+            buffer, Si::zlib_deflate_stream(Z_DEFAULT_COMPRESSION,
+                                            Si::zlib_format::gzip),
+            staging_size);
+        std::size_t total = 0;
+        for (std::string const &fragment : fragments)
+        {
+            BOOST_REQUIRE(!Si::append(
+                compressor, Si::zlib_sink_element{Si::make_memory_range(
+                                fragment.data(),
+                                fragment.data() + fragment.size())}));
+            total += fragment.size();
+        }
+        BOOST_REQUIRE(
+            !Si::append(compressor, Si::zlib_sink_element{Si::finish()}));
+        BOOST_CHECK_EQUAL(total, compressor.uncompressed_bytes());
+        BOOST_CHECK_EQUAL(compressed.size(), compressor.compressed_bytes());
+        return requests;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zlib_deflating_sink_coalesces)
+{
+    std::vector<std::string> const fragments = make_fragments();
+    std::string const original = boost::algorithm::join(fragments, "");
+
+    std::vector<char> coalesced;
+    std::size_t const coalesced_requests =
+        deflate_fragments(fragments, 16 * 1024, coalesced);
+    BOOST_CHECK_EQUAL(original, inflate_in_pieces(coalesced,
+                                                  Si::zlib_format::gzip,
+                                                  coalesced.size(), 4096));
+
+    std::vector<char> separate;
+    std::size_t const separate_requests =
+        deflate_fragments(fragments, 0, separate);
+    BOOST_CHECK_EQUAL(original,
+                      inflate_in_pieces(separate, Si::zlib_format::gzip,
+                                        separate.size(), 4096));
+
+    BOOST_CHECK_LT(coalesced_requests * 10, separate_requests);
+}
+
+BOOST_AUTO_TEST_CASE(zlib_deflating_sink_sync_flush)
+{
+    std::vector<char> compressed;
+    auto compressor =
+        Si::make_deflating_sink(Si::make_container_buffer(compressed),
+                                Si::zlib_deflate_stream(Z_DEFAULT_COMPRESSION));
+    BOOST_REQUIRE(!Si::append(
+        compressor, Si::zlib_sink_element{Si::make_c_str_range("Hello")}));
+    BOOST_CHECK(compressed.empty());
+    BOOST_REQUIRE(!Si::append(compressor, Si::zlib_sink_element{Si::flush()}));
+
+    // everything appended before the flush can be decompressed already
+    std::vector<char> decompressed;
+    auto decompressor =
+        Si::make_inflating_sink(Si::make_container_buffer(decompressed),
+                                Si::zlib_inflate_stream(Si::zlib_format::zlib));
+    BOOST_REQUIRE(!decompressor.append(Si::make_iterator_range(
+        compressed.data(), compressed.data() + compressed.size())));
+    BOOST_CHECK_EQUAL("Hello",
+                      std::string(decompressed.begin(), decompressed.end()));
+    BOOST_CHECK(!decompressor.is_complete());
+
+    std::size_t const flushed_size = compressed.size();
+    BOOST_REQUIRE(!Si::append(
+        compressor, Si::zlib_sink_element{Si::make_c_str_range(", world")}));
+    BOOST_REQUIRE(
+        !Si::append(compressor, Si::zlib_sink_element{Si::full_flush()}));
+    BOOST_REQUIRE(
+        !Si::append(compressor, Si::zlib_sink_element{Si::finish()}));
+    BOOST_REQUIRE(!decompressor.append(
+        Si::make_iterator_range(compressed.data() + flushed_size,
+                                compressed.data() + compressed.size())));
+    BOOST_CHECK_EQUAL("Hello, world",
+                      std::string(decompressed.begin(), decompressed.end()));
+    BOOST_CHECK(decompressor.is_complete());
+}
+
+#if SILICIUM_HAS_PARALLEL_DEFLATING_SINK
+namespace
+{
+    std::vector<char> deflate_in_parallel(
+        std::vector<std::string> const &fragments, Si::zlib_format format,
+        std::size_t block_size)
+    {
+        std::vector<char> compressed;
+        auto compressor = Si::make_parallel_deflating_sink(
+            Si::make_container_buffer(compressed), Z_DEFAULT_COMPRESSION,
+            format, 3, block_size);
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < fragments.size(); ++i)
+        {
+            std::string const &fragment = fragments[i];
+            BOOST_REQUIRE(!Si::append(
+                compressor, Si::zlib_sink_element{Si::make_memory_range(
+                                fragment.data(),
+                                fragment.data() + fragment.size())}));
+            total += fragment.size();
+            if (i == 1000)
+            {
+                BOOST_REQUIRE(!Si::append(compressor,
+                                          Si::zlib_sink_element{Si::flush()}));
+            }
+            if (i == 2000)
+            {
+                BOOST_REQUIRE(!Si::append(
+                    compressor, Si::zlib_sink_element{Si::full_flush()}));
+            }
+        }
+        BOOST_REQUIRE(
+            !Si::append(compressor, Si::zlib_sink_element{Si::finish()}));
+        BOOST_CHECK_EQUAL(total, compressor.uncompressed_bytes());
+        BOOST_CHECK_EQUAL(compressed.size(), compressor.compressed_bytes());
+        return compressed;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zlib_parallel_deflating_sink)
+{
+    std::vector<std::string> const fragments = make_fragments();
+    std::string const original = boost::algorithm::join(fragments, "");
+    std::vector<char> sequential;
+    deflate_fragments(fragments, 16 * 1024, sequential);
+    Si::zlib_format const formats[] = {
+        Si::zlib_format::zlib, Si::zlib_format::gzip, Si::zlib_format::raw};
+    for (Si::zlib_format format : formats)
+    {
+        std::vector<char> const compressed =
+            deflate_in_parallel(fragments, format, 4096);
+        // inflate checks the checksum and the length in the trailer
+        BOOST_CHECK_EQUAL(original,
+                          inflate_in_pieces(compressed, format,
+                                            compressed.size(), 4096));
+        BOOST_CHECK_LT(compressed.size(), sequential.size() * 11 / 10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zlib_parallel_deflating_sink_shared_workers)
+{
+    Si::deflate_worker_pool workers(2);
+    std::string const original(100000, 'a');
+    std::vector<char> first, second;
+    auto first_compressor = Si::make_parallel_deflating_sink(
+        Si::make_container_buffer(first), workers, Z_BEST_SPEED,
+        Si::zlib_format::gzip, 4096);
+    auto second_compressor = Si::make_parallel_deflating_sink(
+        Si::make_container_buffer(second), workers, Z_BEST_COMPRESSION,
+        Si::zlib_format::zlib, 4096);
+    Si::zlib_sink_element const content{Si::make_memory_range(
+        original.data(), original.data() + original.size())};
+    BOOST_REQUIRE(!Si::append(first_compressor, content));
+    BOOST_REQUIRE(!Si::append(second_compressor, content));
+    BOOST_REQUIRE(!Si::append(first_compressor,
+                              Si::zlib_sink_element{Si::finish()}));
+    BOOST_REQUIRE(!Si::append(second_compressor,
+                              Si::zlib_sink_element{Si::finish()}));
+    BOOST_CHECK_EQUAL(original, inflate_in_pieces(first, Si::zlib_format::gzip,
+                                                  first.size(), 4096));
+    BOOST_CHECK_EQUAL(original,
+                      inflate_in_pieces(second, Si::zlib_format::zlib,
+                                        second.size(), 4096));
+}
+
+BOOST_AUTO_TEST_CASE(zlib_parallel_deflating_sink_worker_error)
+{
+    Si::deflate_worker_pool workers(1);
+    std::vector<char> compressed;
+    // deflateInit2 rejects the level on the worker thread
+    auto compressor = Si::make_parallel_deflating_sink(
+        Si::make_container_buffer(compressed), workers, 42,
+        Si::zlib_format::gzip);
+    BOOST_REQUIRE(!Si::append(compressor, Si::zlib_sink_element{
+                                              Si::make_c_str_range("Hello")}));
+    boost::system::error_code const error =
+        Si::append(compressor, Si::zlib_sink_element{Si::finish()});
+    BOOST_CHECK(error == boost::system::error_code(Z_STREAM_ERROR,
+                                                   Si::zlib_category()));
+}
+
+BOOST_AUTO_TEST_CASE(zlib_parallel_deflating_sink_empty)
+{
+    std::vector<char> compressed;
+    auto compressor = Si::make_parallel_deflating_sink(
+        Si::make_container_buffer(compressed), Z_BEST_COMPRESSION,
+        Si::zlib_format::zlib, 2);
+    BOOST_REQUIRE(
+        !Si::append(compressor, Si::zlib_sink_element{Si::finish()}));
+    BOOST_CHECK_EQUAL("", inflate_in_pieces(compressed, Si::zlib_format::zlib,
+                                            1, 100));
+}
+#endif
 #endif
@@ -0,0 +1,7 @@
+#include <silicium/asio/deadline_flush.hpp>
+#ifdef _MSC_VER
+namespace {
+	//"This object file does not define any previously undefined public symbols, so it will not be used by any link operation that consumes this library"
+	int dummy_to_avoid_msvc_linker_warning_LNK4221;
+}
+#endif
@@ -9,28 +9,40 @@
 #include <silicium/asio/block_thread.hpp>
 #include <silicium/asio/connecting_observable.hpp>
 #include <silicium/asio/connecting_source.hpp>
+#include <silicium/asio/deadline_flush.hpp>
+#include <silicium/asio/get_io_service.hpp>
 #include <silicium/asio/post_forwarder.hpp>
 #include <silicium/asio/posting_observable.hpp>
 #include <silicium/asio/process_output.hpp>
 #include <silicium/asio/reading_observable.hpp>
+#include <silicium/asio/server_pool.hpp>
+#include <silicium/asio/socket_pool.hpp>
 #include <silicium/asio/socket_sink.hpp>
 #include <silicium/asio/socket_source.hpp>
 #include <silicium/asio/tcp_acceptor.hpp>
 #include <silicium/asio/timer.hpp>
+#include <silicium/asio/uring_service.hpp>
 #include <silicium/asio/use_observable.hpp>
 #include <silicium/asio/writing_observable.hpp>
+#include <silicium/asio/yield_wait.hpp>
 #include <silicium/boost_threading.hpp>
 #include <silicium/bounded_int.hpp>
+#include <silicium/buffer_pool.hpp>
 #include <silicium/byte.hpp>
 #include <silicium/byte_order_intrinsics.hpp>
 #include <silicium/c_string.hpp>
+#include <silicium/channel.hpp>
+#include <silicium/compression/codec.hpp>
+#include <silicium/compression/select.hpp>
 #include <silicium/config.hpp>
 #include <silicium/detail/argument_of.hpp>
 #include <silicium/detail/basic_dynamic_library.hpp>
 #include <silicium/detail/element_from_optional_like.hpp>
+#include <silicium/detail/find_byte.hpp>
 #include <silicium/detail/integer_sequence.hpp>
 #include <silicium/detail/line_source.hpp>
 #include <silicium/detail/proper_value_function.hpp>
+#include <silicium/detail/pull_buffer.hpp>
 #include <silicium/detail/then.hpp>
 #include <silicium/dynamic_library.hpp>
 #include <silicium/environment_variables.hpp>
@@ -48,22 +60,28 @@
 #include <silicium/http/generate_header.hpp>
 #include <silicium/http/generate_request.hpp>
 #include <silicium/http/generate_response.hpp>
+#include <silicium/http/header_table.hpp>
 #include <silicium/http/http.hpp>
+#include <silicium/http/message_body.hpp>
 #include <silicium/http/parse_request.hpp>
 #include <silicium/http/parse_response.hpp>
 #include <silicium/http/receive_request.hpp>
 #include <silicium/http/request_parser_sink.hpp>
+#include <silicium/http/request_view_parser_sink.hpp>
 #include <silicium/identity.hpp>
 #include <silicium/initialize_array.hpp>
 #include <silicium/iterator_range.hpp>
 #include <silicium/linux/dynamic_library_impl.hpp>
+#include <silicium/linux/io_uring.hpp>
 #include <silicium/lossless_cast.hpp>
+#include <silicium/lz4/codec.hpp>
 #include <silicium/make_array.hpp>
 #include <silicium/make_destructor.hpp>
 #include <silicium/make_unique.hpp>
 #include <silicium/memory_range.hpp>
 #include <silicium/move.hpp>
 #include <silicium/move_if_noexcept.hpp>
+#include <silicium/mpmc_queue.hpp>
 #include <silicium/native_file_descriptor.hpp>
 #include <silicium/noexcept_string.hpp>
 #include <silicium/null_mutex.hpp>
@@ -75,15 +93,19 @@
 #include <silicium/range_value.hpp>
 #include <silicium/read.hpp>
 #include <silicium/sink/append.hpp>
+#include <silicium/sink/append_file.hpp>
+#include <silicium/sink/append_ranges.hpp>
 #include <silicium/sink/buffer.hpp>
 #include <silicium/sink/buffering_sink.hpp>
 #include <silicium/sink/container_buffer.hpp>
 #include <silicium/sink/copy.hpp>
 #include <silicium/sink/file_sink.hpp>
+#include <silicium/sink/flush_policy.hpp>
 #include <silicium/sink/function_sink.hpp>
 #include <silicium/sink/iterator_sink.hpp>
 #include <silicium/sink/multi_sink.hpp>
 #include <silicium/sink/ostream_sink.hpp>
+#include <silicium/sink/pooled_buffer.hpp>
 #include <silicium/sink/ptr_sink.hpp>
 #include <silicium/sink/sink.hpp>
 #include <silicium/sink/throwing_sink.hpp>
@@ -94,6 +116,8 @@
 #include <silicium/source/error_extracting_source.hpp>
 #include <silicium/source/filter_source.hpp>
 #include <silicium/source/generator_source.hpp>
+#include <silicium/source/line_view_source.hpp>
+#include <silicium/source/mapped_file_source.hpp>
 #include <silicium/source/memory_source.hpp>
 #include <silicium/source/ptr_source.hpp>
 #include <silicium/source/range_source.hpp>
@@ -103,6 +127,7 @@
 #include <silicium/source/throwing_source.hpp>
 #include <silicium/source/transforming_source.hpp>
 #include <silicium/source/virtualized_source.hpp>
+#include <silicium/spsc_ring.hpp>
 #include <silicium/std_threading.hpp>
 #include <silicium/steady_clock.hpp>
 #include <silicium/success.hpp>
@@ -111,10 +136,15 @@
 #include <silicium/to_shared.hpp>
 #include <silicium/to_unique.hpp>
 #include <silicium/trait.hpp>
+#include <silicium/transfer_file.hpp>
 #include <silicium/type_traits.hpp>
+#include <silicium/unique_function.hpp>
 #include <silicium/variant.hpp>
 #include <silicium/version.hpp>
 #include <silicium/write.hpp>
+#include <silicium/zlib/codec.hpp>
 #include <silicium/zlib/deflating_sink.hpp>
 #include <silicium/zlib/inflating_sink.hpp>
+#include <silicium/zlib/parallel_deflating_sink.hpp>
 #include <silicium/zlib/zlib.hpp>
+#include <silicium/zstd/codec.hpp>